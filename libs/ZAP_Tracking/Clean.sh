@@ -24,6 +24,7 @@ Clean()
 Clean ZT
 Clean ZT_Agent
 Clean ZT_Lib
+Clean ZT_Lib_Bench
 Clean ZT_Lib_Test
 
 # ===== End =================================================================
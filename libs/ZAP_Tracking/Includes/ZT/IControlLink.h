@@ -29,6 +29,25 @@ namespace ZT
 
         virtual Result Gimbals_Set(ISystem * aSystem) = 0;
 
+        // Return the number of gimbals, one per GIMBAL line of the
+        // configuration or one without GIMBAL line
+        virtual unsigned int Gimbal_Count_Get() const = 0;
+
+        // aIndex  0 to Gimbal_Count_Get() - 1
+        //
+        // Start activates the gimbals. The functions ignore the gimbals
+        // it did not activate, Start succeeds when at least one gimbal
+        // activates.
+        //
+        // Return  The result of the activation, ZT_OK before Start
+        //         ZT_ERROR_GIMBAL  aIndex is not valid
+        virtual Result Gimbal_Result_Get(unsigned int aIndex) const = 0;
+
+        // Display the metrics of each gimbal, the gimbals do not stop.
+        //
+        // aReset  Start a new measurement period
+        virtual void Metrics_Display(void * aOut = NULL, bool aReset = false) = 0;
+
         virtual Result Receiver_Set(ZT::IMessageReceiver * aReceiver, unsigned int aConfigured, unsigned int aUnknown) = 0;
 
         // If Start return an error, the IControlLink instance must be
@@ -20,6 +20,8 @@
 namespace ZT
 {
 
+    class IMessageReceiver;
+
     class IGimbal : public IObject
     {
 
@@ -81,6 +83,33 @@ namespace ZT
         }
         Info;
 
+        // --> INACTIVE --> OK <--> RECOVERING --> FAILED
+        //                               ^             |
+        //                               +-------------+
+        typedef enum
+        {
+            HEALTH_FAILED,     // The recovery stopped, it tries again later
+            HEALTH_INACTIVE,   // Not activated
+            HEALTH_OK,
+            HEALTH_RECOVERING, // The communication failed, the recovery runs
+
+            HEALTH_QTY
+        }
+        Health;
+
+        typedef struct
+        {
+            Health mHealth;
+
+            unsigned int mFailure;  // Failed recoveries in a row
+            unsigned int mRecovery; // Successful recoveries
+            unsigned int mRetry_ms; // Before the next CAN reset, 0 when none
+                                    // is waiting
+
+            uint8_t mReserved0[16];
+        }
+        HealthStatus;
+
         typedef enum
         {
             OPERATION_CAL_AUTO_ENABLE,
@@ -99,12 +128,87 @@ namespace ZT
         }
         Position;
 
+        typedef struct
+        {
+            Position mPosition;
+
+            uint64_t     mTimestamp_us; // Capture time, monotonic clock
+            unsigned int mAge_ms;       // Age when returned
+
+            uint8_t mReserved0[20];
+        }
+        PositionSample;
+
         typedef struct
         {
             double mAxis_deg_s[AXIS_QTY];
         }
         Speed;
 
+        typedef enum
+        {
+            MOTION_MOVING,
+            MOTION_SPEED,
+            MOTION_STOPPED,
+            MOTION_UNKNOWN,
+
+            MOTION_QTY
+        }
+        Motion;
+
+        // The data of the telemetry message
+        typedef struct
+        {
+            Position mPosition;
+            Speed    mSpeed;    // Requested speed
+
+            uint64_t     mTimestamp_us; // Capture time, monotonic clock
+            unsigned int mIndex;        // Received positions, the skipped ones included
+            Motion       mMotion;
+
+            uint8_t mReserved0[16];
+        }
+        Telemetry;
+
+        // A latency distribution, the percentiles are the upper limit of
+        // their histogram bucket, 12.5 % over the value at worst.
+        typedef struct
+        {
+            uint64_t mCount;
+
+            unsigned int mAvg_us;
+            unsigned int mMax_us;
+            unsigned int mP50_us;
+            unsigned int mP90_us;
+            unsigned int mP99_us;
+
+            uint8_t mReserved0[12];
+        }
+        Latency;
+
+        typedef struct
+        {
+            Latency mCommand;    // From the command to the send of its frame
+            Latency mRoundTrip;  // From the send of a request to its reply
+            Latency mTick;       // Between two periodic ticks
+            Latency mZone0_Hold; // The time the internal lock stays locked
+            Latency mZone0_Wait; // The time waiting for the internal lock
+            Latency mGroup_Skew; // The start of a group move after the
+                                 // first gimbal of the group
+
+            unsigned int mRetry;
+            unsigned int mRx_byte;
+            unsigned int mRx_Error;
+            unsigned int mRx_frame;
+            unsigned int mTimeout;
+            unsigned int mTx_byte;
+            unsigned int mTx_Error;
+            unsigned int mTx_frame;
+
+            uint8_t mReserved1[32];
+        }
+        Metrics;
+
         static const double POSITION_MAX_deg;
         static const double POSITION_MIN_deg;
 
@@ -122,11 +226,17 @@ namespace ZT
         static void Display(void * aOut, Axis aIn);
         static void Display(void * aOut, const Config & aIn);
         static void Display(void * aOut, const Config_Axis & aIn);
+        static void Display(void * aOut, Health aIn);
+        static void Display(void * aOut, const HealthStatus & aIn);
         static void Display(void * aOut, const Info & aIn);
         static void Display(void * aOut, const Info_Axis & aIn);
+        static void Display(void * aOut, const Latency & aIn);
+        static void Display(void * aOut, const Metrics & aIn);
+        static void Display(void * aOut, Motion aIn);
         static void Display(void * aOut, Operation aIn);
         static void Display(void * aOut, const Position & aIn);
         static void Display(void * aOut, const Speed & aIn);
+        static void Display(void * aOut, const Telemetry & aIn);
 
         virtual Result Activate() = 0;
 
@@ -137,15 +247,58 @@ namespace ZT
         virtual Result Focus_Position_Set(double aPosition_pc) = 0;
         virtual Result Focus_Speed_Set   (double aSpeed_pc_s) = 0;
 
+        // Never wait. The gimbal recovers from a communication error in
+        // background, the other methods return ZT_ERROR_NOT_READY while it
+        // cannot communicate.
+        virtual Result Health_Get(HealthStatus * aOut) = 0;
+
         virtual void Info_Get(Info * aOut) const = 0;
 
+        // aOut    [---;-W-]
+        // aReset            Start a new measurement period, each event is
+        //                   part of one returned Metrics only
+        //
+        // The thread communicating with the gimbal does not stop while the
+        // metrics are read.
+        virtual Result Metrics_Get(Metrics * aOut, bool aReset = false) = 0;
+
         virtual Result Position_Get(Position * aOut) = 0;
+
+        // aMaxAge_ms  Return the last received position when it is not
+        //             older, wait for a new one otherwise
+        virtual Result Position_Get(PositionSample * aOut, unsigned int aMaxAge_ms) = 0;
+
+        // Return the last received position, never wait.
+        // ZT_ERROR_NOT_READY when no position was received yet.
+        virtual Result Position_Get_Cached(PositionSample * aOut) = 0;
+
         virtual Result Position_Set(const Position & aIn, unsigned int aFlags = 0, unsigned int aDuration_ms = 0) = 0;
 
+        // aFileName  The file must not exist. NULL creates a new
+        //            /tmp/ZT_Recorder_<IPv4 address>_XXXXXX file, the
+        //            gimbal displays its name.
+        //
+        // Write the last CAN fragments, transactions and state changes of
+        // the gimbal. The gimbal also writes them to a new default file
+        // when its communication fails. A dump never replaces a file nor
+        // follows a link.
+        virtual Result Recorder_Dump(const char * aFileName = NULL) = 0;
+
         virtual Result Speed_Get(Speed * aOut) = 0;
         virtual Result Speed_Set(const Speed & aIn, unsigned int aFlags = 0) = 0;
         virtual Result Speed_Stop() = 0;
 
+        // aReceiver    ProcessMessage(this, aCode, const Telemetry *) is
+        //              called by the thread receiving the positions, right
+        //              after the position is received. It must return
+        //              quickly and it must not call Telemetry_Start or
+        //              Telemetry_Stop.
+        // aDecimation  Only one position of aDecimation is sent
+        virtual Result Telemetry_Start(IMessageReceiver * aReceiver, unsigned int aCode, unsigned int aDecimation = 1) = 0;
+
+        // The receiver is not called anymore when this method returns.
+        virtual Result Telemetry_Stop() = 0;
+
         virtual Result Track_Speed_Set(double aSpeed_pc) = 0;
         virtual Result Track_Switch() = 0;
 
@@ -6,14 +6,16 @@
 
 #pragma once
 
+#include <ZT/IGimbal.h>
 #include <ZT/IObject.h>
 #include <ZT/Result.h>
 
+#define ZT_GROUP_MAX (16)
+
 namespace ZT
 {
 
     class IGamepad;
-    class IGimbal;
 
     class ISystem : public IObject
     {
@@ -22,6 +24,20 @@ namespace ZT
 
         static ISystem * Create();
 
+        // aFolder  The folder of the cache files, NULL disables the cache.
+        //          The folder must belong to the user and only the user
+        //          can write into it. By default, the cache is disabled.
+        //
+        // The next Gimbals_Detect gives the folder to the DJI gimbals.
+        // With the cache, Activate uses what the gimbal reported at the
+        // previous activation and validates it in background.
+        //
+        // Return  ZT_OK
+        //         ZT_ERROR_CONFIG
+        //         ZT_ERROR_FILE_OPEN
+        //         ZT_ERROR_MAX
+        virtual Result Cache_Set(const char * aFolder) = 0;
+
         virtual Result Gamepads_Detect() = 0;
 
         virtual IGamepad * Gamepad_Get(unsigned int aIndex) = 0;
@@ -32,6 +48,33 @@ namespace ZT
         virtual IGimbal * Gimbal_Find_IPv4(uint32_t aIPv4) = 0;
         virtual IGimbal * Gimbal_Get(unsigned int aIndex) = 0;
 
+        // aGimbals      The gimbals of the group, they come from a system
+        // aPositions    One position per gimbal
+        // aCount        1 to ZT_GROUP_MAX
+        // aFlags        See ZT_FLAG_IGNORE_...
+        // aDuration_ms  The minimum duration of the move
+        //
+        // The gimbals start their move at the same time and they use the
+        // same duration, the longest one a gimbal of the group needs. No
+        // gimbal moves when one of them cannot. Metrics::mGroup_Skew of
+        // each gimbal tells how long after the first one it started. A
+        // gimbal listed many times moves once, to its first position.
+        //
+        // Return  ZT_OK
+        //         ZT_ERROR_MAX
+        //         ZT_ERROR_MIN
+        //         See IGimbal::Position_Set
+        virtual Result Gimbals_Position_Set(IGimbal ** aGimbals, const IGimbal::Position * aPositions, unsigned int aCount, unsigned int aFlags = 0, unsigned int aDuration_ms = 0) = 0;
+
+        // aGimbal_Count  0 to 64, 0 removes the simulated gimbals
+        //
+        // The next Gimbals_Detect also returns aGimbal_Count simulated DJI
+        // gimbals, at 127.1.0.1, 127.1.0.2, ... They need no hardware.
+        //
+        // Return  ZT_OK
+        //         ZT_ERROR_MAX
+        virtual Result Simulator_Set(unsigned int aGimbal_Count) = 0;
+
     };
 
 }
@@ -30,6 +30,7 @@ Make ZT_Lib
 Make ZT
 Make ZT_Agent
 Make ZT_Lib_Test
+Make ZT_Lib_Bench
 
 # ===== End =================================================================
 
@@ -6,8 +6,8 @@
 
 IMPORT_FOLDER = ../Import
 
-# COMPILE_FLAGS = -DDEBUG -fpic -ggdb -O2
-COMPILE_FLAGS = -DNDEBUG -fpic -ggdb -O2
+# COMPILE_FLAGS = -DDEBUG -fpic -ggdb -O2 -std=c++14
+COMPILE_FLAGS = -DNDEBUG -fpic -ggdb -O2 -std=c++14
 
 INCLUDE_IMPORT = -I $(IMPORT_FOLDER)/Includes
 
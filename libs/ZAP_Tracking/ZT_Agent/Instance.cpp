@@ -71,6 +71,15 @@ ZT::Result Instance::Init(ZT::ISystem * aSystem)
     return lResult;
 }
 
+void Instance::Metrics_Display(bool aReset)
+{
+    assert(NULL != mControlLink);
+
+    printf("===== Instance %u - Metrics =====\n", mIndex);
+
+    mControlLink->Metrics_Display(stdout, aReset);
+}
+
 ZT::Result Instance::Start(MessageReceiver * aReceiver, unsigned int aCode)
 {
     assert(NULL != aReceiver);
@@ -24,6 +24,9 @@ public:
 
     ZT::Result Init(ZT::ISystem * aSystem);
 
+    // aReset  Start a new measurement period
+    void Metrics_Display(bool aReset);
+
     ZT::Result Start(MessageReceiver * aReceiver, unsigned int aCode);
 
     void Stop();
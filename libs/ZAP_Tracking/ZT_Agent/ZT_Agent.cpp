@@ -28,6 +28,13 @@
 
 typedef std::list<Instance *> InstanceList;
 
+// Constants
+// //////////////////////////////////////////////////////////////////////////
+
+// The agent displays the metrics of the gimbals and starts a new period at
+// this interval.
+#define METRICS_PERIOD_s (60)
+
 // Static variables
 // //////////////////////////////////////////////////////////////////////////
 
@@ -40,6 +47,8 @@ static ZT::ISystem *   sSystem = NULL;
 
 static ZT::Result Init();
 
+static void Metrics_Display();
+
 static ZT::Result Start();
 static void       Stop();
 
@@ -66,9 +75,18 @@ int main()
         {
             if (ZT::ZT_OK == Start())
             {
+                unsigned int lSecond = 0;
+
                 while (!sReceiver.IsStopRequested())
                 {
                     sleep(1);
+
+                    lSecond ++;
+                    if (METRICS_PERIOD_s <= lSecond)
+                    {
+                        Metrics_Display();
+                        lSecond = 0;
+                    }
                 }
 
                 Stop();
@@ -131,6 +149,16 @@ ZT::Result Init()
     return lResult;
 }
 
+void Metrics_Display()
+{
+    for (InstanceList::iterator lIt = sInstances.begin(); lIt != sInstances.end(); lIt++)
+    {
+        assert(NULL != (*lIt));
+
+        (*lIt)->Metrics_Display(true);
+    }
+}
+
 ZT::Result Start()
 {
     ZT::Result lResult = ZT::ZT_OK;
@@ -0,0 +1,93 @@
+
+// Author  KMS - Martin Dubois, P. Eng.
+// Client  ZAP
+// Product Tacking
+// File    ZT_Lib/CAN_Batch.cpp
+
+#include "Component.h"
+
+// ===== ZT_Lib =============================================================
+#include "CAN_Batch.h"
+
+// Constants
+// //////////////////////////////////////////////////////////////////////////
+
+#define FRAGMENT_MAX_byte (8)
+
+// Public
+// //////////////////////////////////////////////////////////////////////////
+
+CAN_Batch::CAN_Batch() : mCount(0)
+{
+    memset(&mFrames, 0, sizeof(mFrames));
+}
+
+void CAN_Batch::Clear()
+{
+    mCount = 0;
+}
+
+unsigned int CAN_Batch::Count_Get() const
+{
+    assert(CAN_BATCH_SIZE >= mCount);
+
+    return mCount;
+}
+
+const EthCAN_Frame * CAN_Batch::Frames_Get() const
+{
+    return mFrames;
+}
+
+bool CAN_Batch::Frame_Add(const DJI_Frame & aFrame, uint32_t aId)
+{
+    assert(CAN_BATCH_SIZE >= mCount);
+
+    const uint8_t * lFrame          = &aFrame.mSOF;
+    unsigned int    lOffset_byte    = 0;
+    unsigned int    lCount          = mCount;
+    unsigned int    lTotalSize_byte = aFrame.mSize_byte;
+
+    do
+    {
+        if (CAN_BATCH_SIZE <= lCount)
+        {
+            return false;
+        }
+
+        // The footer never shares a fragment with the end of the data
+        unsigned int lSize_byte = lTotalSize_byte - lOffset_byte;
+        if (FRAGMENT_MAX_byte < lSize_byte)
+        {
+            lSize_byte = ((FRAGMENT_MAX_byte + DJI_FOOTER_SIZE_byte) < lSize_byte) ? FRAGMENT_MAX_byte : lSize_byte - DJI_FOOTER_SIZE_byte;
+        }
+
+        EthCAN_Frame & lCF = mFrames[lCount];
+
+        memset(&lCF, 0, sizeof(lCF));
+
+        lCF.mDataSize_byte = lSize_byte;
+        lCF.mId            = aId;
+
+        memcpy(lCF.mData, lFrame + lOffset_byte, lSize_byte);
+
+        lCount       ++;
+        lOffset_byte += lSize_byte;
+    }
+    while (lOffset_byte < lTotalSize_byte);
+
+    // The footer arrives before the short end of the data
+    if ((DJI_CAN_ID_RX == aId) && (mCount + 2 <= lCount)
+        && (FRAGMENT_MAX_byte > mFrames[lCount - 2].mDataSize_byte)
+        && (FRAGMENT_MAX_byte > mFrames[lCount - 1].mDataSize_byte))
+    {
+        EthCAN_Frame lCF = mFrames[lCount - 2];
+
+        mFrames[lCount - 2] = mFrames[lCount - 1];
+        mFrames[lCount - 1] = lCF;
+    }
+
+    mCount = lCount;
+
+    return true;
+}
@@ -0,0 +1,52 @@
+
+// Author  KMS - Martin Dubois, P. Eng.
+// Client  ZAP
+// Product Tacking
+// File    ZT_Lib/CAN_Batch.h
+
+#pragma once
+
+// ===== Import/Includes ====================================================
+#include <EthCAN_Types.h>
+
+// ===== ZT_Lib =============================================================
+#include "DJI.h"
+
+// Constants
+/////////////////////////////////////////////////////////////////////////////
+
+#define CAN_BATCH_SIZE (32)
+
+// Class
+/////////////////////////////////////////////////////////////////////////////
+
+// The CAN fragments of one or more DJI frames, in the order they go on the
+// bus. The transport receives the whole batch in one call.
+class CAN_Batch
+{
+
+public:
+
+    CAN_Batch();
+
+    void Clear();
+
+    unsigned int        Count_Get () const;
+    const EthCAN_Frame * Frames_Get() const;
+
+    // aFrame  The sealed frame
+    // aId     The CAN id of the fragments. With DJI_CAN_ID_RX, the short
+    //         fragments at the end of the frame are in the order the
+    //         gimbal delivers them, see DJI_Reassembler.
+    //
+    // Return false when the batch does not have room for all the fragments,
+    // nothing is added in this case.
+    bool Frame_Add(const DJI_Frame & aFrame, uint32_t aId);
+
+private:
+
+    unsigned int mCount;
+
+    EthCAN_Frame mFrames[CAN_BATCH_SIZE];
+
+};
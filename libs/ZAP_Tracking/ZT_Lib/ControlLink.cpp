@@ -9,6 +9,7 @@
 #include "Component.h"
 
 // ===== C ==================================================================
+#include <pthread.h>
 #include <unistd.h>
 
 // ===== Includes ===========================================================
@@ -45,6 +46,7 @@ static const char * FUNCTION_NAMES[ControlLink::FUNCTION_QTY] =
     "GIMBAL_PREVIOUS_LOOP",
     "GIMBAL_SELECT",
     "HOME",
+    "HOME_ALL",
     "HOME_PITCH",
     "HOME_SET",
     "HOME_YAW",
@@ -81,7 +83,21 @@ static const char * FUNCTION_NAMES[ControlLink::FUNCTION_QTY] =
 #define CURRENT_GIMBAL                           \
     assert(mGimbals.size() > mGimbalIndex);      \
     GimbalInfo & lInfo = mGimbals[mGimbalIndex]; \
-    if (NULL == lInfo.mGimbal) { return; }
+    if ((NULL == lInfo.mGimbal) || (ZT::ZT_OK != lInfo.mResult)) { return; }
+
+// Data types
+// //////////////////////////////////////////////////////////////////////////
+
+// The argument of the activation threads
+typedef struct
+{
+    ZT::IGimbal * mGimbal;
+    ZT::Result    mResult;
+    bool          mStarted;
+    pthread_t     mThread;
+    unsigned int  mFirst; // The first entry using the same gimbal
+}
+Activation;
 
 // Static fonction declarations
 // //////////////////////////////////////////////////////////////////////////
@@ -94,6 +110,10 @@ static void Error(const char * aMsg);
 
 static void VerifyResult(ZT::Result aResult, unsigned int aLine);
 
+// ===== Entry point ========================================================
+
+static void * Run_Link(void * aContext);
+
 // Public
 // //////////////////////////////////////////////////////////////////////////
 
@@ -106,10 +126,12 @@ ControlLink::ControlLink()
     , mReceiver_Unknown   (0)
     , mRefCount(1)
     , mSpeedBoost(0.0)
+    , mSystem(NULL)
 {
     OnGimbalChanged();
 
-    Table_Init();
+    Table_Clear();
+    Table_Init ();
 }
 
 // ===== ZT::IControlLink ===================================================
@@ -149,6 +171,10 @@ ZT::Result ControlLink::Gamepad_Set(ZT::IGamepad * aGamepad)
 
 ZT::Result ControlLink::Gimbals_Set(ZT::ISystem * aSystem)
 {
+    assert(NULL != aSystem);
+
+    mSystem = aSystem;
+
     ZT::Result lResult = ZT::ZT_OK;
 
     if (0 < mGimbalIds.size())
@@ -166,6 +192,47 @@ ZT::Result ControlLink::Gimbals_Set(ZT::ISystem * aSystem)
     return lResult;
 }
 
+unsigned int ControlLink::Gimbal_Count_Get() const
+{
+    return static_cast<unsigned int>(mGimbals.size());
+}
+
+ZT::Result ControlLink::Gimbal_Result_Get(unsigned int aIndex) const
+{
+    if (mGimbals.size() <= aIndex)
+    {
+        return ZT::ZT_ERROR_GIMBAL;
+    }
+
+    return mGimbals[aIndex].mResult;
+}
+
+void ControlLink::Metrics_Display(void * aOut, bool aReset)
+{
+    FILE * lOut = (NULL == aOut) ? stdout : reinterpret_cast<FILE *>(aOut);
+
+    for (unsigned int i = 0; i < mGimbals.size(); i++)
+    {
+        ZT::IGimbal * lGimbal = mGimbals[i].mGimbal;
+        if ((NULL != lGimbal) && (ZT::ZT_OK != mGimbals[i].mResult))
+        {
+            fprintf(lOut, "===== Gimbal %u - Not activated =====\n", i);
+            ZT::Result_Display(mGimbals[i].mResult, lOut);
+        }
+        else if (NULL != lGimbal)
+        {
+            ZT::IGimbal::Metrics lMetrics;
+
+            ZT::Result lRet = lGimbal->Metrics_Get(&lMetrics, aReset);
+            if (ZT::ZT_OK == lRet)
+            {
+                fprintf(lOut, "===== Gimbal %u =====\n", i);
+                ZT::IGimbal::Display(lOut, lMetrics);
+            }
+        }
+    }
+}
+
 ZT::Result ControlLink::Receiver_Set(ZT::IMessageReceiver * aReceiver, unsigned int aConfigured, unsigned int aUnknown)
 {
     if (NULL == aReceiver)
@@ -191,20 +258,90 @@ ZT::Result ControlLink::Receiver_Set(ZT::IMessageReceiver * aReceiver, unsigned
     return ZT::ZT_OK;
 }
 
+// One thread per gimbal, the activation lasts as long as the slowest
+// gimbal. The rig goes live with the gimbals Activate brings up, the
+// functions ignore the other ones. Start fails only when no configured
+// gimbal activates. Many GIMBAL lines can give the same gimbal, it
+// activates once and all its entries get the result.
 ZT::Result ControlLink::Start()
 {
     assert(NULL != mGamepad);
 
-    ZT::Result lResult = ZT::ZT_OK;
+    std::vector<Activation> lActivations(mGimbals.size());
+    unsigned int            i;
 
-    for (GimbalList::iterator lIt = mGimbals.begin(); (ZT::ZT_OK == lResult) && (lIt != mGimbals.end()); lIt++)
+    for (i = 0; i < mGimbals.size(); i ++)
     {
-        if (NULL != lIt->mGimbal)
+        Activation & lA = lActivations[i];
+
+        lA.mGimbal  = mGimbals[i].mGimbal;
+        lA.mResult  = ZT::ZT_OK;
+        lA.mStarted = false;
+
+        for (lA.mFirst = 0; lA.mFirst < i; lA.mFirst ++)
         {
-            lResult = lIt->mGimbal->Activate();
+            if (lActivations[lA.mFirst].mGimbal == lA.mGimbal)
+            {
+                break;
+            }
+        }
+
+        if ((NULL != lA.mGimbal) && (i == lA.mFirst))
+        {
+            int lRet = pthread_create(&lA.mThread, NULL, Run_Link, &lA);
+            if (0 == lRet)
+            {
+                lA.mStarted = true;
+            }
+            else
+            {
+                // Without thread, this gimbal activates in sequence
+                lA.mResult = lA.mGimbal->Activate();
+            }
         }
     }
 
+    unsigned int lActivated = 0;
+    ZT::Result   lResult    = ZT::ZT_OK;
+
+    for (i = 0; i < mGimbals.size(); i ++)
+    {
+        Activation & lA = lActivations[i];
+
+        if (lA.mStarted)
+        {
+            int lRet = pthread_join(lA.mThread, NULL);
+            assert(0 == lRet);
+        }
+
+        // The first entry comes before, its thread is already joined.
+        lA.mResult = lActivations[lA.mFirst].mResult;
+
+        mGimbals[i].mResult = lA.mResult;
+
+        if (NULL != lA.mGimbal)
+        {
+            if (ZT::ZT_OK == lA.mResult)
+            {
+                lActivated ++;
+            }
+            else
+            {
+                fprintf(stderr, "ERROR  Gimbal %u - Activate failed - %s\n", i, ZT::Result_GetName(lA.mResult));
+
+                if (ZT::ZT_OK == lResult)
+                {
+                    lResult = lA.mResult;
+                }
+            }
+        }
+    }
+
+    if (0 < lActivated)
+    {
+        lResult = ZT::ZT_OK;
+    }
+
     if (ZT::ZT_OK == lResult)
     {
         lResult = mGamepad->Receiver_Start(this, MSG_GAMEPAD);
@@ -346,6 +483,7 @@ bool ControlLink::OnGamepadEvent(const ZT::IGamepad::Event & aEvent)
         {
         case FUNCTION_GIMBAL_SELECT: Function_Gimbal_Select(lEntry->mFactor); break;
         case FUNCTION_HOME         : Function_Home         (lEntry->mFactor); break;
+        case FUNCTION_HOME_ALL     : Function_Home_All     (lEntry->mFactor); break;
         case FUNCTION_HOME_PITCH   : Function_Home_Pitch   (lEntry->mFactor); break;
         case FUNCTION_HOME_YAW     : Function_Home_Yaw     (lEntry->mFactor); break;
 
@@ -438,7 +576,7 @@ ZT::Result ControlLink::ParseConfigLine(const char * aLine)
         }
         else if (0 == strncmp("CLEAR", aLine, 5))
         {
-            mTable.clear();
+            Table_Clear();
         }
         else if (1 == sscanf(aLine, "GIMBAL %[^\n\r\t]", lId))
         {
@@ -487,25 +625,11 @@ ZT::Result ControlLink::Table_AddEntry(ZT::IGamepad::Action aAction, ZT::IGamepa
         lResult = Value_Validate(aOffset, OFFSET_MIN, OFFSET_MAX);
         if (ZT::ZT_OK == lResult)
         {
-            TableEntry * lEntry = Table_FindEntry(aAction, aControl);
-            if (NULL == lEntry)
-            {
-                TableEntry lNewEntry;
-
-                lNewEntry.mAction = aAction;
-                lNewEntry.mControl = aControl;
-                lNewEntry.mFunction = aFunction;
-                lNewEntry.mOffset = aOffset;
-                lNewEntry.mFactor = aFactor;
+            TableEntry * lEntry = mTable[aAction] + aControl;
 
-                mTable.push_back(lNewEntry);
-            }
-            else
-            {
-                lEntry->mFunction = aFunction;
-                lEntry->mOffset = aOffset;
-                lEntry->mFactor = aFactor;
-            }
+            lEntry->mFactor   = aFactor;
+            lEntry->mFunction = aFunction;
+            lEntry->mOffset   = aOffset;
         }
     }
 
@@ -537,20 +661,29 @@ ZT::Result ControlLink::Table_AddEntry(const char * aAction, const char * aContr
     return lResult;
 }
 
-ControlLink::TableEntry * ControlLink::Table_FindEntry(ZT::IGamepad::Action aAction, ZT::IGamepad::Control aControl)
+void ControlLink::Table_Clear()
 {
-    assert(ZT::IGamepad::ACTION_QTY > aAction);
-    assert(ZT::IGamepad::CONTROL_QTY > aControl);
-
-    for (Table::iterator lIt = mTable.begin(); lIt != mTable.end(); lIt++)
+    for (unsigned int a = 0; a < ZT::IGamepad::ACTION_QTY; a++)
     {
-        if ((aAction == lIt->mAction) && (aControl == lIt->mControl))
+        for (unsigned int c = 0; c < ZT::IGamepad::CONTROL_QTY; c++)
         {
-            return &(*lIt);
+            mTable[a][c].mFactor   = 0.0;
+            mTable[a][c].mFunction = FUNCTION_QTY;
+            mTable[a][c].mOffset   = 0.0;
         }
     }
+}
 
-    return NULL;
+// The gamepad thread calls it for each event, the analog sticks included.
+// The lookup does not depend on the number of mapped entries.
+ControlLink::TableEntry * ControlLink::Table_FindEntry(ZT::IGamepad::Action aAction, ZT::IGamepad::Control aControl)
+{
+    assert(ZT::IGamepad::ACTION_QTY > aAction);
+    assert(ZT::IGamepad::CONTROL_QTY > aControl);
+
+    TableEntry * lResult = mTable[aAction] + aControl;
+
+    return (FUNCTION_QTY == lResult->mFunction) ? NULL : lResult;
 }
 
 void ControlLink::Table_Init()
@@ -582,14 +715,7 @@ void ControlLink::Table_RemoveEntry(ZT::IGamepad::Action aAction, ZT::IGamepad::
     assert(ZT::IGamepad::ACTION_QTY > aAction);
     assert(ZT::IGamepad::CONTROL_QTY > aControl);
 
-    for (Table::iterator lIt = mTable.begin(); lIt != mTable.end(); lIt++)
-    {
-        if ((aAction == lIt->mAction) && (aControl == lIt->mControl))
-        {
-            mTable.erase(lIt);
-            break;
-        }
-    }
+    mTable[aAction][aControl].mFunction = FUNCTION_QTY;
 }
 
 ZT::Result ControlLink::Table_RemoveEntry(const char * aAction, const char * aControl)
@@ -678,6 +804,46 @@ void ControlLink::Function_Home(double aFactor)
     assert(ZT::ZT_OK == lRet);
 }
 
+// The activated gimbals arrive home together, see
+// ZT::ISystem::Gimbals_Position_Set
+void ControlLink::Function_Home_All(double aFactor)
+{
+    unsigned int          lCount = 0;
+    ZT::IGimbal         * lGimbals  [ZT_GROUP_MAX];
+    ZT::IGimbal::Position lPositions[ZT_GROUP_MAX];
+
+    for (GimbalList::iterator lIt = mGimbals.begin(); (lIt != mGimbals.end()) && (ZT_GROUP_MAX > lCount); lIt ++)
+    {
+        if ((NULL != lIt->mGimbal) && (ZT::ZT_OK == lIt->mResult))
+        {
+            unsigned int i;
+
+            // Many entries can share a gimbal, it goes to its first home.
+            for (i = 0; (i < lCount) && (lGimbals[i] != lIt->mGimbal); i ++)
+            {
+            }
+
+            if (lCount == i)
+            {
+                lGimbals  [lCount] = lIt->mGimbal;
+                lPositions[lCount] = lIt->mHome;
+
+                lCount ++;
+            }
+        }
+    }
+
+    if (0 < lCount)
+    {
+        assert(NULL != mSystem);
+
+        unsigned int lDuration_ms = ComputeHomeDuration(aFactor);
+
+        ZT::Result lRet = mSystem->Gimbals_Position_Set(lGimbals, lPositions, lCount, 0, lDuration_ms);
+        VerifyResult(lRet, __LINE__);
+    }
+}
+
 void ControlLink::Function_Home_Pitch(double aFactor)
 {
     Function_Home_Axis(ZT::IGimbal::AXIS_PITCH, aFactor);
@@ -1072,3 +1238,18 @@ void VerifyResult(ZT::Result aResult, unsigned int aLine)
     default: fprintf(stderr, "ERROR  VerifyResult( %s, %u )\n", ZT::Result_GetName(aResult), aLine);
     }
 }
+
+// ===== Entry point ========================================================
+
+void * Run_Link(void * aContext)
+{
+    assert(NULL != aContext);
+
+    Activation * lA = reinterpret_cast<Activation *>(aContext);
+
+    assert(NULL != lA->mGimbal);
+
+    lA->mResult = lA->mGimbal->Activate();
+
+    return NULL;
+}
@@ -35,6 +35,11 @@ public:
 
     virtual ZT::Result Gimbals_Set(ZT::ISystem * aSystem);
 
+    virtual unsigned int Gimbal_Count_Get() const;
+    virtual ZT::Result   Gimbal_Result_Get(unsigned int aIndex) const;
+
+    virtual void Metrics_Display(void * aOut, bool aReset);
+
     virtual ZT::Result Receiver_Set(ZT::IMessageReceiver * aReceiver, unsigned int aConfigured, unsigned int aUnknown);
 
     virtual ZT::Result Start();
@@ -71,6 +76,7 @@ public:
         FUNCTION_GIMBAL_PREVIOUS_LOOP,
         FUNCTION_GIMBAL_SELECT,
         FUNCTION_HOME,
+        FUNCTION_HOME_ALL,
         FUNCTION_HOME_PITCH,
         FUNCTION_HOME_SET,
         FUNCTION_HOME_YAW,
@@ -98,24 +104,24 @@ private:
         unsigned int  mAtemPort;
         ZT::IGimbal * mGimbal;
         ZT::IGimbal::Position mHome;
+        ZT::Result    mResult; // Of Activate, the functions ignore a gimbal
+                               // it did not activate
     }
     GimbalInfo;
     
+    // The table has one entry per action and control, mFunction is
+    // FUNCTION_QTY when the entry is not mapped.
     typedef struct
     {
-        ZT::IGamepad::Action  mAction;
-        ZT::IGamepad::Control mControl;
-
-        Function mFunction;
-
         double mFactor;
         double mOffset;
+
+        Function mFunction;
     }
     TableEntry;
 
     typedef std::vector<GimbalInfo>    GimbalList;
     typedef std::list<std::string>     StringList;
-    typedef std::list<TableEntry>      Table;
 
     unsigned int ComputeHomeDuration(double aFactor);
     
@@ -129,6 +135,7 @@ private:
 
     ZT::Result   Table_AddEntry(ZT::IGamepad::Action aAction, ZT::IGamepad::Control aControl, Function aFunction, double aFactor = 0.0, double aOffset = 0.0);
     ZT::Result   Table_AddEntry(const char * aAction, const char * aControl, const char * aFunction, double aFactor = 0.0, double aOffset = 0.0);
+    void         Table_Clear();
     TableEntry * Table_FindEntry(ZT::IGamepad::Action aAction, ZT::IGamepad::Control aControl);
     void         Table_Init();
     void         Table_RemoveEntry(ZT::IGamepad::Action aAction, ZT::IGamepad::Control aControl);
@@ -144,6 +151,7 @@ private:
 
     void Function_Gimbal_Select(double aFactor);
     void Function_Home         (double aFactor);
+    void Function_Home_All     (double aFactor);
     void Function_Home_Pitch   (double aFactor);
     void Function_Home_Yaw     (double aFactor);
 
@@ -198,6 +206,9 @@ private:
 
     double mSpeedBoost;
 
-    Table mTable;
+    // Gimbals_Set gives it, Function_Home_All moves its gimbals together
+    ZT::ISystem * mSystem;
+
+    TableEntry mTable[ZT::IGamepad::ACTION_QTY][ZT::IGamepad::CONTROL_QTY];
 
 };
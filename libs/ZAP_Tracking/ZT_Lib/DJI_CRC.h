@@ -6,8 +6,49 @@
 
 #pragma once
 
+// Constants
+/////////////////////////////////////////////////////////////////////////////
+
+#define DJI_CRC_16_INIT (0x3aa3)
+#define DJI_CRC_32_INIT (0x3aa3)
+
+// Reflected polynomials
+#define DJI_CRC_16_POLY (0xa001)
+#define DJI_CRC_32_POLY (0xedb88320)
+
 // Functions
 /////////////////////////////////////////////////////////////////////////////
 
 extern uint16_t DJI_CRC_16(const uint8_t * aIn);
 extern uint32_t DJI_CRC_32(const uint8_t * aIn, unsigned int aSize_byte);
+
+// aCRC  DJI_CRC_*_INIT or the value of the previous bytes
+extern uint16_t DJI_CRC_16_Continue(uint16_t aCRC, const uint8_t * aIn, unsigned int aSize_byte);
+extern uint32_t DJI_CRC_32_Continue(uint32_t aCRC, const uint8_t * aIn, unsigned int aSize_byte);
+
+// One bit at a time, for the constant expressions. Use the functions above
+// at run time.
+
+constexpr uint16_t DJI_CRC_16_Byte(uint16_t aCRC, uint8_t aIn)
+{
+    uint16_t lResult = aCRC ^ aIn;
+
+    for (unsigned int b = 0; b < 8; b ++)
+    {
+        lResult = (lResult & 1) ? ((lResult >> 1) ^ DJI_CRC_16_POLY) : (lResult >> 1);
+    }
+
+    return lResult;
+}
+
+constexpr uint32_t DJI_CRC_32_Byte(uint32_t aCRC, uint8_t aIn)
+{
+    uint32_t lResult = aCRC ^ aIn;
+
+    for (unsigned int b = 0; b < 8; b ++)
+    {
+        lResult = (lResult & 1) ? ((lResult >> 1) ^ DJI_CRC_32_POLY) : (lResult >> 1);
+    }
+
+    return lResult;
+}
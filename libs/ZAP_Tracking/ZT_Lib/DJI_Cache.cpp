@@ -0,0 +1,206 @@
+
+// Author  KMS - Martin Dubois, P. Eng.
+// Client  ZAP
+// Product Tacking
+// File    ZT_Lib/DJI_Cache.cpp
+
+#include "Component.h"
+
+// ===== C ==================================================================
+#include <fcntl.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// ===== ZT_Lib =============================================================
+#include "DJI_CRC.h"
+#include "Gimbal.h"
+
+#include "DJI_Cache.h"
+
+// Static function declarations
+/////////////////////////////////////////////////////////////////////////////
+
+static uint32_t CRC_Get(const DJI_Cache_File & aIn);
+
+// Public
+/////////////////////////////////////////////////////////////////////////////
+
+ZT::Result DJI_Cache::Folder_Validate(const char * aFolder)
+{
+    if (NULL == aFolder)
+    {
+        return ZT::ZT_OK;
+    }
+
+    // FileName_Get adds at most 32 characters
+    if ((PATH_MAX - 32) <= strlen(aFolder))
+    {
+        return ZT::ZT_ERROR_MAX;
+    }
+
+    struct stat lStat;
+
+    if ((0 != stat(aFolder, &lStat)) || (!S_ISDIR(lStat.st_mode)))
+    {
+        return ZT::ZT_ERROR_FILE_OPEN;
+    }
+
+    if ((getuid() != lStat.st_uid) || (0 != (lStat.st_mode & (S_IWGRP | S_IWOTH))))
+    {
+        return ZT::ZT_ERROR_CONFIG;
+    }
+
+    return ZT::ZT_OK;
+}
+
+DJI_Cache::DJI_Cache()
+{
+    mFolder[0] = '\0';
+}
+
+void DJI_Cache::Folder_Set(const char * aFolder)
+{
+    if (NULL == aFolder)
+    {
+        mFolder[0] = '\0';
+    }
+    else
+    {
+        assert(sizeof(mFolder) > strlen(aFolder));
+
+        strncpy(mFolder, aFolder, sizeof(mFolder) - 1);
+        mFolder[sizeof(mFolder) - 1] = '\0';
+    }
+}
+
+bool DJI_Cache::IsEnabled() const
+{
+    return '\0' != mFolder[0];
+}
+
+ZT::Result DJI_Cache::Load(ZT::IGimbal::Info * aInfo, ZT::IGimbal::Config * aConfig) const
+{
+    assert(NULL != aInfo);
+    assert(NULL != aConfig);
+
+    assert(IsEnabled());
+
+    char lFileName[PATH_MAX];
+
+    FileName_Get(lFileName, sizeof(lFileName), aInfo->mIPv4_Address);
+
+    int lFile = open(lFileName, O_RDONLY);
+    if (0 > lFile)
+    {
+        return ZT::ZT_ERROR_FILE_OPEN;
+    }
+
+    DJI_Cache_File lIn;
+
+    ssize_t lSize_byte = read(lFile, &lIn, sizeof(lIn));
+
+    int lRet = close(lFile);
+    assert(0 == lRet);
+
+    if (   (sizeof(lIn) != lSize_byte)
+        || (DJI_CACHE_MAGIC   != lIn.mMagic)
+        || (DJI_CACHE_VERSION != lIn.mVersion)
+        || (CRC_Get(lIn) != lIn.mCRC32))
+    {
+        return ZT::ZT_ERROR_CONFIG;
+    }
+
+    // An other device now uses the address
+    if ((aInfo->mIPv4_Address != lIn.mIPv4_Address) || (0 != memcmp(aInfo->mName, lIn.mName, sizeof(lIn.mName))))
+    {
+        return ZT::ZT_ERROR_GIMBAL;
+    }
+
+    memcpy(aInfo->mVersion, lIn.mGimbal_Version, sizeof(aInfo->mVersion));
+
+    FOR_EACH_AXIS(a)
+    {
+        aConfig->mAxis[a].mMax_deg      = lIn.mAxis[a].mMax_deg;
+        aConfig->mAxis[a].mMin_deg      = lIn.mAxis[a].mMin_deg;
+        aConfig->mAxis[a].mStiffness_pc = lIn.mAxis[a].mStiffness_pc;
+    }
+
+    return ZT::ZT_OK;
+}
+
+ZT::Result DJI_Cache::Save(const ZT::IGimbal::Info & aInfo, const ZT::IGimbal::Config & aConfig) const
+{
+    assert(IsEnabled());
+
+    DJI_Cache_File lOut;
+
+    memset(&lOut, 0, sizeof(lOut));
+
+    lOut.mMagic        = DJI_CACHE_MAGIC;
+    lOut.mVersion      = DJI_CACHE_VERSION;
+    lOut.mIPv4_Address = aInfo.mIPv4_Address;
+
+    memcpy(lOut.mName          , aInfo.mName   , sizeof(lOut.mName));
+    memcpy(lOut.mGimbal_Version, aInfo.mVersion, sizeof(lOut.mGimbal_Version));
+
+    FOR_EACH_AXIS(a)
+    {
+        lOut.mAxis[a].mMax_deg      = aConfig.mAxis[a].mMax_deg;
+        lOut.mAxis[a].mMin_deg      = aConfig.mAxis[a].mMin_deg;
+        lOut.mAxis[a].mStiffness_pc = aConfig.mAxis[a].mStiffness_pc;
+    }
+
+    lOut.mCRC32 = CRC_Get(lOut);
+
+    char lFileName[PATH_MAX];
+    char lTemp    [PATH_MAX];
+
+    FileName_Get(lFileName, sizeof(lFileName), aInfo.mIPv4_Address);
+
+    // mkstemp never opens an existing file, nor follows a link
+    int lRet = snprintf(lTemp, sizeof(lTemp), "%s/ZT_Cache_XXXXXX", mFolder);
+    assert(0 < lRet);
+    assert(sizeof(lTemp) > static_cast<unsigned int>(lRet));
+
+    int lFile = mkstemp(lTemp);
+    if (0 > lFile)
+    {
+        return ZT::ZT_ERROR_FILE_OPEN;
+    }
+
+    ssize_t lSize_byte = write(lFile, &lOut, sizeof(lOut));
+
+    lRet = close(lFile);
+
+    if ((sizeof(lOut) != lSize_byte) || (0 != lRet) || (0 != rename(lTemp, lFileName)))
+    {
+        unlink(lTemp);
+        return ZT::ZT_ERROR_FILE_OPEN;
+    }
+
+    return ZT::ZT_OK;
+}
+
+// Private
+/////////////////////////////////////////////////////////////////////////////
+
+void DJI_Cache::FileName_Get(char * aOut, unsigned int aOutSize_byte, uint32_t aIPv4_Address) const
+{
+    assert(NULL != aOut);
+
+    const uint8_t * lA = reinterpret_cast<const uint8_t *>(&aIPv4_Address);
+
+    int lRet = snprintf(aOut, aOutSize_byte, "%s/ZT_Cache_%u.%u.%u.%u.bin", mFolder, lA[0], lA[1], lA[2], lA[3]);
+    assert(0 < lRet);
+    assert(aOutSize_byte > static_cast<unsigned int>(lRet));
+}
+
+// Static functions
+/////////////////////////////////////////////////////////////////////////////
+
+uint32_t CRC_Get(const DJI_Cache_File & aIn)
+{
+    return DJI_CRC_32_Continue(DJI_CRC_32_INIT, reinterpret_cast<const uint8_t *>(&aIn), offsetof(DJI_Cache_File, mCRC32));
+}
@@ -0,0 +1,90 @@
+
+// Author  KMS - Martin Dubois, P. Eng.
+// Client  ZAP
+// Product Tacking
+// File    ZT_Lib/DJI_Cache.h
+
+#pragma once
+
+// ===== C ==================================================================
+#include <limits.h>
+
+// ===== Includes ===========================================================
+#include <ZT/IGimbal.h>
+
+// Constants
+/////////////////////////////////////////////////////////////////////////////
+
+#define DJI_CACHE_MAGIC   (0x4344545a) // "ZTDC" in little endian
+#define DJI_CACHE_VERSION (1)
+
+// Data types
+/////////////////////////////////////////////////////////////////////////////
+
+// The cache file of a gimbal. The address and the name of the EthCAN device
+// identify the gimbal, the version of the gimbal and what it reports about
+// its axes follow. The values are in the byte order of the host.
+typedef struct
+{
+    uint32_t mMagic;
+    uint32_t mVersion;
+
+    char     mName[16];
+    uint32_t mIPv4_Address;
+
+    uint8_t mGimbal_Version[4];
+
+    struct
+    {
+        double mMax_deg;
+        double mMin_deg;
+        double mStiffness_pc;
+    }
+    mAxis[ZT::IGimbal::AXIS_QTY];
+
+    uint32_t mCRC32; // DJI_CRC_32 of the previous fields
+}
+DJI_Cache_File;
+
+// Class
+/////////////////////////////////////////////////////////////////////////////
+
+// One file per EthCAN device. Save writes a temporary file with a unique
+// name in the same folder and renames it, a reader never sees a partial
+// file.
+class DJI_Cache
+{
+
+public:
+
+    // aFolder  See ZT::ISystem::Cache_Set
+    //
+    // Return  ZT_OK
+    //         ZT_ERROR_CONFIG     Others can write into the folder
+    //         ZT_ERROR_FILE_OPEN
+    //         ZT_ERROR_MAX        The name is too long
+    static ZT::Result Folder_Validate(const char * aFolder);
+
+    DJI_Cache();
+
+    // aFolder  NULL disables the cache
+    void Folder_Set(const char * aFolder);
+
+    bool IsEnabled() const;
+
+    // aInfo   [---;RW-] The address and the name are the key, Load sets
+    //                   the version
+    // aConfig [---;RW-] Load sets the limits and the stiffness
+    //
+    // Load does not change the outputs when it fails.
+    ZT::Result Load(ZT::IGimbal::Info * aInfo, ZT::IGimbal::Config * aConfig) const;
+
+    ZT::Result Save(const ZT::IGimbal::Info & aInfo, const ZT::IGimbal::Config & aConfig) const;
+
+private:
+
+    void FileName_Get(char * aOut, unsigned int aOutSize_byte, uint32_t aIPv4_Address) const;
+
+    char mFolder[PATH_MAX];
+
+};
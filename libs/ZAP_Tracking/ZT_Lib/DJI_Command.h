@@ -0,0 +1,169 @@
+
+// Author  KMS - Martin Dubois, P. Eng.
+// Client  ZAP
+// Product Tacking
+// File    ZT_Lib/DJI_Command.h
+
+#pragma once
+
+// ===== C ==================================================================
+#include <stddef.h>
+
+// ===== ZT_Lib =============================================================
+#include "DJI.h"
+#include "DJI_CRC.h"
+
+// Constants
+/////////////////////////////////////////////////////////////////////////////
+
+// The header bytes before the serial, they only depend on the size and the
+// type of the command.
+#define DJI_COMMAND_CONSTANT_byte (8)
+
+// Functions
+/////////////////////////////////////////////////////////////////////////////
+
+constexpr uint16_t DJI_Command_CRC_16(uint8_t aSize_byte, uint8_t aCmdType)
+{
+    const uint8_t lHeader[DJI_COMMAND_CONSTANT_byte] = { DJI_SOF, aSize_byte, 0, aCmdType, 0, 0, 0, 0 };
+
+    uint16_t lResult = DJI_CRC_16_INIT;
+
+    for (unsigned int i = 0; i < DJI_COMMAND_CONSTANT_byte; i ++)
+    {
+        lResult = DJI_CRC_16_Byte(lResult, lHeader[i]);
+    }
+
+    return lResult;
+}
+
+constexpr uint32_t DJI_Command_CRC_32(uint8_t aSize_byte, uint8_t aCmdType)
+{
+    const uint8_t lHeader[DJI_COMMAND_CONSTANT_byte] = { DJI_SOF, aSize_byte, 0, aCmdType, 0, 0, 0, 0 };
+
+    uint32_t lResult = DJI_CRC_32_INIT;
+
+    for (unsigned int i = 0; i < DJI_COMMAND_CONSTANT_byte; i ++)
+    {
+        lResult = DJI_CRC_32_Byte(lResult, lHeader[i]);
+    }
+
+    return lResult;
+}
+
+// Class
+/////////////////////////////////////////////////////////////////////////////
+
+// One type per command, see the typedef below. The compiler knows the size
+// of the frame and computes the CRCs of the constant header bytes. The
+// setters take the offset as template argument, so the compiler rejects a
+// field outside the data of the command or over the command set and id.
+//
+// Init, the setters, then Seal. The frame is ready to send, the generic
+// DJI_Frame::Init and DJI_Frame::Seal produce the same bytes.
+template <uint8_t DATA_SIZE_byte, uint8_t CMD_TYPE, uint8_t CMD_SET, uint8_t CMD_ID>
+class DJI_Command
+{
+
+public:
+
+    static_assert((DJI_CMD_SET_THIRD_PARTY == CMD_SET) || (DJI_CMD_SET_DEFAULT == CMD_SET), "Invalid command set");
+    static_assert(DJI_DATA_CMD_ID < DATA_SIZE_byte, "The data does not hold the command id");
+    static_assert(sizeof(DJI_Frame::mData) >= DATA_SIZE_byte + DJI_FOOTER_SIZE_byte, "The data and the footer do not fit in DJI_Frame");
+    static_assert(DJI_COMMAND_CONSTANT_byte == offsetof(DJI_Frame, mSerial), "The serial does not follow the constant bytes");
+
+    static constexpr uint8_t SIZE_byte = DJI_FRAME_TOTAL_SIZE(DATA_SIZE_byte);
+
+    static constexpr uint16_t CRC_16 = DJI_Command_CRC_16(SIZE_byte, CMD_TYPE);
+    static constexpr uint32_t CRC_32 = DJI_Command_CRC_32(SIZE_byte, CMD_TYPE);
+
+    // aOut [---;-W-]
+    static void Init(DJI_Frame * aOut, uint16_t aSerial)
+    {
+        assert(NULL != aOut);
+
+        memset(aOut, 0, SIZE_byte);
+
+        aOut->mSOF       = DJI_SOF;
+        aOut->mSize_byte = SIZE_byte;
+        aOut->mCmdType   = CMD_TYPE;
+        aOut->mSerial    = aSerial;
+
+        aOut->mData[DJI_DATA_CMD_SET] = CMD_SET;
+        aOut->mData[DJI_DATA_CMD_ID ] = CMD_ID;
+
+        aOut->mCRC16 = DJI_CRC_16_Continue(CRC_16, reinterpret_cast<const uint8_t *>(&aOut->mSerial), sizeof(aOut->mSerial));
+    }
+
+    // aOut [---;RW-]
+    static void Seal(DJI_Frame * aOut)
+    {
+        assert(NULL != aOut);
+
+        uint8_t * lFrame = &aOut->mSOF;
+
+        uint32_t lCRC_32 = DJI_CRC_32_Continue(CRC_32, lFrame + DJI_COMMAND_CONSTANT_byte, SIZE_byte - DJI_COMMAND_CONSTANT_byte - DJI_FOOTER_SIZE_byte);
+
+        memcpy(lFrame + SIZE_byte - DJI_FOOTER_SIZE_byte, &lCRC_32, sizeof(lCRC_32));
+    }
+
+    // ===== Setters ========================================================
+    // aOut [---;RW-]
+
+    template <unsigned int OFFSET>
+    static void Byte_Set(DJI_Frame * aOut, uint8_t aIn)
+    {
+        static_assert(DJI_DATA_CMD_ID < OFFSET, "The field overwrites the command set or id");
+        static_assert(DATA_SIZE_byte > OFFSET, "The field is outside the data");
+
+        assert(NULL != aOut);
+
+        aOut->mData[OFFSET] = aIn;
+    }
+
+    // Little endian
+    template <unsigned int OFFSET>
+    static void Int16_Set(DJI_Frame * aOut, int16_t aIn)
+    {
+        static_assert(DJI_DATA_CMD_ID < OFFSET, "The field overwrites the command set or id");
+        static_assert(DATA_SIZE_byte >= OFFSET + sizeof(int16_t), "The field is outside the data");
+
+        assert(NULL != aOut);
+
+        aOut->mData[OFFSET    ] = aIn & 0xff;
+        aOut->mData[OFFSET + 1] = aIn >> 8;
+    }
+
+    // 0.1 degree, as DJI_Frame::Angle_Set
+    template <unsigned int OFFSET>
+    static void Angle_Set(DJI_Frame * aOut, double aAngle_deg)
+    {
+        Int16_Set<OFFSET>(aOut, aAngle_deg * 10.0);
+    }
+
+    // 0.1 degree/s, as DJI_Frame::Speed_Set
+    template <unsigned int OFFSET>
+    static void Speed_Set(DJI_Frame * aOut, double aSpeed_deg_s)
+    {
+        Int16_Set<OFFSET>(aOut, aSpeed_deg_s * 10.0);
+    }
+
+};
+
+// Data types
+/////////////////////////////////////////////////////////////////////////////
+
+// The data size includes the command set and the command id
+
+typedef DJI_Command< 3, DJI_CMD_TYPE_DO_REPLY, DJI_CMD_SET_DEFAULT, DJI_CMD_ANGLE_GET          > DJI_Command_ANGLE_GET;
+typedef DJI_Command< 3, DJI_CMD_TYPE_DO_REPLY, DJI_CMD_SET_DEFAULT, DJI_CMD_ANGLE_LIMIT_GET    > DJI_Command_ANGLE_LIMIT_GET;
+typedef DJI_Command< 9, DJI_CMD_TYPE_DO_REPLY, DJI_CMD_SET_DEFAULT, DJI_CMD_ANGLE_LIMIT_SET    > DJI_Command_ANGLE_LIMIT_SET;
+typedef DJI_Command< 5, DJI_CMD_TYPE_NO_REPLY, DJI_CMD_SET_DEFAULT, DJI_CMD_FOCUS              > DJI_Command_FOCUS_CAL;
+typedef DJI_Command< 7, DJI_CMD_TYPE_NO_REPLY, DJI_CMD_SET_DEFAULT, DJI_CMD_FOCUS              > DJI_Command_FOCUS_SET;
+typedef DJI_Command< 3, DJI_CMD_TYPE_DO_REPLY, DJI_CMD_SET_DEFAULT, DJI_CMD_MOTOR_STIFFNESS_GET> DJI_Command_MOTOR_STIFFNESS_GET;
+typedef DJI_Command< 6, DJI_CMD_TYPE_DO_REPLY, DJI_CMD_SET_DEFAULT, DJI_CMD_MOTOR_STIFFNESS_SET> DJI_Command_MOTOR_STIFFNESS_SET;
+typedef DJI_Command<10, DJI_CMD_TYPE_NO_REPLY, DJI_CMD_SET_DEFAULT, DJI_CMD_POSITION_SET       > DJI_Command_POSITION_SET;
+typedef DJI_Command< 9, DJI_CMD_TYPE_NO_REPLY, DJI_CMD_SET_DEFAULT, DJI_CMD_SPEED_SET          > DJI_Command_SPEED_SET;
+typedef DJI_Command< 5, DJI_CMD_TYPE_DO_REPLY, DJI_CMD_SET_DEFAULT, DJI_CMD_TLV_SET            > DJI_Command_TLV_SET;
+typedef DJI_Command< 3, DJI_CMD_TYPE_NO_REPLY, DJI_CMD_SET_DEFAULT, DJI_CMD_TRACK_SWITCH       > DJI_Command_TRACK_SWITCH;
+typedef DJI_Command< 6, DJI_CMD_TYPE_DO_REPLY, DJI_CMD_SET_DEFAULT, DJI_CMD_VERSION            > DJI_Command_VERSION;
@@ -0,0 +1,274 @@
+
+// Author  KMS - Martin Dubois, P. Eng.
+// Client  ZAP
+// Product Tacking
+// File    ZT_Lib/DJI_Connector.cpp
+
+#include "Component.h"
+
+// ===== C ==================================================================
+#include <errno.h>
+#include <time.h>
+
+// ===== ZT_Lib =============================================================
+#include "DJI_Gimbal.h"
+
+#include "DJI_Connector.h"
+
+// Constants
+/////////////////////////////////////////////////////////////////////////////
+
+// See Thread.cpp
+#ifdef __APPLE__
+    #define CONNECTOR_CLOCK CLOCK_REALTIME
+#else
+    #define CONNECTOR_CLOCK CLOCK_MONOTONIC
+#endif
+
+// Static function declarations
+/////////////////////////////////////////////////////////////////////////////
+
+static uint64_t Time_Get_ns();
+
+// ===== Entry point ========================================================
+
+static void * Run_Link(void * aContext);
+
+// Public
+/////////////////////////////////////////////////////////////////////////////
+
+DJI_Connector::DJI_Connector(unsigned int aTimeout_ms) : mDone(false), mPending(0), mRefCount(1), mTimeout_ms(aTimeout_ms)
+{
+    pthread_condattr_t lAttr;
+
+    int lRet = pthread_condattr_init(&lAttr);
+    assert(0 == lRet);
+
+    #ifndef __APPLE__
+        lRet = pthread_condattr_setclock(&lAttr, CONNECTOR_CLOCK);
+        assert(0 == lRet);
+    #endif
+
+    lRet = pthread_cond_init(&mCond, &lAttr);
+    assert(0 == lRet);
+
+    lRet = pthread_condattr_destroy(&lAttr);
+    assert(0 == lRet);
+
+    lRet = pthread_mutex_init(&mZone0, NULL);
+    assert(0 == lRet);
+}
+
+void DJI_Connector::Add(DJI_Gimbal * aGimbal)
+{
+    assert(NULL != aGimbal);
+
+    assert(!mDone);
+    assert(0 == mPending);
+
+    Connection lC;
+
+    lC.mGimbal           = aGimbal;
+    lC.mLink.mConnector  = this;
+    lC.mLink.mIndex      = mConnections.size();
+    lC.mResult           = ZT::ZT_RESULT_INVALID;
+
+    mConnections.push_back(lC);
+}
+
+// The threads start with Zone0 held, they only use it once their Connect
+// returns. mConnections does not change once they run.
+//
+// Thread  Users
+unsigned int DJI_Connector::Run(IDetector::GimbalList * aList)
+{
+    assert(NULL != aList);
+
+    unsigned int lResult = 0;
+
+    uint64_t lDeadline_ns = Time_Get_ns() + mTimeout_ms * 1000000ULL;
+
+    int lRet = pthread_mutex_lock(&mZone0);
+    assert(0 == lRet);
+    {
+        assert(!mDone);
+
+        for (ConnectionList::iterator lIt = mConnections.begin(); lIt != mConnections.end(); lIt ++)
+        {
+            pthread_t lThread;
+
+            lRet = pthread_create(&lThread, NULL, Run_Link, &lIt->mLink);
+            if (0 == lRet)
+            {
+                lRet = pthread_detach(lThread);
+                assert(0 == lRet);
+
+                mPending  ++;
+                mRefCount ++;
+            }
+            else
+            {
+                lIt->mResult = ZT::ZT_ERROR_THREAD;
+            }
+        }
+
+        while ((0 < mPending) && (Time_Get_ns() < lDeadline_ns))
+        {
+            timespec lDeadline;
+
+            lDeadline.tv_sec  = lDeadline_ns / 1000000000;
+            lDeadline.tv_nsec = lDeadline_ns % 1000000000;
+
+            lRet = pthread_cond_timedwait(&mCond, &mZone0, &lDeadline);
+            assert((0 == lRet) || (ETIMEDOUT == lRet));
+        }
+
+        // From here, the threads still connecting own their gimbal.
+        mDone = true;
+
+        for (ConnectionList::iterator lIt = mConnections.begin(); lIt != mConnections.end(); lIt ++)
+        {
+            switch (lIt->mResult)
+            {
+            case ZT::ZT_RESULT_INVALID:
+                TRACE_WARNING(stderr, "DJI_Connector::Run - Timeout");
+                break;
+
+            case ZT::ZT_OK:
+                aList->push_back(lIt->mGimbal);
+                lResult ++;
+                break;
+
+            default:
+                TRACE_WARNING(stderr, "DJI_Connector::Run - Connect failed");
+                Result_Display(lIt->mResult, stderr);
+                lIt->mGimbal->Debug(stderr);
+                delete lIt->mGimbal;
+            }
+        }
+    }
+    lRet = pthread_mutex_unlock(&mZone0);
+    assert(0 == lRet);
+
+    return lResult;
+}
+
+void DJI_Connector::Release()
+{
+    int lRet = pthread_mutex_lock(&mZone0);
+    assert(0 == lRet);
+
+    bool lDelete = Release_Z0();
+
+    lRet = pthread_mutex_unlock(&mZone0);
+    assert(0 == lRet);
+
+    if (lDelete)
+    {
+        delete this;
+    }
+}
+
+// Internal
+/////////////////////////////////////////////////////////////////////////////
+
+// Thread  Connector
+void DJI_Connector::Connect(unsigned int aIndex)
+{
+    assert(mConnections.size() > aIndex);
+
+    Connection & lC      = mConnections[aIndex];
+    DJI_Gimbal * lGimbal = lC.mGimbal; // The last Release can come before the end
+
+    ZT::Result lResult = lGimbal->Connect();
+
+    bool lAbandoned;
+    bool lDelete;
+
+    int lRet = pthread_mutex_lock(&mZone0);
+    assert(0 == lRet);
+    {
+        assert(0 < mPending);
+
+        lAbandoned = mDone;
+
+        lC.mResult = lResult;
+
+        mPending --;
+
+        lRet = pthread_cond_signal(&mCond);
+        assert(0 == lRet);
+
+        lDelete = Release_Z0();
+    }
+    lRet = pthread_mutex_unlock(&mZone0);
+    assert(0 == lRet);
+
+    if (lAbandoned)
+    {
+        delete lGimbal;
+    }
+
+    if (lDelete)
+    {
+        delete this;
+    }
+}
+
+// Private
+/////////////////////////////////////////////////////////////////////////////
+
+DJI_Connector::~DJI_Connector()
+{
+    assert(0 == mPending);
+    assert(0 == mRefCount);
+
+    // Without Run, the gimbals are still there
+    if (!mDone)
+    {
+        for (ConnectionList::iterator lIt = mConnections.begin(); lIt != mConnections.end(); lIt ++)
+        {
+            delete lIt->mGimbal;
+        }
+    }
+
+    int lRet = pthread_cond_destroy(&mCond);
+    assert(0 == lRet);
+
+    lRet = pthread_mutex_destroy(&mZone0);
+    assert(0 == lRet);
+}
+
+bool DJI_Connector::Release_Z0()
+{
+    assert(0 < mRefCount);
+
+    mRefCount --;
+
+    return 0 == mRefCount;
+}
+
+// Static functions
+/////////////////////////////////////////////////////////////////////////////
+
+uint64_t Time_Get_ns()
+{
+    timespec lNow;
+
+    clock_gettime(CONNECTOR_CLOCK, &lNow);
+
+    return static_cast<uint64_t>(lNow.tv_sec) * 1000000000 + lNow.tv_nsec;
+}
+
+// ===== Entry point ========================================================
+
+void * Run_Link(void * aContext)
+{
+    assert(NULL != aContext);
+
+    DJI_Connector::Link * lLink = reinterpret_cast<DJI_Connector::Link *>(aContext);
+
+    lLink->mConnector->Connect(lLink->mIndex);
+
+    return NULL;
+}
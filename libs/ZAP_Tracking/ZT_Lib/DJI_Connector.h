@@ -0,0 +1,102 @@
+
+// Author  KMS - Martin Dubois, P. Eng.
+// Client  ZAP
+// Product Tacking
+// File    ZT_Lib/DJI_Connector.h
+
+#pragma once
+
+// ===== C++ ================================================================
+#include <vector>
+
+// ===== C ==================================================================
+#include <pthread.h>
+
+// ===== ZT_Lib =============================================================
+#include "IDetector.h"
+
+class DJI_Gimbal;
+
+// Constants
+/////////////////////////////////////////////////////////////////////////////
+
+#define DJI_CONNECTOR_TIMEOUT_ms (5000)
+
+// Class
+/////////////////////////////////////////////////////////////////////////////
+
+// Connect DJI_Gimbal in parallel, one thread per gimbal. The detection lasts
+// as long as the slowest gimbal, at most the timeout, instead of the sum of
+// the Connect of all the gimbals.
+//
+// A Connect the timeout abandons keeps running, the EthCAN calls cannot be
+// interrupted. Its thread deletes the gimbal when the call returns, this is
+// why the connector counts its references.
+class DJI_Connector
+{
+
+public:
+
+    // aTimeout_ms  The time each gimbal has to connect
+    DJI_Connector(unsigned int aTimeout_ms = DJI_CONNECTOR_TIMEOUT_ms);
+
+    // aGimbal [D--;RW-] The connector deletes the gimbals it does not add
+    //                   to the list
+    //
+    // Call Add before Run.
+    void Add(DJI_Gimbal * aGimbal);
+
+    // aList [---;RW-] The connected gimbals go at the end of the list, in
+    //                 the order of the Add calls
+    //
+    // Return the number of connected gimbals
+    unsigned int Run(IDetector::GimbalList * aList);
+
+    void Release();
+
+    // Internal
+
+    // The argument of the threads
+    typedef struct
+    {
+        DJI_Connector * mConnector;
+        unsigned int    mIndex;
+    }
+    Link;
+
+    void Connect(unsigned int aIndex);
+
+private:
+
+    // mResult  ZT_RESULT_INVALID while Connect runs
+    typedef struct
+    {
+        DJI_Gimbal * mGimbal;
+        Link         mLink;
+        ZT::Result   mResult;
+    }
+    Connection;
+
+    typedef std::vector<Connection> ConnectionList;
+
+    ~DJI_Connector();
+
+    DJI_Connector(const DJI_Connector &);
+
+    const DJI_Connector & operator = (const DJI_Connector &);
+
+    // Return true when the reference count reaches 0
+    bool Release_Z0();
+
+    // ===== Zone0 ==========================================================
+    bool           mDone;
+    ConnectionList mConnections;
+    unsigned int   mPending;
+    unsigned int   mRefCount;
+
+    unsigned int mTimeout_ms;
+
+    pthread_cond_t  mCond;
+    pthread_mutex_t mZone0;
+
+};
@@ -7,6 +7,7 @@
 #include "Component.h"
 
 // ===== ZT_Lib =============================================================
+#include "DJI_Connector.h"
 #include "DJI_Gimbal.h"
 
 #include "DJI_Detector.h"
@@ -19,6 +20,8 @@ DJI_Detector::DJI_Detector() : mSystem(EthCAN::System::Create())
     assert(NULL != mSystem);
 
     mSystem->SetTraceStream(stdout);
+
+    mCache_Folder[0] = '\0';
 }
 
 DJI_Detector::~DJI_Detector()
@@ -28,6 +31,25 @@ DJI_Detector::~DJI_Detector()
     mSystem->Release();
 }
 
+ZT::Result DJI_Detector::Cache_Set(const char * aFolder)
+{
+    ZT::Result lResult = DJI_Cache::Folder_Validate(aFolder);
+    if (ZT::ZT_OK == lResult)
+    {
+        if (NULL == aFolder)
+        {
+            mCache_Folder[0] = '\0';
+        }
+        else
+        {
+            strncpy(mCache_Folder, aFolder, sizeof(mCache_Folder) - 1);
+            mCache_Folder[sizeof(mCache_Folder) - 1] = '\0';
+        }
+    }
+
+    return lResult;
+}
+
 // ===== IDetector ==========================================================
 
 void DJI_Detector::Gamepads_Detect(GamepadList *)
@@ -43,23 +65,20 @@ void DJI_Detector::Gimbals_Detect(GimbalList *aList)
     EthCAN_Result lRet = mSystem->Detect();
     assert(EthCAN_OK == lRet);
 
+    DJI_Connector * lConnector = new DJI_Connector();
+    assert(NULL != lConnector);
+
     unsigned int lCount = mSystem->Device_GetCount();
     for (unsigned int i = 0; i < lCount; i ++)
     {
         DJI_Gimbal * lGimbal = new DJI_Gimbal(mSystem->Device_Get(i));
         assert(NULL != lGimbal);
 
-        ZT::Result lResult = lGimbal->Connect();
-        if (ZT::ZT_OK == lResult)
-        {
-            aList->push_back(lGimbal);
-        }
-        else
-        {
-            TRACE_WARNING(stderr, "DJI_Detector::Detect - Not a DJI gimbal");
-            Result_Display(lResult, stderr);
-            lGimbal->Debug(stderr);
-            delete lGimbal;
-        }
+        lGimbal->Cache_Set(('\0' == mCache_Folder[0]) ? NULL : mCache_Folder);
+
+        lConnector->Add(lGimbal);
     }
+
+    lConnector->Run(aList);
+    lConnector->Release();
 }
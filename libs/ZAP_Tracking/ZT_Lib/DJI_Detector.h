@@ -6,6 +6,9 @@
 
 #pragma once
 
+// ===== C ==================================================================
+#include <limits.h>
+
 // ===== Import/Includes ====================================================
 #include <EthCAN/System.h>
 
@@ -24,6 +27,9 @@ public:
 
     virtual ~DJI_Detector();
 
+    // See ZT::ISystem::Cache_Set
+    ZT::Result Cache_Set(const char * aFolder);
+
     // ===== IDetector ======================================================
     virtual void Gamepads_Detect(GamepadList *aList);
     virtual void Gimbals_Detect (GimbalList  *aList);
@@ -32,4 +38,6 @@ private:
 
     EthCAN::System * mSystem;
 
+    char mCache_Folder[PATH_MAX]; // Empty when the cache is disabled
+
 };
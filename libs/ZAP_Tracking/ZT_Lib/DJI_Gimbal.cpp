@@ -10,9 +10,6 @@
 
 #include "Component.h"
 
-// ===== C ==================================================================
-#include <unistd.h>
-
 // ===== Import/Includes ====================================================
 #include <EthCAN/Display.h>
 
@@ -35,9 +32,63 @@
 #define MSG_REPEAT              (8)
 #define MSG_SIGNAL              (9)
 #define MSG_TICK                (10)
+#define MSG_STATE_TIMER         (11)
+#define MSG_TR_TIMER            (12)
+#define MSG_CACHE_CONFIG        (13)
+#define MSG_CACHE_INFO          (14)
+#define MSG_CACHE_STIFFNESS     (15)
 
 #define PERIOD_ms (10)
 
+// A link going up and down does not fill the disk
+#define RECORDER_DUMP_PERIOD_us (10000000)
+
+// The CAN controller needs 1 s after a reset
+#define RESET_DELAY_tick (1000 / PERIOD_ms)
+
+// After a failed recovery, the worker waits before the next CAN reset. The
+// first wait is 10 ticks, each of the following ones twice longer than the
+// previous one.
+#define RECOVERY_BACKOFF_tick (10)
+
+// After 4 failed recoveries in a row, the gimbal is probably off. The
+// worker stops resetting its CAN controller and tries again every 10 s.
+#define RECOVERY_FAILURE_MAX (4)
+#define RECOVERY_OPEN_tick   (10000 / PERIOD_ms)
+
+// Without a valid reply during this time, the worker resets the CAN
+// controller. The delay is shorter after a reset or a reconnection.
+#define STATE_TIMEOUT_tick       (30)
+#define STATE_TIMEOUT_RESET_tick (10)
+
+// The first retry waits 5 ticks, each of the following ones twice longer
+// than the previous one.
+#define TR_RETRY_DELAY_tick (5)
+
+#define TR_TIMEOUT_tick (1000 / PERIOD_ms)
+
+// The position is polled every 4 ticks, every 2 ticks while the gimbal
+// moves. A lost reply must not keep its slot in the in-flight window longer
+// than 2 slow polls.
+#define POSITION_TIMEOUT_tick (8)
+
+// Scheduler weights, see Scheduler.h
+#define WEIGHT_FOCUS           (SCHEDULER_SLOT / 2)
+#define WEIGHT_POSITION        (SCHEDULER_SLOT / 4)
+#define WEIGHT_POSITION_MOVING (SCHEDULER_SLOT / 2)
+#define WEIGHT_SPEED           (SCHEDULER_SLOT / 5)
+
+#define BUDGET (2 * SCHEDULER_SLOT)
+
+// Work classes, the first one wins when the credits are equal
+#define WORK_POSITION (0)
+#define WORK_SPEED    (1)
+#define WORK_FOCUS    (2)
+#define WORK_SETPOINT (3)
+
+// Maximum number of queued transactions the worker starts during one tick
+#define TR_DRAIN_MAX (4)
+
 const char * STATE_CHANGES[6][6] =
 {
     { "ACTIVATED -> ACTIVATED (I)" , "ACTIVATED -> ACTIVATING (I)"  , "ACTIVATED -> ERROR_CAN (E)"  , "ACTIVATED -> ERROR_ETH (I)" , "ACTIVATED -> INIT (I)"  , NULL                             },
@@ -53,6 +104,8 @@ const char * STATE_CHANGES[6][6] =
 
 static unsigned int CalculateMoveDuration(double aFrom_deg, double aTo_deg, double aSpeed_deg_s);
 
+static void Latency_Get(ZT::IGimbal::Latency * aOut, const ZT_Lib::Histogram & aIn);
+
 static ZT::Result ReturnError(ZT::Result aResult, unsigned int aLine);
 
 // ===== Entry point ========================================================
@@ -63,27 +116,81 @@ static bool Receiver_Link(EthCAN::Device * aDevice, void * aContext, const EthCA
 /////////////////////////////////////////////////////////////////////////////
 
 DJI_Gimbal::DJI_Gimbal(EthCAN::Device * aDevice)
-    : mCounter(0)
+    : mReply(NULL)
+    , mRecorder_Dump_us(0)
+    , mTick_Last_us(0)
     , mDevice(aDevice)
-    , mReply(reinterpret_cast<DJI_Frame *>(mRxBuffer))
-    , mRxOffset_byte(0)
-    , mRxSize_byte(0)
+    , mReassembler(&mStats)
+    , mTransport_EthCAN(aDevice)
+    , mTransport(&mTransport_EthCAN)
+    , mTx_Stage(mTx_Batches)
+    , mTx_Full(NULL)
+    , mRecorder_Dump(false)
+    , mCache_Save(false)
+    , mCache_Pending(false)
+    , mGroup_State(GROUP_IDLE)
     , mState(STATE_INIT)
-    , mTr_Current(NULL)
-    , mTr_Next(NULL)
+    , mState_Next(STATE_INIT)
+    , mRecovery(RECOVERY_IDLE)
+    , mRecovery_Count(0)
+    , mRecovery_Failure(0)
+    , mRecovery_Reset_us(0)
+    , mTr_InFlight_Count(0)
 {
     assert(NULL != aDevice);
 
+    mState_Timer.Init(this, MSG_STATE_TIMER);
+
+    memset(&mTr_InFlight, 0, sizeof(mTr_InFlight));
+
+    for (unsigned int i = 0; i < DJI_GIMBAL_TX_BATCH_QTY; i++)
+    {
+        mTx_Batches[i].mCommand_Count = 0;
+    }
+
+    memset(&mGroup_Value  , 0, sizeof(mGroup_Value  ));
+    memset(&mSetpoint_Last, 0, sizeof(mSetpoint_Last));
+
     mTr_Position.Prepare(this, MSG_POSITION, 10);
+
+    // The setpoints are sent at the first tick, outside of the slots. The
+    // class is there for the statistics.
+    mScheduler.Class_Init(WORK_POSITION, "Position"    , WEIGHT_POSITION, BUDGET);
+    mScheduler.Class_Init(WORK_SPEED   , "Speed repeat", WEIGHT_SPEED   , BUDGET);
+    mScheduler.Class_Init(WORK_FOCUS   , "Focus speed" , WEIGHT_FOCUS   , BUDGET);
+    mScheduler.Class_Init(WORK_SETPOINT, "Setpoint"    , 0              , BUDGET);
 }
 
 DJI_Gimbal::~DJI_Gimbal()
 {
     assert(NULL != mDevice);
 
+    // The worker stops before the members it uses are destroyed. The timers
+    // still started leave the wheel at the same time.
+    ZT::Result lRet = mThread.Stop();
+    assert(ZT::ZT_OK == lRet);
+
+    for (;;)
+    {
+        DJI_Transaction * lTr = mTr_Queue.Pop();
+        if (NULL == lTr)
+        {
+            break;
+        }
+
+        lTr->Complete(ZT::ZT_OK_REPLACED);
+    }
+
     mDevice->Release();
 }
 
+void DJI_Gimbal::Cache_Set(const char * aFolder)
+{
+    assert(STATE_INIT == mState);
+
+    mCache.Folder_Set(aFolder);
+}
+
 ZT::Result DJI_Gimbal::Connect()
 {
     assert(NULL != mDevice);
@@ -138,34 +245,43 @@ ZT::Result DJI_Gimbal::Activate()
         }
         else
         {
-            lResult = mThread.Start(this, MSG_DUMMY, MSG_TICK, MSG_DUMMY);
+            lResult = mThread.Start(this, MSG_DUMMY, MSG_TICK, MSG_DUMMY, PERIOD_ms);
             if (ZT::ZT_OK == lResult)
             {
-                for (unsigned int lRetry = 0; lRetry < 2; lRetry ++)
+                // The cache gives what the gimbal reported at the previous
+                // activation. The worker validates it after the activation.
+                bool lCached = Cache_Load();
+                if (!lCached)
                 {
-                    if (0 < lRetry)
-                    {
-                        mThread.Zone0_Enter();
-                        {
-                            State_Set_Z0(STATE_ERROR_CAN, __LINE__);
-                            ResetAndSleep_Z0(STATE_ACTIVATING);
-                        }
-                        mThread.Zone0_Leave();
-                    }
-
-                    lResult = Info_Retrieve();
-                    if (ZT::ZT_OK == lResult)
-                    {
-                        break;
-                    }
+                    lResult = Retrieve();
                 }
 
                 if (ZT::ZT_OK == lResult)
                 {
-                    lResult = Config_Retrieve();
+                    lResult = Gimbal::Activate();
                     if (ZT::ZT_OK == lResult)
                     {
-                        lResult = Gimbal::Activate();
+                        if (lCached)
+                        {
+                            // Without transaction, nothing brings the
+                            // state to ACTIVATED.
+                            mThread.Zone0_Enter();
+                            {
+                                State_Set_Z0(STATE_ACTIVATED, __LINE__);
+                                mThread.Timer_Start_Z0(&mState_Timer, STATE_TIMEOUT_tick);
+
+                                mCache_Config  = mConfig;
+                                mCache_Info    = mInfo;
+                                mCache_Pending = true;
+                            }
+                            mThread.Zone0_Leave();
+
+                            Cache_Revalidate();
+                        }
+                        else
+                        {
+                            Cache_Save(mInfo, mConfig);
+                        }
                     }
                 }
 
@@ -212,6 +328,15 @@ ZT::Result DJI_Gimbal::Config_Set(const Config & aIn)
     ZT::Result lResult = Gimbal::Config_Set(aIn);
     if (ZT::ZT_OK == lResult)
     {
+        // The replies of the cache validation describe the previous
+        // configuration.
+        mThread.Zone0_Enter();
+        {
+            mCache_Pending = false;
+            mCache_Save    = false;
+        }
+        mThread.Zone0_Leave();
+
         BEGIN
             DJI_Transaction lTr[2];
 
@@ -224,6 +349,11 @@ ZT::Result DJI_Gimbal::Config_Set(const Config & aIn)
 
                 lResult = Retry(lTr + i);
             }
+
+            if (ZT::ZT_OK == lResult)
+            {
+                Cache_Save(mInfo, mConfig);
+            }
         END
     }
 
@@ -236,17 +366,16 @@ ZT::Result DJI_Gimbal::Focus_Cal(Operation aOperation)
 
     ZT::Result lResult = ZT::ZT_OK;
     BEGIN
-        DJI_Transaction * lTr = new DJI_Transaction;
-
-        lTr->Frame_Init_FOCUS_CAL(aOperation);
-
-        if (ZT::ZT_OK == lResult)
+        DJI_Transaction * lTr = Tr_Alloc();
+        if (NULL == lTr)
         {
-            lResult = Tr_Queue(lTr);
+            lResult = ZT::ZT_ERROR_NOT_READY;
         }
         else
         {
-            delete lTr;
+            lTr->Frame_Init_FOCUS_CAL(aOperation);
+
+            lResult = Tr_Queue(lTr, DJI_TransactionQueue::PRIORITY_FOCUS);
         }
     END
     return lResult;
@@ -258,36 +387,133 @@ ZT::Result DJI_Gimbal::Focus_Position_Set(double aFocus_pc)
     if (ZT::ZT_OK == lResult)
     {
         BEGIN
-            DJI_Transaction * lTr = new DJI_Transaction;
-
-            lTr->Frame_Init_FOCUS_SET(aFocus_pc);
+            DJI_Transaction * lTr = Tr_Alloc();
+            if (NULL == lTr)
+            {
+                lResult = ZT::ZT_ERROR_NOT_READY;
+            }
+            else
+            {
+                lTr->Frame_Init_FOCUS_SET(aFocus_pc);
 
-            lResult = Tr_Queue(lTr);
+                lResult = Tr_Queue(lTr, DJI_TransactionQueue::PRIORITY_FOCUS);
+            }
         END
     }
     
     return lResult;
 }
 
+ZT::Result DJI_Gimbal::Health_Get(HealthStatus * aOut)
+{
+    if (NULL == aOut)
+    {
+        return ReturnError(ZT::ZT_ERROR_FUNCTION, __LINE__);
+    }
+
+    memset(aOut, 0, sizeof(HealthStatus));
+
+    mThread.Zone0_Enter();
+    {
+        switch (mState)
+        {
+        case STATE_ACTIVATED  :
+        case STATE_TRANSACTION: aOut->mHealth = (RECOVERY_PROBE == mRecovery) ? HEALTH_RECOVERING : HEALTH_OK; break;
+
+        case STATE_ERROR_CAN: aOut->mHealth = (RECOVERY_OPEN == mRecovery) ? HEALTH_FAILED : HEALTH_RECOVERING; break;
+
+        // The next call reconnects, see State_Check
+        case STATE_ERROR_ETH: aOut->mHealth = HEALTH_RECOVERING; break;
+
+        case STATE_ACTIVATING:
+        case STATE_INIT      : aOut->mHealth = HEALTH_INACTIVE; break;
+
+        default: assert(false);
+        }
+
+        aOut->mFailure  = mRecovery_Failure;
+        aOut->mRecovery = mRecovery_Count;
+
+        if ((RECOVERY_BACKOFF == mRecovery) || (RECOVERY_OPEN == mRecovery))
+        {
+            uint64_t lNow_us = Time_Get_us();
+
+            if (mRecovery_Reset_us > lNow_us)
+            {
+                aOut->mRetry_ms = static_cast<unsigned int>((mRecovery_Reset_us - lNow_us) / 1000);
+            }
+        }
+    }
+    mThread.Zone0_Leave();
+
+    return ZT::ZT_OK;
+}
+
+// The snapshot does not take Zone0, the worker continues while the users
+// read it.
+ZT::Result DJI_Gimbal::Metrics_Get(Metrics * aOut, bool aReset)
+{
+    if (NULL == aOut)
+    {
+        return ReturnError(ZT::ZT_ERROR_FUNCTION, __LINE__);
+    }
+
+    memset(aOut, 0, sizeof(Metrics));
+
+    Stats             lStats;
+    ZT_Lib::Histogram lHold_us;
+    ZT_Lib::Histogram lWait_us;
+
+    mStats.Snapshot_Get(&lStats, aReset);
+
+    mThread.Zone0_Histograms_Get(&lHold_us, &lWait_us, aReset);
+
+    Latency_Get(&aOut->mCommand   , lStats.mCommand_us);
+    Latency_Get(&aOut->mGroup_Skew, lStats.mGroup_Skew_us);
+    Latency_Get(&aOut->mRoundTrip , lStats.mRoundTrip_us);
+    Latency_Get(&aOut->mTick      , lStats.mTick_us);
+    Latency_Get(&aOut->mZone0_Hold, lHold_us);
+    Latency_Get(&aOut->mZone0_Wait, lWait_us);
+
+    aOut->mRetry    = lStats.mRetry;
+    aOut->mRx_byte  = lStats.mRx_byte;
+    aOut->mRx_Error = lStats.mRx_CRC16 + lStats.mRx_CRC32 + lStats.mRx_Overflow + lStats.mRx_TooLong + lStats.mRx_TooShort + lStats.mRx_Version;
+    aOut->mRx_frame = lStats.mRx_frame;
+    aOut->mTimeout  = lStats.mTr_Timeout;
+    aOut->mTx_byte  = lStats.mTx_byte;
+    aOut->mTx_Error = lStats.mTx_Error;
+    aOut->mTx_frame = lStats.mTx_frame;
+
+    return ZT::ZT_OK;
+}
+
 ZT::Result DJI_Gimbal::Position_Get(Position * aOut)
 {
     ZT::Result lResult = ZT::ZT_OK;
 
     if (!Position_Current_Get(aOut))
     {
-        BEGIN
-            DJI_Transaction lTr;
-
-            lTr.Prepare(this, MSG_POSITION_AND_SIGNAL, 10);
+        lResult = Position_Request();
+        if (ZT::ZT_OK == lResult)
+        {
+            lResult = Gimbal::Position_Get(aOut);
+        }
+    }
 
-            lTr.Frame_Init_ANGLE_GET();
+    return lResult;
+}
 
-            lResult = Tr_QueueAndWait(&lTr);
-        END
+ZT::Result DJI_Gimbal::Position_Get(PositionSample * aOut, unsigned int aMaxAge_ms)
+{
+    assert(NULL != aOut);
 
+    ZT::Result lResult = Position_Get_Cached(aOut);
+    if ((ZT::ZT_OK != lResult) || (aMaxAge_ms < aOut->mAge_ms))
+    {
+        lResult = Position_Request();
         if (ZT::ZT_OK == lResult)
         {
-            lResult = Gimbal::Position_Get(aOut);
+            lResult = Position_Get_Cached(aOut);
         }
     }
 
@@ -300,42 +526,68 @@ ZT::Result DJI_Gimbal::Position_Set(const Position & aIn, unsigned int aFlags, u
     if (ZT::ZT_OK == lResult)
     {
         BEGIN
-            mMoveDuration_ms = CalculateMoveDuration(aIn, aFlags);
-            if (aDuration_ms > mMoveDuration_ms)
-            {
-                mMoveDuration_ms = aDuration_ms;
-            }
-
-            DJI_Transaction * lTr = new DJI_Transaction;
+            DJI_Setpoint::Value lValue;
 
-            lTr->Frame_Init_POSITION_SET(aIn, aFlags, mMoveDuration_ms);
+            lValue.mKind        = DJI_Setpoint::KIND_POSITION;
+            lValue.mDuration_ms = CalculateMoveDuration(aIn, aFlags);
+            lValue.mFlags       = mPosition_Flags;
+            lValue.mPosition    = mPosition_Target;
 
-            lResult = Tr_Queue(lTr);
-            if (ZT::ZT_ERROR_NOT_READY == lResult)
+            if (aDuration_ms > lValue.mDuration_ms)
             {
-                lResult = ZT::ZT_OK;
+                lValue.mDuration_ms = aDuration_ms;
             }
+
+            Setpoint_Publish(lValue);
         END
     }
 
     return lResult;
 }
 
+// The recorder does not need Zone0, the worker and the receiver continue
+// during the dump.
+ZT::Result DJI_Gimbal::Recorder_Dump(const char * aFileName)
+{
+    char lFileName[64];
+    ZT::Result lResult;
+
+    if (NULL == aFileName)
+    {
+        const uint8_t * lA = reinterpret_cast<const uint8_t *>(&mInfo.mIPv4_Address);
+
+        sprintf(lFileName, "/tmp/ZT_Recorder_%u.%u.%u.%u_XXXXXX", lA[0], lA[1], lA[2], lA[3]);
+
+        lResult = mRecorder.Dump_Temp(lFileName);
+
+        aFileName = lFileName;
+    }
+    else
+    {
+        lResult = mRecorder.Dump(aFileName);
+    }
+
+    if (ZT::ZT_OK == lResult)
+    {
+        fprintf(stdout, "INFO  DJI_Gimbal::Recorder_Dump - %s\n", aFileName);
+    }
+
+    TRACE_RESULT(stderr, lResult);
+    return lResult;
+}
+
 ZT::Result DJI_Gimbal::Speed_Set(const Speed & aIn, unsigned int aFlags)
 {
     ZT::Result lResult = Gimbal::Speed_Set(aIn, aFlags);
     if (ZT::ZT_OK == lResult)
     {
         BEGIN
-            DJI_Transaction * lTr = new DJI_Transaction;
+            DJI_Setpoint::Value lValue;
 
-            lTr->Frame_Init_SPEED_SET(mSpeed);
+            lValue.mKind  = DJI_Setpoint::KIND_SPEED;
+            lValue.mSpeed = mSpeed;
 
-            lResult = Tr_Queue(lTr);
-            if (ZT::ZT_ERROR_NOT_READY == lResult)
-            {
-                lResult = ZT::ZT_OK;
-            }
+            Setpoint_Publish(lValue);
         END
     }
 
@@ -348,11 +600,27 @@ ZT::Result DJI_Gimbal::Speed_Stop()
     if (ZT::ZT_OK == lResult)
     {
         BEGIN
-            DJI_Transaction * lTr = new DJI_Transaction;
+            DJI_Setpoint::Value lValue;
+
+            memset(&lValue, 0, sizeof(lValue));
 
-            lTr->Frame_Init_SPEED_SET(mSpeed);
+            lValue.mKind = DJI_Setpoint::KIND_NONE;
+
+            // The stop goes through the queue, the empty setpoint only
+            // prevents the worker from sending an older one after it.
+            Setpoint_Publish(lValue);
+
+            DJI_Transaction * lTr = Tr_Alloc();
+            if (NULL == lTr)
+            {
+                lResult = ZT::ZT_ERROR_NOT_READY;
+            }
+            else
+            {
+                lTr->Frame_Init_SPEED_SET(mSpeed);
 
-            lResult = Tr_Queue(lTr);
+                lResult = Tr_Queue(lTr, DJI_TransactionQueue::PRIORITY_STOP);
+            }
         END
     }
 
@@ -378,11 +646,17 @@ ZT::Result DJI_Gimbal::Track_Switch()
 {
     ZT::Result lResult;
     BEGIN
-        DJI_Transaction * lTr = new DJI_Transaction;
-
-        lTr->Frame_Init_TRACK_SWITCH();
+        DJI_Transaction * lTr = Tr_Alloc();
+        if (NULL == lTr)
+        {
+            lResult = ZT::ZT_ERROR_NOT_READY;
+        }
+        else
+        {
+            lTr->Frame_Init_TRACK_SWITCH();
 
-        lResult = Tr_Queue(lTr);
+            lResult = Tr_Queue(lTr, DJI_TransactionQueue::PRIORITY_FOCUS);
+        }
     END
     return lResult;
 }
@@ -396,11 +670,43 @@ void DJI_Gimbal::Debug(void * aOut)
     try
     {
         fprintf(lOut, "===== Debug Information =====\n");
-        fprintf(lOut, "Rx Buffer     :");
-        DumpRxBuffer(lOut, mRxSize_byte);
-        fprintf(lOut, "Counter       : %u\n"      , mCounter);
-        fprintf(lOut, "Rx Offset     : %u bytes\n", mRxOffset_byte);
-        fprintf(lOut, "Rx Size       : %u bytes\n", mRxSize_byte);
+
+        mThread.Zone0_Enter();
+        {
+            fprintf(lOut, "In Flight     : %u\n"      , mTr_InFlight_Count);
+
+            fprintf(lOut, "Rx Buffer     :");
+            mReassembler.Display(lOut);
+            fprintf(lOut, "Rx Size       : %u bytes\n", mReassembler.Size_Get());
+
+            mScheduler.Display(lOut);
+        }
+        mThread.Zone0_Leave();
+
+        ZT_Lib::Histogram lHold_us;
+        ZT_Lib::Histogram lWait_us;
+
+        mThread.Zone0_Histograms_Get(&lHold_us, &lWait_us);
+
+        fprintf(lOut, "    ===== Zone0 =====\n");
+        lHold_us.Display(lOut, "Hold            ", "us");
+        lWait_us.Display(lOut, "Wait            ", "us");
+
+        Stats lStats;
+
+        mStats.Snapshot_Get(&lStats);
+
+        lStats.Display(lOut);
+
+        ZT_Lib::Thread::Timing lTiming;
+
+        mThread.Timing_Get(&lTiming);
+
+        fprintf(lOut, "Tick          : %u\n"      , lTiming.mTick);
+        fprintf(lOut, "Tick Jitter   : %u us (max), %u us (avg)\n", lTiming.mJitter_Max_us, (0 == lTiming.mTick) ? 0 : static_cast<unsigned int>(lTiming.mJitter_Sum_us / lTiming.mTick));
+        fprintf(lOut, "Tick Overrun  : %u\n"      , lTiming.mOverrun);
+        fprintf(lOut, "Tick Wake     : %u\n"      , lTiming.mWake);
+        fprintf(lOut, "Timer Expired : %u\n"      , lTiming.mTimer);
 
         EthCAN_Info lInfo;
         EthCAN_Result lResult;
@@ -426,98 +732,316 @@ void DJI_Gimbal::Debug(void * aOut)
     }
 }
 
-// ===== ZT::IMessageReceiver ===============================================
+// ===== Gimbal =============================================================
 
-bool DJI_Gimbal::ProcessMessage(void * aSender, unsigned int aCode, const void * aData)
+void DJI_Gimbal::Group_Cancel()
 {
-    assert(NULL != aSender);
+    mThread.Zone0_Enter();
+    {
+        if (GROUP_STAGED == mGroup_State)
+        {
+            mGroup_State = GROUP_IDLE;
+        }
+    }
+    mThread.Zone0_Leave();
+}
 
-    bool lResult = false;
+ZT::Result DJI_Gimbal::Group_Prepare(const Position & aIn, unsigned int aFlags, unsigned int * aDuration_ms)
+{
+    assert(NULL != aDuration_ms);
 
-    DJI_Transaction * lTr = reinterpret_cast<DJI_Transaction *>(aSender);
+    ZT::Result lResult;
 
-    switch (aCode)
-    {
-    case MSG_CONFIG             : lResult = OnConfig_Z0           (lTr); break;
-    case MSG_CONFIG_STIFFNESS   : lResult = OnConfigStiffness_Z0  (lTr); break;
-    case MSG_INFO               : lResult = OnInfo_Z0             (lTr); break;
-    case MSG_POSITION           : lResult = OnPosition_Z0         (lTr); break;
-    case MSG_POSITION_AND_SIGNAL: lResult = OnPositionAndSignal_Z0(lTr); break;
-    case MSG_RELEASE            : lResult = OnRelease_Z0          (lTr); break;
-    case MSG_SIGNAL             : lResult = OnSignal_Z0           (lTr); break;
+    BEGIN
+        lResult = Gimbal::Group_Prepare(aIn, aFlags, aDuration_ms);
+        if (ZT::ZT_OK == lResult)
+        {
+            *aDuration_ms = CalculateMoveDuration(aIn, aFlags);
+        }
+    END
 
-    case MSG_DUMMY: lResult = true; break;
+    return lResult;
+}
 
-    case MSG_TICK: lResult = OnTick(); break;
+// The worker sends the staged frame as soon as it wakes up, it does not wait
+// for the deadline of its next tick.
+ZT::Result DJI_Gimbal::Group_Release()
+{
+    ZT::Result lResult = ZT::ZT_ERROR_STATE;
 
-    default: assert(false);
+    mThread.Zone0_Enter();
+    {
+        if (GROUP_STAGED == mGroup_State)
+        {
+            mGroup_State               = GROUP_RELEASED;
+            mGroup_Value.mPublished_us = Time_Get_us();
+
+            mThread.Wake_Z0();
+
+            lResult = ZT::ZT_OK;
+        }
     }
+    mThread.Zone0_Leave();
 
+    TRACE_RESULT(stderr, lResult);
     return lResult;
 }
 
-// Internal
-/////////////////////////////////////////////////////////////////////////////
-
-bool DJI_Gimbal::Receiver(const EthCAN_Frame & aCF)
+void DJI_Gimbal::Group_Skew_Add(unsigned int aSkew_us)
 {
-    assert(sizeof(aCF.mData) >= aCF.mDataSize_byte);
+    mStats.mGroup_Skew_us.Add(aSkew_us);
+}
 
-    assert(sizeof(mRxBuffer) >= mRxSize_byte);
+// The duration is the one of the group, the move of this gimbal can be
+// shorter. The target of the gimbal changes only when the worker stages the
+// frame, see Tick_Group_Z0. A canceled or failed move leaves it as it was.
+ZT::Result DJI_Gimbal::Group_Stage(const Position & aIn, unsigned int aFlags, unsigned int aDuration_ms)
+{
+    ZT::Result lResult = ZT::ZT_ERROR_STATE;
 
     mThread.Zone0_Enter();
     {
-        if ((DJI_CAN_ID_RX != aCF.mId) || (NULL == mTr_Current))
-        {
-            // EthCAN::Display(stderr, aCF);
-        }
-        else
+        if (GROUP_IDLE == mGroup_State)
         {
-            unsigned int lRxSize_byte = mRxSize_byte + aCF.mDataSize_byte;
-            if (sizeof(mRxBuffer) < lRxSize_byte)
-            {
-                Receiver_Reset();
-            }
-            else
+            lResult = Position_Target_Next(&mGroup_Value.mPosition, &mGroup_Value.mFlags, aIn, aFlags);
+            if (ZT::ZT_OK == lResult)
             {
-                Receiver_CopyNewData(aCF);
+                mGroup_Value.mKind        = DJI_Setpoint::KIND_POSITION;
+                mGroup_Value.mDuration_ms = aDuration_ms;
 
-                ZT::Result lRet = Receiver_Validate_Z0(lRxSize_byte);
-                if (ZT::ZT_OK == lRet)
-                {
-                    if (mTr_Current->RxExpected_Get() <= mRxSize_byte)
-                    {
-                        switch (mState)
-                        {
-                        case STATE_ERROR_ETH:
-                            State_Set_Z0(STATE_ACTIVATED, __LINE__);
-                            // no break
-                        case STATE_ACTIVATED:
-                        case STATE_TRANSACTION:
-                            mState_Counter = 30;
-                            break;
-                        default: assert(false);
-                        }
+                mGroup_Tr.Frame_Init_POSITION_SET(mGroup_Value.mPosition, mGroup_Value.mFlags, mGroup_Value.mDuration_ms);
 
-                        mTr_Current->Complete(ZT::ZT_OK);
-                    }
-                }
-                else
-                {
-                    mTr_Current->Complete(lRet);
-                }
+                mGroup_State = GROUP_STAGED;
             }
         }
     }
     mThread.Zone0_Leave();
 
-    return true;
+    if (ZT::ZT_OK == lResult)
+    {
+        mStats.mSetpoint_Received ++;
+    }
+
+    TRACE_RESULT(stderr, lResult);
+    return lResult;
 }
 
-// Private
-/////////////////////////////////////////////////////////////////////////////
+ZT::Result DJI_Gimbal::Group_Wait(uint64_t * aStart_us)
+{
+    assert(NULL != aStart_us);
 
-// Thread : Users
+    ZT::Result lResult = ZT::ZT_ERROR_STATE;
+
+    mThread.Zone0_Enter();
+    {
+        while ((GROUP_RELEASED == mGroup_State) && (ZT::ZT_OK == mThread.Condition_Wait()))
+        {
+        }
+
+        switch (mGroup_State)
+        {
+        case GROUP_DONE:
+            lResult      = mGroup_Result;
+            *aStart_us   = mGroup_Start_us;
+            mGroup_State = GROUP_IDLE;
+            break;
+
+        case GROUP_RELEASED:
+            lResult      = ZT::ZT_ERROR_THREAD;
+            mGroup_State = GROUP_IDLE;
+            break;
+
+        // The move belongs to an other group, do not touch it.
+        default: break;
+        }
+    }
+    mThread.Zone0_Leave();
+
+    TRACE_RESULT(stderr, lResult);
+    return lResult;
+}
+
+// ===== ZT::IMessageReceiver ===============================================
+
+bool DJI_Gimbal::ProcessMessage(void * aSender, unsigned int aCode, const void * aData)
+{
+    assert(NULL != aSender);
+
+    bool lResult = false;
+
+    DJI_Transaction * lTr = reinterpret_cast<DJI_Transaction *>(aSender);
+
+    switch (aCode)
+    {
+    case MSG_CACHE_CONFIG       : lResult = OnCacheConfig_Z0      (lTr); break;
+    case MSG_CACHE_INFO         : lResult = OnCacheInfo_Z0        (lTr); break;
+    case MSG_CACHE_STIFFNESS    : lResult = OnCacheStiffness_Z0   (lTr); break;
+    case MSG_CONFIG             : lResult = OnConfig_Z0           (lTr); break;
+    case MSG_CONFIG_STIFFNESS   : lResult = OnConfigStiffness_Z0  (lTr); break;
+    case MSG_INFO               : lResult = OnInfo_Z0             (lTr); break;
+    case MSG_POSITION           : lResult = OnPosition_Z0         (lTr); break;
+    case MSG_POSITION_AND_SIGNAL: lResult = OnPositionAndSignal_Z0(lTr); break;
+    case MSG_RELEASE            : lResult = OnRelease_Z0          (lTr); break;
+    case MSG_SIGNAL             : lResult = OnSignal_Z0           (lTr); break;
+
+    case MSG_DUMMY: lResult = true; break;
+
+    case MSG_TICK: lResult = OnTick(); break;
+
+    // The timers expire with Zone0 held, see ZT_Lib::Thread::Timer_Start_Z0
+    case MSG_STATE_TIMER: lResult = OnState_Timer_Z0(); break;
+
+    case MSG_TR_TIMER:
+        assert(NULL != aData);
+
+        lResult = OnTr_Timer_Z0(reinterpret_cast<DJI_Transaction *>(reinterpret_cast<const ZT_Lib::Timer *>(aData)->Context_Get()));
+        break;
+
+    default: assert(false);
+    }
+
+    return lResult;
+}
+
+// Internal
+/////////////////////////////////////////////////////////////////////////////
+
+bool DJI_Gimbal::Receiver(const EthCAN_Frame & aCF)
+{
+    assert(sizeof(aCF.mData) >= aCF.mDataSize_byte);
+
+    mRecorder.Record(FLIGHT_RECORDER_CAN_RX, aCF.mId, 0, 0, aCF.mData, aCF.mDataSize_byte);
+
+    mThread.Zone0_Enter();
+    {
+        if (DJI_CAN_ID_RX == aCF.mId)
+        {
+            mReassembler.Push(aCF.mData, aCF.mDataSize_byte);
+
+            for (;;)
+            {
+                const DJI_Frame * lFrame = mReassembler.Next();
+                if (NULL == lFrame)
+                {
+                    break;
+                }
+
+                Receiver_Frame_Z0(lFrame);
+            }
+        }
+        else
+        {
+            mStats.mRx_Id ++;
+            mStats.mRx_Id_Last = aCF.mId;
+        }
+    }
+    mThread.Zone0_Leave();
+
+    // The telemetry receiver is called without holding Zone0, it can call
+    // the other methods of the gimbal.
+    Telemetry_Send();
+
+    return true;
+}
+
+void DJI_Gimbal::Transport_Set(ITransport * aTransport)
+{
+    mThread.Zone0_Enter();
+    {
+        mTransport = (NULL == aTransport) ? &mTransport_EthCAN : aTransport;
+    }
+    mThread.Zone0_Leave();
+}
+
+// Private
+/////////////////////////////////////////////////////////////////////////////
+
+// Return true when the cache gives the version, the limits and the
+// stiffness of the gimbal.
+//
+// Thread  Users
+bool DJI_Gimbal::Cache_Load()
+{
+    if (!mCache.IsEnabled())
+    {
+        return false;
+    }
+
+    ZT::Result lRet = mCache.Load(&mInfo, &mConfig);
+    if (ZT::ZT_OK != lRet)
+    {
+        mStats.mCache_Miss ++;
+        return false;
+    }
+
+    mStats.mCache_Hit ++;
+    return true;
+}
+
+// The worker saves the cache after releasing Zone0, see OnTick.
+//
+// Thread  Worker
+void DJI_Gimbal::Cache_Mismatch_Z0()
+{
+    mStats.mCache_Mismatch ++;
+
+    mCache_Save = true;
+}
+
+// The worker compares the replies with the cached values, see
+// OnCache..._Z0. A transaction the pool or the queue refuses only leaves
+// the cache without validation.
+//
+// Thread  Users
+void DJI_Gimbal::Cache_Revalidate()
+{
+    static const unsigned int EXPECTED_bytes[3] = { 11, 9, 6 };
+    static const unsigned int MESSAGE_CODES [3] = { MSG_CACHE_INFO, MSG_CACHE_CONFIG, MSG_CACHE_STIFFNESS };
+
+    for (unsigned int i = 0; i < 3; i ++)
+    {
+        DJI_Transaction * lTr = Tr_Alloc();
+        if (NULL == lTr)
+        {
+            TRACE_WARNING(stderr, "DJI_Gimbal::Cache_Revalidate - No transaction");
+            break;
+        }
+
+        switch (i)
+        {
+        case 0: lTr->Frame_Init_VERSION            (); break;
+        case 1: lTr->Frame_Init_ANGLE_LIMIT_GET    (); break;
+        case 2: lTr->Frame_Init_MOTOR_STIFFNESS_GET(); break;
+
+        default: assert(false);
+        }
+
+        lTr->Prepare(EXPECTED_bytes[i]);
+
+        ZT::Result lRet = Tr_Queue(lTr, DJI_TransactionQueue::PRIORITY_CONFIG, MESSAGE_CODES[i]);
+        if (ZT::ZT_OK != lRet)
+        {
+            TRACE_WARNING(stderr, "DJI_Gimbal::Cache_Revalidate - Tr_Queue failed");
+            break;
+        }
+    }
+}
+
+// Thread  Users and Worker, without Zone0
+void DJI_Gimbal::Cache_Save(const Info & aInfo, const Config & aConfig)
+{
+    if (mCache.IsEnabled())
+    {
+        ZT::Result lRet = mCache.Save(aInfo, aConfig);
+        if (ZT::ZT_OK != lRet)
+        {
+            TRACE_WARNING(stderr, "DJI_Gimbal::Cache_Save - Save failed");
+            Result_Display(lRet, stderr);
+        }
+    }
+}
+
+// Thread : Users
 unsigned int DJI_Gimbal::CalculateMoveDuration(const Position & aTo, unsigned int aFlags) const
 {
     unsigned int lResult_ms = 0;
@@ -569,68 +1093,72 @@ ZT::Result DJI_Gimbal::Config_Retrieve()
     return lResult;
 }
 
-void DJI_Gimbal::DumpRxBuffer(void * aOut, unsigned int aSize_byte)
-{
-    assert(NULL != aOut);
-    assert(0 < aSize_byte);
-
-    FILE * lOut = reinterpret_cast<FILE *>(aOut);
-
-    for (unsigned int i = 0; i < aSize_byte; i++)
-    {
-        fprintf(lOut, " %02x", mRxBuffer[i]);
-    }
-
-    fprintf(lOut, "\n");
-}
-
+// The fragments wait in the staging batch, OnTick gives them to the
+// transport after releasing Zone0. A full staging batch waits in mTx_Full,
+// OnTick sends it first. The frame comes from a
+// DJI_Transaction::Frame_Init_* method, it is already sealed.
+//
 // Thread : Worker
-ZT::Result DJI_Gimbal::Frame_Send_Z0(DJI_Frame * aFrame)
+ZT::Result DJI_Gimbal::Frame_Stage_Z0(DJI_Frame * aFrame, uint64_t aCommand_us)
 {
     assert(NULL != aFrame);
 
-    assert(NULL != mDevice);
-
-    uint8_t    * lFrame          = &aFrame->mSOF;
-    unsigned int lOffset_byte    = 0;
-    ZT::Result   lResult         = ZT::ZT_OK;
-    unsigned int lTotalSize_byte = aFrame->mSize_byte;
+    assert(NULL != mTx_Stage);
 
-    aFrame->Seal();
+    ZT::Result lResult = ZT::ZT_OK;
 
-    do
+    if (!mTx_Stage->mBatch.Frame_Add(*aFrame, DJI_CAN_ID_TX))
     {
-        unsigned int lSize_byte = lTotalSize_byte - lOffset_byte;
-        if (8 < lSize_byte)
-        {
-            lSize_byte = (12 < lSize_byte) ? 8 : lSize_byte - DJI_FOOTER_SIZE_byte;
-        }
-
-        EthCAN_Frame lCF;
-
-        memset(&lCF, 0, sizeof(lCF));
+        mStats.mTx_Stage_Full ++;
 
-        lCF.mDataSize_byte = lSize_byte;
-        lCF.mId = DJI_CAN_ID_TX;
+        // A tick stages far less than two batches, see
+        // DJI_GIMBAL_IN_FLIGHT_MAX.
+        if (NULL == mTx_Full)
+        {
+            mTx_Full  = mTx_Stage;
+            mTx_Stage = Tx_Batch_Free_Z0(mTx_Full, NULL);
 
-        memcpy(lCF.mData, lFrame + lOffset_byte, lSize_byte);
+            bool lRetB = mTx_Stage->mBatch.Frame_Add(*aFrame, DJI_CAN_ID_TX);
+            assert(lRetB);
+        }
+        else
+        {
+            lResult = ZT::ZT_ERROR_SEND;
+        }
+    }
 
-        lOffset_byte += lSize_byte;
+    if (ZT::ZT_OK == lResult)
+    {
+        mStats.mTx_byte  += aFrame->mSize_byte;
+        mStats.mTx_frame ++;
 
-        EthCAN_Result lRet = mDevice->Send(lCF, EthCAN_FLAG_NO_RESPONSE);
-        if (EthCAN_OK != lRet)
+        // A frame uses at least one CAN frame, so the array does not
+        // overflow.
+        if (0 != aCommand_us)
         {
-            State_Set_Z0(STATE_ERROR_ETH, __LINE__);
-            lResult = ZT::ZT_ERROR_SEND;
-            break;
+            assert(CAN_BATCH_SIZE > mTx_Stage->mCommand_Count);
+
+            mTx_Stage->mCommand_us[mTx_Stage->mCommand_Count] = aCommand_us;
+            mTx_Stage->mCommand_Count ++;
         }
     }
-    while (lOffset_byte < lTotalSize_byte);
-    
+
     TRACE_RESULT(stderr, lResult);
     return lResult;
 }
 
+// Thread  Worker
+void DJI_Gimbal::Group_Done_Z0(ZT::Result aResult, uint64_t aStart_us)
+{
+    assert(GROUP_RELEASED == mGroup_State);
+
+    mGroup_Result   = aResult;
+    mGroup_Start_us = aStart_us;
+    mGroup_State    = GROUP_DONE;
+
+    mThread.Condition_Broadcast();
+}
+
 ZT::Result DJI_Gimbal::Info_Init()
 {
     assert(NULL != mDevice);
@@ -670,40 +1198,134 @@ ZT::Result DJI_Gimbal::Info_Retrieve()
 // ===== On =================================================================
 // Thread  Worker
 
-bool DJI_Gimbal::OnConfig_Z0(DJI_Transaction * aTr)
+// A difference means the gimbal changed since the cache was saved. The
+// gimbal uses the values it reported from now on and the worker saves them
+// for the next activation.
+bool DJI_Gimbal::OnCacheConfig_Z0(DJI_Transaction * aTr)
 {
     assert(NULL != aTr);
 
-    assert(NULL != mReply);
-
-    if (aTr->IsOK())
+    if (!mCache_Pending)
     {
-        FOR_EACH_AXIS(a)
+        // Config_Set was called, drop the reply.
+    }
+    else if (aTr->IsOK())
+    {
+        Config lConfig = mCache_Config;
+
+        Reply_Limits_Get(&lConfig);
+
+        if (0 != memcmp(&mCache_Config, &lConfig, sizeof(mCache_Config)))
         {
-            unsigned int OFFSETS[AXIS_QTY] = { 3, 7, 5 };
+            TRACE_WARNING(stderr, "DJI_Gimbal::OnCacheConfig_Z0 - The angle limits changed");
+            Cache_Mismatch_Z0();
 
-            mConfig.mAxis[a].mMax_deg =   mReply->mData[OFFSETS[a]    ];
-            mConfig.mAxis[a].mMin_deg = - mReply->mData[OFFSETS[a] + 1];
+            mCache_Config = lConfig;
+
+            Reply_Limits_Get(&mConfig);
         }
     }
+    else
+    {
+        OnCacheError_Z0(aTr);
+    }
 
-    return OnSignal_Z0(aTr);
+    return OnRelease_Z0(aTr);
 }
 
-bool DJI_Gimbal::OnConfigStiffness_Z0(DJI_Transaction * aTr)
+void DJI_Gimbal::OnCacheError_Z0(DJI_Transaction * aTr)
 {
     assert(NULL != aTr);
 
-    assert(NULL != mReply);
+    if (ZT::ZT_OK_REPLACED != aTr->Result_Get())
+    {
+        TRACE_WARNING(stderr, "DJI_Gimbal::OnCacheError_Z0 - The cache is not validated");
+        Result_Display(aTr->Result_Get(), stderr);
+    }
+}
 
-    if (aTr->IsOK())
+bool DJI_Gimbal::OnCacheInfo_Z0(DJI_Transaction * aTr)
+{
+    assert(NULL != aTr);
+
+    if (!mCache_Pending)
     {
-        FOR_EACH_AXIS(a)
+        // Config_Set was called, drop the reply.
+    }
+    else if (aTr->IsOK())
+    {
+        Info lInfo = mCache_Info;
+
+        Reply_Version_Get(&lInfo);
+
+        if (0 != memcmp(mCache_Info.mVersion, lInfo.mVersion, sizeof(mCache_Info.mVersion)))
+        {
+            TRACE_WARNING(stderr, "DJI_Gimbal::OnCacheInfo_Z0 - The version changed");
+            Cache_Mismatch_Z0();
+
+            memcpy(mCache_Info.mVersion, lInfo.mVersion, sizeof(mCache_Info.mVersion));
+            memcpy(mInfo      .mVersion, lInfo.mVersion, sizeof(mInfo      .mVersion));
+        }
+    }
+    else
+    {
+        OnCacheError_Z0(aTr);
+    }
+
+    return OnRelease_Z0(aTr);
+}
+
+bool DJI_Gimbal::OnCacheStiffness_Z0(DJI_Transaction * aTr)
+{
+    assert(NULL != aTr);
+
+    if (!mCache_Pending)
+    {
+        // Config_Set was called, drop the reply.
+    }
+    else if (aTr->IsOK())
+    {
+        Config lConfig = mCache_Config;
+
+        Reply_Stiffness_Get(&lConfig);
+
+        if (0 != memcmp(&mCache_Config, &lConfig, sizeof(mCache_Config)))
         {
-            unsigned int OFFSETS[AXIS_QTY] = { 3, 5, 4 };
+            TRACE_WARNING(stderr, "DJI_Gimbal::OnCacheStiffness_Z0 - The stiffness changed");
+            Cache_Mismatch_Z0();
 
-            mConfig.mAxis[a].mStiffness_pc = mReply->mData[OFFSETS[a]];
+            mCache_Config = lConfig;
+
+            Reply_Stiffness_Get(&mConfig);
         }
+    }
+    else
+    {
+        OnCacheError_Z0(aTr);
+    }
+
+    return OnRelease_Z0(aTr);
+}
+
+bool DJI_Gimbal::OnConfig_Z0(DJI_Transaction * aTr)
+{
+    assert(NULL != aTr);
+
+    if (aTr->IsOK())
+    {
+        Reply_Limits_Get(&mConfig);
+    }
+
+    return OnSignal_Z0(aTr);
+}
+
+bool DJI_Gimbal::OnConfigStiffness_Z0(DJI_Transaction * aTr)
+{
+    assert(NULL != aTr);
+
+    if (aTr->IsOK())
+    {
+        Reply_Stiffness_Get(&mConfig);
 
         aTr->Result_Set(Config_Validate(mConfig));
     }
@@ -715,14 +1337,9 @@ bool DJI_Gimbal::OnInfo_Z0(DJI_Transaction * aTr)
 {
     assert(NULL != aTr);
 
-    assert(NULL != mReply);
-
     if (aTr->IsOK())
     {
-        mInfo.mVersion[0] = mReply->mData[5];
-        mInfo.mVersion[1] = mReply->mData[4];
-        mInfo.mVersion[2] = mReply->mData[3];
-        mInfo.mVersion[3] = mReply->mData[2];
+        Reply_Version_Get(&mInfo);
     }
 
     return OnSignal_Z0(aTr);
@@ -759,52 +1376,142 @@ bool DJI_Gimbal::OnRelease_Z0(DJI_Transaction * aTr)
     if (ZT::ZT_OK_REPLACED != aTr->Result_Get())
     {
         Tr_Complete_Z0(aTr);
-
-        State_Change_Z0(STATE_TRANSACTION, STATE_ACTIVATED, __LINE__);
     }
 
-    delete aTr;
+    mTr_Pool.Free(aTr);
 
     return true;
 }
 
+// Group_Wait, Retrieve and the transactions of Tr_QueueAndWait wait on the
+// same condition. Each one checks its own state when it wakes up.
 bool DJI_Gimbal::OnSignal_Z0(DJI_Transaction * aTr)
 {
     assert(NULL != aTr);
 
-    mThread.Condition_Signal();
+    mThread.Condition_Broadcast();
 
     Tr_Complete_Z0(aTr);
 
-    State_Change_Z0(STATE_TRANSACTION, STATE_ACTIVATED, __LINE__);
-
     return true;
 }
 
-bool DJI_Gimbal::OnTick()
+bool DJI_Gimbal::OnState_Timer_Z0()
 {
-    bool lResult = true;
-
-    usleep(PERIOD_ms * 1000);
-
-    mThread.Zone0_Enter();
+    switch (mState)
     {
-        try
+    case STATE_ACTIVATED:
+        if (RECOVERY_PROBE == mRecovery)
         {
-            switch (mState)
+            Recovery_Failed_Z0();
+        }
+        else
+        {
+            Recovery_Start_Z0(STATE_ACTIVATED);
+        }
+        break;
+
+    case STATE_ERROR_CAN: Recovery_Timer_Z0(); break;
+
+    // The time without a valid reply only counts while ACTIVATED.
+    case STATE_TRANSACTION: mThread.Timer_Start_Z0(&mState_Timer, 1); break;
+
+    case STATE_ACTIVATING:
+    case STATE_ERROR_ETH :
+    case STATE_INIT      : break;
+
+    default: assert(false);
+    }
+
+    return true;
+}
+
+// The reply timeout while the transaction is in flight, the end of the delay
+// before a retry otherwise. A retry does not wait for the end of a recovery.
+bool DJI_Gimbal::OnTr_Timer_Z0(DJI_Transaction * aTr)
+{
+    assert(NULL != aTr);
+
+    if (Tr_IsInFlight_Z0(aTr))
+    {
+        if (!Tr_Retry_Z0(aTr))
+        {
+            mStats.mTr_Timeout ++;
+
+            aTr->Complete(ZT::ZT_ERROR_TIMEOUT);
+        }
+    }
+    else if (STATE_ERROR_CAN == mState)
+    {
+        mStats.mTr_Aborted ++;
+
+        aTr->Complete(ZT::ZT_ERROR_NOT_READY);
+    }
+    else if (!Tr_Queue_Push(aTr, static_cast<DJI_TransactionQueue::Priority>(aTr->Priority_Get())))
+    {
+        aTr->Complete(ZT::ZT_ERROR_NOT_READY);
+    }
+
+    return true;
+}
+
+bool DJI_Gimbal::OnTick()
+{
+    bool lResult = true;
+
+    Config       lConfig;
+    bool         lDump     = false;
+    bool         lGroup    = false;
+    Info         lInfo;
+    bool         lReset    = false;
+    bool         lSave     = false;
+    Tx_Batch   * lTx_Batch = NULL;
+    Tx_Batch   * lTx_Full;
+    ITransport * lTransport;
+
+    mThread.Zone0_Enter();
+    {
+        // A wake-up only starts the queued transactions. The periodic work
+        // counts the deadlines, like the timers.
+        bool lWake = mThread.Iteration_IsWake();
+
+        try
+        {
+            // The frame of a released group move is the first of the
+            // batch, see Group_Release.
+            lGroup = Tick_Group_Z0();
+
+            switch (mState)
             {
-            case STATE_ACTIVATED : Tick_ACTIVATED_Z0(); break;
+            case STATE_ACTIVATED  :
+            case STATE_TRANSACTION:
+                if (lWake)
+                {
+                    State_TRANSACTION_Z0();
+                }
+                else
+                {
+                    Tick_ACTIVATED_Z0();
+                }
+                break;
 
             case STATE_ACTIVATING:
             case STATE_ERROR_ETH :
-                if (NULL != mTr_Next)
+                State_TRANSACTION_Z0();
+                break;
+
+            // A transaction queued after the start of the recovery does not
+            // wait for its end.
+            case STATE_ERROR_CAN:
+                Tr_Abort_Z0();
+
+                if (RECOVERY_RESET == mRecovery)
                 {
-                    State_TRANSACTION_Z0();
+                    mRecovery = RECOVERY_DELAY;
+                    lReset    = true;
                 }
                 break;
 
-            case STATE_TRANSACTION: mTr_Current->Tick(); break;
-
             case STATE_INIT: break;
 
             default: assert(false);
@@ -816,10 +1523,89 @@ bool DJI_Gimbal::OnTick()
             lResult = false;
         }
 
-        Gimbal::Tick();
+        if (!lWake)
+        {
+            Gimbal::Tick();
+
+            uint64_t lNow_us = Time_Get_us();
+
+            if (0 != mTick_Last_us)
+            {
+                mStats.mTick_us.Add(static_cast<unsigned int>(lNow_us - mTick_Last_us));
+            }
+
+            mTick_Last_us = lNow_us;
+        }
+
+        lTransport = mTransport;
+        lTx_Full   = mTx_Full;
+        mTx_Full   = NULL;
+
+        if (0 < mTx_Stage->mBatch.Count_Get())
+        {
+            lTx_Batch = mTx_Stage;
+            mTx_Stage = Tx_Batch_Free_Z0(lTx_Full, lTx_Batch);
+        }
+
+        lDump          = mRecorder_Dump;
+        mRecorder_Dump = false;
+
+        if (mCache_Save)
+        {
+            lConfig     = mCache_Config;
+            lInfo       = mCache_Info;
+            lSave       = true;
+            mCache_Save = false;
+        }
     }
     mThread.Zone0_Leave();
 
+    // The network I/O does not block the EthCAN thread nor the users.
+    if (lReset)
+    {
+        Recovery_Reset();
+    }
+
+    uint64_t lStart_us = Time_Get_us();
+
+    if (NULL != lTx_Full)
+    {
+        Tx_Send(*lTx_Full, lTransport);
+    }
+
+    if (NULL != lTx_Batch)
+    {
+        Tx_Send(*lTx_Batch, lTransport);
+    }
+
+    // The frame of the group move is in one of the batches sent above.
+    if (lGroup)
+    {
+        mThread.Zone0_Enter();
+        {
+            Group_Done_Z0(ZT::ZT_OK, lStart_us);
+        }
+        mThread.Zone0_Leave();
+    }
+
+    // The file I/O neither. Only the worker uses mRecorder_Dump_us.
+    if (lDump)
+    {
+        uint64_t lNow_us = Time_Get_us();
+
+        if ((0 == mRecorder_Dump_us) || (RECORDER_DUMP_PERIOD_us <= lNow_us - mRecorder_Dump_us))
+        {
+            mRecorder_Dump_us = lNow_us;
+
+            Recorder_Dump(NULL);
+        }
+    }
+
+    if (lSave)
+    {
+        Cache_Save(lInfo, lConfig);
+    }
+
     return lResult;
 }
 
@@ -854,387 +1640,969 @@ ZT::Result DJI_Gimbal::Position_Parse()
     return lResult;
 }
 
-void DJI_Gimbal::Receiver_CopyNewData(const EthCAN_Frame & aCF)
+// Thread  Users
+ZT::Result DJI_Gimbal::Position_Request()
+{
+    ZT::Result lResult;
+    BEGIN
+        DJI_Transaction lTr;
+
+        lTr.Prepare(this, MSG_POSITION_AND_SIGNAL, 10);
+
+        lTr.Frame_Init_ANGLE_GET();
+
+        lResult = Tr_QueueAndWait(&lTr);
+    END
+    return lResult;
+}
+
+// Thread  EthCAN
+void DJI_Gimbal::Receiver_Frame_Z0(const DJI_Frame * aFrame)
+{
+    assert(NULL != aFrame);
+
+    DJI_Transaction * lTr = NULL;
+
+    if (DJI_CMD_TYPE_REPLY == aFrame->mCmdType)
+    {
+        lTr = Tr_Find_Z0(aFrame->mSerial);
+        if (NULL == lTr)
+        {
+            // Most likely the reply of a transaction completed on timeout
+            mStats.mRx_Unexpected ++;
+        }
+    }
+    else
+    {
+        mStats.mRx_Unsolicited ++;
+    }
+
+    if (NULL == lTr)
+    {
+        Receiver_Unsolicited_Z0(aFrame);
+        return;
+    }
+
+    mStats.mRoundTrip_us.Add(static_cast<unsigned int>(Time_Get_us() - lTr->Time_Sent_Get()));
+
+    ZT::Result lResult = Receiver_Validate_Z0(lTr, aFrame);
+    if (ZT::ZT_OK == lResult)
+    {
+        switch (mState)
+        {
+        case STATE_ERROR_ETH:
+            State_Set_Z0(STATE_ACTIVATED, __LINE__);
+            // no break
+        case STATE_ACTIVATED:
+        case STATE_TRANSACTION:
+            if (RECOVERY_PROBE == mRecovery)
+            {
+                mRecovery = RECOVERY_IDLE;
+                mRecovery_Count ++;
+                mRecovery_Failure = 0;
+            }
+
+            mThread.Timer_Start_Z0(&mState_Timer, STATE_TIMEOUT_tick);
+            break;
+
+        // A reply sent before the reset, the timer counts the reset delay.
+        case STATE_ERROR_CAN: break;
+
+        default: assert(false);
+        }
+    }
+    else if ((ZT::ZT_ERROR_GIMBAL == lResult) && Tr_Retry_Z0(lTr))
+    {
+        return;
+    }
+
+    // The On..._Z0 methods read the reply through mReply.
+    mReply = aFrame;
+
+    lTr->Complete(lResult);
+}
+
+// Thread  EthCAN
+void DJI_Gimbal::Receiver_Unsolicited_Z0(const DJI_Frame * aFrame)
+{
+    assert(NULL != aFrame);
+
+    // A late reply to the position request still carries a valid position.
+    if (   (DJI_CMD_TYPE_REPLY  == aFrame->mCmdType)
+        && (0                   == aFrame->mEncoded)
+        && (DJI_FRAME_TOTAL_SIZE(10) <= aFrame->mSize_byte)
+        && (DJI_CMD_SET_DEFAULT == aFrame->mData[DJI_DATA_CMD_SET])
+        && (DJI_CMD_ANGLE_GET   == aFrame->mData[DJI_DATA_CMD_ID ])
+        && (DJI_OK              == aFrame->mData[DJI_REPLY_RESULT]))
+    {
+        mReply = aFrame;
+
+        Position_Parse();
+    }
+}
+
+// Thread  EthCAN
+ZT::Result DJI_Gimbal::Receiver_Validate_Z0(const DJI_Transaction * aTr, const DJI_Frame * aFrame)
+{
+    assert(NULL != aTr);
+    assert(NULL != aFrame);
+
+    // The reassembler already verified the SOF, the size, the version and
+    // both CRC.
+    unsigned int lData_byte = aFrame->mSize_byte - DJI_HEADER_SIZE_byte - DJI_FOOTER_SIZE_byte;
+
+    ZT::Result lResult = ZT::ZT_OK;
+
+    if (0 != aFrame->mEncoded)
+    {
+        mStats.mRx_Encoded ++;
+        mStats.mRx_Encoded_Last = aFrame->mEncoded;
+        lResult = ZT::ZT_ERROR_ENCODED;
+    }
+    else if (aTr->RxExpected_Get() + DJI_FOOTER_SIZE_byte > aFrame->mSize_byte)
+    {
+        mStats.mRx_TooShort ++;
+        lResult = ZT::ZT_ERROR_FRAME_TOO_SHORT;
+    }
+    else if (DJI_CMD_SET_DEFAULT != aFrame->mData[DJI_DATA_CMD_SET])
+    {
+        mStats.mRx_CmdSet ++;
+        mStats.mRx_CmdSet_Last = aFrame->mData[DJI_DATA_CMD_SET];
+        lResult = ZT::ZT_ERROR_CMD_SET;
+    }
+    else if (aTr->Frame_Data_Get(DJI_DATA_CMD_ID) != aFrame->mData[DJI_DATA_CMD_ID])
+    {
+        mStats.mRx_CmdId ++;
+        mStats.mRx_CmdId_Last = aFrame->mData[DJI_DATA_CMD_ID];
+        lResult = ZT::ZT_ERROR_CMD_ID;
+    }
+    else if ((DJI_REPLY_RESULT < lData_byte) && (DJI_OK != aFrame->mData[DJI_REPLY_RESULT]))
+    {
+        mStats.mRx_Result ++;
+        mStats.mRx_Result_Last = aFrame->mData[DJI_REPLY_RESULT];
+        lResult = ZT::ZT_ERROR_GIMBAL;
+    }
+
+    TRACE_RESULT(stderr, lResult);
+    return lResult;
+}
+
+// The reply is only available when the transaction succeeded.
+//
+// Thread  Worker
+void DJI_Gimbal::Reply_Limits_Get(Config * aOut) const
+{
+    assert(NULL != aOut);
+
+    assert(NULL != mReply);
+
+    FOR_EACH_AXIS(a)
+    {
+        unsigned int OFFSETS[AXIS_QTY] = { 3, 7, 5 };
+
+        aOut->mAxis[a].mMax_deg =   mReply->mData[OFFSETS[a]    ];
+        aOut->mAxis[a].mMin_deg = - mReply->mData[OFFSETS[a] + 1];
+    }
+}
+
+// Thread  Worker
+void DJI_Gimbal::Reply_Stiffness_Get(Config * aOut) const
+{
+    assert(NULL != aOut);
+
+    assert(NULL != mReply);
+
+    FOR_EACH_AXIS(a)
+    {
+        unsigned int OFFSETS[AXIS_QTY] = { 3, 5, 4 };
+
+        aOut->mAxis[a].mStiffness_pc = mReply->mData[OFFSETS[a]];
+    }
+}
+
+// Thread  Worker
+void DJI_Gimbal::Reply_Version_Get(Info * aOut) const
+{
+    assert(NULL != aOut);
+
+    assert(NULL != mReply);
+
+    aOut->mVersion[0] = mReply->mData[5];
+    aOut->mVersion[1] = mReply->mData[4];
+    aOut->mVersion[2] = mReply->mData[3];
+    aOut->mVersion[3] = mReply->mData[2];
+}
+
+// Without the cache, the activation asks the gimbal. The first request
+// after the power up sometimes fails, the CAN reset helps.
+//
+// Thread  Users
+ZT::Result DJI_Gimbal::Retrieve()
+{
+    ZT::Result lResult = ZT::ZT_ERROR_GIMBAL;
+
+    for (unsigned int lRetry = 0; lRetry < 2; lRetry ++)
+    {
+        if (0 < lRetry)
+        {
+            // The worker resets the CAN controller, the activation waits
+            // for the end of the reset delay.
+            mThread.Zone0_Enter();
+            {
+                Recovery_Start_Z0(STATE_ACTIVATING);
+
+                while ((STATE_ERROR_CAN == mState) && (ZT::ZT_OK == mThread.Condition_Wait()))
+                {
+                }
+            }
+            mThread.Zone0_Leave();
+        }
+
+        lResult = Info_Retrieve();
+        if (ZT::ZT_OK == lResult)
+        {
+            break;
+        }
+    }
+
+    if (ZT::ZT_OK == lResult)
+    {
+        lResult = Config_Retrieve();
+    }
+
+    return lResult;
+}
+
+// Thread  Users
+ZT::Result DJI_Gimbal::Retry(DJI_Transaction * aTr)
+{
+    assert(NULL != aTr);
+
+    // The worker sends the transaction a second time after a timeout or an
+    // error the gimbal reports, see Tr_Retry_Z0.
+    ZT::Result lResult = Tr_QueueAndWait(aTr, 1);
+
+    TRACE_RESULT(stderr, lResult);
+    return lResult;
+}
+
+// Thread  Users
+void DJI_Gimbal::Setpoint_Publish(const DJI_Setpoint::Value & aIn)
+{
+    DJI_Setpoint::Value lValue = aIn;
+
+    lValue.mPublished_us = Time_Get_us();
+
+    mSetpoint.Publish(lValue);
+
+    mStats.mSetpoint_Received ++;
+}
+
+// ===== Recovery ===========================================================
+// Thread  Worker
+
+// No valid reply after the reset
+void DJI_Gimbal::Recovery_Failed_Z0()
+{
+    assert(RECOVERY_PROBE == mRecovery);
+
+    mRecovery_Failure ++;
+
+    State_Set_Z0(STATE_ERROR_CAN, __LINE__);
+
+    Tr_Abort_Z0();
+
+    unsigned int lDelay_tick;
+
+    if (RECOVERY_FAILURE_MAX <= mRecovery_Failure)
+    {
+        lDelay_tick = RECOVERY_OPEN_tick;
+        mRecovery   = RECOVERY_OPEN;
+    }
+    else
+    {
+        lDelay_tick = RECOVERY_BACKOFF_tick << (mRecovery_Failure - 1);
+        mRecovery   = RECOVERY_BACKOFF;
+    }
+
+    mRecovery_Reset_us = Time_Get_us() + lDelay_tick * PERIOD_ms * 1000;
+
+    mThread.Timer_Start_Z0(&mState_Timer, lDelay_tick);
+}
+
+// CAN_Reset is a TCP round trip to the EthCAN device, the worker calls it
+// without Zone0 held.
+void DJI_Gimbal::Recovery_Reset()
+{
+    assert(NULL != mDevice);
+
+    EthCAN_Result lRet = mDevice->CAN_Reset();
+
+    mThread.Zone0_Enter();
+    {
+        // A send error can bring the state to ERROR_ETH meanwhile.
+        if ((STATE_ERROR_CAN == mState) && (RECOVERY_DELAY == mRecovery))
+        {
+            if (EthCAN_OK == lRet)
+            {
+                mThread.Timer_Start_Z0(&mState_Timer, RESET_DELAY_tick);
+            }
+            else
+            {
+                mRecovery = RECOVERY_IDLE;
+
+                State_Set_Z0(STATE_ERROR_ETH, __LINE__);
+
+                mThread.Condition_Broadcast();
+            }
+        }
+    }
+    mThread.Zone0_Leave();
+}
+
+// The worker resets the CAN controller at its next tick, see OnTick. The
+// waiting callers do not wait for the end of the recovery.
+//
+// Thread  Users and Worker
+void DJI_Gimbal::Recovery_Start_Z0(State aNextState)
+{
+    State_Set_Z0(STATE_ERROR_CAN, __LINE__);
+
+    mRecovery   = RECOVERY_RESET;
+    mState_Next = aNextState;
+
+    Tr_Abort_Z0();
+}
+
+void DJI_Gimbal::Recovery_Timer_Z0()
+{
+    switch (mRecovery)
+    {
+    case RECOVERY_BACKOFF:
+    case RECOVERY_OPEN   : mRecovery = RECOVERY_RESET; break;
+
+    // End of the reset delay, an activation waits for it. After an error
+    // while ACTIVATED, the first valid reply ends the recovery.
+    case RECOVERY_DELAY:
+        State_Set_Z0(mState_Next, __LINE__);
+
+        if (STATE_ACTIVATED == mState_Next)
+        {
+            mRecovery = RECOVERY_PROBE;
+            mThread.Timer_Start_Z0(&mState_Timer, STATE_TIMEOUT_RESET_tick);
+        }
+        else
+        {
+            mRecovery = RECOVERY_IDLE;
+        }
+
+        mThread.Condition_Broadcast();
+        break;
+
+    default: assert(false);
+    }
+}
+
+// ===== State ==============================================================
+
+ZT::Result DJI_Gimbal::State_Change_Z0(State aFrom, State aTo, unsigned int aLine)
+{
+    assert(STATE_QTY > aFrom);
+    assert(STATE_QTY > aTo);
+
+    if (mState != aFrom)
+    {
+        fprintf(stderr, "WARNING  DJI_Gimbal::State_Change - mState = %u, aFrom = %u, aTo = %u, aLine = %u\n", mState, aFrom, aTo, aLine);
+        return ZT::ZT_ERROR_STATE;
+    }
+
+    State_Set_Z0(aTo, aLine);
+    return ZT::ZT_OK;
+}
+
+ZT::Result DJI_Gimbal::State_Check()
+{
+    ZT::Result lResult = ZT::ZT_ERROR_STATE;
+    mThread.Zone0_Enter();
+    {
+        switch (mState)
+        {
+        case STATE_ACTIVATED:
+        case STATE_TRANSACTION:
+            lResult = ZT::ZT_OK;
+            break;
+
+        // The worker recovers in background, the caller does not wait.
+        case STATE_ERROR_CAN: lResult = ZT::ZT_ERROR_NOT_READY; break;
+
+        case STATE_ACTIVATING:
+        case STATE_INIT      :
+            break;
+
+        case STATE_ERROR_ETH:
+            EthCAN_Result lRet;
+            mThread.Zone0_Leave();
+            {
+                lRet = mDevice->Protocol_Reset();
+                assert(EthCAN_OK == lRet);
+                lRet = mDevice->Receiver_Config();
+            }
+            mThread.Zone0_Enter();
+            if (EthCAN_OK == lRet)
+            {
+                lResult = State_Change_Z0(STATE_ERROR_ETH, STATE_ACTIVATED, __LINE__);
+                mThread.Timer_Start_Z0(&mState_Timer, STATE_TIMEOUT_RESET_tick);
+            }
+            break;
+
+        default: assert(false);
+        }
+    }
+    mThread.Zone0_Leave();
+    TRACE_RESULT(stderr, lResult);
+    return lResult;
+}
+
+void DJI_Gimbal::State_Set_Z0(State aTo, unsigned int aLine)
 {
-    assert(sizeof(mRxBuffer) > mRxOffset_byte);
-    assert(sizeof(mRxBuffer) > mRxSize_byte);
-    assert(mRxOffset_byte <= mRxSize_byte);
+    assert(STATE_QTY > aTo);
 
-    unsigned int lSize_byte = aCF.mDataSize_byte;
+    assert(STATE_QTY > mState);
 
-    unsigned int lToMove_byte = mRxSize_byte - mRxOffset_byte;
-    if (0 < lToMove_byte)
+    const char * lMsg = STATE_CHANGES[mState][aTo];
+    if (NULL != lMsg)
     {
-        memmove(mRxBuffer + mRxOffset_byte + lSize_byte, mRxBuffer + mRxOffset_byte, lToMove_byte);
+        fprintf(stdout, "DEBUG  DJI_Gimbal::State_Set_Z0 - %s (Line %u)\n", lMsg, aLine);
     }
 
-    memcpy(mRxBuffer + mRxOffset_byte, aCF.mData, lSize_byte);
+    if (mState != aTo)
+    {
+        uint8_t lData[2] = { static_cast<uint8_t>(mState), static_cast<uint8_t>(aTo) };
+
+        mRecorder.Record(FLIGHT_RECORDER_STATE, aLine, 0, 0, lData, sizeof(lData));
 
-    if (8 <= lSize_byte)
+        switch (aTo)
+        {
+        case STATE_ERROR_CAN:
+        case STATE_ERROR_ETH: mRecorder_Dump = true; break;
+
+        default: break;
+        }
+    }
+
+    mState = aTo;
+}
+
+// Transactions without reply complete in Tr_Start_Z0 and bring the state
+// back to ACTIVATED, so the loop can start more than one per tick. It stops
+// when a transaction waits for its reply or after an error.
+void DJI_Gimbal::State_TRANSACTION_Z0()
+{
+    for (unsigned int i = 0; (i < TR_DRAIN_MAX) && (DJI_GIMBAL_IN_FLIGHT_MAX > mTr_InFlight_Count); i++)
     {
-        mRxOffset_byte += lSize_byte;
+        DJI_Transaction * lTr = mTr_Queue.Pop();
+        if (NULL == lTr)
+        {
+            break;
+        }
+
+        if (STATE_TRANSACTION != mState)
+        {
+            State_Set_Z0(STATE_TRANSACTION, __LINE__);
+        }
+
+        Tr_Start_Z0(lTr);
+
+        if ((STATE_ACTIVATED != mState) && (STATE_TRANSACTION != mState))
+        {
+            break;
+        }
+    }
+}
+
+// ===== Tick ===============================================================
+// Thread  Worker
+
+// The periodic work continues while transactions wait for their reply, so
+// a slow reply does not delay the setpoints.
+void DJI_Gimbal::Tick_ACTIVATED_Z0()
+{
+    if (!mTr_Queue.IsEmpty())
+    {
+        State_TRANSACTION_Z0();
+    }
+
+    // The state timer and the transaction timers count the time without
+    // reply.
+    switch (mState)
+    {
+    case STATE_ACTIVATED  :
+    case STATE_TRANSACTION: Tick_Work_Z0(); break;
+
+    default: break;
+    }
+}
+
+void DJI_Gimbal::Tick_Focus_Speed_Z0()
+{
+    if (IsFocusMoving())
+    {
+        double lPosition_pc = mFocus_Position_pc + mFocus_Speed_pc_s * mScheduler.Elapsed_Get(WORK_FOCUS) * PERIOD_ms / 1000.0;
+
+        mFocus_Position_pc = Value_Limit(lPosition_pc, ZT::IGimbal::FOCUS_POSITION_MIN_pc, ZT::IGimbal::FOCUS_POSITION_MAX_pc);
+
+        DJI_Transaction lTr;
+
+        lTr.Frame_Init_FOCUS_SET(mFocus_Position_pc);
+
+        ZT::Result lRet = Frame_Stage_Z0(lTr.Frame_Get());
+        assert(ZT::ZT_OK == lRet);
+    }
+}
+
+// The group move replaces the setpoints published before its release. It
+// does not wait for the end of an error.
+//
+// Return true when the staging batch holds the frame of the group move
+bool DJI_Gimbal::Tick_Group_Z0()
+{
+    if (GROUP_RELEASED != mGroup_State)
+    {
+        return false;
+    }
+
+    switch (mState)
+    {
+    case STATE_ACTIVATED  :
+    case STATE_TRANSACTION: break;
+
+    default:
+        Group_Done_Z0(ZT::ZT_ERROR_STATE, 0);
+        return false;
+    }
+
+    while (mSetpoint.Read(&mSetpoint_Last))
+    {
+    }
+
+    mSetpoint_Last = mGroup_Value;
+
+    ZT::Result lRet = Frame_Stage_Z0(mGroup_Tr.Frame_Get(), mGroup_Value.mPublished_us);
+    if (ZT::ZT_OK != lRet)
+    {
+        Group_Done_Z0(lRet, 0);
+        return false;
+    }
+
+    Position_Target_Set(mGroup_Value.mPosition, mGroup_Value.mFlags);
+
+    mStats.mSetpoint_Sent ++;
+
+    return true;
+}
+
+void DJI_Gimbal::Tick_Position_Z0()
+{
+    assert(DJI_GIMBAL_IN_FLIGHT_MAX > mTr_InFlight_Count);
+    assert(!Tr_IsInFlight_Z0(&mTr_Position));
+
+    mTr_Position.Frame_Init_ANGLE_GET();
+    mTr_Position.Reset();
+    mTr_Position.RxTimeout_Set(POSITION_TIMEOUT_tick);
+
+    Tr_Start_Z0(&mTr_Position);
+}
+
+// A Position_Set followed by a Speed_Set during the same tick sends both
+// setpoints, in the order of their publication.
+//
+// Return true when a new setpoint was sent
+bool DJI_Gimbal::Tick_Setpoint_Z0()
+{
+    bool lResult = false;
+
+    while (mSetpoint.Read(&mSetpoint_Last))
+    {
+        DJI_Transaction lTr;
+
+        switch (mSetpoint_Last.mKind)
+        {
+        case DJI_Setpoint::KIND_NONE: continue;
+
+        case DJI_Setpoint::KIND_POSITION: lTr.Frame_Init_POSITION_SET(mSetpoint_Last.mPosition, mSetpoint_Last.mFlags, mSetpoint_Last.mDuration_ms); break;
+        case DJI_Setpoint::KIND_SPEED   : lTr.Frame_Init_SPEED_SET   (mSetpoint_Last.mSpeed); break;
+
+        default: assert(false);
+        }
+
+        // We do not test the return value, see Tick_Speed_Z0.
+        Frame_Stage_Z0(lTr.Frame_Get(), mSetpoint_Last.mPublished_us);
+
+        mStats.mSetpoint_Sent ++;
+
+        lResult = true;
+    }
+
+    return lResult;
+}
+
+// Return true when the last setpoint needs to be repeated
+bool DJI_Gimbal::Tick_Speed_IsReady_Z0() const
+{
+    switch (Position_State_Get())
+    {
+    case STATE_KNOWN:
+    case STATE_UNKNOWN: break;
+
+    case STATE_MOVING: return (DJI_Setpoint::KIND_POSITION == mSetpoint_Last.mKind);
+    case STATE_SPEED : return (DJI_Setpoint::KIND_SPEED    == mSetpoint_Last.mKind);
+
+    default: assert(false);
     }
+
+    return false;
 }
 
-void DJI_Gimbal::Receiver_Reset()
+void DJI_Gimbal::Tick_Speed_Z0()
 {
-    assert(sizeof(mRxBuffer) >= mRxOffset_byte);
-    assert(sizeof(mRxBuffer) >= mRxSize_byte);
+    DJI_Transaction lTr;
+
+    switch (mSetpoint_Last.mKind)
+    {
+    case DJI_Setpoint::KIND_POSITION: lTr.Frame_Init_POSITION_SET(mSetpoint_Last.mPosition, mSetpoint_Last.mFlags, mSetpoint_Last.mDuration_ms); break;
+    case DJI_Setpoint::KIND_SPEED   : lTr.Frame_Init_SPEED_SET   (mSetpoint_Last.mSpeed); break;
+
+    default: assert(false);
+    }
 
-    mRxOffset_byte = 0;
-    mRxSize_byte   = 0;
+    // We do not test the return value because this operation fail when we
+    // reset the device after a communication error.
+    Frame_Stage_Z0(lTr.Frame_Get());
 }
 
-ZT::Result DJI_Gimbal::Receiver_Validate_Z0(unsigned int aTo_byte)
+void DJI_Gimbal::Tick_Work_Z0()
 {
-    assert(NULL != mTr_Current);
-    assert(mRxSize_byte < aTo_byte);
-    assert(sizeof(mRxBuffer) >= aTo_byte);
-
-    ZT::Result lResult = ZT::ZT_OK;
+    // A new setpoint is sent at the first tick following its publication,
+    // Tick_Speed_Z0 only repeats the last one.
+    unsigned int lTx_byte = mStats.mTx_byte;
 
-    if ((1 > mRxSize_byte) && (1 <= aTo_byte))
+    if (Tick_Setpoint_Z0())
     {
-        if (DJI_SOF != mReply->mSOF)
-        {
-            goto Error;
-        }
+        mScheduler.Account(WORK_SETPOINT, mStats.mTx_byte - lTx_byte);
+        mScheduler.Credit_Reset(WORK_SPEED);
     }
 
-    if ((2 > mRxSize_byte) && (2 <= aTo_byte))
-    {
-        if (sizeof(mRxBuffer) < mReply->mSize_byte)
-        {
-            lResult = ZT::ZT_ERROR_FRAME_TOO_LONG;
-            goto Error;
-        }
-        if (DJI_FRAME_TOTAL_SIZE(1) > mReply->mSize_byte)
-        {
-            lResult = ZT::ZT_ERROR_FRAME_TOO_SHORT;
-            goto Error;
-        }
-    }
+    // The idle work classes do not ask for a slot
+    unsigned int lReady = 0;
 
-    if ((3 > mRxSize_byte) && (3 <= aTo_byte))
+    if (IsFocusMoving())
     {
-        if (0 != (mReply->mVersion & 0xfc))
-        {
-            lResult = ZT::ZT_ERROR_GIMBAL_VERSION;
-            goto Error;
-        }
+        lReady |= 1 << WORK_FOCUS;
     }
 
-    if ((4 > mRxSize_byte) && (4 <= aTo_byte))
+    if ((DJI_GIMBAL_IN_FLIGHT_MAX > mTr_InFlight_Count) && (!Tr_IsInFlight_Z0(&mTr_Position)))
     {
-        if (DJI_CMD_TYPE_REPLY != mReply->mCmdType)
-        {
-            lResult = ZT::ZT_ERROR_CMD_TYPE;
-            goto Error;
-        }
+        lReady |= 1 << WORK_POSITION;
     }
 
-    if ((5 > mRxSize_byte) && (5 <= aTo_byte))
+    if (Tick_Speed_IsReady_Z0())
     {
-        if (0 != mReply->mEncoded)
-        {
-            lResult = ZT::ZT_ERROR_ENCODED;
-            goto Error;
-        }
+        lReady |= 1 << WORK_SPEED;
     }
 
-    if ((10 > mRxSize_byte) && (10 <= aTo_byte))
+    switch (Position_State_Get())
     {
-        // TODO DJI_Gimbal
-        //      Verify serial
-    }
+    case STATE_MOVING:
+    case STATE_SPEED: mScheduler.Class_Weight_Set(WORK_POSITION, WEIGHT_POSITION_MOVING); break;
 
-    if ((12 > mRxSize_byte) && (12 <= aTo_byte))
-    {
-        // TODO DJI_Gimbal
-        //      Verify CRC-16
+    default: mScheduler.Class_Weight_Set(WORK_POSITION, WEIGHT_POSITION);
     }
 
-    if ((13 > mRxSize_byte) && (13 <= aTo_byte))
-    {
-        if (DJI_CMD_SET_DEFAULT != mReply->mData[DJI_DATA_CMD_SET])
-        {
-            lResult = ZT::ZT_ERROR_CMD_SET;
-            goto Error;
-        }
-    }
+    unsigned int lClass;
 
-    if ((14 > mRxSize_byte) && (14 <= aTo_byte))
+    if (mScheduler.Tick(&lClass, lReady))
     {
-        if (mTr_Current->Frame_Data_Get(DJI_DATA_CMD_ID) != mReply->mData[DJI_DATA_CMD_ID])
+        lTx_byte = mStats.mTx_byte;
+
+        switch (lClass)
         {
-            lResult = ZT::ZT_ERROR_CMD_ID;
-            goto Error;
+        case WORK_FOCUS   : Tick_Focus_Speed_Z0(); break;
+        case WORK_POSITION: Tick_Position_Z0   (); break;
+        case WORK_SPEED   : Tick_Speed_Z0      (); break;
+
+        default: assert(false);
         }
+
+        mScheduler.Account(lClass, mStats.mTx_byte - lTx_byte);
     }
+}
+
+// ===== Tx =================================================================
+// Thread  Worker
 
-    if ((15 > mRxSize_byte) && (15 <= aTo_byte))
+// The worker sends the batches before staging again, so a batch other than
+// aA and aB is free.
+DJI_Gimbal::Tx_Batch * DJI_Gimbal::Tx_Batch_Free_Z0(const Tx_Batch * aA, const Tx_Batch * aB)
+{
+    for (unsigned int i = 0; i < DJI_GIMBAL_TX_BATCH_QTY; i++)
     {
-        if (DJI_OK != mReply->mData[DJI_REPLY_RESULT])
+        Tx_Batch * lResult = mTx_Batches + i;
+        if ((aA != lResult) && (aB != lResult))
         {
-            lResult = ZT::ZT_ERROR_GIMBAL;
-            goto Error;
+            lResult->mBatch.Clear();
+            lResult->mCommand_Count = 0;
+
+            return lResult;
         }
     }
 
-    mRxSize_byte = aTo_byte;
-    return lResult;
+    assert(false);
+    return NULL;
+}
 
-Error:
-    Receiver_Reset();
+void DJI_Gimbal::Tx_Error_Z0()
+{
+    mStats.mTx_Error ++;
 
-    TRACE_RESULT(stderr, lResult);
-    return lResult;
+    State_Set_Z0(STATE_ERROR_ETH, __LINE__);
 }
 
-void DJI_Gimbal::ResetAndSleep_Z0(State aNextState)
+// Zone0 is not needed
+void DJI_Gimbal::Tx_Latency(const Tx_Batch & aBatch)
 {
-    assert(NULL != mDevice);
-    assert(STATE_ERROR_CAN == mState);
-
-    EthCAN_Result lRet = mDevice->CAN_Reset();
-    if (EthCAN_OK == lRet)
+    if (0 < aBatch.mCommand_Count)
     {
-        sleep(1);
+        uint64_t lNow_us = Time_Get_us();
 
-        mState_Counter = 10;
-        State_Set_Z0(aNextState, __LINE__);
-    }
-    else
-    {
-        State_Set_Z0(STATE_ERROR_ETH, __LINE__);
+        for (unsigned int i = 0; i < aBatch.mCommand_Count; i++)
+        {
+            mStats.mCommand_us.Add(static_cast<unsigned int>(lNow_us - aBatch.mCommand_us[i]));
+        }
     }
 }
 
-// Thread  Users
-ZT::Result DJI_Gimbal::Retry(DJI_Transaction * aTr)
+// Zone0 is not needed
+void DJI_Gimbal::Tx_Record(const CAN_Batch & aBatch, EthCAN_Result aResult)
 {
-    assert(NULL != aTr);
+    const EthCAN_Frame * lFrames = aBatch.Frames_Get();
 
-    ZT::Result lResult;
-
-    for (unsigned int lRetry = 0; lRetry < 2; lRetry++)
+    for (unsigned int i = 0; i < aBatch.Count_Get(); i++)
     {
-        lResult = Tr_QueueAndWait(aTr);
-        if ((ZT::ZT_ERROR_TIMEOUT != lResult) && (ZT::ZT_ERROR_GIMBAL != lResult))
-        {
-            break;
-        }
-
-        TRACE_DEBUG(stdout, "DJI_Gimbal::Retry");
+        mRecorder.Record(FLIGHT_RECORDER_CAN_TX, lFrames[i].mId, 0, aResult, lFrames[i].mData, lFrames[i].mDataSize_byte);
     }
-
-    TRACE_RESULT(stderr, lResult);
-    return lResult;
 }
 
-// ===== State ==============================================================
-
-ZT::Result DJI_Gimbal::State_Change_Z0(State aFrom, State aTo, unsigned int aLine)
+// The transactions the batch started are already in flight, their timer
+// completes them when the send fails.
+void DJI_Gimbal::Tx_Send(const Tx_Batch & aBatch, ITransport * aTransport)
 {
-    assert(STATE_QTY > aFrom);
-    assert(STATE_QTY > aTo);
+    assert(NULL != aTransport);
 
-    if (mState != aFrom)
+    EthCAN_Result lRet = aTransport->Send(aBatch.mBatch);
+
+    Tx_Record(aBatch.mBatch, lRet);
+
+    if (EthCAN_OK == lRet)
     {
-        fprintf(stderr, "WARNING  DJI_Gimbal::State_Change - mState = %u, aFrom = %u, aTo = %u, aLine = %u\n", mState, aFrom, aTo, aLine);
-        return ZT::ZT_ERROR_STATE;
+        Tx_Latency(aBatch);
+    }
+    else
+    {
+        mThread.Zone0_Enter();
+        {
+            Tx_Error_Z0();
+        }
+        mThread.Zone0_Leave();
     }
-
-    State_Set_Z0(aTo, aLine);
-    return ZT::ZT_OK;
 }
 
-ZT::Result DJI_Gimbal::State_Check()
+// ===== Tr =================================================================
+
+// Complete the queued and the in flight transactions with
+// ZT_ERROR_NOT_READY. The transactions waiting for a retry complete at the
+// end of their delay, see OnTr_Timer_Z0.
+//
+// Thread  Users and Worker
+void DJI_Gimbal::Tr_Abort_Z0()
 {
-    ZT::Result lResult = ZT::ZT_ERROR_STATE;
-    mThread.Zone0_Enter();
+    for (;;)
     {
-        switch (mState)
+        DJI_Transaction * lTr = mTr_Queue.Pop();
+        if (NULL == lTr)
         {
-        case STATE_ACTIVATED:
-        case STATE_TRANSACTION:
-            lResult = ZT::ZT_OK;
             break;
+        }
 
-        case STATE_ACTIVATING:
-        case STATE_INIT:
-            break;
+        mStats.mTr_Aborted ++;
 
-        case STATE_ERROR_ETH:
-            EthCAN_Result lRet;
-            mThread.Zone0_Leave();
-            {
-                lRet = mDevice->Protocol_Reset();
-                assert(EthCAN_OK == lRet);
-                lRet = mDevice->Receiver_Config();
-            }
-            mThread.Zone0_Enter();
-            if (EthCAN_OK == lRet)
-            {
-                lResult = State_Change_Z0(STATE_ERROR_ETH, STATE_ACTIVATED, __LINE__);
-                mState_Counter = 10;
-            }
-            break;
+        lTr->Complete(ZT::ZT_ERROR_NOT_READY);
+    }
 
-        default: assert(false);
+    // The completion removes the transaction from the window.
+    for (unsigned int i = 0; i < DJI_GIMBAL_IN_FLIGHT_MAX; i++)
+    {
+        DJI_Transaction * lTr = mTr_InFlight[i];
+        if (NULL != lTr)
+        {
+            mStats.mTr_Aborted ++;
+
+            lTr->Complete(ZT::ZT_ERROR_NOT_READY);
         }
     }
-    mThread.Zone0_Leave();
-    TRACE_RESULT(stderr, lResult);
-    return lResult;
+
+    assert(0 == mTr_InFlight_Count);
 }
 
-void DJI_Gimbal::State_Set_Z0(State aTo, unsigned int aLine)
+// Thread  Users
+DJI_Transaction * DJI_Gimbal::Tr_Alloc()
 {
-    assert(STATE_QTY > aTo);
-
-    assert(STATE_QTY > mState);
-
-    const char * lMsg = STATE_CHANGES[mState][aTo];
-    if (NULL != lMsg)
+    DJI_Transaction * lResult = mTr_Pool.Alloc();
+    if (NULL == lResult)
     {
-        fprintf(stdout, "DEBUG  DJI_Gimbal::State_Set_Z0 - %s (Line %u)\n", lMsg, aLine);
+        mStats.mTr_Pool_Empty ++;
     }
 
-    mState = aTo;
+    return lResult;
 }
 
-void DJI_Gimbal::State_TRANSACTION_Z0()
+// Thread  Worker
+void DJI_Gimbal::Tr_Complete_Z0(DJI_Transaction * aTr)
 {
-    assert(NULL != mTr_Next);
-
-    State_Set_Z0(STATE_TRANSACTION, __LINE__);
-    Tr_Start_Z0(mTr_Next);
-    mTr_Next = NULL;
-}
+    assert(NULL != aTr);
 
-// ===== Tick ===============================================================
-// Thread  Worker
+    // ZT_RESULT_INVALID when the transaction leaves the window for a retry
+    mRecorder.Record(FLIGHT_RECORDER_TR_COMPLETE, aTr->Result_Get(), aTr->Serial_Get(), aTr->Retry_Get());
 
-void DJI_Gimbal::Tick_ACTIVATED_Z0()
-{
-    if (NULL != mTr_Next)
-    {
-        State_TRANSACTION_Z0();
-    }
-    else
+    for (unsigned int i = 0; i < DJI_GIMBAL_IN_FLIGHT_MAX; i++)
     {
-        Tick_Work_Z0();
-
-        switch (mState_Counter)
+        if (mTr_InFlight[i] == aTr)
         {
-        case 0: assert(false);
+            assert(0 < mTr_InFlight_Count);
 
-        case 1:
-            State_Set_Z0(STATE_ERROR_CAN, __LINE__);
-            ResetAndSleep_Z0(STATE_ACTIVATED);
+            mTr_InFlight[i] = NULL;
+            mTr_InFlight_Count --;
             break;
-
-        default: mState_Counter--;
         }
     }
-}
 
-void DJI_Gimbal::Tick_Focus_Speed_Z0()
-{
-    if (IsFocusMoving())
+    if ((0 >= mTr_InFlight_Count) && (STATE_TRANSACTION == mState))
     {
-        double lPosition_pc = mFocus_Position_pc + mFocus_Speed_pc_s * 2 * PERIOD_ms / 1000.0;
-
-        mFocus_Position_pc = Value_Limit(lPosition_pc, ZT::IGimbal::FOCUS_POSITION_MIN_pc, ZT::IGimbal::FOCUS_POSITION_MAX_pc);
-
-        DJI_Transaction lTr;
-
-        lTr.Frame_Init_FOCUS_SET(mFocus_Position_pc);
-
-        ZT::Result lRet = Frame_Send_Z0(lTr.Frame_Get());
-        assert(ZT::ZT_OK == lRet);
+        State_Set_Z0(STATE_ACTIVATED, __LINE__);
     }
 }
 
-void DJI_Gimbal::Tick_Position_Z0()
+DJI_Transaction * DJI_Gimbal::Tr_Find_Z0(uint16_t aSerial)
 {
-    mTr_Position.Frame_Init_ANGLE_GET();
-    mTr_Position.Reset();
+    for (unsigned int i = 0; i < DJI_GIMBAL_IN_FLIGHT_MAX; i++)
+    {
+        DJI_Transaction * lTr = mTr_InFlight[i];
+        if ((NULL != lTr) && (lTr->Serial_Get() == aSerial))
+        {
+            return lTr;
+        }
+    }
 
-    Tr_Start_Z0(&mTr_Position);
+    return NULL;
 }
 
-void DJI_Gimbal::Tick_Speed_Z0()
+bool DJI_Gimbal::Tr_IsInFlight_Z0(const DJI_Transaction * aTr) const
 {
-    DJI_Transaction lTr;
+    assert(NULL != aTr);
 
-    switch (Position_State_Get())
+    for (unsigned int i = 0; i < DJI_GIMBAL_IN_FLIGHT_MAX; i++)
     {
-    case STATE_KNOWN:
-    case STATE_UNKNOWN: break;
-
-    case STATE_MOVING:
-        lTr.Frame_Init_POSITION_SET(mPosition_Target, mPosition_Flags, mMoveDuration_ms);
-        Frame_Send_Z0(lTr.Frame_Get());
-        break;
+        if (mTr_InFlight[i] == aTr)
+        {
+            return true;
+        }
+    }
 
-    case STATE_SPEED:
-        lTr.Frame_Init_SPEED_SET(mSpeed);
-        Frame_Send_Z0(lTr.Frame_Get());
-        // We do not test the return value because this operation fail when
-        // we reset the device after a communication error.
-        break;
+    return false;
+}
 
-    default: assert(false);
-    }
+// Thread  Users
+ZT::Result DJI_Gimbal::Tr_Queue(DJI_Transaction * aTr, DJI_TransactionQueue::Priority aPriority)
+{
+    return Tr_Queue(aTr, aPriority, MSG_RELEASE);
 }
 
-void DJI_Gimbal::Tick_Work_Z0()
+// aCode  The message of the completion, its handler frees the transaction
+//
+// Thread  Users
+ZT::Result DJI_Gimbal::Tr_Queue(DJI_Transaction * aTr, DJI_TransactionQueue::Priority aPriority, unsigned int aCode)
 {
-    mCounter ++;
+    assert(NULL != aTr);
+
+    aTr->Prepare(this, aCode);
+
+    aTr->Reset();
+    aTr->RxTimeout_Set(TR_TIMEOUT_tick);
+    aTr->Time_Queued_Set(Time_Get_us());
 
-    switch (mCounter % 4)
+    if (!Tr_Queue_Push(aTr, aPriority))
     {
-    case 0:
-    case 2:
-        Tick_Focus_Speed_Z0(); break;
+        mTr_Pool.Free(aTr);
+        return ZT::ZT_ERROR_NOT_READY;
+    }
 
-    case 1: Tick_Position_Z0(); break;
-    case 3: Tick_Speed_Z0   (); break;
+    // The worker starts an urgent transaction without waiting for the end
+    // of the current period.
+    if (0 != (DJI_GIMBAL_WAKE_PRIORITIES & (1 << aPriority)))
+    {
+        mThread.Wake();
     }
-}
 
-// ===== Tr =================================================================
+    return ZT::ZT_OK;
+}
 
-// Thread  Worker
-void DJI_Gimbal::Tr_Complete_Z0(DJI_Transaction * aTr)
+// Thread  Users
+bool DJI_Gimbal::Tr_Queue_Push(DJI_Transaction * aTr, DJI_TransactionQueue::Priority aPriority)
 {
     assert(NULL != aTr);
 
-    if (mTr_Current == aTr)
+    aTr->Priority_Set(aPriority);
+
+    if (mTr_Queue.Push(aTr, aPriority))
+    {
+        mStats.mTr_Queued ++;
+        return true;
+    }
+
+    switch (aPriority)
     {
-        mTr_Current = NULL;
+    case DJI_TransactionQueue::PRIORITY_CONFIG: mStats.mTr_Overflow_Config ++; break;
+    case DJI_TransactionQueue::PRIORITY_FOCUS : mStats.mTr_Overflow_Focus  ++; break;
+    case DJI_TransactionQueue::PRIORITY_STOP  : mStats.mTr_Overflow_Stop   ++; break;
+
+    default: assert(false);
     }
+
+    return false;
 }
 
+// Up to DJI_GIMBAL_IN_FLIGHT_MAX callers wait at the same time, the
+// completion wakes all of them, see OnSignal_Z0.
+//
 // Thread  Users
-ZT::Result DJI_Gimbal::Tr_Queue(DJI_Transaction * aTr)
+ZT::Result DJI_Gimbal::Tr_QueueAndWait(DJI_Transaction * aTr, unsigned int aRetry)
 {
+    assert(NULL != aTr);
+
     ZT::Result lResult = ZT::ZT_ERROR_NOT_READY;
 
-    aTr->Prepare(this, MSG_RELEASE);
+    aTr->Reset();
+    aTr->Retry_Set(aRetry);
+    aTr->RxTimeout_Set(TR_TIMEOUT_tick);
+    aTr->Time_Queued_Set(Time_Get_us());
 
     mThread.Zone0_Enter();
     {
-        if (NULL == mTr_Next)
-        {
-            Tr_Queue_Z0(aTr);
-            lResult = ZT::ZT_OK;
-        }
-        else
+        // During a recovery, the caller does not wait, see Tr_Abort_Z0.
+        if ((STATE_ERROR_CAN != mState) && Tr_Queue_Push(aTr, DJI_TransactionQueue::PRIORITY_CONFIG))
         {
-            delete aTr;
+            mThread.Wake_Z0();
+
+            lResult = aTr->Wait(&mThread);
         }
     }
     mThread.Zone0_Leave();
@@ -1242,48 +2610,72 @@ ZT::Result DJI_Gimbal::Tr_Queue(DJI_Transaction * aTr)
     return lResult;
 }
 
-// Thread  Users
-void DJI_Gimbal::Tr_Queue_Z0(DJI_Transaction * aTr)
+// Return false when the transaction has no retry left, the caller completes
+// it. Otherwise the transaction leaves the window and its timer puts it back
+// in the queue after the delay.
+//
+// Thread  Worker or EthCAN
+bool DJI_Gimbal::Tr_Retry_Z0(DJI_Transaction * aTr)
 {
     assert(NULL != aTr);
 
-    assert(NULL == mTr_Next);
+    if (!aTr->Retry_Use())
+    {
+        return false;
+    }
+
+    Tr_Complete_Z0(aTr);
+
+    mStats.mRetry ++;
 
-    aTr->Reset();
-    aTr->RxTimeout_Set(1000 / PERIOD_ms);
+    mThread.Timer_Start_Z0(aTr->Timer_Get(), TR_RETRY_DELAY_tick << (aTr->Retry_Get() - 1));
 
-    mTr_Next = aTr;
+    return true;
 }
 
-// Thread  Users
-ZT::Result DJI_Gimbal::Tr_QueueAndWait(DJI_Transaction * aTr)
+// Thread  Worker
+void DJI_Gimbal::Tr_Start_Z0(DJI_Transaction * aTr)
 {
-    ZT::Result lResult = ZT::ZT_ERROR_NOT_READY;
+    assert(NULL != aTr);
 
-    mThread.Zone0_Enter();
+    assert(DJI_GIMBAL_IN_FLIGHT_MAX > mTr_InFlight_Count);
+
+    for (unsigned int i = 0; i < DJI_GIMBAL_IN_FLIGHT_MAX; i++)
     {
-        if (NULL == mTr_Next)
+        if (NULL == mTr_InFlight[i])
         {
-            Tr_Queue_Z0(aTr);
-            lResult = aTr->Wait(&mThread);
+            mTr_InFlight[i] = aTr;
+            mTr_InFlight_Count ++;
+            break;
         }
     }
-    mThread.Zone0_Leave();
 
-    return lResult;
-}
+    if (mStats.mTr_InFlight_Max < mTr_InFlight_Count)
+    {
+        mStats.mTr_InFlight_Max = mTr_InFlight_Count;
+    }
 
-// Thread  Worker
-void DJI_Gimbal::Tr_Start_Z0(DJI_Transaction * aTr)
-{
-    assert(NULL != aTr);
+    // A retry is not a new command, only the first send counts in the
+    // command latency.
+    ZT::Result lRet = Frame_Stage_Z0(aTr->Frame_Get(), aTr->Time_Queued_Get());
+
+    aTr->Time_Queued_Set(0);
+    aTr->Time_Sent_Set(Time_Get_us());
 
-    mTr_Current = aTr;
+    const DJI_Frame * lFrame = aTr->Frame_Get();
 
-    Receiver_Reset();
+    uint8_t lData[3] = { lFrame->mCmdType, lFrame->mData[DJI_DATA_CMD_SET], lFrame->mData[DJI_DATA_CMD_ID] };
 
-    ZT::Result lRet = Frame_Send_Z0(aTr->Frame_Get());
+    mRecorder.Record(FLIGHT_RECORDER_TR_START, 0, lFrame->mSerial, aTr->Retry_Get(), lData, sizeof(lData));
 
+    ZT_Lib::Timer * lTimer = aTr->Timer_Get();
+
+    lTimer->Init(this, MSG_TR_TIMER, aTr);
+
+    mThread.Timer_Start_Z0(lTimer, aTr->RxTimeout_Get());
+
+    // When no reply is expected, Started completes the transaction, it
+    // leaves the window at once and Complete stops the timer.
     aTr->Started(lRet);
 }
 
@@ -1308,6 +2700,18 @@ unsigned int CalculateMoveDuration(double aFrom_deg, double aTo_deg, double aSpe
     return lDuration_s * 1000;
 }
 
+void Latency_Get(ZT::IGimbal::Latency * aOut, const ZT_Lib::Histogram & aIn)
+{
+    assert(NULL != aOut);
+
+    aOut->mCount  = aIn.Count_Get();
+    aOut->mAvg_us = aIn.Avg_Get();
+    aOut->mMax_us = aIn.Max_Get();
+    aOut->mP50_us = aIn.Percentile_Get(50);
+    aOut->mP90_us = aIn.Percentile_Get(90);
+    aOut->mP99_us = aIn.Percentile_Get(99);
+}
+
 ZT::Result ReturnError(ZT::Result aResult, unsigned int aLine)
 {
     assert(0 < aLine);
@@ -16,12 +16,36 @@
 #include <ZT/IMessageReceiver.h>
 
 // ===== ZT_Lib =============================================================
+#include "CAN_Batch.h"
 #include "DJI.h"
+#include "DJI_Cache.h"
+#include "DJI_Reassembler.h"
+#include "DJI_Setpoint.h"
 #include "DJI_Transaction.h"
+#include "DJI_TransactionPool.h"
+#include "DJI_TransactionQueue.h"
+#include "EthCAN_Transport.h"
+#include "FlightRecorder.h"
 #include "Gimbal.h"
+#include "Scheduler.h"
 #include "Stats.h"
 #include "ZT_Lib/Thread.h"
 
+// Constants
+/////////////////////////////////////////////////////////////////////////////
+
+// Maximum number of transactions waiting for their reply
+#define DJI_GIMBAL_IN_FLIGHT_MAX (4)
+
+// The staging batch, the full batch waiting for the end of the tick and the
+// one the transport uses
+#define DJI_GIMBAL_TX_BATCH_QTY (3)
+
+// The priorities of the transactions Tr_Queue starts without waiting for
+// the next tick, one bit per DJI_TransactionQueue::Priority. Waking the
+// worker takes Zone0, the other transactions wait at most one period.
+#define DJI_GIMBAL_WAKE_PRIORITIES (1 << DJI_TransactionQueue::PRIORITY_STOP)
+
 // Class
 /////////////////////////////////////////////////////////////////////////////
 
@@ -34,6 +58,13 @@ public:
 
     virtual ~DJI_Gimbal();
 
+    // aFolder  The folder of the cache files, NULL disables the cache.
+    //          With the cache, Activate uses what the gimbal reported at
+    //          the previous activation and validates it in background.
+    //
+    // Call Cache_Set before Activate.
+    void Cache_Set(const char * aFolder);
+
     ZT::Result Connect();
 
     // ===== ZT::IGimbal ====================================================
@@ -42,8 +73,12 @@ public:
     virtual ZT::Result Config_Set(const Config & aIn);
     virtual ZT::Result Focus_Cal(Operation aOperation);
     virtual ZT::Result Focus_Position_Set(double aFocus);
+    virtual ZT::Result Health_Get(HealthStatus * aOut);
+    virtual ZT::Result Metrics_Get(Metrics * aOut, bool aReset);
     virtual ZT::Result Position_Get(Position * aOut);
+    virtual ZT::Result Position_Get(PositionSample * aOut, unsigned int aMaxAge_ms);
     virtual ZT::Result Position_Set(const Position & aIn, unsigned int aFlags, unsigned int aDuration_ms);
+    virtual ZT::Result Recorder_Dump(const char * aFileName);
     virtual ZT::Result Speed_Set(const Speed & aIn, unsigned int aFlags);
     virtual ZT::Result Speed_Stop();
     virtual ZT::Result Track_Speed_Set(double aSpeed_pc);
@@ -51,6 +86,15 @@ public:
 
     virtual void Debug(void * aOut);
 
+    // ===== Gimbal =========================================================
+
+    virtual void       Group_Cancel  ();
+    virtual ZT::Result Group_Prepare (const Position & aIn, unsigned int aFlags, unsigned int * aDuration_ms);
+    virtual ZT::Result Group_Release ();
+    virtual void       Group_Skew_Add(unsigned int aSkew_us);
+    virtual ZT::Result Group_Stage   (const Position & aIn, unsigned int aFlags, unsigned int aDuration_ms);
+    virtual ZT::Result Group_Wait    (uint64_t * aStart_us);
+
     // ===== ZT::IMessageReceiver ===========================================
     virtual bool ProcessMessage(void * aSender, unsigned int aCode, const void * aData);
 
@@ -58,6 +102,9 @@ public:
 
     bool Receiver(const EthCAN_Frame & aFrame);
 
+    // aTransport  NULL to go back to the EthCAN device
+    void Transport_Set(ITransport * aTransport);
+
 private:
 
     // --> INIT <--+     +---+==> ERROR_ETH <--+
@@ -82,19 +129,77 @@ private:
     }
     State;
 
+    // The recovery from a CAN error. The state is ERROR_CAN, except during
+    // PROBE.
+    //
+    // --> IDLE --> RESET --> DELAY --> PROBE --> IDLE
+    //               ^                    |
+    //               +---- BACKOFF <------+
+    //               |                    |
+    //               +---- OPEN <---------+
+    typedef enum
+    {
+        RECOVERY_BACKOFF,
+        RECOVERY_DELAY,
+        RECOVERY_IDLE,
+        RECOVERY_OPEN,
+        RECOVERY_PROBE,
+        RECOVERY_RESET,
+
+        RECOVERY_QTY
+    }
+    Recovery;
+
+    // --> IDLE --> STAGED --> RELEASED --> DONE
+    //      |  |         |                   |
+    //      |  +<--------+ Group_Cancel      |
+    //      +<-------------------------------+
+    typedef enum
+    {
+        GROUP_DONE,
+        GROUP_IDLE,
+        GROUP_RELEASED,
+        GROUP_STAGED,
+
+        GROUP_QTY
+    }
+    GroupState;
+
+    // A staging batch and the time of the commands its frames carry
+    typedef struct
+    {
+        CAN_Batch mBatch;
+
+        unsigned int mCommand_Count;
+        uint64_t     mCommand_us[CAN_BATCH_SIZE];
+    }
+    Tx_Batch;
+
+    bool Cache_Load      ();
+    void Cache_Mismatch_Z0();
+    void Cache_Revalidate();
+    void Cache_Save      (const Info & aInfo, const Config & aConfig);
+
     unsigned int CalculateMoveDuration(const Position & aTo, unsigned int aFlags = 0) const;
 
     ZT::Result Config_Retrieve();
 
-    void DumpRxBuffer(void * aOut, unsigned int aSize_byte);
+    // aCommand_us  The time of the command the frame carries, 0 when the
+    //              worker generated the frame itself
+    ZT::Result Frame_Stage_Z0(DJI_Frame * aFrame, uint64_t aCommand_us = 0);
 
-    ZT::Result Frame_Send_Z0(DJI_Frame * aFrame);
+    // aStart_us  The time the worker sent the frame of the group move
+    void Group_Done_Z0(ZT::Result aResult, uint64_t aStart_us);
 
     ZT::Result Info_Init();
     ZT::Result Info_Retrieve();
 
     // ===== On... ==========================================================
 
+    bool OnCacheConfig_Z0      (DJI_Transaction * aTr);
+    void OnCacheError_Z0       (DJI_Transaction * aTr);
+    bool OnCacheInfo_Z0        (DJI_Transaction * aTr);
+    bool OnCacheStiffness_Z0   (DJI_Transaction * aTr);
     bool OnConfig_Z0           (DJI_Transaction * aTr);
     bool OnConfigStiffness_Z0  (DJI_Transaction * aTr);
     bool OnInfo_Z0             (DJI_Transaction * aTr);
@@ -102,19 +207,34 @@ private:
     bool OnPositionAndSignal_Z0(DJI_Transaction * aTr);
     bool OnRelease_Z0          (DJI_Transaction * aTr);
     bool OnSignal_Z0           (DJI_Transaction * aTr);
+    bool OnState_Timer_Z0      ();
+    bool OnTr_Timer_Z0         (DJI_Transaction * aTr);
 
     bool OnTick();
 
     ZT::Result Position_Parse();
+    ZT::Result Position_Request();
 
-    void Receiver_CopyNewData(const EthCAN_Frame & aCF);
-    void Receiver_Reset();
-    ZT::Result Receiver_Validate_Z0(unsigned int aTo_byte);
+    void       Receiver_Frame_Z0      (const DJI_Frame * aFrame);
+    void       Receiver_Unsolicited_Z0(const DJI_Frame * aFrame);
+    ZT::Result Receiver_Validate_Z0   (const DJI_Transaction * aTr, const DJI_Frame * aFrame);
 
-    void ResetAndSleep_Z0(State aNextState);
-    
+    void Reply_Limits_Get   (Config * aOut) const;
+    void Reply_Stiffness_Get(Config * aOut) const;
+    void Reply_Version_Get  (Info   * aOut) const;
+
+    // ===== Recovery =======================================================
+
+    void Recovery_Failed_Z0();
+    void Recovery_Reset    ();
+    void Recovery_Start_Z0 (State aNextState);
+    void Recovery_Timer_Z0 ();
+
+    ZT::Result Retrieve();
     ZT::Result Retry(DJI_Transaction * aTr);
 
+    void Setpoint_Publish(const DJI_Setpoint::Value & aIn);
+
     // ===== State ==========================================================
 
     ZT::Result State_Change_Z0(State aFrom, State aTo, unsigned int aLine);
@@ -128,39 +248,109 @@ private:
     void Tick_ACTIVATED_Z0();
     
     void Tick_Focus_Speed_Z0();
+    bool Tick_Group_Z0      ();
     void Tick_Position_Z0   ();
+    bool Tick_Setpoint_Z0   ();
+    bool Tick_Speed_IsReady_Z0() const;
     void Tick_Speed_Z0      ();
     void Tick_Work_Z0       ();
 
+    // ===== Tx =============================================================
+    Tx_Batch * Tx_Batch_Free_Z0(const Tx_Batch * aA, const Tx_Batch * aB);
+
+    void Tx_Error_Z0();
+    void Tx_Latency (const Tx_Batch & aBatch);
+    void Tx_Record  (const CAN_Batch & aBatch, EthCAN_Result aResult);
+    void Tx_Send    (const Tx_Batch & aBatch, ITransport * aTransport);
+
     // ===== Tr =============================================================
-    void       Tr_Complete_Z0 (DJI_Transaction * aTr);
-    ZT::Result Tr_Queue       (DJI_Transaction * aTr);
-    void       Tr_Queue_Z0    (DJI_Transaction * aTr);
-    ZT::Result Tr_QueueAndWait(DJI_Transaction * aTr);
-    void       Tr_Start_Z0    (DJI_Transaction * aTr);
+    void              Tr_Abort_Z0     ();
+    DJI_Transaction * Tr_Alloc        ();
+    void              Tr_Complete_Z0  (DJI_Transaction * aTr);
+    DJI_Transaction * Tr_Find_Z0      (uint16_t aSerial);
+    bool              Tr_IsInFlight_Z0(const DJI_Transaction * aTr) const;
+    ZT::Result        Tr_Queue        (DJI_Transaction * aTr, DJI_TransactionQueue::Priority aPriority);
+    ZT::Result        Tr_Queue        (DJI_Transaction * aTr, DJI_TransactionQueue::Priority aPriority, unsigned int aCode);
+    bool              Tr_Queue_Push   (DJI_Transaction * aTr, DJI_TransactionQueue::Priority aPriority);
+    ZT::Result        Tr_QueueAndWait (DJI_Transaction * aTr, unsigned int aRetry = 0);
+    bool              Tr_Retry_Z0     (DJI_Transaction * aTr);
+    void              Tr_Start_Z0     (DJI_Transaction * aTr);
+
+    Stats mStats;
+
+    // Any thread records without Zone0
+    FlightRecorder mRecorder;
 
-    unsigned int mMoveDuration_ms;
-    
     ZT_Lib::Thread mThread;
 
+    // ===== Users / Worker =================================================
+    DJI_Cache            mCache;
+    DJI_Setpoint         mSetpoint;
+    DJI_TransactionPool  mTr_Pool;
+    DJI_TransactionQueue mTr_Queue;
+
     // ===== Receiver =======================================================
     const DJI_Frame * mReply;
-    uint8_t           mRxBuffer[128];
 
     // ===== Worker =========================================================
-    unsigned int    mCounter;
-    DJI_Transaction mTr_Position;
+    Scheduler           mScheduler;
+    DJI_Setpoint::Value mSetpoint_Last;
+    DJI_Transaction     mTr_Position;
+    uint64_t            mRecorder_Dump_us;
+    uint64_t            mTick_Last_us;
 
     // ===== Zone 0 =========================================================
     EthCAN::Device * mDevice;
 
-    unsigned int mRxOffset_byte;
-    unsigned int mRxSize_byte;
-
-    State        mState;
-    unsigned int mState_Counter;
-
-    DJI_Transaction * mTr_Current;
-    DJI_Transaction * mTr_Next;
+    DJI_Reassembler mReassembler;
+
+    EthCAN_Transport mTransport_EthCAN;
+    ITransport     * mTransport;
+
+    // The worker fills the staging batch with Zone0 held and sends it after
+    // releasing Zone0. A batch the staging fills waits in mTx_Full for the
+    // end of the tick, the staging continues in a free batch.
+    Tx_Batch   mTx_Batches[DJI_GIMBAL_TX_BATCH_QTY];
+    Tx_Batch * mTx_Stage;
+    Tx_Batch * mTx_Full;
+
+    // Set when the communication fails, the worker dumps the recorder after
+    // releasing Zone0.
+    bool mRecorder_Dump;
+
+    // Set when the validation of the cache finds a difference, the worker
+    // saves the cache after releasing Zone0.
+    bool mCache_Save;
+
+    // The values Cache_Load gave. A reply of the validation which differs
+    // updates them, mConfig and mInfo. Config_Set clears mCache_Pending and
+    // the later replies are dropped.
+    Config mCache_Config;
+    Info   mCache_Info;
+    bool   mCache_Pending;
+
+    // Group_Stage builds the frame, the worker sends it at the wake-up
+    // Group_Release asks for.
+    DJI_Transaction     mGroup_Tr;
+    GroupState          mGroup_State;
+    DJI_Setpoint::Value mGroup_Value;
+
+    State mState;
+    State mState_Next;
+
+    // While ERROR_CAN, the end of the current recovery step. Otherwise, the
+    // time without a valid reply before the recovery starts.
+    ZT_Lib::Timer mState_Timer;
+
+    Recovery     mRecovery;
+    unsigned int mRecovery_Count;   // Successful recoveries
+    unsigned int mRecovery_Failure; // Failed recoveries in a row
+    uint64_t     mRecovery_Reset_us; // The time of the next reset, see
+                                     // Health_Get
+
+    // More than one transaction can wait for its reply. The serial number
+    // of a complete reply tells which one it belongs to.
+    DJI_Transaction * mTr_InFlight[DJI_GIMBAL_IN_FLIGHT_MAX];
+    unsigned int      mTr_InFlight_Count;
 
 };
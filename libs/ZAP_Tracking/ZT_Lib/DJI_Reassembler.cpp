@@ -0,0 +1,279 @@
+
+// Author  KMS - Martin Dubois, P. Eng.
+// Client  ZAP
+// Product Tacking
+// File    ZT_Lib/DJI_Reassembler.cpp
+
+#include "Component.h"
+
+// ===== ZT_Lib =============================================================
+#include "DJI_CRC.h"
+
+#include "DJI_Reassembler.h"
+
+// Constants
+// //////////////////////////////////////////////////////////////////////////
+
+#define MASK (DJI_REASSEMBLER_SIZE_byte - 1)
+
+// The reply carries at least the command set and the command id
+#define FRAME_MIN_byte (DJI_FRAME_TOTAL_SIZE(2))
+
+// Public
+// //////////////////////////////////////////////////////////////////////////
+
+unsigned int DJI_Reassembler::Insert(uint8_t * aFrame, unsigned int * aSize_byte, unsigned int * aInsert_byte, const uint8_t * aIn, unsigned int aIn_byte)
+{
+    assert(NULL != aFrame);
+    assert(NULL != aSize_byte);
+    assert(NULL != aInsert_byte);
+    assert(NULL != aIn);
+    assert(*aInsert_byte <= *aSize_byte);
+
+    unsigned int lResult = *aInsert_byte;
+
+    memmove(aFrame + lResult + aIn_byte, aFrame + lResult, *aSize_byte - lResult);
+    memcpy (aFrame + lResult, aIn, aIn_byte);
+
+    (*aSize_byte) += aIn_byte;
+
+    if (DJI_REASSEMBLER_FRAGMENT_byte <= aIn_byte)
+    {
+        (*aInsert_byte) += aIn_byte;
+    }
+
+    return lResult;
+}
+
+DJI_Reassembler::DJI_Reassembler(Stats * aStats, bool aReorder) : mHead(0), mInsert(0), mTail(0), mReorder(aReorder), mStats(aStats)
+{
+    assert(NULL != aStats);
+
+    assert(0 == (DJI_REASSEMBLER_SIZE_byte & MASK));
+    assert(DJI_REASSEMBLER_SIZE_byte >= DJI_REASSEMBLER_FRAME_MAX_byte);
+
+    memset(&mBuffer      , 0, sizeof(mBuffer));
+    memset(&mFrame_Buffer, 0, sizeof(mFrame_Buffer));
+}
+
+const DJI_Frame * DJI_Reassembler::Next()
+{
+    assert(NULL != mStats);
+
+    for (;;)
+    {
+        // ===== SOF ========================================================
+        while ((mHead != mTail) && (DJI_SOF != mBuffer[mHead & MASK]))
+        {
+            mStats->mRx_SOF ++;
+            mStats->mRx_SOF_Last = mBuffer[mHead & MASK];
+            Drop(1);
+        }
+
+        unsigned int lSize_byte = Size_Get();
+        if (DJI_HEADER_SIZE_byte > lSize_byte)
+        {
+            return NULL;
+        }
+
+        // ===== Header =====================================================
+        Copy(mFrame_Buffer, DJI_HEADER_SIZE_byte);
+
+        if (DJI_CRC_16(mFrame_Buffer) != mFrame.mCRC16)
+        {
+            if (Waiting(DJI_HEADER_SIZE_byte))
+            {
+                return NULL;
+            }
+
+            mStats->mRx_CRC16 ++;
+            Drop(1);
+            continue;
+        }
+
+        if (DJI_REASSEMBLER_FRAME_MAX_byte < mFrame.mSize_byte)
+        {
+            mStats->mRx_TooLong ++;
+            Drop(1);
+            continue;
+        }
+
+        if (FRAME_MIN_byte > mFrame.mSize_byte)
+        {
+            mStats->mRx_TooShort ++;
+            Drop(1);
+            continue;
+        }
+
+        if (0 != (mFrame.mVersion & 0xfc))
+        {
+            mStats->mRx_Version ++;
+            mStats->mRx_Version_Last = mFrame.mVersion;
+            Drop(1);
+            continue;
+        }
+
+        if (mFrame.mSize_byte > lSize_byte)
+        {
+            return NULL;
+        }
+
+        // ===== Footer =====================================================
+        unsigned int lData_byte = mFrame.mSize_byte - DJI_FOOTER_SIZE_byte;
+
+        Copy(mFrame_Buffer, mFrame.mSize_byte);
+
+        uint32_t lCRC32;
+
+        memcpy(&lCRC32, mFrame_Buffer + lData_byte, sizeof(lCRC32));
+
+        if (DJI_CRC_32(mFrame_Buffer, lData_byte) != lCRC32)
+        {
+            if (Waiting(mFrame.mSize_byte))
+            {
+                return NULL;
+            }
+
+            mStats->mRx_CRC32 ++;
+            Drop(1);
+            continue;
+        }
+
+        Drop(mFrame.mSize_byte);
+
+        // Short fragments left alone belong to a frame already dropped.
+        if (mInsert == mHead)
+        {
+            Reset();
+        }
+
+        mStats->mRx_frame ++;
+
+        return &mFrame;
+    }
+}
+
+void DJI_Reassembler::Push(const uint8_t * aIn, unsigned int aSize_byte)
+{
+    assert(NULL != aIn);
+    assert(DJI_REASSEMBLER_SIZE_byte >= aSize_byte);
+
+    assert(NULL != mStats);
+
+    mStats->mRx_byte += aSize_byte;
+
+    unsigned int lFree_byte = DJI_REASSEMBLER_SIZE_byte - Size_Get();
+    if (lFree_byte < aSize_byte)
+    {
+        mStats->mRx_Overflow ++;
+        Drop(aSize_byte - lFree_byte);
+    }
+
+    // The waiting short fragments move after the new one.
+    unsigned int lWaiting_byte = mTail - mInsert;
+    if (0 < lWaiting_byte)
+    {
+        mStats->mRx_Unordered ++;
+
+        for (unsigned int i = lWaiting_byte; 0 < i; i--)
+        {
+            mBuffer[(mInsert + aSize_byte + i - 1) & MASK] = mBuffer[(mInsert + i - 1) & MASK];
+        }
+    }
+
+    Write(mInsert, aIn, aSize_byte);
+
+    mTail += aSize_byte;
+
+    if ((!mReorder) || (DJI_REASSEMBLER_FRAGMENT_byte <= aSize_byte))
+    {
+        mInsert += aSize_byte;
+    }
+}
+
+void DJI_Reassembler::Reset()
+{
+    mHead   = mTail;
+    mInsert = mTail;
+}
+
+unsigned int DJI_Reassembler::Size_Get() const
+{
+    assert(DJI_REASSEMBLER_SIZE_byte >= mTail - mHead);
+
+    return mTail - mHead;
+}
+
+void DJI_Reassembler::Display(FILE * aOut) const
+{
+    assert(NULL != aOut);
+
+    unsigned int lSize_byte = Size_Get();
+
+    for (unsigned int i = 0; i < lSize_byte; i++)
+    {
+        fprintf(aOut, " %02x", mBuffer[(mHead + i) & MASK]);
+    }
+
+    fprintf(aOut, "\n");
+}
+
+// Private
+// //////////////////////////////////////////////////////////////////////////
+
+void DJI_Reassembler::Copy(uint8_t * aOut, unsigned int aSize_byte) const
+{
+    assert(NULL != aOut);
+    assert(Size_Get() >= aSize_byte);
+
+    unsigned int lOffset = mHead & MASK;
+    unsigned int lFirst_byte = DJI_REASSEMBLER_SIZE_byte - lOffset;
+
+    if (lFirst_byte >= aSize_byte)
+    {
+        memcpy(aOut, mBuffer + lOffset, aSize_byte);
+    }
+    else
+    {
+        memcpy(aOut, mBuffer + lOffset, lFirst_byte);
+        memcpy(aOut + lFirst_byte, mBuffer, aSize_byte - lFirst_byte);
+    }
+}
+
+void DJI_Reassembler::Drop(unsigned int aSize_byte)
+{
+    assert(Size_Get() >= aSize_byte);
+
+    mHead += aSize_byte;
+
+    if (mTail - mHead < mTail - mInsert)
+    {
+        mInsert = mHead;
+    }
+}
+
+bool DJI_Reassembler::Waiting(unsigned int aSize_byte) const
+{
+    assert(mInsert - mHead <= mTail - mHead);
+
+    return mInsert - mHead < aSize_byte;
+}
+
+void DJI_Reassembler::Write(unsigned int aIndex, const uint8_t * aIn, unsigned int aSize_byte)
+{
+    assert(NULL != aIn);
+    assert(DJI_REASSEMBLER_SIZE_byte >= aSize_byte);
+
+    unsigned int lOffset = aIndex & MASK;
+    unsigned int lFirst_byte = DJI_REASSEMBLER_SIZE_byte - lOffset;
+
+    if (lFirst_byte >= aSize_byte)
+    {
+        memcpy(mBuffer + lOffset, aIn, aSize_byte);
+    }
+    else
+    {
+        memcpy(mBuffer + lOffset, aIn, lFirst_byte);
+        memcpy(mBuffer, aIn + lFirst_byte, aSize_byte - lFirst_byte);
+    }
+}
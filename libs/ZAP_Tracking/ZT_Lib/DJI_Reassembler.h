@@ -0,0 +1,112 @@
+
+// Author  KMS - Martin Dubois, P. Eng.
+// Client  ZAP
+// Product Tacking
+// File    ZT_Lib/DJI_Reassembler.h
+
+#pragma once
+
+// ===== Includes ===========================================================
+#include <ZT/Result.h>
+
+// ===== ZT_Lib =============================================================
+#include "DJI.h"
+#include "Stats.h"
+
+// Constants
+/////////////////////////////////////////////////////////////////////////////
+
+// Must be a power of 2
+#define DJI_REASSEMBLER_SIZE_byte (256)
+
+#define DJI_REASSEMBLER_FRAME_MAX_byte (128)
+
+// The size of a CAN fragment in the middle of a frame
+#define DJI_REASSEMBLER_FRAGMENT_byte (8)
+
+// Class
+/////////////////////////////////////////////////////////////////////////////
+
+// Streaming reassembler of the DJI frames received in CAN fragments. The
+// bytes go in a circular buffer. Next looks for the SOF, verifies the
+// header as soon as its 12 bytes are there and the CRC-32 once the frame is
+// complete. When a verification fails, only the SOF is dropped and the
+// search restarts at the next byte, so a corrupted or partial frame does
+// not cost the frames following it.
+//
+// The footer of a frame goes in its own fragment, so the end of the data
+// and the footer can both be shorter than 8 bytes. The gimbal delivers the
+// footer first. Push keeps the short fragments after the fragments
+// received later, as the receiver always did. A reply arriving as
+// [8][4][6] is rebuilt as [8][6][4]. A verification reaching the waiting
+// short fragments waits for the next fragment instead of failing.
+class DJI_Reassembler
+{
+
+public:
+
+    // Insert a fragment in a frame being rebuilt, as Push does
+    //
+    // aFrame       [---;RW-] The frame being rebuilt
+    // aSize_byte   [---;RW-] The size of the frame being rebuilt
+    // aInsert_byte [---;RW-] Where the next fragment goes, 0 at the start
+    //                        of the frame
+    //
+    // Return  The offset of the fragment in the frame
+    static unsigned int Insert(uint8_t * aFrame, unsigned int * aSize_byte, unsigned int * aInsert_byte, const uint8_t * aIn, unsigned int aIn_byte);
+
+    // aStats   [---;RW-] The Rx counters
+    // aReorder  false for the fragments sent in order, as the gimbal
+    //           receives them
+    DJI_Reassembler(Stats * aStats, bool aReorder = true);
+
+    // Return NULL when more bytes are needed. The returned frame remains
+    // valid until the next call to Next or Reset.
+    const DJI_Frame * Next();
+
+    // When the buffer overflows, the oldest bytes are dropped. The receiver
+    // calls Next after each fragment, the short fragments of a frame
+    // otherwise wait after the fragments of the next frame.
+    void Push(const uint8_t * aIn, unsigned int aSize_byte);
+
+    void Reset();
+
+    unsigned int Size_Get() const;
+
+    void Display(FILE * aOut) const;
+
+private:
+
+    DJI_Reassembler(const DJI_Reassembler &);
+
+    const DJI_Reassembler & operator = (const DJI_Reassembler &);
+
+    void Copy(uint8_t * aOut, unsigned int aSize_byte) const;
+
+    void Drop(unsigned int aSize_byte);
+
+    // Return true when the first aSize_byte bytes include short fragments
+    // still waiting for the fragment preceding them
+    bool Waiting(unsigned int aSize_byte) const;
+
+    void Write(unsigned int aIndex, const uint8_t * aIn, unsigned int aSize_byte);
+
+    uint8_t mBuffer[DJI_REASSEMBLER_SIZE_byte];
+
+    // Free running indexes. The bytes between mInsert and mTail are the
+    // short fragments waiting for the fragments preceding them.
+    unsigned int mHead;
+    unsigned int mInsert;
+    unsigned int mTail;
+
+    bool mReorder;
+
+    union
+    {
+        DJI_Frame mFrame;
+        uint8_t   mFrame_Buffer[DJI_REASSEMBLER_FRAME_MAX_byte];
+    };
+
+    Stats * mStats;
+
+};
@@ -0,0 +1,135 @@
+
+// Author  KMS - Martin Dubois, P. Eng.
+// Client  ZAP
+// Product Tacking
+// File    ZT_Lib/DJI_Setpoint.cpp
+
+#include "Component.h"
+
+// ===== ZT_Lib =============================================================
+#include "DJI_Setpoint.h"
+
+// Public
+// //////////////////////////////////////////////////////////////////////////
+
+DJI_Setpoint::DJI_Setpoint() : mOrder(0)
+{
+    for (unsigned int i = 0; i < KIND_QTY; i++)
+    {
+        mSlots[i].mSequence = 0;
+        mSlots[i].mOrder    = 0;
+
+        memset(&mSlots[i].mValue, 0, sizeof(mSlots[i].mValue));
+
+        mSequence_Read[i] = 0;
+    }
+}
+
+// The writer never waits for the reader nor for the writers of the other
+// kinds.
+void DJI_Setpoint::Publish(const Value & aIn)
+{
+    assert(KIND_QTY > aIn.mKind);
+
+    Slot & lSlot = mSlots[aIn.mKind];
+
+    unsigned int lSeq = lSlot.mSequence.load(std::memory_order_relaxed);
+
+    lSlot.mSequence.store(lSeq + 1, std::memory_order_relaxed);
+
+    std::atomic_thread_fence(std::memory_order_release);
+
+    lSlot.mOrder = mOrder.fetch_add(1, std::memory_order_relaxed);
+    lSlot.mValue = aIn;
+
+    lSlot.mSequence.store(lSeq + 2, std::memory_order_release);
+}
+
+bool DJI_Setpoint::Read(Value * aOut)
+{
+    assert(NULL != aOut);
+
+    bool         lNew  [KIND_QTY];
+    unsigned int lOrder[KIND_QTY];
+    unsigned int lSeq  [KIND_QTY];
+    Value        lValue[KIND_QTY];
+
+    for (unsigned int i = 0; i < KIND_QTY; i++)
+    {
+        lNew[i] = Slot_Read(static_cast<Kind>(i), lValue + i, lOrder + i, lSeq + i);
+    }
+
+    // The order wraps around, only the difference counts.
+    if (lNew[KIND_NONE])
+    {
+        for (unsigned int i = 0; i < KIND_QTY; i++)
+        {
+            if (lNew[i] && (0 > static_cast<int>(lOrder[i] - lOrder[KIND_NONE])))
+            {
+                lNew[i] = false;
+                mSequence_Read[i] = lSeq[i];
+            }
+        }
+    }
+
+    unsigned int lKind = KIND_QTY;
+
+    for (unsigned int i = 0; i < KIND_QTY; i++)
+    {
+        if (lNew[i] && ((KIND_QTY == lKind) || (0 > static_cast<int>(lOrder[i] - lOrder[lKind]))))
+        {
+            lKind = i;
+        }
+    }
+
+    if (KIND_QTY == lKind)
+    {
+        return false;
+    }
+
+    *aOut = lValue[lKind];
+
+    mSequence_Read[lKind] = lSeq[lKind];
+
+    return true;
+}
+
+// Private
+// //////////////////////////////////////////////////////////////////////////
+
+// Return false when the slot did not change since the last value read
+bool DJI_Setpoint::Slot_Read(Kind aKind, Value * aOut, unsigned int * aOrder, unsigned int * aSequence)
+{
+    assert(KIND_QTY > aKind);
+    assert(NULL != aOut);
+    assert(NULL != aOrder);
+    assert(NULL != aSequence);
+
+    Slot & lSlot = mSlots[aKind];
+
+    for (;;)
+    {
+        unsigned int lBefore = lSlot.mSequence.load(std::memory_order_acquire);
+        if (mSequence_Read[aKind] == lBefore)
+        {
+            return false;
+        }
+
+        if (0 == (lBefore & 1))
+        {
+            unsigned int lOrder = lSlot.mOrder;
+            Value        lValue = lSlot.mValue;
+
+            std::atomic_thread_fence(std::memory_order_acquire);
+
+            if (lSlot.mSequence.load(std::memory_order_relaxed) == lBefore)
+            {
+                *aOrder    = lOrder;
+                *aOut      = lValue;
+                *aSequence = lBefore;
+
+                return true;
+            }
+        }
+    }
+}
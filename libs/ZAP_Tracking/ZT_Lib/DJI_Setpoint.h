@@ -0,0 +1,87 @@
+
+// Author  KMS - Martin Dubois, P. Eng.
+// Client  ZAP
+// Product Tacking
+// File    ZT_Lib/DJI_Setpoint.h
+
+#pragma once
+
+// ===== C++ ================================================================
+#include <atomic>
+
+// ===== Includes ===========================================================
+#include <ZT/IGimbal.h>
+
+// Class
+/////////////////////////////////////////////////////////////////////////////
+
+// Latest-wins mailbox for the motion setpoint, one slot per kind. Users
+// threads overwrite the value of a kind, the worker thread reads the new
+// values at each tick, in the order of their publication. The sequence
+// number of a slot works as a seqlock: it is odd while the writer copies
+// the value and the reader retries when it changes during the copy. Like
+// the motion state of Gimbal, a slot has only one writer at a time.
+class DJI_Setpoint
+{
+
+public:
+
+    typedef enum
+    {
+        KIND_NONE,
+        KIND_POSITION,
+        KIND_SPEED,
+
+        KIND_QTY
+    }
+    Kind;
+
+    typedef struct
+    {
+        Kind         mKind;
+        unsigned int mDuration_ms;
+        unsigned int mFlags;
+
+        ZT::IGimbal::Position mPosition;
+        ZT::IGimbal::Speed    mSpeed;
+
+        uint64_t mPublished_us;
+    }
+    Value;
+
+    DJI_Setpoint();
+
+    // Thread  Users
+    void Publish(const Value & aIn);
+
+    // Thread  Worker
+    //
+    // aOut [---;-W-] The oldest value not read yet. A KIND_NONE value
+    //                drops the values published before it.
+    //
+    // Return false when nothing was published since the previous call. In
+    // this case, aOut is not modified.
+    bool Read(Value * aOut);
+
+private:
+
+    typedef struct
+    {
+        std::atomic<unsigned int> mSequence;
+
+        unsigned int mOrder;
+        Value        mValue;
+    }
+    Slot;
+
+    bool Slot_Read(Kind aKind, Value * aOut, unsigned int * aOrder, unsigned int * aSequence);
+
+    // The order of the publications, it goes across the slots
+    std::atomic<unsigned int> mOrder;
+
+    Slot mSlots[KIND_QTY];
+
+    // ===== Worker =========================================================
+    unsigned int mSequence_Read[KIND_QTY];
+
+};
@@ -6,7 +6,11 @@
 
 #include "Component.h"
 
+// ===== C++ ================================================================
+#include <atomic>
+
 // ===== ZT_Lib =============================================================
+#include "DJI_Command.h"
 #include "Gimbal.h"
 
 #include "DJI_Transaction.h"
@@ -14,12 +18,22 @@
 // Static variables
 // //////////////////////////////////////////////////////////////////////////
 
-static unsigned int sSerial = 0;
+// User threads and the worker threads of all the gimbals start
+// transactions concurrently. The serial wraps on 16 bits like the field of
+// the frame.
+static std::atomic<uint16_t> sSerial(0);
+
+// Static function declarations
+// //////////////////////////////////////////////////////////////////////////
+
+// Return the control bit of the axis when it is ignored, 0 otherwise
+template <unsigned int OFFSET, uint8_t IGNORED>
+static uint8_t Position_Axis(DJI_Frame * aOut, double aAngle_deg, unsigned int aIgnore);
 
 // Public
 // //////////////////////////////////////////////////////////////////////////
 
-DJI_Transaction::DJI_Transaction() : mCode(0), mReceiver(NULL), mRxExpected_byte(0)
+DJI_Transaction::DJI_Transaction() : mCode(0), mReceiver(NULL), mPriority(0), mRxExpected_byte(0), mRxTimeout_tick(0)
 {
     Reset();
 }
@@ -32,17 +46,14 @@ void DJI_Transaction::Complete(ZT::Result aResult)
 
     mResult = aResult;
 
+    mTimer.Stop_Z0();
+
     if (NULL != mReceiver)
     {
         mReceiver->ProcessMessage(this, mCode, NULL);
     }
 }
 
-void DJI_Transaction::Frame_Angle_Set(unsigned int aOffset_byte, double aIn_deg)
-{
-    mTxFrame.Angle_Set(aOffset_byte, aIn_deg);
-}
-
 uint8_t DJI_Transaction::Frame_Data_Get(unsigned int aOffset_byte) const
 {
     assert(sizeof(mTxFrame.mData) > aOffset_byte);
@@ -57,31 +68,47 @@ DJI_Frame * DJI_Transaction::Frame_Get()
 
 void DJI_Transaction::Frame_Init_ANGLE_GET()
 {
-    Frame_Init(3, DJI_CMD_TYPE_DO_REPLY, DJI_CMD_SET_DEFAULT, DJI_CMD_ANGLE_GET);
+    DJI_Command_ANGLE_GET::Init(&mTxFrame, ++ sSerial);
 
-    mTxFrame.mData[2] = 0x01;
+    DJI_Command_ANGLE_GET::Byte_Set<2>(&mTxFrame, 0x01);
+
+    DJI_Command_ANGLE_GET::Seal(&mTxFrame);
 }
 
 void DJI_Transaction::Frame_Init_ANGLE_LIMIT_GET()
 {
-    Frame_Init(3, DJI_CMD_TYPE_DO_REPLY, DJI_CMD_SET_DEFAULT, DJI_CMD_ANGLE_LIMIT_GET);
+    DJI_Command_ANGLE_LIMIT_GET::Init(&mTxFrame, ++ sSerial);
+
+    DJI_Command_ANGLE_LIMIT_GET::Byte_Set<2>(&mTxFrame, 0x01);
 
-    mTxFrame.mData[2] = 0x01;
+    DJI_Command_ANGLE_LIMIT_GET::Seal(&mTxFrame);
 }
 
+// The layout of the reply, after the control byte: pitch, yaw, roll.
 void DJI_Transaction::Frame_Init_ANGLE_LIMIT_SET(const ZT::IGimbal::Config & aConfig)
 {
-    Frame_Init(8, DJI_CMD_TYPE_DO_REPLY, DJI_CMD_SET_DEFAULT, DJI_CMD_ANGLE_LIMIT_SET);
+    typedef DJI_Command_ANGLE_LIMIT_SET C;
+
+    uint8_t lMax[ZT::IGimbal::AXIS_QTY];
+    uint8_t lMin[ZT::IGimbal::AXIS_QTY];
 
     FOR_EACH_AXIS(a)
     {
-        static const unsigned int OFFSETS[ZT::IGimbal::AXIS_QTY] = { 2, 7, 5 };
-
-        mTxFrame.mData[OFFSETS[a]    ] = (0.0 < aConfig.mAxis[a].mMax_deg) ?   aConfig.mAxis[a].mMax_deg : 0.0;
-        mTxFrame.mData[OFFSETS[a] + 1] = (0.0 > aConfig.mAxis[a].mMin_deg) ? - aConfig.mAxis[a].mMin_deg : 0.0;
+        lMax[a] = (0.0 < aConfig.mAxis[a].mMax_deg) ?   aConfig.mAxis[a].mMax_deg : 0.0;
+        lMin[a] = (0.0 > aConfig.mAxis[a].mMin_deg) ? - aConfig.mAxis[a].mMin_deg : 0.0;
     }
 
-    mTxFrame.mData[2] = 0x01;
+    C::Init(&mTxFrame, ++ sSerial);
+
+    C::Byte_Set<2>(&mTxFrame, 0x01);
+    C::Byte_Set<3>(&mTxFrame, lMax[ZT::IGimbal::AXIS_PITCH]);
+    C::Byte_Set<4>(&mTxFrame, lMin[ZT::IGimbal::AXIS_PITCH]);
+    C::Byte_Set<5>(&mTxFrame, lMax[ZT::IGimbal::AXIS_YAW  ]);
+    C::Byte_Set<6>(&mTxFrame, lMin[ZT::IGimbal::AXIS_YAW  ]);
+    C::Byte_Set<7>(&mTxFrame, lMax[ZT::IGimbal::AXIS_ROLL ]);
+    C::Byte_Set<8>(&mTxFrame, lMin[ZT::IGimbal::AXIS_ROLL ]);
+
+    C::Seal(&mTxFrame);
 }
 
 void DJI_Transaction::Frame_Init_FOCUS_CAL(ZT::IGimbal::Operation aOperation)
@@ -90,11 +117,12 @@ void DJI_Transaction::Frame_Init_FOCUS_CAL(ZT::IGimbal::Operation aOperation)
 
     assert(ZT::IGimbal::OPERATION_QTY > aOperation);
 
-    Frame_Init(5, DJI_CMD_TYPE_NO_REPLY, DJI_CMD_SET_DEFAULT, DJI_CMD_FOCUS);
+    DJI_Command_FOCUS_CAL::Init(&mTxFrame, ++ sSerial);
+
+    DJI_Command_FOCUS_CAL::Byte_Set<2>(&mTxFrame, DJI_CMD_FOCUS_CAL);
+    DJI_Command_FOCUS_CAL::Byte_Set<4>(&mTxFrame, OP_CODES[aOperation]);
 
-    mTxFrame.mData[2] = DJI_CMD_FOCUS_CAL;
-        
-    mTxFrame.mData[4] = OP_CODES[aOperation];
+    DJI_Command_FOCUS_CAL::Seal(&mTxFrame);
 }
 
 void DJI_Transaction::Frame_Init_FOCUS_SET(double aValue_pc)
@@ -107,71 +135,69 @@ void DJI_Transaction::Frame_Init_FOCUS_SET(double aValue_pc)
     lValue /= 100.0;
     lValue *= 4095;
 
-    int16_t lValueInt16 = lValue;
+    DJI_Command_FOCUS_SET::Init(&mTxFrame, ++ sSerial);
 
-    Frame_Init(7, DJI_CMD_TYPE_NO_REPLY, DJI_CMD_SET_DEFAULT, DJI_CMD_FOCUS);
+    DJI_Command_FOCUS_SET::Byte_Set <2>(&mTxFrame, DJI_CMD_FOCUS_SET);
+    DJI_Command_FOCUS_SET::Byte_Set <4>(&mTxFrame, 0x02);
+    DJI_Command_FOCUS_SET::Int16_Set<5>(&mTxFrame, lValue);
 
-    mTxFrame.mData[2] = DJI_CMD_FOCUS_SET;
-    mTxFrame.mData[4] = 0x02;
-    mTxFrame.mData[5] = lValueInt16 & 0xff;
-    mTxFrame.mData[6] = lValueInt16 >> 8;
+    DJI_Command_FOCUS_SET::Seal(&mTxFrame);
 }
 
 void DJI_Transaction::Frame_Init_MOTOR_STIFFNESS_GET()
 {
-    Frame_Init(3, DJI_CMD_TYPE_DO_REPLY, DJI_CMD_SET_DEFAULT, DJI_CMD_MOTOR_STIFFNESS_GET);
+    DJI_Command_MOTOR_STIFFNESS_GET::Init(&mTxFrame, ++ sSerial);
 
-    mTxFrame.mData[2] = 0x01;
+    DJI_Command_MOTOR_STIFFNESS_GET::Byte_Set<2>(&mTxFrame, 0x01);
+
+    DJI_Command_MOTOR_STIFFNESS_GET::Seal(&mTxFrame);
 }
 
 void DJI_Transaction::Frame_Init_MOTOR_STIFFNESS_SET(const ZT::IGimbal::Config & aConfig)
 {
-    Frame_Init(6, DJI_CMD_TYPE_DO_REPLY, DJI_CMD_SET_DEFAULT, DJI_CMD_MOTOR_STIFFNESS_SET);
+    typedef DJI_Command_MOTOR_STIFFNESS_SET C;
 
-    FOR_EACH_AXIS(a)
-    {
-        mTxFrame.mData[3 + a] = aConfig.mAxis[a].mStiffness_pc;
-    }
+    C::Init(&mTxFrame, ++ sSerial);
 
-    mTxFrame.mData[2] = 0x01;
+    C::Byte_Set<2>(&mTxFrame, 0x01);
+    C::Byte_Set<3>(&mTxFrame, aConfig.mAxis[ZT::IGimbal::AXIS_PITCH].mStiffness_pc);
+    C::Byte_Set<4>(&mTxFrame, aConfig.mAxis[ZT::IGimbal::AXIS_ROLL ].mStiffness_pc);
+    C::Byte_Set<5>(&mTxFrame, aConfig.mAxis[ZT::IGimbal::AXIS_YAW  ].mStiffness_pc);
+
+    C::Seal(&mTxFrame);
 }
 
+// The angles of the ignored axes stay at 0.
 void DJI_Transaction::Frame_Init_POSITION_SET(const ZT::IGimbal::Position & aIn, unsigned int aFlags, unsigned int aDuration_ms)
 {
-    Frame_Init(10, DJI_CMD_TYPE_NO_REPLY, DJI_CMD_SET_DEFAULT, DJI_CMD_POSITION_SET);
+    typedef DJI_Command_POSITION_SET C;
 
-    mTxFrame.mData[8] = 0x01;
+    uint8_t lControl = 0x01;
 
-    FOR_EACH_AXIS(a)
-    {
-        static const uint8_t      FLAGS  [ZT::IGimbal::AXIS_QTY] = { 0x08, 0x04, 0x02 };
-        static const unsigned int OFFSETS[ZT::IGimbal::AXIS_QTY] = { 6, 4, 2 };
-
-        if (0 == (aFlags & ZT_FLAG_IGNORE(a)))
-        {
-            Frame_Angle_Set(OFFSETS[a], aIn.mAxis_deg[a]);
-        }
-        else
-        {
-            mTxFrame.mData[8] |= FLAGS[a];
-        }
-    }
+    C::Init(&mTxFrame, ++ sSerial);
+
+    lControl |= Position_Axis<6, 0x08>(&mTxFrame, aIn.mAxis_deg[ZT::IGimbal::AXIS_PITCH], aFlags & ZT_FLAG_IGNORE_PITCH);
+    lControl |= Position_Axis<4, 0x04>(&mTxFrame, aIn.mAxis_deg[ZT::IGimbal::AXIS_ROLL ], aFlags & ZT_FLAG_IGNORE_ROLL );
+    lControl |= Position_Axis<2, 0x02>(&mTxFrame, aIn.mAxis_deg[ZT::IGimbal::AXIS_YAW  ], aFlags & ZT_FLAG_IGNORE_YAW  );
 
-    mTxFrame.mData[9] = aDuration_ms / 100;
+    C::Byte_Set<8>(&mTxFrame, lControl);
+    C::Byte_Set<9>(&mTxFrame, aDuration_ms / 100);
+
+    C::Seal(&mTxFrame);
 }
 
 void DJI_Transaction::Frame_Init_SPEED_SET(const ZT::IGimbal::Speed & aSpeed)
 {
-    Frame_Init(9, DJI_CMD_TYPE_NO_REPLY, DJI_CMD_SET_DEFAULT, DJI_CMD_SPEED_SET);
+    typedef DJI_Command_SPEED_SET C;
 
-    FOR_EACH_AXIS(a)
-    {
-        unsigned int OFFSETS[ZT::IGimbal::AXIS_QTY] = { 6, 4, 2 };
+    C::Init(&mTxFrame, ++ sSerial);
 
-        mTxFrame.Speed_Set(OFFSETS[a], aSpeed.mAxis_deg_s[a]);
-    }
+    C::Speed_Set<6>(&mTxFrame, aSpeed.mAxis_deg_s[ZT::IGimbal::AXIS_PITCH]);
+    C::Speed_Set<4>(&mTxFrame, aSpeed.mAxis_deg_s[ZT::IGimbal::AXIS_ROLL ]);
+    C::Speed_Set<2>(&mTxFrame, aSpeed.mAxis_deg_s[ZT::IGimbal::AXIS_YAW  ]);
+    C::Byte_Set <8>(&mTxFrame, 0x88);
 
-    mTxFrame.mData[8] = 0x88;
+    C::Seal(&mTxFrame);
 }
 
 void DJI_Transaction::Frame_Init_TLV_SET(double aSpeed_pc)
@@ -179,25 +205,31 @@ void DJI_Transaction::Frame_Init_TLV_SET(double aSpeed_pc)
     assert(0.0 <= aSpeed_pc);
     assert(100.0 >= aSpeed_pc);
 
-    Frame_Init(5, DJI_CMD_TYPE_DO_REPLY, DJI_CMD_SET_DEFAULT, DJI_CMD_TLV_SET);
+    DJI_Command_TLV_SET::Init(&mTxFrame, ++ sSerial);
 
-    mTxFrame.mData[2] = 0x75;
-    mTxFrame.mData[3] = 1;
-    mTxFrame.mData[4] = static_cast<uint8_t>(aSpeed_pc / 100.0 * 29.0 + 1);
+    DJI_Command_TLV_SET::Byte_Set<2>(&mTxFrame, 0x75);
+    DJI_Command_TLV_SET::Byte_Set<3>(&mTxFrame, 1);
+    DJI_Command_TLV_SET::Byte_Set<4>(&mTxFrame, static_cast<uint8_t>(aSpeed_pc / 100.0 * 29.0 + 1));
+
+    DJI_Command_TLV_SET::Seal(&mTxFrame);
 }
 
 void DJI_Transaction::Frame_Init_TRACK_SWITCH()
 {
-    Frame_Init(3, DJI_CMD_TYPE_NO_REPLY, DJI_CMD_SET_DEFAULT, DJI_CMD_TRACK_SWITCH);
+    DJI_Command_TRACK_SWITCH::Init(&mTxFrame, ++ sSerial);
+
+    DJI_Command_TRACK_SWITCH::Byte_Set<2>(&mTxFrame, 0x03);
 
-    mTxFrame.mData[2] = 0x03;
+    DJI_Command_TRACK_SWITCH::Seal(&mTxFrame);
 }
 
 void DJI_Transaction::Frame_Init_VERSION()
 {
-    Frame_Init(6, DJI_CMD_TYPE_DO_REPLY, DJI_CMD_SET_DEFAULT, DJI_CMD_VERSION);
+    DJI_Command_VERSION::Init(&mTxFrame, ++ sSerial);
+
+    DJI_Command_VERSION::Byte_Set<2>(&mTxFrame, 1);
 
-    mTxFrame.mData[2] = 1;
+    DJI_Command_VERSION::Seal(&mTxFrame);
 }
 
 bool DJI_Transaction::IsOK() const
@@ -230,9 +262,24 @@ void DJI_Transaction::Prepare(unsigned int aRxExpected_byte)
     mRxExpected_byte = DJI_FRAME_TOTAL_SIZE(aRxExpected_byte) - DJI_FOOTER_SIZE_byte;
 }
 
+unsigned int DJI_Transaction::Priority_Get() const
+{
+    return mPriority;
+}
+
+void DJI_Transaction::Priority_Set(unsigned int aIn)
+{
+    mPriority = aIn;
+}
+
 void DJI_Transaction::Reset()
 {
-    mResult = ZT::ZT_RESULT_INVALID;
+    mResult    = ZT::ZT_RESULT_INVALID;
+    mRetry     = 0;
+    mRetry_Max = 0;
+
+    mTime_Queued_us = 0;
+    mTime_Sent_us   = 0;
 }
 
 ZT::Result DJI_Transaction::Result_Get() const
@@ -247,11 +294,44 @@ void DJI_Transaction::Result_Set(ZT::Result aResult)
     mResult = aResult;
 }
 
+unsigned int DJI_Transaction::Retry_Get() const
+{
+    return mRetry;
+}
+
+void DJI_Transaction::Retry_Set(unsigned int aMax)
+{
+    mRetry     = 0;
+    mRetry_Max = aMax;
+}
+
+bool DJI_Transaction::Retry_Use()
+{
+    if (mRetry_Max <= mRetry)
+    {
+        return false;
+    }
+
+    mRetry ++;
+
+    return true;
+}
+
 unsigned int DJI_Transaction::RxExpected_Get() const
 {
     return mRxExpected_byte;
 }
 
+uint16_t DJI_Transaction::Serial_Get() const
+{
+    return mTxFrame.mSerial;
+}
+
+unsigned int DJI_Transaction::RxTimeout_Get() const
+{
+    return mRxTimeout_tick;
+}
+
 void DJI_Transaction::RxTimeout_Set(unsigned int aIn_tick)
 {
     mRxTimeout_tick = aIn_tick;
@@ -265,16 +345,29 @@ void DJI_Transaction::Started(ZT::Result aResult)
     }
 }
 
-void DJI_Transaction::Tick()
+ZT_Lib::Timer * DJI_Transaction::Timer_Get()
 {
-    switch (mRxTimeout_tick)
-    {
-    case 0: break;
+    return & mTimer;
+}
 
-    case 1: Complete(ZT::ZT_ERROR_TIMEOUT); break;
+uint64_t DJI_Transaction::Time_Queued_Get() const
+{
+    return mTime_Queued_us;
+}
 
-    default: mRxTimeout_tick --;
-    }
+void DJI_Transaction::Time_Queued_Set(uint64_t aIn_us)
+{
+    mTime_Queued_us = aIn_us;
+}
+
+uint64_t DJI_Transaction::Time_Sent_Get() const
+{
+    return mTime_Sent_us;
+}
+
+void DJI_Transaction::Time_Sent_Set(uint64_t aIn_us)
+{
+    mTime_Sent_us = aIn_us;
 }
 
 ZT::Result DJI_Transaction::Wait(ZT_Lib::Thread * aThread)
@@ -296,10 +389,18 @@ ZT::Result DJI_Transaction::Wait(ZT_Lib::Thread * aThread)
     return lResult;
 }
 
-// Private
+// Static functions
 // //////////////////////////////////////////////////////////////////////////
 
-void DJI_Transaction::Frame_Init(uint8_t aDataSize_byte, uint8_t aCmdType, uint8_t aCmdSet, uint8_t aCmdId)
+template <unsigned int OFFSET, uint8_t IGNORED>
+uint8_t Position_Axis(DJI_Frame * aOut, double aAngle_deg, unsigned int aIgnore)
 {
-    mTxFrame.Init(aDataSize_byte, aCmdType, aCmdSet, aCmdId, ++ sSerial);
+    if (0 != aIgnore)
+    {
+        return IGNORED;
+    }
+
+    DJI_Command_POSITION_SET::Angle_Set<OFFSET>(aOut, aAngle_deg);
+
+    return 0;
 }
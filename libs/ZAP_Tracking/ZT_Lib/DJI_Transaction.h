@@ -25,12 +25,12 @@ public:
 
     void Complete(ZT::Result aResult);
 
-    void Frame_Angle_Set(unsigned int aOffset_byte, double aIn_deg);
-
     uint8_t Frame_Data_Get(unsigned int aOffset_byte) const;
 
     DJI_Frame * Frame_Get();
 
+    // The Frame_Init_* methods give the frame its serial and seal it, it
+    // is ready to send.
     void Frame_Init_ANGLE_GET();
     void Frame_Init_ANGLE_LIMIT_GET();
     void Frame_Init_ANGLE_LIMIT_SET(const ZT::IGimbal::Config & aConfig);
@@ -50,33 +50,78 @@ public:
     void Prepare(ZT::IMessageReceiver * aReceiver, unsigned int aCode, unsigned int aRxExpected_byte);
     void Prepare(unsigned int aRxExpected_byte);
 
+    // A DJI_TransactionQueue::Priority, the retries go back in the queue at
+    // the priority of the first push.
+    unsigned int Priority_Get() const;
+    void         Priority_Set(unsigned int aIn);
+
     void Reset();
 
     ZT::Result Result_Get() const;
     void       Result_Set(ZT::Result aIn);
 
+    // Return the number of retries already used
+    unsigned int Retry_Get() const;
+
+    // aMax  The number of times the transaction can be sent again
+    void Retry_Set(unsigned int aMax);
+
+    // Return false when no retry is left
+    bool Retry_Use();
+
     unsigned int RxExpected_Get() const;
 
-    void RxTimeout_Set(unsigned int aIn_tick);
+    uint16_t Serial_Get() const;
+
+    unsigned int RxTimeout_Get() const;
+    void         RxTimeout_Set(unsigned int aIn_tick);
 
     void Started(ZT::Result aResult);
 
-    void Tick();
+    // The timer of the reply timeout and of the delay before a retry.
+    // Complete stops it.
+    ZT_Lib::Timer * Timer_Get();
+
+    // The time the user queued the transaction, 0 once its frame is staged
+    // or when the worker started it itself.
+    uint64_t Time_Queued_Get() const;
+    void     Time_Queued_Set(uint64_t aIn_us);
 
+    // The time the frame was staged, the start of the round trip
+    uint64_t Time_Sent_Get() const;
+    void     Time_Sent_Set(uint64_t aIn_us);
+
+    // Many transactions can wait at the same time on the condition of
+    // aThread, their completion must wake all the waiters.
+    //
+    // Zone0 of aThread is held
     ZT::Result Wait(ZT_Lib::Thread * aThread);
 
 private:
 
-    void Frame_Init(uint8_t aDataSize_byte, uint8_t aCmdType, uint8_t aCmdSet, uint8_t aCmdId);
+    friend class DJI_TransactionPool;
 
     unsigned int           mCode;
     ZT::IMessageReceiver * mReceiver;
 
+    unsigned int mPriority;
+
     ZT::Result mResult;
 
+    unsigned int mRetry;
+    unsigned int mRetry_Max;
+
     unsigned int mRxExpected_byte;
     unsigned int mRxTimeout_tick;
 
+    uint64_t mTime_Queued_us;
+    uint64_t mTime_Sent_us;
+
+    ZT_Lib::Timer mTimer;
+
     DJI_Frame mTxFrame;
 
+    // ===== DJI_TransactionPool ============================================
+    unsigned int mPool_Next;
+
 };
@@ -0,0 +1,124 @@
+
+// Author  KMS - Martin Dubois, P. Eng.
+// Client  ZAP
+// Product Tacking
+// File    ZT_Lib/DJI_TransactionPool.cpp
+
+#include "Component.h"
+
+// ===== C ==================================================================
+#include <stdlib.h>
+
+// ===== C++ ================================================================
+#include <new>
+
+// ===== ZT_Lib =============================================================
+#include "DJI_TransactionPool.h"
+
+// Constants
+// //////////////////////////////////////////////////////////////////////////
+
+#define CACHE_LINE_byte (64)
+
+#define ENTRY_SIZE_byte ((sizeof(DJI_Transaction) + CACHE_LINE_byte - 1) & ~(CACHE_LINE_byte - 1))
+
+#define INDEX_NONE (0xffffffff)
+
+// Macros
+// //////////////////////////////////////////////////////////////////////////
+
+#define HEAD(I,T) ((static_cast<uint64_t>(T) << 32) | (I))
+
+#define HEAD_INDEX(H) (static_cast<unsigned int>((H) & 0xffffffff))
+#define HEAD_TAG(H)   (static_cast<unsigned int>((H) >> 32))
+
+// Public
+// //////////////////////////////////////////////////////////////////////////
+
+DJI_TransactionPool::DJI_TransactionPool() : mEntries(NULL)
+{
+    void * lMemory;
+
+    int lRet = posix_memalign(&lMemory, CACHE_LINE_byte, ENTRY_SIZE_byte * DJI_TRANSACTION_POOL_SIZE);
+    if (0 != lRet)
+    {
+        throw std::bad_alloc();
+    }
+
+    mEntries = reinterpret_cast<uint8_t *>(lMemory);
+
+    for (unsigned int i = 0; i < DJI_TRANSACTION_POOL_SIZE; i++)
+    {
+        DJI_Transaction * lTr = new (mEntries + ENTRY_SIZE_byte * i) DJI_Transaction;
+
+        lTr->mPool_Next = (DJI_TRANSACTION_POOL_SIZE > (i + 1)) ? i + 1 : INDEX_NONE;
+    }
+
+    mHead.store(HEAD(0, 0));
+}
+
+DJI_TransactionPool::~DJI_TransactionPool()
+{
+    assert(NULL != mEntries);
+
+    free(mEntries);
+}
+
+DJI_Transaction * DJI_TransactionPool::Alloc()
+{
+    uint64_t lHead = mHead.load(std::memory_order_acquire);
+
+    for (;;)
+    {
+        unsigned int lIndex = HEAD_INDEX(lHead);
+        if (INDEX_NONE == lIndex)
+        {
+            return NULL;
+        }
+
+        DJI_Transaction * lResult = Entry_Get(lIndex);
+
+        uint64_t lNext = HEAD(lResult->mPool_Next, HEAD_TAG(lHead) + 1);
+
+        if (mHead.compare_exchange_weak(lHead, lNext, std::memory_order_acquire, std::memory_order_acquire))
+        {
+            // Placement new restores the state of a new transaction without
+            // allocating memory.
+            return new (lResult) DJI_Transaction;
+        }
+    }
+}
+
+void DJI_TransactionPool::Free(DJI_Transaction * aTr)
+{
+    assert(IsOwner(aTr));
+
+    unsigned int lIndex = static_cast<unsigned int>((reinterpret_cast<uint8_t *>(aTr) - mEntries) / ENTRY_SIZE_byte);
+
+    uint64_t lHead = mHead.load(std::memory_order_relaxed);
+
+    do
+    {
+        aTr->mPool_Next = HEAD_INDEX(lHead);
+    }
+    while (!mHead.compare_exchange_weak(lHead, HEAD(lIndex, HEAD_TAG(lHead) + 1), std::memory_order_release, std::memory_order_relaxed));
+}
+
+bool DJI_TransactionPool::IsOwner(const DJI_Transaction * aTr) const
+{
+    const uint8_t * lTr = reinterpret_cast<const uint8_t *>(aTr);
+
+    return (mEntries <= lTr)
+        && ((mEntries + ENTRY_SIZE_byte * DJI_TRANSACTION_POOL_SIZE) > lTr)
+        && (0 == ((lTr - mEntries) % ENTRY_SIZE_byte));
+}
+
+// Private
+// //////////////////////////////////////////////////////////////////////////
+
+DJI_Transaction * DJI_TransactionPool::Entry_Get(unsigned int aIndex) const
+{
+    assert(DJI_TRANSACTION_POOL_SIZE > aIndex);
+
+    return reinterpret_cast<DJI_Transaction *>(mEntries + ENTRY_SIZE_byte * aIndex);
+}
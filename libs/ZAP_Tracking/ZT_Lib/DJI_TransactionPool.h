@@ -0,0 +1,58 @@
+
+// Author  KMS - Martin Dubois, P. Eng.
+// Client  ZAP
+// Product Tacking
+// File    ZT_Lib/DJI_TransactionPool.h
+
+#pragma once
+
+// ===== C++ ================================================================
+#include <atomic>
+
+// ===== ZT_Lib =============================================================
+#include "DJI_Transaction.h"
+
+// Constants
+/////////////////////////////////////////////////////////////////////////////
+
+#define DJI_TRANSACTION_POOL_SIZE (64)
+
+// Class
+/////////////////////////////////////////////////////////////////////////////
+
+// Fixed capacity pool of transactions. The storage is allocated once, by the
+// constructor, and each transaction uses its own cache line(s). The free
+// list is intrusive (DJI_Transaction::mPool_Next) and its head carries a tag
+// to protect the lock-free pop against ABA.
+class DJI_TransactionPool
+{
+
+public:
+
+    DJI_TransactionPool();
+
+    ~DJI_TransactionPool();
+
+    // Thread  Users
+    //
+    // Return NULL when the pool is empty.
+    DJI_Transaction * Alloc();
+
+    // Thread  Users, Worker
+    void Free(DJI_Transaction * aTr);
+
+    bool IsOwner(const DJI_Transaction * aTr) const;
+
+private:
+
+    DJI_TransactionPool(const DJI_TransactionPool &);
+
+    const DJI_TransactionPool & operator = (const DJI_TransactionPool &);
+
+    DJI_Transaction * Entry_Get(unsigned int aIndex) const;
+
+    uint8_t * mEntries;
+
+    std::atomic<uint64_t> mHead;
+
+};
@@ -0,0 +1,129 @@
+
+// Author  KMS - Martin Dubois, P. Eng.
+// Client  ZAP
+// Product Tacking
+// File    ZT_Lib/DJI_TransactionQueue.cpp
+
+#include "Component.h"
+
+// ===== ZT_Lib =============================================================
+#include "DJI_TransactionQueue.h"
+
+// Constants
+// //////////////////////////////////////////////////////////////////////////
+
+#define MASK (DJI_TRANSACTION_QUEUE_SIZE - 1)
+
+// Public
+// //////////////////////////////////////////////////////////////////////////
+
+DJI_TransactionQueue::DJI_TransactionQueue()
+{
+    assert(0 == (DJI_TRANSACTION_QUEUE_SIZE & MASK));
+
+    for (unsigned int p = 0; p < PRIORITY_QTY; p++)
+    {
+        Ring & lRing = mRings[p];
+
+        lRing.mHead = 0;
+        lRing.mTail.store(0);
+
+        for (unsigned int i = 0; i < DJI_TRANSACTION_QUEUE_SIZE; i++)
+        {
+            lRing.mSlots[i].mSequence.store(i);
+            lRing.mSlots[i].mTr = NULL;
+        }
+    }
+}
+
+bool DJI_TransactionQueue::IsEmpty() const
+{
+    for (unsigned int p = 0; p < PRIORITY_QTY; p++)
+    {
+        const Ring & lRing = mRings[p];
+
+        if (lRing.mSlots[lRing.mHead & MASK].mSequence.load(std::memory_order_acquire) == lRing.mHead + 1)
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+DJI_Transaction * DJI_TransactionQueue::Pop()
+{
+    for (unsigned int p = 0; p < PRIORITY_QTY; p++)
+    {
+        DJI_Transaction * lResult = Pop(mRings + p);
+        if (NULL != lResult)
+        {
+            return lResult;
+        }
+    }
+
+    return NULL;
+}
+
+bool DJI_TransactionQueue::Push(DJI_Transaction * aTr, Priority aPriority)
+{
+    assert(NULL != aTr);
+    assert(PRIORITY_QTY > aPriority);
+
+    Ring & lRing = mRings[aPriority];
+
+    unsigned int lPos = lRing.mTail.load(std::memory_order_relaxed);
+    Slot       * lSlot;
+
+    for (;;)
+    {
+        lSlot = lRing.mSlots + (lPos & MASK);
+
+        int lDiff = static_cast<int>(lSlot->mSequence.load(std::memory_order_acquire) - lPos);
+        if (0 == lDiff)
+        {
+            if (lRing.mTail.compare_exchange_weak(lPos, lPos + 1, std::memory_order_relaxed))
+            {
+                break;
+            }
+        }
+        else if (0 > lDiff)
+        {
+            return false;
+        }
+        else
+        {
+            lPos = lRing.mTail.load(std::memory_order_relaxed);
+        }
+    }
+
+    lSlot->mTr = aTr;
+
+    lSlot->mSequence.store(lPos + 1, std::memory_order_release);
+
+    return true;
+}
+
+// Private
+// //////////////////////////////////////////////////////////////////////////
+
+DJI_Transaction * DJI_TransactionQueue::Pop(Ring * aRing)
+{
+    assert(NULL != aRing);
+
+    Slot & lSlot = aRing->mSlots[aRing->mHead & MASK];
+
+    if (lSlot.mSequence.load(std::memory_order_acquire) != aRing->mHead + 1)
+    {
+        return NULL;
+    }
+
+    DJI_Transaction * lResult = lSlot.mTr;
+
+    lSlot.mTr = NULL;
+    lSlot.mSequence.store(aRing->mHead + DJI_TRANSACTION_QUEUE_SIZE, std::memory_order_release);
+
+    aRing->mHead ++;
+
+    return lResult;
+}
@@ -0,0 +1,80 @@
+
+// Author  KMS - Martin Dubois, P. Eng.
+// Client  ZAP
+// Product Tacking
+// File    ZT_Lib/DJI_TransactionQueue.h
+
+#pragma once
+
+// ===== C++ ================================================================
+#include <atomic>
+
+// ===== ZT_Lib =============================================================
+#include "DJI_Transaction.h"
+
+// Constants
+/////////////////////////////////////////////////////////////////////////////
+
+#define DJI_TRANSACTION_QUEUE_SIZE (16)
+
+// Class
+/////////////////////////////////////////////////////////////////////////////
+
+// Bounded multi-producer / single-consumer queue of pending transactions.
+// Users threads push without taking Zone0, the worker thread is the only
+// one to pop. Each priority class uses its own ring.
+class DJI_TransactionQueue
+{
+
+public:
+
+    // The order of this enum is the order the worker empties the rings.
+    // Speed_Set and Position_Set go through DJI_Setpoint, only the stop
+    // command uses the queue to move the gimbal.
+    typedef enum
+    {
+        PRIORITY_STOP,
+        PRIORITY_FOCUS,
+        PRIORITY_CONFIG,
+
+        PRIORITY_QTY
+    }
+    Priority;
+
+    DJI_TransactionQueue();
+
+    bool IsEmpty() const;
+
+    // Thread  Worker
+    DJI_Transaction * Pop();
+
+    // Thread  Users
+    //
+    // Return false when the ring of the priority class is full.
+    bool Push(DJI_Transaction * aTr, Priority aPriority);
+
+private:
+
+    typedef struct
+    {
+        std::atomic<unsigned int> mSequence;
+
+        DJI_Transaction * mTr;
+    }
+    Slot;
+
+    typedef struct
+    {
+        std::atomic<unsigned int> mTail;
+
+        unsigned int mHead;
+
+        Slot mSlots[DJI_TRANSACTION_QUEUE_SIZE];
+    }
+    Ring;
+
+    DJI_Transaction * Pop(Ring * aRing);
+
+    Ring mRings[PRIORITY_QTY];
+
+};
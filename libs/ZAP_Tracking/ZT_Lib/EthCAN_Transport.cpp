@@ -0,0 +1,39 @@
+
+// Author  KMS - Martin Dubois, P. Eng.
+// Client  ZAP
+// Product Tacking
+// File    ZT_Lib/EthCAN_Transport.cpp
+
+#include "Component.h"
+
+// ===== ZT_Lib =============================================================
+#include "EthCAN_Transport.h"
+
+// Public
+// //////////////////////////////////////////////////////////////////////////
+
+EthCAN_Transport::EthCAN_Transport(EthCAN::Device * aDevice) : mDevice(aDevice)
+{
+    assert(NULL != aDevice);
+}
+
+// ===== ITransport =========================================================
+
+EthCAN_Result EthCAN_Transport::Send(const CAN_Batch & aBatch)
+{
+    assert(NULL != mDevice);
+
+    const EthCAN_Frame * lFrames = aBatch.Frames_Get();
+    unsigned int         lCount  = aBatch.Count_Get();
+
+    for (unsigned int i = 0; i < lCount; i++)
+    {
+        EthCAN_Result lRet = mDevice->Send(lFrames[i], EthCAN_FLAG_NO_RESPONSE);
+        if (EthCAN_OK != lRet)
+        {
+            return lRet;
+        }
+    }
+
+    return EthCAN_OK;
+}
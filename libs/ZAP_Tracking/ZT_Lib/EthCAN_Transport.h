@@ -0,0 +1,35 @@
+
+// Author  KMS - Martin Dubois, P. Eng.
+// Client  ZAP
+// Product Tacking
+// File    ZT_Lib/EthCAN_Transport.h
+
+#pragma once
+
+// ===== Import/Includes ====================================================
+#include <EthCAN/Device.h>
+
+// ===== ZT_Lib =============================================================
+#include "ITransport.h"
+
+// Class
+/////////////////////////////////////////////////////////////////////////////
+
+// The EthCAN library only sends one CAN frame per call. This transport is
+// the place to use a vectored write once the library offers one.
+class EthCAN_Transport : public ITransport
+{
+
+public:
+
+    // aDevice  The device is not released by the transport
+    EthCAN_Transport(EthCAN::Device * aDevice);
+
+    // ===== ITransport =====================================================
+    virtual EthCAN_Result Send(const CAN_Batch & aBatch);
+
+private:
+
+    EthCAN::Device * mDevice;
+
+};
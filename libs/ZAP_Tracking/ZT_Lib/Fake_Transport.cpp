@@ -0,0 +1,48 @@
+
+// Author  KMS - Martin Dubois, P. Eng.
+// Client  ZAP
+// Product Tacking
+// File    ZT_Lib/Fake_Transport.cpp
+
+#include "Component.h"
+
+// ===== ZT_Lib =============================================================
+#include "Fake_Transport.h"
+
+// Public
+// //////////////////////////////////////////////////////////////////////////
+
+Fake_Transport::Fake_Transport(Handler aHandler, void * aContext) : mContext(aContext), mHandler(aHandler)
+{
+    Counters_Reset();
+}
+
+void Fake_Transport::Counters_Get(Counters * aOut) const
+{
+    assert(NULL != aOut);
+
+    *aOut = mCounters;
+}
+
+void Fake_Transport::Counters_Reset()
+{
+    memset(&mCounters, 0, sizeof(mCounters));
+}
+
+// ===== ITransport =========================================================
+
+EthCAN_Result Fake_Transport::Send(const CAN_Batch & aBatch)
+{
+    const EthCAN_Frame * lFrames = aBatch.Frames_Get();
+    unsigned int         lCount  = aBatch.Count_Get();
+
+    mCounters.mBatch ++;
+    mCounters.mFrame += lCount;
+
+    for (unsigned int i = 0; i < lCount; i++)
+    {
+        mCounters.mByte += lFrames[i].mDataSize_byte;
+    }
+
+    return (NULL == mHandler) ? EthCAN_OK : mHandler(mContext, aBatch);
+}
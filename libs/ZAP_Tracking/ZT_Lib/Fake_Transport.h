@@ -0,0 +1,49 @@
+
+// Author  KMS - Martin Dubois, P. Eng.
+// Client  ZAP
+// Product Tacking
+// File    ZT_Lib/Fake_Transport.h
+
+#pragma once
+
+// ===== ZT_Lib =============================================================
+#include "ITransport.h"
+
+// Class
+/////////////////////////////////////////////////////////////////////////////
+
+// Local transport, nothing goes on the network. It counts what a real
+// transport would send and passes each batch to an optional handler, for
+// example a simulated gimbal.
+class Fake_Transport : public ITransport
+{
+
+public:
+
+    typedef EthCAN_Result (*Handler)(void * aContext, const CAN_Batch & aBatch);
+
+    typedef struct
+    {
+        unsigned int mBatch;
+        unsigned int mByte;
+        unsigned int mFrame;
+    }
+    Counters;
+
+    // aHandler  NULL to only count
+    Fake_Transport(Handler aHandler = NULL, void * aContext = NULL);
+
+    void Counters_Get(Counters * aOut) const;
+    void Counters_Reset();
+
+    // ===== ITransport =====================================================
+    virtual EthCAN_Result Send(const CAN_Batch & aBatch);
+
+private:
+
+    Counters mCounters;
+
+    void  * mContext;
+    Handler mHandler;
+
+};
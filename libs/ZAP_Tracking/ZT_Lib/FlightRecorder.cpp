@@ -0,0 +1,196 @@
+
+// Author  KMS - Martin Dubois, P. Eng.
+// Client  ZAP
+// Product Tacking
+// File    ZT_Lib/FlightRecorder.cpp
+
+#include "Component.h"
+
+// ===== C ==================================================================
+#include <fcntl.h>
+#include <stdlib.h>
+#include <sys/mman.h>
+#include <time.h>
+#include <unistd.h>
+
+// ===== ZT_Lib =============================================================
+#include "FlightRecorder.h"
+
+// Constants
+/////////////////////////////////////////////////////////////////////////////
+
+#define MASK (FLIGHT_RECORDER_SIZE - 1)
+
+// Static function declarations
+/////////////////////////////////////////////////////////////////////////////
+
+static uint64_t Time_Get_ns();
+
+// Public
+/////////////////////////////////////////////////////////////////////////////
+
+FlightRecorder::FlightRecorder() : mNext(0)
+{
+    for (unsigned int i = 0; i < FLIGHT_RECORDER_SIZE; i++)
+    {
+        mSlots[i].mSequence.store(0, std::memory_order_relaxed);
+    }
+}
+
+// Each writer owns the slot its index gives, so the writers do not wait for
+// each other. The sequence works as a seqlock for Dump.
+void FlightRecorder::Record(FlightRecorder_Type aType, uint32_t aId, uint16_t aSerial, uint32_t aValue, const void * aData, unsigned int aDataSize_byte)
+{
+    assert(FLIGHT_RECORDER_TYPE_QTY > aType);
+
+    uint32_t lIndex = mNext.fetch_add(1, std::memory_order_relaxed);
+
+    Slot & lS = mSlots[lIndex & MASK];
+
+    lS.mSequence.store(0, std::memory_order_relaxed);
+
+    std::atomic_thread_fence(std::memory_order_release);
+
+    FlightRecorder_Record & lR = lS.mRecord;
+
+    if (sizeof(lR.mData) < aDataSize_byte)
+    {
+        aDataSize_byte = sizeof(lR.mData);
+    }
+
+    lR.mTime_ns       = Time_Get_ns();
+    lR.mIndex         = lIndex;
+    lR.mId            = aId;
+    lR.mValue         = aValue;
+    lR.mSerial        = aSerial;
+    lR.mType          = aType;
+    lR.mDataSize_byte = aDataSize_byte;
+
+    if (0 < aDataSize_byte)
+    {
+        assert(NULL != aData);
+
+        memcpy(lR.mData, aData, aDataSize_byte);
+    }
+
+    lS.mSequence.store(lIndex + 1, std::memory_order_release);
+}
+
+ZT::Result FlightRecorder::Dump(const char * aFileName) const
+{
+    assert(NULL != aFileName);
+
+    int lFile = open(aFileName, O_CREAT | O_EXCL | O_NOFOLLOW | O_RDWR, 0644);
+    if (0 > lFile)
+    {
+        return ZT::ZT_ERROR_FILE_OPEN;
+    }
+
+    ZT::Result lResult = Dump_File(lFile);
+    if (ZT::ZT_OK != lResult)
+    {
+        unlink(aFileName);
+    }
+
+    return lResult;
+}
+
+ZT::Result FlightRecorder::Dump_Temp(char * aTemplate) const
+{
+    assert(NULL != aTemplate);
+
+    int lFile = mkstemp(aTemplate);
+    if (0 > lFile)
+    {
+        return ZT::ZT_ERROR_FILE_OPEN;
+    }
+
+    ZT::Result lResult = Dump_File(lFile);
+    if (ZT::ZT_OK != lResult)
+    {
+        unlink(aTemplate);
+    }
+
+    return lResult;
+}
+
+// Private
+/////////////////////////////////////////////////////////////////////////////
+
+// Dump_File closes aFile
+ZT::Result FlightRecorder::Dump_File(int aFile) const
+{
+    assert(0 <= aFile);
+
+    uint32_t lNext  = mNext.load(std::memory_order_acquire);
+    uint32_t lCount = (FLIGHT_RECORDER_SIZE < lNext) ? FLIGHT_RECORDER_SIZE : lNext;
+
+    size_t lSize_byte = sizeof(FlightRecorder_Header) + lCount * sizeof(FlightRecorder_Record);
+
+    ZT::Result lResult = ZT::ZT_ERROR_FILE_OPEN;
+
+    if (0 == ftruncate(aFile, lSize_byte))
+    {
+        void * lMap = mmap(NULL, lSize_byte, PROT_READ | PROT_WRITE, MAP_SHARED, aFile, 0);
+        if (MAP_FAILED != lMap)
+        {
+            FlightRecorder_Header * lHeader  = reinterpret_cast<FlightRecorder_Header *>(lMap);
+            FlightRecorder_Record * lRecords = reinterpret_cast<FlightRecorder_Record *>(lHeader + 1);
+
+            unsigned int lValid = 0;
+
+            for (uint32_t i = lNext - lCount; i != lNext; i++)
+            {
+                const Slot & lS = mSlots[i & MASK];
+
+                uint32_t lBefore = lS.mSequence.load(std::memory_order_acquire);
+                if (i + 1 == lBefore)
+                {
+                    lRecords[lValid] = lS.mRecord;
+
+                    std::atomic_thread_fence(std::memory_order_acquire);
+
+                    if (lS.mSequence.load(std::memory_order_relaxed) == lBefore)
+                    {
+                        lValid ++;
+                    }
+                }
+            }
+
+            memset(lHeader, 0, sizeof(FlightRecorder_Header));
+
+            lHeader->mMagic            = FLIGHT_RECORDER_MAGIC;
+            lHeader->mVersion          = FLIGHT_RECORDER_VERSION;
+            lHeader->mRecord_Count     = lValid;
+            lHeader->mRecord_Size_byte = sizeof(FlightRecorder_Record);
+            lHeader->mDump_ns          = Time_Get_ns();
+
+            int lRet = munmap(lMap, lSize_byte);
+            assert(0 == lRet);
+
+            // The records overwritten during the copy leave room at the end
+            lRet = ftruncate(aFile, sizeof(FlightRecorder_Header) + lValid * sizeof(FlightRecorder_Record));
+            if (0 == lRet)
+            {
+                lResult = ZT::ZT_OK;
+            }
+        }
+    }
+
+    int lRet = close(aFile);
+    assert(0 == lRet);
+
+    return lResult;
+}
+
+// Static functions
+/////////////////////////////////////////////////////////////////////////////
+
+uint64_t Time_Get_ns()
+{
+    timespec lNow;
+
+    clock_gettime(CLOCK_MONOTONIC, &lNow);
+
+    return static_cast<uint64_t>(lNow.tv_sec) * 1000000000 + lNow.tv_nsec;
+}
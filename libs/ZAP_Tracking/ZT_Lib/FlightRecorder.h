@@ -0,0 +1,126 @@
+
+// Author  KMS - Martin Dubois, P. Eng.
+// Client  ZAP
+// Product Tacking
+// File    ZT_Lib/FlightRecorder.h
+
+#pragma once
+
+// ===== C++ ================================================================
+#include <atomic>
+
+// ===== Includes ===========================================================
+#include <ZT/Result.h>
+
+// Constants
+/////////////////////////////////////////////////////////////////////////////
+
+// Power of 2
+#define FLIGHT_RECORDER_SIZE (4096)
+
+#define FLIGHT_RECORDER_MAGIC   (0x5246545a) // "ZTFR" in little endian
+#define FLIGHT_RECORDER_VERSION (1)
+
+// Data types
+/////////////////////////////////////////////////////////////////////////////
+
+// The dump file is a FlightRecorder_Header followed by mRecord_Count
+// records, the oldest first. The values are in the byte order of the host.
+typedef struct
+{
+    uint32_t mMagic;
+    uint32_t mVersion;
+    uint32_t mRecord_Count;
+    uint32_t mRecord_Size_byte;
+
+    uint64_t mDump_ns; // Time of the dump, monotonic clock
+
+    uint8_t mReserved0[8];
+}
+FlightRecorder_Header;
+
+//                 mId       mSerial  mValue        mData
+// CAN_RX          CAN id    -        -             The fragment
+// CAN_TX          CAN id    -        EthCAN result The fragment
+// STATE           Line      -        -             From, To
+// TR_COMPLETE     Result    Serial   Retries used  -
+// TR_START        -         Serial   Retries used  Cmd Type, Cmd Set, Cmd Id
+typedef enum
+{
+    FLIGHT_RECORDER_CAN_RX,
+    FLIGHT_RECORDER_CAN_TX,
+    FLIGHT_RECORDER_STATE,
+    FLIGHT_RECORDER_TR_COMPLETE,
+    FLIGHT_RECORDER_TR_START,
+
+    FLIGHT_RECORDER_TYPE_QTY
+}
+FlightRecorder_Type;
+
+typedef struct
+{
+    uint64_t mTime_ns;  // Monotonic clock
+    uint32_t mIndex;    // Position in the recording, a gap is a lost record
+    uint32_t mId;
+    uint32_t mValue;
+    uint16_t mSerial;
+    uint8_t  mType;     // See FlightRecorder_Type
+    uint8_t  mDataSize_byte;
+    uint8_t  mData[8];
+}
+FlightRecorder_Record;
+
+// Class
+/////////////////////////////////////////////////////////////////////////////
+
+// Ring of the last FLIGHT_RECORDER_SIZE records. Any thread can record
+// without lock, a record costs an atomic increment, a clock read and a 32
+// bytes copy. Dump copies the ring while the writers continue, a record
+// overwritten during the copy is not part of the dump.
+class FlightRecorder
+{
+
+public:
+
+    FlightRecorder();
+
+    // aData  The first 8 bytes at most are recorded
+    void Record(FlightRecorder_Type aType, uint32_t aId, uint16_t aSerial = 0, uint32_t aValue = 0, const void * aData = NULL, unsigned int aDataSize_byte = 0);
+
+    // aFileName  The file must not exist. Dump never replaces a file nor
+    //            follows a link.
+    //
+    // Return  ZT_OK
+    //         ZT_ERROR_FILE_OPEN
+    ZT::Result Dump(const char * aFileName) const;
+
+    // aTemplate [---;RW-] A mkstemp template, "/tmp/Name_XXXXXX" for
+    //                     example. Dump_Temp sets the name of the new file.
+    //
+    // Return  ZT_OK
+    //         ZT_ERROR_FILE_OPEN
+    ZT::Result Dump_Temp(char * aTemplate) const;
+
+private:
+
+    FlightRecorder(const FlightRecorder &);
+
+    const FlightRecorder & operator = (const FlightRecorder &);
+
+    ZT::Result Dump_File(int aFile) const;
+
+    // mSequence is the index of the record plus 1, 0 while the record is
+    // written.
+    typedef struct
+    {
+        std::atomic<uint32_t> mSequence;
+
+        FlightRecorder_Record mRecord;
+    }
+    Slot;
+
+    std::atomic<uint32_t> mNext;
+
+    Slot mSlots[FLIGHT_RECORDER_SIZE];
+
+};
@@ -10,6 +10,13 @@
 
 #include "Component.h"
 
+// ===== C ==================================================================
+#include <time.h>
+
+// ===== Includes ===========================================================
+#include <ZT/IMessageReceiver.h>
+#include <ZT/ISystem.h>
+
 // ===== ZT_Lib =============================================================
 #include "Value.h"
 
@@ -28,6 +35,15 @@
 
 static const ZT::IGimbal::Speed SPEED_STOPPED = { 0.0, 0.0, 0.0 };
 
+// Indexed by Gimbal::State
+static const ZT::IGimbal::Motion STATE_MOTIONS[] =
+{
+    ZT::IGimbal::MOTION_STOPPED,
+    ZT::IGimbal::MOTION_MOVING,
+    ZT::IGimbal::MOTION_SPEED,
+    ZT::IGimbal::MOTION_UNKNOWN,
+};
+
 // Static function declarations
 /////////////////////////////////////////////////////////////////////////////
 
@@ -48,16 +64,32 @@ static ZT::Result Speed_Validate(double aIn_deg_s, double aMax_deg_s);
 Gimbal::Gimbal()
     : mFocus_Position_pc(FOCUS_POSITION_MIN_pc)
     , mFocus_Speed_pc_s(FOCUS_SPEED_STOP_pc_s)
-    , mPosition_Count(0)
     , mPosition_Flags(ZT_FLAG_IGNORE_ALL)
+    , mGroup_Result(ZT::ZT_ERROR_STATE)
+    , mGroup_Start_us(0)
+    , mGroup_Duration_ms(0)
+    , mGroup_Flags(ZT_FLAG_IGNORE_ALL)
+    , mPosition_Count(0)
     , mPosition_State(STATE_UNKNOWN)
+    , mSample_Sequence(0)
+    , mSample_Timestamp_us(0)
+    , mTelemetry_Code(0)
+    , mTelemetry_Decimation(1)
+    , mTelemetry_Pending(false)
+    , mTelemetry_Receiver(NULL)
     , mRefCount(1)
 {
     memset(&mConfig  , 0, sizeof(mConfig  ));
+    memset(&mGroup_Position  , 0, sizeof(mGroup_Position  ));
     memset(&mInfo    , 0, sizeof(mInfo    ));
     memset(&mPosition_Current, 0, sizeof(mPosition_Current));
     memset(&mPosition_Target , 0, sizeof(mPosition_Target ));
+    memset(&mSample_Position , 0, sizeof(mSample_Position ));
     memset(&mSpeed   , 0, sizeof(mSpeed   ));
+    memset(&mTelemetry_Message, 0, sizeof(mTelemetry_Message));
+
+    int lRet = pthread_mutex_init(&mTelemetry_Mutex, NULL);
+    assert(0 == lRet);
 
     FOR_EACH_AXIS(a)
     {
@@ -69,6 +101,8 @@ Gimbal::Gimbal()
 
 Gimbal::~Gimbal()
 {
+    int lRet = pthread_mutex_destroy(&mTelemetry_Mutex);
+    assert(0 == lRet);
 }
 
 void Gimbal::IncRefCount()
@@ -76,6 +110,185 @@ void Gimbal::IncRefCount()
     mRefCount++;
 }
 
+// ===== Group ==============================================================
+
+unsigned int Gimbal::Group_Find(Gimbal * const * aGimbals, unsigned int aCount, const Gimbal * aGimbal)
+{
+    assert(NULL != aGimbals);
+
+    unsigned int lResult;
+
+    for (lResult = 0; lResult < aCount; lResult ++)
+    {
+        if (aGimbal == aGimbals[lResult])
+        {
+            break;
+        }
+    }
+
+    return lResult;
+}
+
+// The positions are validated before the first gimbal stages its move. The
+// release loop only wakes the workers, the frames are already built. A
+// gimbal listed many times moves once, to its first position.
+ZT::Result Gimbal::Group_Position_Set(Gimbal ** aGimbals, const Position * aPositions, unsigned int aCount, unsigned int aFlags, unsigned int aDuration_ms)
+{
+    assert(NULL != aGimbals);
+    assert(NULL != aPositions);
+
+    if (0 == aCount)
+    {
+        return ZT::ZT_ERROR_MIN;
+    }
+
+    if (ZT_GROUP_MAX < aCount)
+    {
+        return ZT::ZT_ERROR_MAX;
+    }
+
+    unsigned int     i;
+    unsigned int     lCount = 0;
+    unsigned int     lDuration_ms = aDuration_ms;
+    Gimbal         * lGimbals  [ZT_GROUP_MAX];
+    const Position * lPositions[ZT_GROUP_MAX];
+    ZT::Result       lResult;
+
+    for (i = 0; i < aCount; i ++)
+    {
+        assert(NULL != aGimbals[i]);
+
+        if (lCount == Group_Find(lGimbals, lCount, aGimbals[i]))
+        {
+            lGimbals  [lCount] = aGimbals  [i];
+            lPositions[lCount] = aPositions + i;
+
+            lCount ++;
+        }
+    }
+
+    for (i = 0; i < lCount; i ++)
+    {
+        unsigned int lNeeded_ms;
+
+        lResult = lGimbals[i]->Group_Prepare(*lPositions[i], aFlags, &lNeeded_ms);
+        if (ZT::ZT_OK != lResult)
+        {
+            return lResult;
+        }
+
+        if (lDuration_ms < lNeeded_ms)
+        {
+            lDuration_ms = lNeeded_ms;
+        }
+    }
+
+    for (i = 0; i < lCount; i ++)
+    {
+        lResult = lGimbals[i]->Group_Stage(*lPositions[i], aFlags, lDuration_ms);
+        if (ZT::ZT_OK != lResult)
+        {
+            // No gimbal moves
+            while (0 < i)
+            {
+                i --;
+                lGimbals[i]->Group_Cancel();
+            }
+
+            return lResult;
+        }
+    }
+
+    ZT::Result lResults[ZT_GROUP_MAX];
+
+    for (i = 0; i < lCount; i ++)
+    {
+        lResults[i] = lGimbals[i]->Group_Release();
+    }
+
+    uint64_t lFirst_us = UINT64_MAX;
+    uint64_t lStart_us[ZT_GROUP_MAX];
+
+    lResult = ZT::ZT_OK;
+
+    for (i = 0; i < lCount; i ++)
+    {
+        if (ZT::ZT_OK == lResults[i])
+        {
+            lResults[i] = lGimbals[i]->Group_Wait(lStart_us + i);
+        }
+
+        if (ZT::ZT_OK == lResults[i])
+        {
+            if (lFirst_us > lStart_us[i])
+            {
+                lFirst_us = lStart_us[i];
+            }
+        }
+        else if (ZT::ZT_OK == lResult)
+        {
+            lResult = lResults[i];
+        }
+    }
+
+    for (i = 0; i < lCount; i ++)
+    {
+        if (ZT::ZT_OK == lResults[i])
+        {
+            lGimbals[i]->Group_Skew_Add(static_cast<unsigned int>(lStart_us[i] - lFirst_us));
+        }
+    }
+
+    return lResult;
+}
+
+void Gimbal::Group_Cancel()
+{
+}
+
+ZT::Result Gimbal::Group_Prepare(const Position & aIn, unsigned int aFlags, unsigned int * aDuration_ms)
+{
+    assert(NULL != aDuration_ms);
+
+    Position lPosition;
+
+    *aDuration_ms = 0;
+
+    return Position_Target_Get(&lPosition, aIn, aFlags);
+}
+
+ZT::Result Gimbal::Group_Stage(const Position & aIn, unsigned int aFlags, unsigned int aDuration_ms)
+{
+    mGroup_Duration_ms = aDuration_ms;
+    mGroup_Flags       = aFlags;
+    mGroup_Position    = aIn;
+
+    return ZT::ZT_OK;
+}
+
+// Without a worker, the move starts in the releasing thread. Group_Wait
+// returns its result.
+ZT::Result Gimbal::Group_Release()
+{
+    mGroup_Start_us = Time_Get_us();
+    mGroup_Result   = Position_Set(mGroup_Position, mGroup_Flags, mGroup_Duration_ms);
+
+    return ZT::ZT_OK;
+}
+
+ZT::Result Gimbal::Group_Wait(uint64_t * aStart_us)
+{
+    assert(NULL != aStart_us);
+
+    *aStart_us = mGroup_Start_us;
+
+    return mGroup_Result;
+}
+
+void Gimbal::Group_Skew_Add(unsigned int)
+{
+}
+
 // ===== ZT::IGimbal ========================================================
 
 ZT::Result Gimbal::Activate()
@@ -130,6 +343,18 @@ ZT::Result Gimbal::Focus_Speed_Set(double aSpeed_pc_s)
     return lResult;
 }
 
+// The base class has no communication to recover.
+ZT::Result Gimbal::Health_Get(HealthStatus * aOut)
+{
+    assert(NULL != aOut);
+
+    memset(aOut, 0, sizeof(HealthStatus));
+
+    aOut->mHealth = HEALTH_OK;
+
+    return ZT::ZT_OK;
+}
+
 ZT::Result Gimbal::Position_Get(ZT::IGimbal::Position * aOut)
 {
     assert(NULL != aOut);
@@ -151,26 +376,74 @@ ZT::Result Gimbal::Position_Get(ZT::IGimbal::Position * aOut)
     return lResult;
 }
 
-ZT::Result Gimbal::Position_Set(const ZT::IGimbal::Position & aIn, unsigned int aFlags, unsigned int aDuration_ms)
+// The base class has no way to request a new position, a stale sample is
+// returned with ZT_ERROR_NOT_READY.
+ZT::Result Gimbal::Position_Get(PositionSample * aOut, unsigned int aMaxAge_ms)
 {
+    assert(NULL != aOut);
+
+    ZT::Result lResult = Position_Get_Cached(aOut);
+    if ((ZT::ZT_OK == lResult) && (aMaxAge_ms < aOut->mAge_ms))
+    {
+        lResult = ZT::ZT_ERROR_NOT_READY;
+    }
+
+    return lResult;
+}
+
+ZT::Result Gimbal::Position_Get_Cached(PositionSample * aOut)
+{
+    assert(NULL != aOut);
+
+    memset(aOut, 0, sizeof(PositionSample));
+
     Position lPosition;
+    uint64_t lTimestamp_us;
 
-    FOR_EACH_AXIS(a)
+    for (;;)
     {
-        if (0 == (aFlags & ZT_FLAG_IGNORE(a)))
+        unsigned int lBefore = mSample_Sequence.load(std::memory_order_acquire);
+        if (0 == (lBefore & 1))
         {
-            lPosition.mAxis_deg[a] = aIn.mAxis_deg[a] + mConfig.mAxis[a].mOffset_deg;
+            lPosition     = mSample_Position;
+            lTimestamp_us = mSample_Timestamp_us;
+
+            std::atomic_thread_fence(std::memory_order_acquire);
+
+            if (mSample_Sequence.load(std::memory_order_relaxed) == lBefore)
+            {
+                break;
+            }
         }
     }
 
-    ZT::Result lResult = Position_Validate(lPosition, aFlags);
-    if (ZT::ZT_OK == lResult)
+    if (0 == lTimestamp_us)
     {
-        // TRACE_DEBUG(stdout, "Gimbal::Position_Set - --> MOVING");
-        mPosition_Flags &= aFlags;
-        mPosition_State  = STATE_MOVING;
+        return ZT::ZT_ERROR_NOT_READY;
+    }
+
+    FOR_EACH_AXIS(a)
+    {
+        aOut->mPosition.mAxis_deg[a] = lPosition.mAxis_deg[a] - mConfig.mAxis[a].mOffset_deg;
+    }
+
+    uint64_t lNow_us = Time_Get_us();
+
+    aOut->mAge_ms       = (lNow_us > lTimestamp_us) ? static_cast<unsigned int>((lNow_us - lTimestamp_us) / 1000) : 0;
+    aOut->mTimestamp_us = lTimestamp_us;
+
+    return ZT::ZT_OK;
+}
+
+ZT::Result Gimbal::Position_Set(const ZT::IGimbal::Position & aIn, unsigned int aFlags, unsigned int aDuration_ms)
+{
+    Position     lTarget;
+    unsigned int lTarget_Flags;
 
-        Position_Copy(&mPosition_Target, lPosition, aFlags);
+    ZT::Result lResult = Position_Target_Next(&lTarget, &lTarget_Flags, aIn, aFlags);
+    if (ZT::ZT_OK == lResult)
+    {
+        Position_Target_Set(lTarget, lTarget_Flags);
     }
 
     return lResult;
@@ -194,7 +467,7 @@ ZT::Result Gimbal::Speed_Get(ZT::IGimbal::Speed * aOut)
     default: assert(false);
     }
 
-    return ZT::ZT_OK;
+    return lResult;
 }
 
 ZT::Result Gimbal::Speed_Set(const ZT::IGimbal::Speed & aIn, unsigned int aFlags)
@@ -228,6 +501,56 @@ ZT::Result Gimbal::Speed_Stop()
     return ZT::ZT_OK;
 }
 
+ZT::Result Gimbal::Telemetry_Start(ZT::IMessageReceiver * aReceiver, unsigned int aCode, unsigned int aDecimation)
+{
+    if (NULL == aReceiver)
+    {
+        return ZT::ZT_ERROR_RECEIVER;
+    }
+
+    if (0 == aDecimation)
+    {
+        return ZT::ZT_ERROR_MIN;
+    }
+
+    ZT::Result lResult = ZT::ZT_ERROR_ALREADY_STARTED;
+
+    pthread_mutex_lock(&mTelemetry_Mutex);
+    {
+        if (NULL == mTelemetry_Receiver)
+        {
+            mTelemetry_Code       = aCode;
+            mTelemetry_Decimation = aDecimation;
+            mTelemetry_Receiver   = aReceiver;
+
+            lResult = ZT::ZT_OK;
+        }
+    }
+    pthread_mutex_unlock(&mTelemetry_Mutex);
+
+    return lResult;
+}
+
+// The mutex is held while the receiver is called, so the receiver is not
+// in use anymore when the method returns.
+ZT::Result Gimbal::Telemetry_Stop()
+{
+    ZT::Result lResult = ZT::ZT_ERROR_ALREADY_STOPPED;
+
+    pthread_mutex_lock(&mTelemetry_Mutex);
+    {
+        if (NULL != mTelemetry_Receiver)
+        {
+            mTelemetry_Receiver = NULL;
+
+            lResult = ZT::ZT_OK;
+        }
+    }
+    pthread_mutex_unlock(&mTelemetry_Mutex);
+
+    return lResult;
+}
+
 // ===== ZT::IObject ========================================================
 
 void Gimbal::Release()
@@ -304,6 +627,20 @@ void Gimbal::Position_Update(const Position & aIn)
     mPosition_Count   = 15;
     mPosition_Current = aIn;
 
+    // Only one writer, the thread receiving the positions
+    unsigned int lSeq = mSample_Sequence.load(std::memory_order_relaxed);
+
+    mSample_Sequence.store(lSeq + 1, std::memory_order_relaxed);
+
+    std::atomic_thread_fence(std::memory_order_release);
+
+    uint64_t lNow_us = Time_Get_us();
+
+    mSample_Position     = aIn;
+    mSample_Timestamp_us = lNow_us;
+
+    mSample_Sequence.store(lSeq + 2, std::memory_order_release);
+
     switch (mPosition_State)
     {
     case STATE_KNOWN:
@@ -335,6 +672,20 @@ void Gimbal::Position_Update(const Position & aIn)
 
     default: assert(false);
     }
+
+    // The message is prepared even when nobody receives it, Telemetry_Send
+    // checks the receiver.
+    FOR_EACH_AXIS(a)
+    {
+        mTelemetry_Message.mPosition.mAxis_deg[a] = aIn.mAxis_deg[a] - mConfig.mAxis[a].mOffset_deg;
+    }
+
+    mTelemetry_Message.mIndex        ++;
+    mTelemetry_Message.mMotion       = STATE_MOTIONS[mPosition_State];
+    mTelemetry_Message.mSpeed        = mSpeed;
+    mTelemetry_Message.mTimestamp_us = lNow_us;
+
+    mTelemetry_Pending = true;
 }
 
 ZT::Result Gimbal::Position_Validate(const Position & aIn, unsigned int aFlags) const
@@ -352,6 +703,50 @@ ZT::Result Gimbal::Position_Validate(const Position & aIn, unsigned int aFlags)
     return lResult;
 }
 
+ZT::Result Gimbal::Position_Target_Next(Position * aTarget, unsigned int * aTarget_Flags, const Position & aIn, unsigned int aFlags) const
+{
+    assert(NULL != aTarget);
+    assert(NULL != aTarget_Flags);
+
+    Position lPosition;
+
+    ZT::Result lResult = Position_Target_Get(&lPosition, aIn, aFlags);
+    if (ZT::ZT_OK == lResult)
+    {
+        *aTarget       = mPosition_Target;
+        *aTarget_Flags = mPosition_Flags & aFlags;
+
+        Position_Copy(aTarget, lPosition, aFlags);
+    }
+
+    return lResult;
+}
+
+void Gimbal::Position_Target_Set(const Position & aTarget, unsigned int aTarget_Flags)
+{
+    // TRACE_DEBUG(stdout, "Gimbal::Position_Target_Set - --> MOVING");
+    mPosition_Flags  = aTarget_Flags;
+    mPosition_State  = STATE_MOVING;
+    mPosition_Target = aTarget;
+}
+
+void Gimbal::Telemetry_Send()
+{
+    if (mTelemetry_Pending)
+    {
+        mTelemetry_Pending = false;
+
+        pthread_mutex_lock(&mTelemetry_Mutex);
+        {
+            if ((NULL != mTelemetry_Receiver) && (0 == (mTelemetry_Message.mIndex % mTelemetry_Decimation)))
+            {
+                mTelemetry_Receiver->ProcessMessage(this, mTelemetry_Code, &mTelemetry_Message);
+            }
+        }
+        pthread_mutex_unlock(&mTelemetry_Mutex);
+    }
+}
+
 void Gimbal::Tick()
 {
     switch (mPosition_State)
@@ -377,9 +772,34 @@ void Gimbal::Tick()
     }
 }
 
+uint64_t Gimbal::Time_Get_us()
+{
+    timespec lNow;
+
+    clock_gettime(CLOCK_MONOTONIC, &lNow);
+
+    return static_cast<uint64_t>(lNow.tv_sec) * 1000000 + lNow.tv_nsec / 1000;
+}
+
 // Private
 /////////////////////////////////////////////////////////////////////////////
 
+// aOut [---;-W-] The position with the offsets
+ZT::Result Gimbal::Position_Target_Get(Position * aOut, const Position & aIn, unsigned int aFlags) const
+{
+    assert(NULL != aOut);
+
+    FOR_EACH_AXIS(a)
+    {
+        if (0 == (aFlags & ZT_FLAG_IGNORE(a)))
+        {
+            aOut->mAxis_deg[a] = aIn.mAxis_deg[a] + mConfig.mAxis[a].mOffset_deg;
+        }
+    }
+
+    return Position_Validate(*aOut, aFlags);
+}
+
 ZT::Result Gimbal::Speed_Validate(const Speed & aIn, unsigned int aFlags) const
 {
     ZT::Result lResult = ZT::ZT_OK;
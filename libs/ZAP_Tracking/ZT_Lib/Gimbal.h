@@ -6,6 +6,12 @@
 
 #pragma once
 
+// ===== C ==================================================================
+#include <pthread.h>
+
+// ===== C++ ================================================================
+#include <atomic>
+
 // ===== Includes ===========================================================
 #include <ZT/IGimbal.h>
 
@@ -23,6 +29,50 @@ public:
 
     void IncRefCount();
 
+    // ===== Group ==========================================================
+
+    // Return the index of aGimbal in aGimbals, aCount when it is not there
+    static unsigned int Group_Find(Gimbal * const * aGimbals, unsigned int aCount, const Gimbal * aGimbal);
+
+    // aGimbals      [---;RW-]
+    // aPositions    [---;R--] One position per gimbal
+    // aCount                  1 to ZT_GROUP_MAX
+    // aFlags
+    // aDuration_ms            The minimum duration
+    //
+    // See ZT::ISystem::Gimbals_Position_Set
+    //
+    // Thread  Users
+    static ZT::Result Group_Position_Set(Gimbal ** aGimbals, const Position * aPositions, unsigned int aCount, unsigned int aFlags, unsigned int aDuration_ms);
+
+    // aDuration_ms [---;-W-] The duration the move needs
+    virtual ZT::Result Group_Prepare(const Position & aIn, unsigned int aFlags, unsigned int * aDuration_ms);
+
+    // Forget the staged move
+    virtual void Group_Cancel();
+
+    // Group_Prepare accepted the position, Group_Stage fails only when an
+    // other group move of the gimbal is in progress.
+    //
+    // Return  ZT_OK
+    //         ZT_ERROR_STATE
+    virtual ZT::Result Group_Stage(const Position & aIn, unsigned int aFlags, unsigned int aDuration_ms);
+
+    // Start the staged move without waiting for the next tick
+    //
+    // Return  ZT_OK
+    //         ZT_ERROR_STATE  No staged move
+    virtual ZT::Result Group_Release();
+
+    // aStart_us [---;-W-] The time the move started, see Time_Get_us
+    //
+    // Return  The result of the move
+    //         ZT_ERROR_STATE  No released move
+    virtual ZT::Result Group_Wait(uint64_t * aStart_us);
+
+    // aSkew_us  The start of the move after the first gimbal of the group
+    virtual void Group_Skew_Add(unsigned int aSkew_us);
+
     // ===== ZT::IGimbal ====================================================
 
     virtual ZT::Result Activate();
@@ -33,15 +83,22 @@ public:
     virtual ZT::Result Focus_Position_Set(double aFocus);
     virtual ZT::Result Focus_Speed_Set(double aFocus);
 
+    virtual ZT::Result Health_Get(HealthStatus * aOut);
+
     virtual void Info_Get(Info * aOut) const;
 
     virtual ZT::Result Position_Get(Position * aOut);
+    virtual ZT::Result Position_Get(PositionSample * aOut, unsigned int aMaxAge_ms);
+    virtual ZT::Result Position_Get_Cached(PositionSample * aOut);
     virtual ZT::Result Position_Set(const Position & aIn, unsigned int aFlags, unsigned int aDuration_ms);
 
     virtual ZT::Result Speed_Get(Speed * aOut);
     virtual ZT::Result Speed_Set(const Speed & aIn, unsigned int aFlags);
     virtual ZT::Result Speed_Stop();
 
+    virtual ZT::Result Telemetry_Start(ZT::IMessageReceiver * aReceiver, unsigned int aCode, unsigned int aDecimation);
+    virtual ZT::Result Telemetry_Stop();
+
     // ===== ZT::IObject ====================================================
     virtual void Release();
 
@@ -80,8 +137,25 @@ protected:
     void       Position_Update(const Position & aIn);
     ZT::Result Position_Validate(const Position & aIn, unsigned int aFlags = 0) const;
 
+    // Compute the target and the flags Position_Set gives, without changing
+    // the target of the gimbal
+    //
+    // aTarget       [---;-W-]
+    // aTarget_Flags [---;-W-]
+    ZT::Result Position_Target_Next(Position * aTarget, unsigned int * aTarget_Flags, const Position & aIn, unsigned int aFlags) const;
+
+    // Move toward a target Position_Target_Next computed
+    void Position_Target_Set(const Position & aTarget, unsigned int aTarget_Flags);
+
+    // The thread calling Position_Update calls Telemetry_Send once it
+    // does not hold any lock.
+    void Telemetry_Send();
+
     void Tick();
 
+    // Return the monotonic time, the time base of the timestamps
+    static uint64_t Time_Get_us();
+
     Config   mConfig;
     double   mFocus_Position_pc;
     double   mFocus_Speed_pc_s;
@@ -90,14 +164,45 @@ protected:
     Position     mPosition_Target;
     Speed    mSpeed;
 
+    // ===== Group ==========================================================
+    // The result and the start of the last released group move
+    ZT::Result mGroup_Result;
+    uint64_t   mGroup_Start_us;
+
 private:
 
+    ZT::Result Position_Target_Get(Position * aOut, const Position & aIn, unsigned int aFlags) const;
+
     ZT::Result Speed_Validate(const Speed & aIn, unsigned int aFlags = 0) const;
 
+    // ===== Group ==========================================================
+    // The move the default Group_Stage stages
+    unsigned int mGroup_Duration_ms;
+    unsigned int mGroup_Flags;
+    Position     mGroup_Position;
+
     unsigned int mPosition_Count;
     Position     mPosition_Current;
     State        mPosition_State;
 
+    // The last received position and its capture time. Position_Update
+    // writes it, the users threads read it without lock. The sequence
+    // number works as a seqlock.
+    std::atomic<unsigned int> mSample_Sequence;
+    Position                  mSample_Position;
+    uint64_t                  mSample_Timestamp_us;
+
+    // ===== Telemetry ======================================================
+    // mTelemetry_Mutex protects the receiver, its code and the decimation.
+    // Only the thread calling Position_Update uses mTelemetry_Message and
+    // mTelemetry_Pending.
+    unsigned int           mTelemetry_Code;
+    unsigned int           mTelemetry_Decimation;
+    Telemetry              mTelemetry_Message;
+    pthread_mutex_t        mTelemetry_Mutex;
+    bool                   mTelemetry_Pending;
+    ZT::IMessageReceiver * mTelemetry_Receiver;
+
     unsigned int mRefCount;
 
 };
@@ -0,0 +1,176 @@
+
+// Author  KMS - Martin Dubois, P.Eng.
+// Client  ZAP
+// Product Tacking
+// File    ZT_Lib/Histogram.cpp
+
+#include "Component.h"
+
+// ===== ZT_Lib =============================================================
+#include "ZT_Lib/Histogram.h"
+
+// Static function declarations
+// //////////////////////////////////////////////////////////////////////////
+
+static unsigned int Bucket_Get(unsigned int aValue);
+
+static unsigned int Bucket_Limit(unsigned int aBucket);
+
+namespace ZT_Lib
+{
+
+    // Public
+    // //////////////////////////////////////////////////////////////////////
+
+    Histogram::Histogram()
+    {
+        Reset();
+    }
+
+    // The counters are statistics, they do not order other memory accesses.
+    void Histogram::Add(unsigned int aValue)
+    {
+        mBuckets[Bucket_Get(aValue)].fetch_add(1, std::memory_order_relaxed);
+
+        mCount.fetch_add(1     , std::memory_order_relaxed);
+        mSum  .fetch_add(aValue, std::memory_order_relaxed);
+
+        unsigned int lMax = mMax.load(std::memory_order_relaxed);
+
+        while ((lMax < aValue) && (!mMax.compare_exchange_weak(lMax, aValue, std::memory_order_relaxed)))
+        {
+        }
+    }
+
+    unsigned int Histogram::Avg_Get() const
+    {
+        uint64_t lCount = Count_Get();
+
+        return (0 < lCount) ? static_cast<unsigned int>(mSum.load(std::memory_order_relaxed) / lCount) : 0;
+    }
+
+    uint64_t Histogram::Count_Get() const
+    {
+        return mCount.load(std::memory_order_relaxed);
+    }
+
+    unsigned int Histogram::Max_Get() const
+    {
+        return mMax.load(std::memory_order_relaxed);
+    }
+
+    unsigned int Histogram::Percentile_Get(unsigned int aPercent) const
+    {
+        assert(100 >= aPercent);
+
+        unsigned int lMax = Max_Get();
+
+        uint64_t lRank = (Count_Get() * aPercent + 99) / 100;
+        uint64_t lSum  = 0;
+
+        for (unsigned int b = 0; b < HISTOGRAM_BUCKETS; b++)
+        {
+            lSum += mBuckets[b].load(std::memory_order_relaxed);
+            if (lRank <= lSum)
+            {
+                unsigned int lResult = Bucket_Limit(b);
+
+                return (lMax < lResult) ? lMax : lResult;
+            }
+        }
+
+        return lMax;
+    }
+
+    void Histogram::Reset()
+    {
+        for (unsigned int b = 0; b < HISTOGRAM_BUCKETS; b++)
+        {
+            mBuckets[b].store(0, std::memory_order_relaxed);
+        }
+
+        mCount.store(0, std::memory_order_relaxed);
+        mMax  .store(0, std::memory_order_relaxed);
+        mSum  .store(0, std::memory_order_relaxed);
+    }
+
+    void Histogram::Snapshot_Get(Histogram * aOut, bool aReset)
+    {
+        assert(NULL != aOut);
+
+        uint64_t lCount = 0;
+
+        for (unsigned int b = 0; b < HISTOGRAM_BUCKETS; b++)
+        {
+            uint64_t lValue = aReset ? mBuckets[b].exchange(0, std::memory_order_relaxed) : mBuckets[b].load(std::memory_order_relaxed);
+
+            aOut->mBuckets[b].store(lValue, std::memory_order_relaxed);
+
+            lCount += lValue;
+        }
+
+        aOut->mCount.store(lCount, std::memory_order_relaxed);
+
+        if (aReset)
+        {
+            mCount.store(0, std::memory_order_relaxed);
+
+            aOut->mMax.store(mMax.exchange(0, std::memory_order_relaxed), std::memory_order_relaxed);
+            aOut->mSum.store(mSum.exchange(0, std::memory_order_relaxed), std::memory_order_relaxed);
+        }
+        else
+        {
+            aOut->mMax.store(mMax.load(std::memory_order_relaxed), std::memory_order_relaxed);
+            aOut->mSum.store(mSum.load(std::memory_order_relaxed), std::memory_order_relaxed);
+        }
+    }
+
+    void Histogram::Display(FILE * aOut, const char * aName, const char * aUnit) const
+    {
+        assert(NULL != aOut);
+        assert(NULL != aName);
+        assert(NULL != aUnit);
+
+        fprintf(aOut, "    %s : %llu, avg %u %s, 50 %% %u %s, 99 %% %u %s, max %u %s\n", aName,
+            static_cast<unsigned long long>(Count_Get()), Avg_Get(), aUnit,
+            Percentile_Get(50), aUnit, Percentile_Get(99), aUnit, Max_Get(), aUnit);
+    }
+
+}
+
+// Static functions
+// //////////////////////////////////////////////////////////////////////////
+
+// The index of the most significant bit gives the power of 2, the next
+// HISTOGRAM_SUB_BITS bits give the linear bucket.
+unsigned int Bucket_Get(unsigned int aValue)
+{
+    if (HISTOGRAM_SUB_COUNT > aValue)
+    {
+        return aValue;
+    }
+
+    unsigned int lMSB   = 31 - __builtin_clz(aValue);
+    unsigned int lShift = lMSB - HISTOGRAM_SUB_BITS;
+
+    unsigned int lResult = HISTOGRAM_SUB_COUNT * (lShift + 1) + ((aValue >> lShift) & (HISTOGRAM_SUB_COUNT - 1));
+    assert(HISTOGRAM_BUCKETS > lResult);
+
+    return lResult;
+}
+
+unsigned int Bucket_Limit(unsigned int aBucket)
+{
+    assert(HISTOGRAM_BUCKETS > aBucket);
+
+    if (HISTOGRAM_SUB_COUNT > aBucket)
+    {
+        return aBucket;
+    }
+
+    unsigned int lShift = aBucket / HISTOGRAM_SUB_COUNT - 1;
+    uint64_t     lLow   = static_cast<uint64_t>(HISTOGRAM_SUB_COUNT + aBucket % HISTOGRAM_SUB_COUNT) << lShift;
+    uint64_t     lLimit = lLow + (static_cast<uint64_t>(1) << lShift) - 1;
+
+    return (0xffffffff < lLimit) ? 0xffffffff : static_cast<unsigned int>(lLimit);
+}
@@ -71,6 +71,31 @@ namespace ZT
         fprintf(lOut, "    Stiffness : %f %%\n"   , aIn.mStiffness_pc);
     }
 
+    void IGimbal::Display(void * aOut, Health aIn)
+    {
+        FILE * lOut = (NULL == aOut) ? stdout : reinterpret_cast<FILE *>(aOut);
+
+        switch (aIn)
+        {
+        case HEALTH_FAILED    : fprintf(lOut, "HEALTH_FAILED\n"    ); break;
+        case HEALTH_INACTIVE  : fprintf(lOut, "HEALTH_INACTIVE\n"  ); break;
+        case HEALTH_OK        : fprintf(lOut, "HEALTH_OK\n"        ); break;
+        case HEALTH_RECOVERING: fprintf(lOut, "HEALTH_RECOVERING\n"); break;
+
+        default: fprintf(lOut, "Invalid Health value (%u)\n", aIn);
+        }
+    }
+
+    void IGimbal::Display(void * aOut, const HealthStatus & aIn)
+    {
+        FILE * lOut = (NULL == aOut) ? stdout : reinterpret_cast<FILE *>(aOut);
+
+        fprintf(lOut, "Health   : "); Display(lOut, aIn.mHealth);
+        fprintf(lOut, "Failure  : %u\n"   , aIn.mFailure );
+        fprintf(lOut, "Recovery : %u\n"   , aIn.mRecovery);
+        fprintf(lOut, "Retry    : %u ms\n", aIn.mRetry_ms);
+    }
+
     void IGimbal::Display(void * aOut, const Info & aIn)
     {
         FILE * lOut = (NULL == aOut) ? stdout : reinterpret_cast<FILE *>(aOut);
@@ -95,6 +120,45 @@ namespace ZT
         fprintf(lOut, "    Speed Max. : %f deg/s\n", aIn.mSpeed_Max_deg_s);
     }
 
+    void IGimbal::Display(void * aOut, const Latency & aIn)
+    {
+        FILE * lOut = (NULL == aOut) ? stdout : reinterpret_cast<FILE *>(aOut);
+
+        fprintf(lOut, "%llu, avg %u us, 50 %% %u us, 90 %% %u us, 99 %% %u us, max %u us\n", static_cast<unsigned long long>(aIn.mCount),
+            aIn.mAvg_us, aIn.mP50_us, aIn.mP90_us, aIn.mP99_us, aIn.mMax_us);
+    }
+
+    void IGimbal::Display(void * aOut, const Metrics & aIn)
+    {
+        FILE * lOut = (NULL == aOut) ? stdout : reinterpret_cast<FILE *>(aOut);
+
+        fprintf(lOut, "Command    : "); Display(lOut, aIn.mCommand);
+        fprintf(lOut, "Round Trip : "); Display(lOut, aIn.mRoundTrip);
+        fprintf(lOut, "Tick       : "); Display(lOut, aIn.mTick);
+        fprintf(lOut, "Zone0 Hold : "); Display(lOut, aIn.mZone0_Hold);
+        fprintf(lOut, "Zone0 Wait : "); Display(lOut, aIn.mZone0_Wait);
+        fprintf(lOut, "Group Skew : "); Display(lOut, aIn.mGroup_Skew);
+        fprintf(lOut, "Rx         : %u frames, %u bytes, %u errors\n", aIn.mRx_frame, aIn.mRx_byte, aIn.mRx_Error);
+        fprintf(lOut, "Tx         : %u frames, %u bytes, %u errors\n", aIn.mTx_frame, aIn.mTx_byte, aIn.mTx_Error);
+        fprintf(lOut, "Retry      : %u\n", aIn.mRetry);
+        fprintf(lOut, "Timeout    : %u\n", aIn.mTimeout);
+    }
+
+    void IGimbal::Display(void * aOut, Motion aIn)
+    {
+        FILE * lOut = (NULL == aOut) ? stdout : reinterpret_cast<FILE *>(aOut);
+
+        switch (aIn)
+        {
+        case MOTION_MOVING : fprintf(lOut, "MOTION_MOVING\n" ); break;
+        case MOTION_SPEED  : fprintf(lOut, "MOTION_SPEED\n"  ); break;
+        case MOTION_STOPPED: fprintf(lOut, "MOTION_STOPPED\n"); break;
+        case MOTION_UNKNOWN: fprintf(lOut, "MOTION_UNKNOWN\n"); break;
+
+        default: fprintf(lOut, "Invalid Motion value (%u)\n", aIn);
+        }
+    }
+
     void IGimbal::Display(void * aOut, Operation aIn)
     {
         FILE * lOut = (NULL == aOut) ? stdout : reinterpret_cast<FILE *>(aOut);
@@ -133,6 +197,18 @@ namespace ZT
         }
     }
 
+    void IGimbal::Display(void * aOut, const Telemetry & aIn)
+    {
+        FILE * lOut = (NULL == aOut) ? stdout : reinterpret_cast<FILE *>(aOut);
+
+        fprintf(lOut, "Index     : %u\n"      , aIn.mIndex);
+        fprintf(lOut, "Timestamp : %llu us\n" , static_cast<unsigned long long>(aIn.mTimestamp_us));
+        fprintf(lOut, "Motion    : "); Display(lOut, aIn.mMotion);
+
+        Display(lOut, aIn.mPosition);
+        Display(lOut, aIn.mSpeed);
+    }
+
 }
 
 // Static functions
@@ -0,0 +1,17 @@
+
+// Author  KMS - Martin Dubois, P. Eng.
+// Client  ZAP
+// Product Tacking
+// File    ZT_Lib/ITransport.cpp
+
+#include "Component.h"
+
+// ===== ZT_Lib =============================================================
+#include "ITransport.h"
+
+// Public
+// //////////////////////////////////////////////////////////////////////////
+
+ITransport::~ITransport()
+{
+}
@@ -0,0 +1,31 @@
+
+// Author  KMS - Martin Dubois, P. Eng.
+// Client  ZAP
+// Product Tacking
+// File    ZT_Lib/ITransport.h
+
+#pragma once
+
+// ===== Import/Includes ====================================================
+#include <EthCAN_Result.h>
+
+// ===== ZT_Lib =============================================================
+#include "CAN_Batch.h"
+
+// Interface
+/////////////////////////////////////////////////////////////////////////////
+
+// Where the CAN fragments go. DJI_Gimbal uses EthCAN_Transport, the tests
+// and the benchmarks swap it for Fake_Transport.
+class ITransport
+{
+
+public:
+
+    virtual ~ITransport();
+
+    // Send all the fragments of the batch, in order. The transport stops at
+    // the first error.
+    virtual EthCAN_Result Send(const CAN_Batch & aBatch) = 0;
+
+};
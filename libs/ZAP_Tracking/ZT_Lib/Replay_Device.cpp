@@ -0,0 +1,713 @@
+
+// Author  KMS - Martin Dubois, P. Eng.
+// Client  ZAP
+// Product Tacking
+// File    ZT_Lib/Replay_Device.cpp
+
+#include "Component.h"
+
+// ===== C++ ================================================================
+#include <iterator>
+
+// ===== C ==================================================================
+#include <errno.h>
+#include <time.h>
+
+// ===== ZT_Lib =============================================================
+#include "DJI.h"
+#include "DJI_CRC.h"
+
+#include "Replay_Device.h"
+
+// Constants
+/////////////////////////////////////////////////////////////////////////////
+
+// See Thread.cpp
+#ifdef __APPLE__
+    #define REPLAY_CLOCK CLOCK_REALTIME
+#else
+    #define REPLAY_CLOCK CLOCK_MONOTONIC
+#endif
+
+#define OFFSET_CMD_TYPE (3)
+#define OFFSET_SERIAL   (8)
+#define OFFSET_SIZE     (1)
+
+#define OFFSET_CMD_SET (DJI_HEADER_SIZE_byte + DJI_DATA_CMD_SET)
+#define OFFSET_CMD_ID  (DJI_HEADER_SIZE_byte + DJI_DATA_CMD_ID )
+
+// Static function declarations
+/////////////////////////////////////////////////////////////////////////////
+
+static bool Frame_IsValid(const uint8_t * aIn, unsigned int aSize_byte);
+
+static uint16_t Serial_Get(const uint8_t * aIn);
+
+static uint64_t Time_Get_ns();
+
+// ===== Entry point ========================================================
+
+static void * Run_Link(void * aContext);
+
+// Public
+/////////////////////////////////////////////////////////////////////////////
+
+Replay_Device::Replay_Device(Mode aMode)
+    : mLoad_Rx_Count(0)
+    , mLoad_Rx_Insert_byte(0)
+    , mLoad_Rx_Size_byte(0)
+    , mLoad_Tx_ns(0)
+    , mLoad_Tx_Size_byte(0)
+    , mTx_Size_byte(0)
+    , mDelivering(false)
+    , mStep_Next(1)
+    , mStop(false)
+    , mContext(NULL)
+    , mMode(aMode)
+    , mReceiver(NULL)
+    , mThread_Running(false)
+{
+    assert(MODE_QTY > aMode);
+
+    memset(&mCounters, 0, sizeof(mCounters));
+
+    // The step 0 holds the Rx fragments recorded before the first Tx frame.
+    Step lStep;
+
+    memset(&lStep, 0, sizeof(lStep));
+
+    lStep.mResult = EthCAN_OK;
+
+    mSteps.push_back(lStep);
+
+    pthread_condattr_t lAttr;
+
+    int lRet = pthread_condattr_init(&lAttr);
+    assert(0 == lRet);
+
+    #ifndef __APPLE__
+        lRet = pthread_condattr_setclock(&lAttr, REPLAY_CLOCK);
+        assert(0 == lRet);
+    #endif
+
+    lRet = pthread_cond_init(&mCond, &lAttr);
+    assert(0 == lRet);
+
+    lRet = pthread_condattr_destroy(&lAttr);
+    assert(0 == lRet);
+
+    lRet = pthread_mutex_init(&mZone0, NULL);
+    assert(0 == lRet);
+}
+
+ZT::Result Replay_Device::Load(const char * aFileName)
+{
+    assert(NULL != aFileName);
+
+    FILE * lFile = fopen(aFileName, "rb");
+    if (NULL == lFile)
+    {
+        return ZT::ZT_ERROR_FILE_OPEN;
+    }
+
+    ZT::Result lResult = ZT::ZT_ERROR_FILE_OPEN;
+
+    FlightRecorder_Header lHeader;
+
+    if (   (1                       == fread(&lHeader, sizeof(lHeader), 1, lFile))
+        && (FLIGHT_RECORDER_MAGIC   == lHeader.mMagic)
+        && (FLIGHT_RECORDER_VERSION == lHeader.mVersion)
+        && (sizeof(FlightRecorder_Record) == lHeader.mRecord_Size_byte))
+    {
+        FlightRecorder_Record lRecord;
+        unsigned int          i;
+
+        for (i = 0; (i < lHeader.mRecord_Count) && (1 == fread(&lRecord, sizeof(lRecord), 1, lFile)); i++)
+        {
+            Record_Add(lRecord);
+        }
+
+        if (lHeader.mRecord_Count == i)
+        {
+            lResult = ZT::ZT_OK;
+        }
+    }
+
+    int lRet = fclose(lFile);
+    assert(0 == lRet);
+
+    return lResult;
+}
+
+void Replay_Device::Record_Add(const FlightRecorder_Record & aRecord)
+{
+    assert(!mThread_Running);
+
+    if ((1 == mSteps.size()) && (0 == mSteps[0].mTime_ns))
+    {
+        mSteps[0].mTime_ns = aRecord.mTime_ns;
+    }
+
+    switch (aRecord.mType)
+    {
+    case FLIGHT_RECORDER_CAN_RX: Load_Rx(aRecord); break;
+    case FLIGHT_RECORDER_CAN_TX: Load_Tx(aRecord); break;
+    }
+}
+
+void Replay_Device::Counters_Get(Counters * aOut) const
+{
+    assert(NULL != aOut);
+
+    Replay_Device * lThis = const_cast<Replay_Device *>(this);
+
+    int lRet = pthread_mutex_lock(&lThis->mZone0);
+    assert(0 == lRet);
+    {
+        *aOut = mCounters;
+    }
+    lRet = pthread_mutex_unlock(&lThis->mZone0);
+    assert(0 == lRet);
+}
+
+bool Replay_Device::IsDone() const
+{
+    Replay_Device * lThis = const_cast<Replay_Device *>(this);
+
+    bool lResult;
+
+    int lRet = pthread_mutex_lock(&lThis->mZone0);
+    assert(0 == lRet);
+    {
+        lResult = (mSteps.size() <= mStep_Next) && mDeliveries.empty() && (!mDelivering);
+    }
+    lRet = pthread_mutex_unlock(&lThis->mZone0);
+    assert(0 == lRet);
+
+    return lResult;
+}
+
+// ===== EthCAN::Object =====================================================
+
+void Replay_Device::Release()
+{
+    delete this;
+}
+
+// ===== EthCAN::Device =====================================================
+
+EthCAN_Result Replay_Device::CAN_Reset      () { return EthCAN_OK; }
+EthCAN_Result Replay_Device::Protocol_Reset () { return EthCAN_OK; }
+EthCAN_Result Replay_Device::Receiver_Config() { return EthCAN_OK; }
+
+EthCAN_Result Replay_Device::Protocol_Set(Protocol aProtocol) { return EthCAN_OK; }
+
+EthCAN_Result Replay_Device::Config_Get(EthCAN_Config * aOut)
+{
+    assert(NULL != aOut);
+
+    memset(aOut, 0, sizeof(EthCAN_Config));
+
+    aOut->mCAN_Filters[0] = DJI_CAN_ID_RX;
+    aOut->mCAN_Masks  [0] = 0x7ff;
+    aOut->mCAN_Rate       = EthCAN_RATE_1_Mb;
+
+    return EthCAN_OK;
+}
+
+EthCAN_Result Replay_Device::GetInfo(EthCAN_Info * aOut)
+{
+    assert(NULL != aOut);
+
+    memset(aOut, 0, sizeof(EthCAN_Info));
+
+    strncpy(aOut->mName, "Replay", sizeof(aOut->mName) - 1);
+
+    return EthCAN_OK;
+}
+
+EthCAN_Result Replay_Device::Receiver_Start(Receiver aReceiver, void * aContext)
+{
+    assert(NULL != aReceiver);
+
+    if (mThread_Running)
+    {
+        return EthCAN_ERROR;
+    }
+
+    if (0 < mLoad_Rx_Count)
+    {
+        Load_Rx_End(false);
+    }
+
+    mContext  = aContext;
+    mReceiver = aReceiver;
+    mStop     = false;
+
+    int lRet = pthread_create(&mThread, NULL, Run_Link, this);
+    if (0 != lRet)
+    {
+        return EthCAN_ERROR;
+    }
+
+    mThread_Running = true;
+
+    lRet = pthread_mutex_lock(&mZone0);
+    assert(0 == lRet);
+    {
+        Step_Play_Z0(0);
+    }
+    lRet = pthread_mutex_unlock(&mZone0);
+    assert(0 == lRet);
+
+    return EthCAN_OK;
+}
+
+EthCAN_Result Replay_Device::Receiver_Stop()
+{
+    if (!mThread_Running)
+    {
+        return EthCAN_ERROR;
+    }
+
+    int lRet = pthread_mutex_lock(&mZone0);
+    assert(0 == lRet);
+    {
+        mStop = true;
+
+        lRet = pthread_cond_signal(&mCond);
+        assert(0 == lRet);
+    }
+    lRet = pthread_mutex_unlock(&mZone0);
+    assert(0 == lRet);
+
+    lRet = pthread_join(mThread, NULL);
+    assert(0 == lRet);
+
+    mThread_Running = false;
+
+    return EthCAN_OK;
+}
+
+// The DJI_Gimbal sends one frame at a time, so the fragments of a frame
+// follow each other.
+EthCAN_Result Replay_Device::Send(const EthCAN_Frame & aFrame, uint8_t aFlags)
+{
+    EthCAN_Result lResult = EthCAN_OK;
+
+    int lRet = pthread_mutex_lock(&mZone0);
+    assert(0 == lRet);
+    {
+        if (   ((0 == mTx_Size_byte) && (DJI_SOF != aFrame.mData[0]))
+            || (sizeof(mTx) < mTx_Size_byte + aFrame.mDataSize_byte))
+        {
+            mTx_Size_byte = 0;
+        }
+        else
+        {
+            memcpy(mTx + mTx_Size_byte, aFrame.mData, aFrame.mDataSize_byte);
+            mTx_Size_byte += aFrame.mDataSize_byte;
+
+            if ((OFFSET_CMD_ID < mTx_Size_byte) && (mTx[OFFSET_SIZE] <= mTx_Size_byte))
+            {
+                mTx_Size_byte = 0;
+
+                mCounters.mTx_Frame ++;
+
+                unsigned int lStep;
+
+                for (lStep = mStep_Next; lStep < mSteps.size(); lStep ++)
+                {
+                    const Step & lS = mSteps[lStep];
+
+                    if ((mTx[OFFSET_CMD_TYPE] == lS.mCmdType) && (mTx[OFFSET_CMD_SET] == lS.mCmdSet) && (mTx[OFFSET_CMD_ID] == lS.mCmdId))
+                    {
+                        break;
+                    }
+                }
+
+                if (mSteps.size() > lStep)
+                {
+                    mStep_Next = lStep + 1;
+
+                    const Step & lS = mSteps[lStep];
+
+                    mSerials[lS.mSerial] = Serial_Get(mTx);
+
+                    if (EthCAN_OK != lS.mResult)
+                    {
+                        mCounters.mTx_Error ++;
+                        lResult = lS.mResult;
+                    }
+
+                    Step_Play_Z0(lStep);
+                }
+                else
+                {
+                    mCounters.mTx_Unmatched ++;
+                }
+            }
+        }
+    }
+    lRet = pthread_mutex_unlock(&mZone0);
+    assert(0 == lRet);
+
+    return lResult;
+}
+
+// Internal
+/////////////////////////////////////////////////////////////////////////////
+
+// Thread  Replay
+void Replay_Device::Run()
+{
+    int lRet = pthread_mutex_lock(&mZone0);
+    assert(0 == lRet);
+
+    while (!mStop)
+    {
+        if (mDeliveries.empty())
+        {
+            lRet = pthread_cond_wait(&mCond, &mZone0);
+            assert(0 == lRet);
+            continue;
+        }
+
+        const Delivery & lD = mDeliveries.front();
+
+        if (Time_Get_ns() < lD.mDeadline_ns)
+        {
+            timespec lDeadline;
+
+            lDeadline.tv_sec  = lD.mDeadline_ns / 1000000000;
+            lDeadline.tv_nsec = lD.mDeadline_ns % 1000000000;
+
+            lRet = pthread_cond_timedwait(&mCond, &mZone0, &lDeadline);
+            assert((0 == lRet) || (ETIMEDOUT == lRet));
+            continue;
+        }
+
+        unsigned int lFrame = lD.mFrame;
+
+        mDeliveries.pop_front();
+
+        mDelivering = true;
+
+        lRet = pthread_mutex_unlock(&mZone0);
+        assert(0 == lRet);
+        {
+            Deliver(lFrame);
+        }
+        lRet = pthread_mutex_lock(&mZone0);
+        assert(0 == lRet);
+
+        mDelivering = false;
+    }
+
+    lRet = pthread_mutex_unlock(&mZone0);
+    assert(0 == lRet);
+}
+
+// Private
+/////////////////////////////////////////////////////////////////////////////
+
+Replay_Device::~Replay_Device()
+{
+    if (mThread_Running)
+    {
+        Receiver_Stop();
+    }
+
+    int lRet = pthread_cond_destroy(&mCond);
+    assert(0 == lRet);
+
+    lRet = pthread_mutex_destroy(&mZone0);
+    assert(0 == lRet);
+}
+
+// Thread  Replay
+void Replay_Device::Deliver(unsigned int aFrame)
+{
+    assert(mFrames.size() > aFrame);
+    assert(NULL != mReceiver);
+
+    const RxFrame & lF = mFrames[aFrame];
+
+    uint8_t      lData[DJI_REASSEMBLER_FRAME_MAX_byte];
+    unsigned int lInsert_byte = 0;
+    unsigned int lOffsets_byte[DJI_REASSEMBLER_FRAME_MAX_byte];
+    unsigned int lSize_byte = 0;
+    unsigned int i;
+
+    assert(DJI_REASSEMBLER_FRAME_MAX_byte >= lF.mCount);
+
+    // The fragments go back in the frame as the receiver puts them, so the
+    // patch below reaches the bytes each of them carries.
+    for (i = 0; i < lF.mCount; i++)
+    {
+        const Fragment & lFragment = mFragments[lF.mFirst + i];
+
+        lOffsets_byte[i] = DJI_Reassembler::Insert(lData, &lSize_byte, &lInsert_byte, lFragment.mData, lFragment.mDataSize_byte);
+
+        for (unsigned int j = 0; j < i; j++)
+        {
+            if (lOffsets_byte[i] <= lOffsets_byte[j])
+            {
+                lOffsets_byte[j] += lFragment.mDataSize_byte;
+            }
+        }
+    }
+
+    bool lPatched = false;
+
+    if (lF.mReply)
+    {
+        int lRet = pthread_mutex_lock(&mZone0);
+        assert(0 == lRet);
+        {
+            SerialMap::const_iterator lIt = mSerials.find(lF.mSerial);
+            if ((mSerials.end() != lIt) && (lIt->second != lF.mSerial))
+            {
+                DJI_Frame * lFrame = reinterpret_cast<DJI_Frame *>(lData);
+
+                lFrame->mSerial = lIt->second;
+                lFrame->mCRC16  = DJI_CRC_16(lData);
+                lFrame->Seal();
+
+                lPatched = true;
+            }
+        }
+        lRet = pthread_mutex_unlock(&mZone0);
+        assert(0 == lRet);
+    }
+
+    for (i = 0; i < lF.mCount; i++)
+    {
+        const Fragment & lFragment = mFragments[lF.mFirst + i];
+
+        EthCAN_Frame lFrame;
+
+        memset(&lFrame, 0, sizeof(lFrame));
+
+        lFrame.mId            = lFragment.mId;
+        lFrame.mDataSize_byte = lFragment.mDataSize_byte;
+
+        memcpy(lFrame.mData, lData + lOffsets_byte[i], lFragment.mDataSize_byte);
+
+        mReceiver(this, mContext, lFrame);
+    }
+
+    int lRet = pthread_mutex_lock(&mZone0);
+    assert(0 == lRet);
+    {
+        mCounters.mRx_Fragment += lF.mCount;
+        mCounters.mRx_Frame    ++;
+
+        if (lPatched)
+        {
+            mCounters.mRx_Serial ++;
+        }
+    }
+    lRet = pthread_mutex_unlock(&mZone0);
+    assert(0 == lRet);
+}
+
+// A fragment not starting a frame is a frame by itself. It goes to the
+// receiver as recorded.
+void Replay_Device::Load_Rx(const FlightRecorder_Record & aRecord)
+{
+    assert(sizeof(aRecord.mData) >= aRecord.mDataSize_byte);
+
+    if ((0 < mLoad_Rx_Count) && (sizeof(mLoad_Rx) < mLoad_Rx_Size_byte + aRecord.mDataSize_byte))
+    {
+        Load_Rx_End(false);
+    }
+
+    Fragment lFragment;
+
+    lFragment.mTime_ns       = aRecord.mTime_ns;
+    lFragment.mId            = aRecord.mId;
+    lFragment.mDataSize_byte = aRecord.mDataSize_byte;
+
+    memcpy(lFragment.mData, aRecord.mData, sizeof(lFragment.mData));
+
+    mFragments.push_back(lFragment);
+    mLoad_Rx_Count ++;
+
+    if ((1 == mLoad_Rx_Count) && ((0 == aRecord.mDataSize_byte) || (DJI_SOF != aRecord.mData[0])))
+    {
+        Load_Rx_End(false);
+        return;
+    }
+
+    DJI_Reassembler::Insert(mLoad_Rx, &mLoad_Rx_Size_byte, &mLoad_Rx_Insert_byte, aRecord.mData, aRecord.mDataSize_byte);
+
+    if ((OFFSET_SIZE < mLoad_Rx_Size_byte) && (mLoad_Rx[OFFSET_SIZE] <= mLoad_Rx_Size_byte))
+    {
+        Load_Rx_End(   (mLoad_Rx[OFFSET_SIZE] == mLoad_Rx_Size_byte)
+                    && (DJI_CMD_TYPE_REPLY    == mLoad_Rx[OFFSET_CMD_TYPE])
+                    && Frame_IsValid(mLoad_Rx, mLoad_Rx_Size_byte));
+    }
+}
+
+void Replay_Device::Load_Rx_End(bool aReply)
+{
+    assert(0 < mLoad_Rx_Count);
+
+    RxFrame lFrame;
+
+    lFrame.mCount  = mLoad_Rx_Count;
+    lFrame.mFirst  = static_cast<unsigned int>(mFragments.size()) - mLoad_Rx_Count;
+    lFrame.mReply  = aReply;
+    lFrame.mSerial = aReply ? Serial_Get(mLoad_Rx) : 0;
+
+    mFrames.push_back(lFrame);
+
+    mSteps.back().mRx_Count ++;
+
+    mLoad_Rx_Count       = 0;
+    mLoad_Rx_Insert_byte = 0;
+    mLoad_Rx_Size_byte   = 0;
+}
+
+void Replay_Device::Load_Tx(const FlightRecorder_Record & aRecord)
+{
+    assert(sizeof(aRecord.mData) >= aRecord.mDataSize_byte);
+
+    if (   ((0 == mLoad_Tx_Size_byte) && ((0 == aRecord.mDataSize_byte) || (DJI_SOF != aRecord.mData[0])))
+        || (sizeof(mLoad_Tx) < mLoad_Tx_Size_byte + aRecord.mDataSize_byte))
+    {
+        mLoad_Tx_Size_byte = 0;
+        return;
+    }
+
+    memcpy(mLoad_Tx + mLoad_Tx_Size_byte, aRecord.mData, aRecord.mDataSize_byte);
+    mLoad_Tx_Size_byte += aRecord.mDataSize_byte;
+
+    if ((OFFSET_CMD_ID < mLoad_Tx_Size_byte) && (mLoad_Tx[OFFSET_SIZE] <= mLoad_Tx_Size_byte))
+    {
+        mLoad_Tx_ns = aRecord.mTime_ns;
+
+        // DJI_Gimbal records the result of the batch with each fragment.
+        Load_Tx_End(static_cast<EthCAN_Result>(aRecord.mValue));
+    }
+}
+
+void Replay_Device::Load_Tx_End(EthCAN_Result aResult)
+{
+    if (0 < mLoad_Rx_Count)
+    {
+        Load_Rx_End(false);
+    }
+
+    Step lStep;
+
+    lStep.mTime_ns  = mLoad_Tx_ns;
+    lStep.mCmdType  = mLoad_Tx[OFFSET_CMD_TYPE];
+    lStep.mCmdSet   = mLoad_Tx[OFFSET_CMD_SET ];
+    lStep.mCmdId    = mLoad_Tx[OFFSET_CMD_ID  ];
+    lStep.mSerial   = Serial_Get(mLoad_Tx);
+    lStep.mResult   = aResult;
+    lStep.mRx_First = static_cast<unsigned int>(mFrames.size());
+    lStep.mRx_Count = 0;
+
+    mSteps.push_back(lStep);
+
+    mLoad_Tx_Size_byte = 0;
+}
+
+void Replay_Device::Step_Play_Z0(unsigned int aStep)
+{
+    assert(mSteps.size() > aStep);
+
+    const Step & lS = mSteps[aStep];
+
+    uint64_t lNow_ns = Time_Get_ns();
+
+    for (unsigned int i = 0; i < lS.mRx_Count; i++)
+    {
+        Delivery lD;
+
+        lD.mDeadline_ns = lNow_ns;
+        lD.mFrame       = lS.mRx_First + i;
+
+        if (MODE_TIMED == mMode)
+        {
+            uint64_t lTime_ns = mFragments[mFrames[lD.mFrame].mFirst].mTime_ns;
+
+            if (lS.mTime_ns < lTime_ns)
+            {
+                lD.mDeadline_ns += lTime_ns - lS.mTime_ns;
+            }
+        }
+
+        // The deliveries with the same deadline keep their order. The
+        // search starts from the end, the new deadlines are usually the
+        // latest and a MODE_FAST burst does not walk the list.
+        DeliveryList::iterator lIt = mDeliveries.end();
+
+        while ((mDeliveries.begin() != lIt) && (std::prev(lIt)->mDeadline_ns > lD.mDeadline_ns))
+        {
+            lIt --;
+        }
+
+        mDeliveries.insert(lIt, lD);
+    }
+
+    int lRet = pthread_cond_signal(&mCond);
+    assert(0 == lRet);
+}
+
+// Static functions
+/////////////////////////////////////////////////////////////////////////////
+
+bool Frame_IsValid(const uint8_t * aIn, unsigned int aSize_byte)
+{
+    assert(NULL != aIn);
+
+    if (DJI_FRAME_TOTAL_SIZE(0) > aSize_byte)
+    {
+        return false;
+    }
+
+    const DJI_Frame * lFrame = reinterpret_cast<const DJI_Frame *>(aIn);
+
+    uint32_t lCRC_32;
+
+    memcpy(&lCRC_32, aIn + aSize_byte - sizeof(lCRC_32), sizeof(lCRC_32));
+
+    return (DJI_CRC_16(aIn) == lFrame->mCRC16) && (DJI_CRC_32(aIn, aSize_byte - sizeof(lCRC_32)) == lCRC_32);
+}
+
+uint16_t Serial_Get(const uint8_t * aIn)
+{
+    assert(NULL != aIn);
+
+    uint16_t lResult;
+
+    memcpy(&lResult, aIn + OFFSET_SERIAL, sizeof(lResult));
+
+    return lResult;
+}
+
+uint64_t Time_Get_ns()
+{
+    timespec lNow;
+
+    clock_gettime(REPLAY_CLOCK, &lNow);
+
+    return static_cast<uint64_t>(lNow.tv_sec) * 1000000000 + lNow.tv_nsec;
+}
+
+// ===== Entry point ========================================================
+
+void * Run_Link(void * aContext)
+{
+    assert(NULL != aContext);
+
+    Replay_Device * lThis = reinterpret_cast<Replay_Device *>(aContext);
+
+    lThis->Run();
+
+    return NULL;
+}
@@ -0,0 +1,205 @@
+
+// Author  KMS - Martin Dubois, P. Eng.
+// Client  ZAP
+// Product Tacking
+// File    ZT_Lib/Replay_Device.h
+
+#pragma once
+
+// ===== C++ ================================================================
+#include <list>
+#include <map>
+#include <vector>
+
+// ===== C ==================================================================
+#include <pthread.h>
+
+// ===== Import/Includes ====================================================
+#include <EthCAN/Device.h>
+
+// ===== Includes ===========================================================
+#include <ZT/Result.h>
+
+// ===== ZT_Lib =============================================================
+#include "DJI_Reassembler.h"
+#include "FlightRecorder.h"
+
+// Class
+/////////////////////////////////////////////////////////////////////////////
+
+// EthCAN device playing back a CAN trace, usually the dump of a
+// FlightRecorder. Give it to a DJI_Gimbal in place of the real device.
+//
+// The trace is a list of steps. A step is a Tx frame of the recording and
+// the Rx fragments recorded after it. When the gimbal sends a frame, the
+// device looks for the next step sending the same command and delivers its
+// Rx fragments through the receiver, from its own thread, as the EthCAN
+// library does. The serial of the replies follows the serial of the new
+// Tx frames. The Rx fragments recorded before the first Tx frame are
+// delivered when the receiver starts.
+//
+// A Tx frame without matching step gets no reply, as on a silent CAN bus.
+// A Tx frame which failed during the recording fails the same way.
+class Replay_Device : public EthCAN::Device
+{
+
+public:
+
+    typedef enum
+    {
+        MODE_FAST,  // Deliver the Rx fragments without delay
+        MODE_TIMED, // Keep the delays of the recording
+
+        MODE_QTY
+    }
+    Mode;
+
+    typedef struct
+    {
+        unsigned int mRx_Fragment;
+        unsigned int mRx_Frame;
+        unsigned int mRx_Serial; // Reply serials replaced
+        unsigned int mTx_Error;  // Errors returned as recorded
+        unsigned int mTx_Frame;
+        unsigned int mTx_Unmatched;
+    }
+    Counters;
+
+    Replay_Device(Mode aMode);
+
+    // aFileName  A FlightRecorder dump
+    //
+    // Only the CAN_RX and CAN_TX records are used.
+    ZT::Result Load(const char * aFileName);
+
+    // Add a record at the end of the trace. Call it before starting the
+    // receiver.
+    void Record_Add(const FlightRecorder_Record & aRecord);
+
+    void Counters_Get(Counters * aOut) const;
+
+    // Return true once each step played and each delivered fragment
+    // reached the receiver
+    bool IsDone() const;
+
+    // ===== EthCAN::Object =================================================
+    virtual void Release();
+
+    // ===== EthCAN::Device =================================================
+    virtual EthCAN_Result CAN_Reset      ();
+    virtual EthCAN_Result Config_Get     (EthCAN_Config * aOut);
+    virtual EthCAN_Result GetInfo        (EthCAN_Info * aOut);
+    virtual EthCAN_Result Protocol_Reset ();
+    virtual EthCAN_Result Protocol_Set   (Protocol aProtocol);
+    virtual EthCAN_Result Receiver_Config();
+    virtual EthCAN_Result Receiver_Start (Receiver aReceiver, void * aContext);
+    virtual EthCAN_Result Receiver_Stop  ();
+    virtual EthCAN_Result Send           (const EthCAN_Frame & aFrame, uint8_t aFlags = 0);
+
+    // Internal
+
+    void Run();
+
+private:
+
+    typedef struct
+    {
+        uint64_t mTime_ns;
+        uint32_t mId;
+
+        uint8_t mData[8];
+        uint8_t mDataSize_byte;
+    }
+    Fragment;
+
+    // mReply  The fragments form a valid reply, its serial can be replaced
+    typedef struct
+    {
+        unsigned int mFirst;
+        unsigned int mCount;
+
+        bool     mReply;
+        uint16_t mSerial;
+    }
+    RxFrame;
+
+    typedef struct
+    {
+        uint64_t mTime_ns;
+
+        uint8_t  mCmdType;
+        uint8_t  mCmdSet;
+        uint8_t  mCmdId;
+        uint16_t mSerial;
+
+        EthCAN_Result mResult;
+
+        unsigned int mRx_First;
+        unsigned int mRx_Count;
+    }
+    Step;
+
+    typedef struct
+    {
+        uint64_t     mDeadline_ns;
+        unsigned int mFrame;
+    }
+    Delivery;
+
+    typedef std::list  <Delivery          > DeliveryList;
+    typedef std::vector<Fragment          > FragmentList;
+    typedef std::vector<RxFrame           > RxFrameList;
+    typedef std::map   <uint16_t, uint16_t> SerialMap;
+    typedef std::vector<Step              > StepList;
+
+    ~Replay_Device();
+
+    Replay_Device(const Replay_Device &);
+
+    const Replay_Device & operator = (const Replay_Device &);
+
+    void Deliver(unsigned int aFrame);
+
+    void Load_Rx(const FlightRecorder_Record & aRecord);
+    void Load_Rx_End(bool aReply);
+    void Load_Tx(const FlightRecorder_Record & aRecord);
+    void Load_Tx_End(EthCAN_Result aResult);
+
+    void Step_Play_Z0(unsigned int aStep);
+
+    // ===== Loading ========================================================
+    uint8_t      mLoad_Rx[DJI_REASSEMBLER_FRAME_MAX_byte];
+    unsigned int mLoad_Rx_Count;
+    unsigned int mLoad_Rx_Insert_byte;
+    unsigned int mLoad_Rx_Size_byte;
+    uint64_t     mLoad_Tx_ns;
+    uint8_t      mLoad_Tx[DJI_REASSEMBLER_FRAME_MAX_byte];
+    unsigned int mLoad_Tx_Size_byte;
+
+    // ===== Trace ==========================================================
+    FragmentList mFragments;
+    RxFrameList  mFrames;
+    StepList     mSteps;
+
+    // ===== Thread  Users ==================================================
+    uint8_t      mTx[DJI_REASSEMBLER_FRAME_MAX_byte];
+    unsigned int mTx_Size_byte;
+
+    // ===== Zone0 ==========================================================
+    Counters     mCounters;
+    DeliveryList mDeliveries;
+    bool         mDelivering;
+    SerialMap    mSerials;
+    unsigned int mStep_Next;
+    bool         mStop;
+
+    void   * mContext;
+    Mode     mMode;
+    Receiver mReceiver;
+
+    pthread_cond_t  mCond;
+    pthread_t       mThread;
+    bool            mThread_Running;
+    pthread_mutex_t mZone0;
+
+};
@@ -0,0 +1,139 @@
+
+// Author  KMS - Martin Dubois, P. Eng.
+// Client  ZAP
+// Product Tacking
+// File    ZT_Lib/Scheduler.cpp
+
+#include "Component.h"
+
+// ===== ZT_Lib =============================================================
+#include "Scheduler.h"
+
+// Public
+// //////////////////////////////////////////////////////////////////////////
+
+Scheduler::Scheduler() : mClass_Count(0), mTick(0), mTick_Idle(0)
+{
+    memset(&mClasses, 0, sizeof(mClasses));
+}
+
+void Scheduler::Class_Init(unsigned int aClass, const char * aName, unsigned int aWeight, unsigned int aBudget)
+{
+    assert(SCHEDULER_CLASS_MAX > aClass);
+    assert(NULL != aName);
+    assert(SCHEDULER_SLOT <= aBudget);
+
+    Class & lC = mClasses[aClass];
+
+    lC.mBudget = aBudget;
+    lC.mName   = aName;
+    lC.mWeight = aWeight;
+
+    if (mClass_Count <= aClass)
+    {
+        mClass_Count = aClass + 1;
+    }
+}
+
+void Scheduler::Class_Weight_Set(unsigned int aClass, unsigned int aWeight)
+{
+    assert(mClass_Count > aClass);
+
+    mClasses[aClass].mWeight = aWeight;
+}
+
+bool Scheduler::Tick(unsigned int * aClass, unsigned int aReady)
+{
+    assert(NULL != aClass);
+
+    mTick ++;
+
+    Class * lSelected = NULL;
+
+    for (unsigned int c = 0; c < mClass_Count; c++)
+    {
+        Class & lC = mClasses[c];
+
+        if (0 == (aReady & (1 << c)))
+        {
+            lC.mCredit    = 0;
+            lC.mLast_tick = mTick;
+        }
+        else
+        {
+            lC.mCredit += lC.mWeight;
+            if (lC.mBudget < lC.mCredit)
+            {
+                lC.mCredit = lC.mBudget;
+            }
+
+            if ((SCHEDULER_SLOT <= lC.mCredit) && ((NULL == lSelected) || (lSelected->mCredit < lC.mCredit)))
+            {
+                lSelected = &lC;
+                *aClass   = c;
+            }
+        }
+    }
+
+    if (NULL == lSelected)
+    {
+        mTick_Idle ++;
+        return false;
+    }
+
+    lSelected->mCredit      -= SCHEDULER_SLOT;
+    lSelected->mElapsed_tick = mTick - lSelected->mLast_tick;
+    lSelected->mLast_tick    = mTick;
+    lSelected->mSlot        ++;
+
+    return true;
+}
+
+unsigned int Scheduler::Elapsed_Get(unsigned int aClass) const
+{
+    assert(mClass_Count > aClass);
+
+    return mClasses[aClass].mElapsed_tick;
+}
+
+void Scheduler::Account(unsigned int aClass, unsigned int aSize_byte)
+{
+    assert(mClass_Count > aClass);
+
+    mClasses[aClass].mByte += aSize_byte;
+}
+
+void Scheduler::Credit_Reset(unsigned int aClass)
+{
+    assert(mClass_Count > aClass);
+
+    mClasses[aClass].mCredit    = 0;
+    mClasses[aClass].mLast_tick = mTick;
+}
+
+void Scheduler::Display(FILE * aOut) const
+{
+    assert(NULL != aOut);
+
+    unsigned int lTotal_byte = 0;
+
+    for (unsigned int c = 0; c < mClass_Count; c++)
+    {
+        lTotal_byte += mClasses[c].mByte;
+    }
+
+    fprintf(aOut, "    ===== Scheduler =====\n");
+    fprintf(aOut, "    Ticks           : %u, %u idle\n", mTick, mTick_Idle);
+
+    for (unsigned int c = 0; c < mClass_Count; c++)
+    {
+        const Class & lC = mClasses[c];
+
+        if (NULL != lC.mName)
+        {
+            fprintf(aOut, "    %-15s : weight %u, %u slots (%.1f %%), %u bytes (%.1f %%)\n", lC.mName, lC.mWeight,
+                lC.mSlot, (0 < mTick     ) ? lC.mSlot * 100.0 / mTick      : 0.0,
+                lC.mByte, (0 < lTotal_byte) ? lC.mByte * 100.0 / lTotal_byte : 0.0);
+        }
+    }
+}
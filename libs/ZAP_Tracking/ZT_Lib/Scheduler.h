@@ -0,0 +1,90 @@
+
+// Author  KMS - Martin Dubois, P. Eng.
+// Client  ZAP
+// Product Tacking
+// File    ZT_Lib/Scheduler.h
+
+#pragma once
+
+// Constants
+/////////////////////////////////////////////////////////////////////////////
+
+#define SCHEDULER_CLASS_MAX (8)
+
+// The credit one tick slot costs. A weight of SCHEDULER_SLOT gives a slot at
+// each tick, a weight of SCHEDULER_SLOT / 4 a slot every 4 ticks.
+#define SCHEDULER_SLOT (100)
+
+// Class
+/////////////////////////////////////////////////////////////////////////////
+
+// Gives the slot of each tick to one of the work classes. A ready class
+// earns its weight in credit at each tick, up to its budget. The ready class
+// with the most credit gets the slot when it has enough credit to pay for
+// it. A class that is not ready loses its credit, idle work does not take
+// slots away from the others when it wakes up. When the work does not fit
+// in the slots, the credits reach the budgets and the lower class index
+// wins the ties, so the first classes have priority.
+//
+// Thread  Worker
+class Scheduler
+{
+
+public:
+
+    Scheduler();
+
+    // aClass   The index of the class
+    // aName    The name used by Display
+    // aWeight  The credit earned at each tick
+    // aBudget  The maximum credit, SCHEDULER_SLOT or more
+    void Class_Init(unsigned int aClass, const char * aName, unsigned int aWeight, unsigned int aBudget);
+
+    void Class_Weight_Set(unsigned int aClass, unsigned int aWeight);
+
+    // aClass [---;-W-] The class getting the slot
+    // aReady           One bit per class, set when the class has work
+    //
+    // Return false when no class gets the slot
+    bool Tick(unsigned int * aClass, unsigned int aReady);
+
+    // Return the number of ticks since the class became ready or since its
+    // previous slot, the current slot included
+    unsigned int Elapsed_Get(unsigned int aClass) const;
+
+    // The bytes a class sent during its slot
+    void Account(unsigned int aClass, unsigned int aSize_byte);
+
+    // The class lose its credit, for example because its work was done
+    // outside of its slot
+    void Credit_Reset(unsigned int aClass);
+
+    void Display(FILE * aOut) const;
+
+private:
+
+    typedef struct
+    {
+        const char * mName;
+
+        unsigned int mBudget;
+        unsigned int mCredit;
+        unsigned int mWeight;
+
+        unsigned int mElapsed_tick;
+        unsigned int mLast_tick;
+
+        // ===== Statistics =================================================
+        unsigned int mByte;
+        unsigned int mSlot;
+    }
+    Class;
+
+    Class mClasses[SCHEDULER_CLASS_MAX];
+
+    unsigned int mClass_Count;
+
+    unsigned int mTick;
+    unsigned int mTick_Idle;
+
+};
@@ -0,0 +1,53 @@
+
+// Author  KMS - Martin Dubois, P. Eng.
+// Client  ZAP
+// Product Tacking
+// File    ZT_Lib/Sim_Detector.cpp
+
+#include "Component.h"
+
+// ===== ZT_Lib =============================================================
+#include "DJI_Connector.h"
+#include "DJI_Gimbal.h"
+
+#include "Sim_Detector.h"
+
+// Public
+/////////////////////////////////////////////////////////////////////////////
+
+Sim_Detector::Sim_Detector(unsigned int aGimbal_Count, const Sim_Device::Config & aConfig)
+    : mConfig(aConfig), mGimbal_Count(aGimbal_Count)
+{
+    assert(0 < aGimbal_Count);
+    assert(SIM_DETECTOR_GIMBAL_MAX >= aGimbal_Count);
+}
+
+// ===== IDetector ==========================================================
+
+void Sim_Detector::Gamepads_Detect(GamepadList *)
+{
+}
+
+void Sim_Detector::Gimbals_Detect(GimbalList *aList)
+{
+    assert(NULL != aList);
+
+    DJI_Connector * lConnector = new DJI_Connector();
+    assert(NULL != lConnector);
+
+    for (unsigned int i = 0; i < mGimbal_Count; i ++)
+    {
+        Sim_Device::Config lConfig = mConfig;
+
+        lConfig.mIPv4_Address = 127 | (1 << 8) | ((i + 1) << 24);
+        lConfig.mSeed        += i;
+
+        DJI_Gimbal * lGimbal = new DJI_Gimbal(new Sim_Device(lConfig));
+        assert(NULL != lGimbal);
+
+        lConnector->Add(lGimbal);
+    }
+
+    lConnector->Run(aList);
+    lConnector->Release();
+}
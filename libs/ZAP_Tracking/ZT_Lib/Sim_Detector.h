@@ -0,0 +1,40 @@
+
+// Author  KMS - Martin Dubois, P. Eng.
+// Client  ZAP
+// Product Tacking
+// File    ZT_Lib/Sim_Detector.h
+
+#pragma once
+
+// ===== ZT_Lib =============================================================
+#include "IDetector.h"
+#include "Sim_Device.h"
+
+// Constants
+/////////////////////////////////////////////////////////////////////////////
+
+#define SIM_DETECTOR_GIMBAL_MAX (64)
+
+// Class
+/////////////////////////////////////////////////////////////////////////////
+
+// Each detection creates aGimbal_Count DJI_Gimbal using a Sim_Device. The
+// gimbal i uses the address 127.1.0.(i + 1) and the seed mSeed + i.
+class Sim_Detector : public IDetector
+{
+
+public:
+
+    // aGimbal_Count  1 to SIM_DETECTOR_GIMBAL_MAX
+    Sim_Detector(unsigned int aGimbal_Count, const Sim_Device::Config & aConfig = Sim_Device::CONFIG_DEFAULT);
+
+    // ===== IDetector ======================================================
+    virtual void Gamepads_Detect(GamepadList *aList);
+    virtual void Gimbals_Detect (GimbalList  *aList);
+
+private:
+
+    Sim_Device::Config mConfig;
+    unsigned int       mGimbal_Count;
+
+};
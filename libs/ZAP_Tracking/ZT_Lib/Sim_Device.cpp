@@ -0,0 +1,694 @@
+
+// Author  KMS - Martin Dubois, P. Eng.
+// Client  ZAP
+// Product Tacking
+// File    ZT_Lib/Sim_Device.cpp
+
+#include "Component.h"
+
+// ===== C ==================================================================
+#include <errno.h>
+#include <math.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+
+// ===== ZT_Lib =============================================================
+#include "CAN_Batch.h"
+#include "DJI.h"
+#include "Gimbal.h"
+
+#include "Sim_Device.h"
+
+// Constants
+/////////////////////////////////////////////////////////////////////////////
+
+// See Thread.cpp
+#ifdef __APPLE__
+    #define SIM_CLOCK CLOCK_REALTIME
+#else
+    #define SIM_CLOCK CLOCK_MONOTONIC
+#endif
+
+// The gimbal stops when no SPEED_SET comes during this time
+#define SIM_SPEED_TIMEOUT_ms (500)
+
+// Integration step while a reference moves
+#define STEP_ns (1000000)
+
+static const uint8_t LIMIT_MAX_deg[ZT::IGimbal::AXIS_QTY] = {  90,  30, 180 };
+static const uint8_t LIMIT_MIN_deg[ZT::IGimbal::AXIS_QTY] = {  90,  30, 180 };
+
+static const uint8_t VERSION[3] = { 0x04, 0x01, 0x02 };
+
+// Offsets in the data of the frames, see DJI_Transaction.cpp and
+// DJI_Gimbal.cpp
+
+static const unsigned int OFFSETS_ANGLE_GET  [ZT::IGimbal::AXIS_QTY] = { 8, 6, 4 };
+static const unsigned int OFFSETS_LIMIT      [ZT::IGimbal::AXIS_QTY] = { 3, 7, 5 };
+static const unsigned int OFFSETS_POSITION   [ZT::IGimbal::AXIS_QTY] = { 6, 4, 2 };
+static const unsigned int OFFSETS_STIFFNESS_GET[ZT::IGimbal::AXIS_QTY] = { 3, 5, 4 };
+static const unsigned int OFFSETS_STIFFNESS_SET[ZT::IGimbal::AXIS_QTY] = { 3, 4, 5 };
+
+static const uint8_t POSITION_IGNORE[ZT::IGimbal::AXIS_QTY] = { 0x08, 0x04, 0x02 };
+
+// Static function declarations
+/////////////////////////////////////////////////////////////////////////////
+
+static int16_t Int16_Get(const uint8_t * aIn);
+
+static uint64_t Time_Get_ns();
+
+// ===== Entry point ========================================================
+
+static void * Run_Link(void * aContext);
+
+// Public
+/////////////////////////////////////////////////////////////////////////////
+
+const Sim_Device::Config Sim_Device::CONFIG_DEFAULT = { 0, 0, 1000, 2000, 0.0, 1, 50.0 };
+
+Sim_Device::Sim_Device(const Config & aConfig)
+    : mDelivery_Count(0)
+    , mDelivery_Out(0)
+    , mFocus_pc(0.0)
+    , mLast_ns(0)
+    , mMotors_ns(Time_Get_ns())
+    , mRandom(aConfig.mSeed)
+    , mReassembler(&mStats, false)
+    , mStop(false)
+    , mTrack(false)
+    , mTrack_Speed(0)
+    , mConfig(aConfig)
+    , mContext(NULL)
+    , mReceiver(NULL)
+    , mThread_Running(false)
+{
+    assert(0.0 <= aConfig.mLoss_pc);
+    assert(100.0 >= aConfig.mLoss_pc);
+    assert(0.0 < aConfig.mTau_ms);
+
+    memset(&mCounters, 0, sizeof(mCounters));
+    memset(&mMotors  , 0, sizeof(mMotors  ));
+
+    FOR_EACH_AXIS(a)
+    {
+        mMotors[a].mLimit_Max_deg = LIMIT_MAX_deg[a];
+        mMotors[a].mLimit_Min_deg = LIMIT_MIN_deg[a];
+        mMotors[a].mStiffness_pc  = 50;
+    }
+
+    pthread_condattr_t lAttr;
+
+    int lRet = pthread_condattr_init(&lAttr);
+    assert(0 == lRet);
+
+    #ifndef __APPLE__
+        lRet = pthread_condattr_setclock(&lAttr, SIM_CLOCK);
+        assert(0 == lRet);
+    #endif
+
+    lRet = pthread_cond_init(&mCond, &lAttr);
+    assert(0 == lRet);
+
+    lRet = pthread_condattr_destroy(&lAttr);
+    assert(0 == lRet);
+
+    lRet = pthread_mutex_init(&mZone0, NULL);
+    assert(0 == lRet);
+}
+
+void Sim_Device::Counters_Get(Counters * aOut) const
+{
+    assert(NULL != aOut);
+
+    Sim_Device * lThis = const_cast<Sim_Device *>(this);
+
+    int lRet = pthread_mutex_lock(&lThis->mZone0);
+    assert(0 == lRet);
+    {
+        *aOut = mCounters;
+    }
+    lRet = pthread_mutex_unlock(&lThis->mZone0);
+    assert(0 == lRet);
+}
+
+void Sim_Device::Loss_Set(double aLoss_pc)
+{
+    assert(0.0 <= aLoss_pc);
+    assert(100.0 >= aLoss_pc);
+
+    int lRet = pthread_mutex_lock(&mZone0);
+    assert(0 == lRet);
+    {
+        mConfig.mLoss_pc = aLoss_pc;
+    }
+    lRet = pthread_mutex_unlock(&mZone0);
+    assert(0 == lRet);
+}
+
+void Sim_Device::Position_Get(ZT::IGimbal::Position * aOut)
+{
+    assert(NULL != aOut);
+
+    int lRet = pthread_mutex_lock(&mZone0);
+    assert(0 == lRet);
+    {
+        Motors_Update_Z0(Time_Get_ns());
+
+        FOR_EACH_AXIS(a)
+        {
+            aOut->mAxis_deg[a] = mMotors[a].mAngle_deg;
+        }
+    }
+    lRet = pthread_mutex_unlock(&mZone0);
+    assert(0 == lRet);
+}
+
+// ===== EthCAN::Object =====================================================
+
+void Sim_Device::Release()
+{
+    delete this;
+}
+
+// ===== EthCAN::Device =====================================================
+
+EthCAN_Result Sim_Device::Protocol_Reset () { return EthCAN_OK; }
+EthCAN_Result Sim_Device::Receiver_Config() { return EthCAN_OK; }
+
+EthCAN_Result Sim_Device::CAN_Reset()
+{
+    Call();
+
+    int lRet = pthread_mutex_lock(&mZone0);
+    assert(0 == lRet);
+    {
+        mCounters.mCAN_Reset ++;
+    }
+    lRet = pthread_mutex_unlock(&mZone0);
+    assert(0 == lRet);
+
+    return EthCAN_OK;
+}
+
+EthCAN_Result Sim_Device::Protocol_Set(Protocol aProtocol)
+{
+    Call();
+
+    return EthCAN_OK;
+}
+
+EthCAN_Result Sim_Device::Config_Get(EthCAN_Config * aOut)
+{
+    assert(NULL != aOut);
+
+    Call();
+
+    memset(aOut, 0, sizeof(EthCAN_Config));
+
+    aOut->mCAN_Filters[0] = DJI_CAN_ID_RX;
+    aOut->mCAN_Masks  [0] = 0x7ff;
+    aOut->mCAN_Rate       = EthCAN_RATE_1_Mb;
+
+    return EthCAN_OK;
+}
+
+EthCAN_Result Sim_Device::GetInfo(EthCAN_Info * aOut)
+{
+    assert(NULL != aOut);
+
+    Call();
+
+    memset(aOut, 0, sizeof(EthCAN_Info));
+
+    aOut->mIPv4_Address = mConfig.mIPv4_Address;
+
+    strncpy(aOut->mName, "Simulator", sizeof(aOut->mName) - 1);
+
+    return EthCAN_OK;
+}
+
+EthCAN_Result Sim_Device::Receiver_Start(Receiver aReceiver, void * aContext)
+{
+    assert(NULL != aReceiver);
+
+    if (mThread_Running)
+    {
+        return EthCAN_ERROR;
+    }
+
+    mContext  = aContext;
+    mReceiver = aReceiver;
+    mStop     = false;
+
+    int lRet = pthread_create(&mThread, NULL, Run_Link, this);
+    if (0 != lRet)
+    {
+        return EthCAN_ERROR;
+    }
+
+    mThread_Running = true;
+
+    return EthCAN_OK;
+}
+
+EthCAN_Result Sim_Device::Receiver_Stop()
+{
+    if (!mThread_Running)
+    {
+        return EthCAN_ERROR;
+    }
+
+    int lRet = pthread_mutex_lock(&mZone0);
+    assert(0 == lRet);
+    {
+        mStop = true;
+
+        lRet = pthread_cond_signal(&mCond);
+        assert(0 == lRet);
+    }
+    lRet = pthread_mutex_unlock(&mZone0);
+    assert(0 == lRet);
+
+    lRet = pthread_join(mThread, NULL);
+    assert(0 == lRet);
+
+    mThread_Running = false;
+
+    return EthCAN_OK;
+}
+
+EthCAN_Result Sim_Device::Send(const EthCAN_Frame & aFrame, uint8_t aFlags)
+{
+    if (DJI_CAN_ID_TX != aFrame.mId)
+    {
+        return EthCAN_OK;
+    }
+
+    int lRet = pthread_mutex_lock(&mZone0);
+    assert(0 == lRet);
+    {
+        mReassembler.Push(aFrame.mData, aFrame.mDataSize_byte);
+
+        const DJI_Frame * lRequest;
+
+        while (NULL != (lRequest = mReassembler.Next()))
+        {
+            mCounters.mRx_Frame ++;
+
+            if (Lost_Z0())
+            {
+                mCounters.mRx_Lost ++;
+            }
+            else
+            {
+                Request_Z0(*lRequest);
+            }
+        }
+    }
+    lRet = pthread_mutex_unlock(&mZone0);
+    assert(0 == lRet);
+
+    return EthCAN_OK;
+}
+
+// Internal
+/////////////////////////////////////////////////////////////////////////////
+
+// Thread  Simulator
+void Sim_Device::Run()
+{
+    int lRet = pthread_mutex_lock(&mZone0);
+    assert(0 == lRet);
+
+    while (!mStop)
+    {
+        if (0 >= mDelivery_Count)
+        {
+            lRet = pthread_cond_wait(&mCond, &mZone0);
+            assert(0 == lRet);
+            continue;
+        }
+
+        const Delivery & lD = mDeliveries[mDelivery_Out];
+
+        if (Time_Get_ns() < lD.mDeadline_ns)
+        {
+            timespec lDeadline;
+
+            lDeadline.tv_sec  = lD.mDeadline_ns / 1000000000;
+            lDeadline.tv_nsec = lD.mDeadline_ns % 1000000000;
+
+            lRet = pthread_cond_timedwait(&mCond, &mZone0, &lDeadline);
+            assert((0 == lRet) || (ETIMEDOUT == lRet));
+            continue;
+        }
+
+        EthCAN_Frame lFrame = lD.mFrame;
+
+        mDelivery_Count --;
+        mDelivery_Out = (mDelivery_Out + 1) % SIM_DEVICE_DELIVERY_QTY;
+
+        lRet = pthread_mutex_unlock(&mZone0);
+        assert(0 == lRet);
+        {
+            mReceiver(this, mContext, lFrame);
+        }
+        lRet = pthread_mutex_lock(&mZone0);
+        assert(0 == lRet);
+    }
+
+    lRet = pthread_mutex_unlock(&mZone0);
+    assert(0 == lRet);
+}
+
+// Private
+/////////////////////////////////////////////////////////////////////////////
+
+Sim_Device::~Sim_Device()
+{
+    if (mThread_Running)
+    {
+        Receiver_Stop();
+    }
+
+    int lRet = pthread_cond_destroy(&mCond);
+    assert(0 == lRet);
+
+    lRet = pthread_mutex_destroy(&mZone0);
+    assert(0 == lRet);
+}
+
+// Thread  Users
+void Sim_Device::Call() const
+{
+    if (0 < mConfig.mCall_us)
+    {
+        usleep(mConfig.mCall_us);
+    }
+}
+
+bool Sim_Device::Lost_Z0()
+{
+    if (0.0 >= mConfig.mLoss_pc)
+    {
+        return false;
+    }
+
+    return (100.0 * rand_r(&mRandom) / RAND_MAX) < mConfig.mLoss_pc;
+}
+
+// The integration uses small steps while a reference moves and one exact
+// step once all of them are still, so an idle gimbal costs nothing.
+void Sim_Device::Motors_Update_Z0(uint64_t aNow_ns)
+{
+    while (mMotors_ns < aNow_ns)
+    {
+        bool lMoving = false;
+
+        FOR_EACH_AXIS(a)
+        {
+            const Motor & lM = mMotors[a];
+
+            lMoving |= (mMotors_ns < lM.mEnd_ns) || (mMotors_ns < lM.mSpeed_End_ns);
+        }
+
+        uint64_t lStep_ns = aNow_ns - mMotors_ns;
+
+        if (lMoving && (STEP_ns < lStep_ns))
+        {
+            lStep_ns = STEP_ns;
+        }
+
+        mMotors_ns += lStep_ns;
+
+        double lK = 1.0 - exp(- static_cast<double>(lStep_ns) / (mConfig.mTau_ms * 1000000.0));
+
+        FOR_EACH_AXIS(a)
+        {
+            Motor * lM = mMotors + a;
+
+            Reference_Update_Z0(lM, mMotors_ns, lStep_ns / 1000000000.0);
+
+            lM->mAngle_deg += (lM->mReference_deg - lM->mAngle_deg) * lK;
+        }
+    }
+}
+
+void Sim_Device::Reference_Update_Z0(Motor * aMotor, uint64_t aNow_ns, double aStep_s)
+{
+    assert(NULL != aMotor);
+
+    if (aMotor->mFrom_ns < aMotor->mEnd_ns)
+    {
+        if (aMotor->mEnd_ns <= aNow_ns)
+        {
+            aMotor->mReference_deg = aMotor->mTo_deg;
+            aMotor->mEnd_ns        = 0;
+            aMotor->mFrom_ns       = 0;
+        }
+        else
+        {
+            double lRatio = static_cast<double>(aNow_ns - aMotor->mFrom_ns) / (aMotor->mEnd_ns - aMotor->mFrom_ns);
+
+            aMotor->mReference_deg = aMotor->mFrom_deg + (aMotor->mTo_deg - aMotor->mFrom_deg) * lRatio;
+        }
+    }
+    else if (aNow_ns <= aMotor->mSpeed_End_ns)
+    {
+        aMotor->mReference_deg += aMotor->mSpeed_deg_s * aStep_s;
+    }
+
+    if (aMotor->mLimit_Max_deg < aMotor->mReference_deg)
+    {
+        aMotor->mReference_deg = aMotor->mLimit_Max_deg;
+    }
+
+    if (- aMotor->mLimit_Min_deg > aMotor->mReference_deg)
+    {
+        aMotor->mReference_deg = - aMotor->mLimit_Min_deg;
+    }
+}
+
+// The fragments of a reply keep the order of the requests, the jitter only
+// delays them.
+void Sim_Device::Reply_Z0(const DJI_Frame & aRequest, const uint8_t * aData, unsigned int aDataSize_byte)
+{
+    assert(NULL != aData);
+    assert(DJI_DATA_CMD_ID < aDataSize_byte);
+
+    mCounters.mTx_Frame ++;
+
+    if (Lost_Z0())
+    {
+        mCounters.mTx_Lost ++;
+        return;
+    }
+
+    DJI_Frame lReply;
+
+    lReply.Init(aDataSize_byte, DJI_CMD_TYPE_REPLY, aData[DJI_DATA_CMD_SET], aData[DJI_DATA_CMD_ID], aRequest.mSerial);
+
+    memcpy(lReply.mData, aData, aDataSize_byte);
+
+    lReply.Seal();
+
+    CAN_Batch lBatch;
+
+    bool lRet = lBatch.Frame_Add(lReply, DJI_CAN_ID_RX);
+    assert(lRet);
+
+    if (SIM_DEVICE_DELIVERY_QTY - mDelivery_Count < lBatch.Count_Get())
+    {
+        mCounters.mTx_Lost ++;
+        return;
+    }
+
+    uint64_t lDeadline_ns = Time_Get_ns() + mConfig.mLatency_us * 1000ULL;
+
+    if (0 < mConfig.mJitter_us)
+    {
+        lDeadline_ns += (rand_r(&mRandom) % (mConfig.mJitter_us + 1)) * 1000ULL;
+    }
+
+    if (mLast_ns > lDeadline_ns)
+    {
+        lDeadline_ns = mLast_ns;
+    }
+
+    mLast_ns = lDeadline_ns;
+
+    // The simulator does not allocate, so the tests see only the
+    // allocations of DJI_Gimbal.
+    for (unsigned int i = 0; i < lBatch.Count_Get(); i++)
+    {
+        Delivery & lD = mDeliveries[(mDelivery_Out + mDelivery_Count) % SIM_DEVICE_DELIVERY_QTY];
+
+        lD.mDeadline_ns = lDeadline_ns;
+        lD.mFrame       = lBatch.Frames_Get()[i];
+
+        mDelivery_Count ++;
+    }
+
+    int lRetI = pthread_cond_signal(&mCond);
+    assert(0 == lRetI);
+}
+
+void Sim_Device::Request_Z0(const DJI_Frame & aRequest)
+{
+    uint8_t lData[16];
+
+    memset(&lData, 0, sizeof(lData));
+
+    lData[DJI_DATA_CMD_SET] = aRequest.mData[DJI_DATA_CMD_SET];
+    lData[DJI_DATA_CMD_ID ] = aRequest.mData[DJI_DATA_CMD_ID ];
+    lData[DJI_REPLY_RESULT] = DJI_OK;
+
+    unsigned int lDataSize_byte = 3;
+
+    uint64_t lNow_ns = Time_Get_ns();
+
+    Motors_Update_Z0(lNow_ns);
+
+    if (DJI_CMD_SET_DEFAULT != aRequest.mData[DJI_DATA_CMD_SET])
+    {
+        lData[DJI_REPLY_RESULT] = DJI_ERROR_PARSE;
+    }
+    else
+    {
+        switch (aRequest.mData[DJI_DATA_CMD_ID])
+        {
+        case DJI_CMD_POSITION_SET:
+            FOR_EACH_AXIS(a)
+            {
+                if (0 == (aRequest.mData[8] & POSITION_IGNORE[a]))
+                {
+                    Motor * lM = mMotors + a;
+
+                    lM->mFrom_deg     = lM->mReference_deg;
+                    lM->mFrom_ns      = lNow_ns;
+                    lM->mEnd_ns       = lNow_ns + aRequest.mData[9] * 100000000ULL + 1;
+                    lM->mSpeed_End_ns = 0;
+                    lM->mTo_deg       = aRequest.Angle_Get(OFFSETS_POSITION[a]);
+                }
+            }
+            break;
+
+        case DJI_CMD_SPEED_SET:
+            FOR_EACH_AXIS(a)
+            {
+                Motor * lM = mMotors + a;
+
+                lM->mEnd_ns       = 0;
+                lM->mFrom_ns      = 0;
+                lM->mSpeed_deg_s  = static_cast<double>(Int16_Get(aRequest.mData + OFFSETS_POSITION[a])) / 10.0;
+                lM->mSpeed_End_ns = lNow_ns + SIM_SPEED_TIMEOUT_ms * 1000000ULL;
+            }
+            break;
+
+        case DJI_CMD_ANGLE_GET:
+            lData[3] = 0x01;
+
+            FOR_EACH_AXIS(a)
+            {
+                int16_t lAngle = static_cast<int16_t>(mMotors[a].mAngle_deg * 10.0);
+
+                lData[OFFSETS_ANGLE_GET[a]    ] = lAngle & 0xff;
+                lData[OFFSETS_ANGLE_GET[a] + 1] = lAngle >> 8;
+            }
+
+            lDataSize_byte = 10;
+            break;
+
+        case DJI_CMD_ANGLE_LIMIT_SET:
+            FOR_EACH_AXIS(a)
+            {
+                mMotors[a].mLimit_Max_deg = aRequest.mData[OFFSETS_LIMIT[a]    ];
+                mMotors[a].mLimit_Min_deg = aRequest.mData[OFFSETS_LIMIT[a] + 1];
+            }
+            break;
+
+        case DJI_CMD_ANGLE_LIMIT_GET:
+            FOR_EACH_AXIS(a)
+            {
+                lData[OFFSETS_LIMIT[a]    ] = mMotors[a].mLimit_Max_deg;
+                lData[OFFSETS_LIMIT[a] + 1] = mMotors[a].mLimit_Min_deg;
+            }
+
+            lDataSize_byte = 9;
+            break;
+
+        case DJI_CMD_MOTOR_STIFFNESS_SET:
+            FOR_EACH_AXIS(a)
+            {
+                mMotors[a].mStiffness_pc = aRequest.mData[OFFSETS_STIFFNESS_SET[a]];
+            }
+            break;
+
+        case DJI_CMD_MOTOR_STIFFNESS_GET:
+            FOR_EACH_AXIS(a)
+            {
+                lData[OFFSETS_STIFFNESS_GET[a]] = mMotors[a].mStiffness_pc;
+            }
+
+            lDataSize_byte = 6;
+            break;
+
+        case DJI_CMD_VERSION:
+            memcpy(lData + 3, VERSION, sizeof(VERSION));
+
+            lDataSize_byte = 11;
+            break;
+
+        case DJI_CMD_TLV_SET     : mTrack_Speed = aRequest.mData[4]; break;
+        case DJI_CMD_TRACK_SWITCH: mTrack       = !mTrack          ; break;
+
+        case DJI_CMD_FOCUS:
+            if (DJI_CMD_FOCUS_SET == aRequest.mData[2])
+            {
+                mFocus_pc = Int16_Get(aRequest.mData + 5) * 100.0 / 4095.0;
+            }
+            break;
+
+        default: lData[DJI_REPLY_RESULT] = DJI_ERROR_FAIL;
+        }
+    }
+
+    if (DJI_CMD_TYPE_DO_REPLY == aRequest.mCmdType)
+    {
+        Reply_Z0(aRequest, lData, lDataSize_byte);
+    }
+}
+
+// Static functions
+/////////////////////////////////////////////////////////////////////////////
+
+int16_t Int16_Get(const uint8_t * aIn)
+{
+    assert(NULL != aIn);
+
+    return static_cast<int16_t>(aIn[0] | (aIn[1] << 8));
+}
+
+uint64_t Time_Get_ns()
+{
+    timespec lNow;
+
+    clock_gettime(SIM_CLOCK, &lNow);
+
+    return static_cast<uint64_t>(lNow.tv_sec) * 1000000000 + lNow.tv_nsec;
+}
+
+// ===== Entry point ========================================================
+
+void * Run_Link(void * aContext)
+{
+    assert(NULL != aContext);
+
+    Sim_Device * lThis = reinterpret_cast<Sim_Device *>(aContext);
+
+    lThis->Run();
+
+    return NULL;
+}
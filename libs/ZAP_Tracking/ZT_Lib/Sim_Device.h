@@ -0,0 +1,179 @@
+
+// Author  KMS - Martin Dubois, P. Eng.
+// Client  ZAP
+// Product Tacking
+// File    ZT_Lib/Sim_Device.h
+
+#pragma once
+
+// ===== C ==================================================================
+#include <pthread.h>
+
+// ===== Import/Includes ====================================================
+#include <EthCAN/Device.h>
+
+// ===== Includes ===========================================================
+#include <ZT/IGimbal.h>
+
+// ===== ZT_Lib =============================================================
+#include "DJI_Reassembler.h"
+#include "Stats.h"
+
+// Constants
+/////////////////////////////////////////////////////////////////////////////
+
+// The CAN frames waiting for their delivery. A reply which does not fit is
+// lost.
+#define SIM_DEVICE_DELIVERY_QTY (256)
+
+// Class
+/////////////////////////////////////////////////////////////////////////////
+
+// EthCAN device simulating a DJI gimbal on its CAN bus. It answers the DJI
+// frames DJI_Gimbal sends: POSITION_SET, SPEED_SET, ANGLE_GET, the angle
+// limits, the motor stiffness, the focus, TLV_SET, TRACK_SWITCH and
+// VERSION.
+//
+// Each motor follows its reference with a first order response. A
+// POSITION_SET moves the reference to the target during the requested
+// duration. A SPEED_SET moves it at the requested speed for
+// SIM_SPEED_TIMEOUT_ms. The angle limits bound the reference.
+//
+// The replies go through the receiver from the device thread, after the
+// configured latency and jitter. The frames lost in either direction are
+// dropped as a whole. The synchronous calls last mCall_us, as the TCP round
+// trips to a real EthCAN device.
+class Sim_Device : public EthCAN::Device
+{
+
+public:
+
+    typedef struct
+    {
+        uint32_t mIPv4_Address;
+
+        unsigned int mCall_us;    // Config_Get, GetInfo and Protocol_Set
+        unsigned int mJitter_us;  // Uniform, 0 to mJitter_us
+        unsigned int mLatency_us; // Request to reply
+        double       mLoss_pc;    // Each direction
+        unsigned int mSeed;
+        double       mTau_ms;     // Time constant of the motors
+    }
+    Config;
+
+    typedef struct
+    {
+        unsigned int mCAN_Reset;
+        unsigned int mRx_Frame;
+        unsigned int mRx_Lost;
+        unsigned int mTx_Frame;
+        unsigned int mTx_Lost;
+    }
+    Counters;
+
+    // Immediate calls, 2 ms latency, 1 ms jitter, no loss, 50 ms time
+    // constant
+    static const Config CONFIG_DEFAULT;
+
+    Sim_Device(const Config & aConfig);
+
+    void Counters_Get(Counters * aOut) const;
+
+    // aLoss_pc  100.0 simulates a gimbal going off
+    void Loss_Set(double aLoss_pc);
+
+    // Return the simulated angles, not the ones the gimbal reports
+    void Position_Get(ZT::IGimbal::Position * aOut);
+
+    // ===== EthCAN::Object =================================================
+    virtual void Release();
+
+    // ===== EthCAN::Device =================================================
+    virtual EthCAN_Result CAN_Reset      ();
+    virtual EthCAN_Result Config_Get     (EthCAN_Config * aOut);
+    virtual EthCAN_Result GetInfo        (EthCAN_Info * aOut);
+    virtual EthCAN_Result Protocol_Reset ();
+    virtual EthCAN_Result Protocol_Set   (Protocol aProtocol);
+    virtual EthCAN_Result Receiver_Config();
+    virtual EthCAN_Result Receiver_Start (Receiver aReceiver, void * aContext);
+    virtual EthCAN_Result Receiver_Stop  ();
+    virtual EthCAN_Result Send           (const EthCAN_Frame & aFrame, uint8_t aFlags = 0);
+
+    // Internal
+
+    void Run();
+
+private:
+
+    typedef struct
+    {
+        double mAngle_deg;
+        double mReference_deg;
+
+        // Position
+        uint64_t mEnd_ns;
+        double   mFrom_deg;
+        uint64_t mFrom_ns;
+        double   mTo_deg;
+
+        // Speed
+        double   mSpeed_deg_s;
+        uint64_t mSpeed_End_ns;
+
+        uint8_t mLimit_Max_deg;
+        uint8_t mLimit_Min_deg;
+        uint8_t mStiffness_pc;
+    }
+    Motor;
+
+    typedef struct
+    {
+        uint64_t     mDeadline_ns;
+        EthCAN_Frame mFrame;
+    }
+    Delivery;
+
+    ~Sim_Device();
+
+    Sim_Device(const Sim_Device &);
+
+    const Sim_Device & operator = (const Sim_Device &);
+
+    void Call() const;
+
+    bool Lost_Z0();
+
+    void Motors_Update_Z0(uint64_t aNow_ns);
+
+    void Reference_Update_Z0(Motor * aMotor, uint64_t aNow_ns, double aStep_s);
+
+    void Reply_Z0(const DJI_Frame & aRequest, const uint8_t * aData, unsigned int aDataSize_byte);
+
+    void Request_Z0(const DJI_Frame & aRequest);
+
+    // ===== Zone0 ==========================================================
+    Counters     mCounters;
+    Delivery     mDeliveries[SIM_DEVICE_DELIVERY_QTY];
+    unsigned int mDelivery_Count;
+    unsigned int mDelivery_Out;
+    double       mFocus_pc;
+    uint64_t     mLast_ns;
+    Motor        mMotors[ZT::IGimbal::AXIS_QTY];
+    uint64_t     mMotors_ns;
+    unsigned int mRandom;
+    Stats        mStats; // Before mReassembler, it uses it
+    DJI_Reassembler mReassembler;
+    bool         mStop;
+    bool         mTrack;
+    uint8_t      mTrack_Speed;
+
+    Config   mConfig;
+    void   * mContext;
+    Receiver mReceiver;
+
+    pthread_cond_t  mCond;
+    pthread_t       mThread;
+    bool            mThread_Running;
+    pthread_mutex_t mZone0;
+
+};
@@ -12,9 +12,74 @@
 // ===== ZT_Lib =============================================================
 #include "Stats.h"
 
+// Macros
+/////////////////////////////////////////////////////////////////////////////
+
+#define FIELDS \
+    F(mCache_Hit) \
+    F(mCache_Miss) \
+    F(mCache_Mismatch) \
+    F(mDelay) \
+    F(mDelay_ms) \
+    F(mPos_Error) \
+    F(mPos_Error_Last) \
+    F(mPos_Get) \
+    F(mPos_Get_Error) \
+    F(mPos_Get_Error_Last) \
+    F(mPos_Get_Unknown) \
+    F(mPos_Process) \
+    F(mPos_Request) \
+    F(mPos_Set) \
+    F(mPos_Valid) \
+    F(mRetry) \
+    F(mRx_byte) \
+    F(mRx_frame) \
+    F(mRx_CmdId) \
+    F(mRx_CmdId_Last) \
+    F(mRx_CmdSet) \
+    F(mRx_CmdSet_Last) \
+    F(mRx_CmdType) \
+    F(mRx_CmdType_Last) \
+    F(mRx_CRC16) \
+    F(mRx_CRC32) \
+    F(mRx_Encoded) \
+    F(mRx_Encoded_Last) \
+    F(mRx_Id) \
+    F(mRx_Id_Last) \
+    F(mRx_Overflow) \
+    F(mRx_Result) \
+    F(mRx_Result_Last) \
+    F(mRx_SOF) \
+    F(mRx_SOF_Last) \
+    F(mRx_TooLong) \
+    F(mRx_TooShort) \
+    F(mRx_Unexpected) \
+    F(mRx_Unordered) \
+    F(mRx_Unsolicited) \
+    F(mRx_Version) \
+    F(mRx_Version_Last) \
+    F(mSetpoint_Received) \
+    F(mSetpoint_Sent) \
+    F(mTx_byte) \
+    F(mTx_frame) \
+    F(mTx_Error) \
+    F(mTx_Stage_Full) \
+    F(mTr_Aborted) \
+    F(mTr_InFlight_Max) \
+    F(mTr_Overflow_Config) \
+    F(mTr_Overflow_Focus) \
+    F(mTr_Overflow_Stop) \
+    F(mTr_Pool_Empty) \
+    F(mTr_Queued) \
+    F(mTr_Timeout) \
+    F(mWait_Timeout)
+
 // Static function declarations
 /////////////////////////////////////////////////////////////////////////////
 
+template <typename T> static void Copy (std::atomic<T> * aOut, std::atomic<T> * aIn, bool aReset);
+template <typename T> static void Reset(std::atomic<T> * aInOut);
+
 static void Display_A(FILE * aOut, const char * aName, unsigned int aVal);
 static void Display_B(FILE * aOut, const char * aName, unsigned int aVal0, unsigned int aVal1, const char * aUnit);
 static void Display_C(FILE * aOut, const char * aName, unsigned int aVal, uint8_t aLast);
@@ -28,15 +93,18 @@ static void Display_G(FILE * aOut, const char * aName, unsigned int aVal0, unsig
 
 Stats::Stats()
 {
-    memset(this, 0, sizeof(Stats));
+    Reset();
 }
 
-void Stats::Display(FILE * aOut)
+void Stats::Display(FILE * aOut) const
 {
     assert(NULL != aOut);
 
     fprintf(aOut, "    ===== Stats =====\n");
 
+    Display_A(aOut, "Cache Hit       ", mCache_Hit);
+    Display_A(aOut, "Cache Miss      ", mCache_Miss);
+    Display_A(aOut, "Cache Mismatch  ", mCache_Mismatch);
     Display_B(aOut, "Delay           ", mDelay        , mDelay_ms, "ms");
     Display_C(aOut, "Pos. Error      ", mPos_Error    , mPos_Error_Last);
     Display_A(aOut, "Pos. Get        ", mPos_Get);
@@ -51,6 +119,8 @@ void Stats::Display(FILE * aOut)
     Display_C(aOut, "Rx Command Id   ", mRx_CmdId     , mRx_CmdId_Last);
     Display_C(aOut, "Rx Command Set  ", mRx_CmdSet    , mRx_CmdSet_Last);
     Display_C(aOut, "Rx Command Type ", mRx_CmdType   , mRx_CmdType_Last);
+    Display_A(aOut, "Rx CRC-16       ", mRx_CRC16);
+    Display_A(aOut, "Rx CRC-32       ", mRx_CRC32);
     Display_C(aOut, "Rx Encoded      ", mRx_Encoded   , mRx_Encoded_Last);
     Display_F(aOut, "Rx Id           ", mRx_Id        , mRx_Id_Last);
     Display_A(aOut, "Rx Overflow     ", mRx_Overflow);
@@ -60,15 +130,76 @@ void Stats::Display(FILE * aOut)
     Display_A(aOut, "Rx Too short    ", mRx_TooShort);
     Display_A(aOut, "Rx Unexpected   ", mRx_Unexpected);
     Display_A(aOut, "Rx Unordered    ", mRx_Unordered);
+    Display_A(aOut, "Rx Unsolicited  ", mRx_Unsolicited);
     Display_C(aOut, "Rx Version      ", mRx_Version   , mRx_Version_Last);
+    Display_A(aOut, "Setpoint Rx     ", mSetpoint_Received);
+    Display_A(aOut, "Setpoint Tx     ", mSetpoint_Sent);
     Display_G(aOut, "Tx              ", mTx_frame     , mTx_byte, "frames", "bytes");
     Display_A(aOut, "Tx Error        ", mTx_Error);
+    Display_A(aOut, "Tx Stage Full   ", mTx_Stage_Full);
+    Display_A(aOut, "Tr. Aborted     ", mTr_Aborted);
+    Display_A(aOut, "Tr. In Flight Mx", mTr_InFlight_Max);
+    Display_A(aOut, "Tr. Overflow Cfg", mTr_Overflow_Config);
+    Display_A(aOut, "Tr. Overflow Foc", mTr_Overflow_Focus);
+    Display_A(aOut, "Tr. Overflow Stp", mTr_Overflow_Stop);
+    Display_A(aOut, "Tr. Pool Empty  ", mTr_Pool_Empty);
+    Display_A(aOut, "Tr. Queued      ", mTr_Queued);
+    Display_A(aOut, "Tr. Timeout     ", mTr_Timeout);
     Display_A(aOut, "Wait Timeout    ", mWait_Timeout);
+
+    fprintf(aOut, "    ===== Latency =====\n");
+
+    mCommand_us  .Display(aOut, "Command         ", "us");
+    mGroup_Skew_us.Display(aOut, "Group Skew      ", "us");
+    mRoundTrip_us.Display(aOut, "Round Trip      ", "us");
+    mTick_us     .Display(aOut, "Tick            ", "us");
+}
+
+void Stats::Reset()
+{
+    #define F(N) ::Reset(&N);
+        FIELDS
+    #undef F
+
+    mCommand_us  .Reset();
+    mGroup_Skew_us.Reset();
+    mRoundTrip_us.Reset();
+    mTick_us     .Reset();
+}
+
+void Stats::Snapshot_Get(Stats * aOut, bool aReset)
+{
+    assert(NULL != aOut);
+
+    #define F(N) Copy(&aOut->N, &N, aReset);
+        FIELDS
+    #undef F
+
+    mCommand_us  .Snapshot_Get(&aOut->mCommand_us  , aReset);
+    mGroup_Skew_us.Snapshot_Get(&aOut->mGroup_Skew_us, aReset);
+    mRoundTrip_us.Snapshot_Get(&aOut->mRoundTrip_us, aReset);
+    mTick_us     .Snapshot_Get(&aOut->mTick_us     , aReset);
 }
 
 // Static functions
 /////////////////////////////////////////////////////////////////////////////
 
+// The counters are statistics, they do not order other memory accesses.
+template <typename T> void Copy(std::atomic<T> * aOut, std::atomic<T> * aIn, bool aReset)
+{
+    assert(NULL != aOut);
+    assert(NULL != aIn);
+
+    aOut->store(aReset ? aIn->exchange(T(), std::memory_order_relaxed) : aIn->load(std::memory_order_relaxed), std::memory_order_relaxed);
+}
+
+template <typename T> void Reset(std::atomic<T> * aInOut)
+{
+    assert(NULL != aInOut);
+
+    aInOut->store(T(), std::memory_order_relaxed);
+}
+
 void Display_A(FILE * aOut, const char * aName, unsigned int aVal)
 {
     assert(NULL != aOut);
@@ -6,9 +6,19 @@
 
 #pragma once
 
+// ===== C++ ================================================================
+#include <atomic>
+
+// ===== ZT_Lib =============================================================
+#include "ZT_Lib/Histogram.h"
+
 // Class
 /////////////////////////////////////////////////////////////////////////////
 
+// The counters and the histograms are atomic, the threads update them
+// without Zone0 and the readers work on a snapshot.
+//
+// Thread  Users, Worker and EthCAN
 class Stats
 {
 
@@ -16,47 +26,83 @@ public:
 
     Stats();
 
-    void Display(FILE * aOut);
-
-    unsigned int mDelay;
-    unsigned int mDelay_ms;
-    unsigned int mPos_Error;
-    unsigned int mPos_Error_Last;
-    unsigned int mPos_Get;
-    unsigned int mPos_Get_Error;
-    ZT::Result   mPos_Get_Error_Last;
-    unsigned int mPos_Get_Unknown;
-    unsigned int mPos_Process;
-    unsigned int mPos_Request;
-    unsigned int mPos_Set;
-    unsigned int mPos_Valid;
-    unsigned int mRetry;
-    unsigned int mRx_byte;
-    unsigned int mRx_frame;
-    unsigned int mRx_CmdId;
-    uint8_t      mRx_CmdId_Last;
-    unsigned int mRx_CmdSet;
-    uint8_t      mRx_CmdSet_Last;
-    unsigned int mRx_CmdType;
-    uint8_t      mRx_CmdType_Last;
-    unsigned int mRx_Encoded;
-    uint8_t      mRx_Encoded_Last;
-    unsigned int mRx_Id;
-    uint32_t     mRx_Id_Last;
-    unsigned int mRx_Overflow;
-    unsigned int mRx_Result;
-    uint8_t      mRx_Result_Last;
-    unsigned int mRx_SOF;
-    unsigned int mRx_SOF_Last;
-    unsigned int mRx_TooLong;
-    unsigned int mRx_TooShort;
-    unsigned int mRx_Unexpected;
-    unsigned int mRx_Unordered;
-    unsigned int mRx_Version;
-    uint8_t      mRx_Version_Last;
-    unsigned int mTx_byte;
-    unsigned int mTx_frame;
-    unsigned int mTx_Error;
-    unsigned int mWait_Timeout;
+    void Display(FILE * aOut) const;
+
+    void Reset();
+
+    // aOut   [---;-W-] The copy
+    // aReset           Reset the counters while reading them, an event is
+    //                  counted in one snapshot only
+    void Snapshot_Get(Stats * aOut, bool aReset = false);
+
+    std::atomic<unsigned int> mCache_Hit;
+    std::atomic<unsigned int> mCache_Miss;
+    std::atomic<unsigned int> mCache_Mismatch;
+    std::atomic<unsigned int> mDelay;
+    std::atomic<unsigned int> mDelay_ms;
+    std::atomic<unsigned int> mPos_Error;
+    std::atomic<unsigned int> mPos_Error_Last;
+    std::atomic<unsigned int> mPos_Get;
+    std::atomic<unsigned int> mPos_Get_Error;
+    std::atomic<ZT::Result>   mPos_Get_Error_Last;
+    std::atomic<unsigned int> mPos_Get_Unknown;
+    std::atomic<unsigned int> mPos_Process;
+    std::atomic<unsigned int> mPos_Request;
+    std::atomic<unsigned int> mPos_Set;
+    std::atomic<unsigned int> mPos_Valid;
+    std::atomic<unsigned int> mRetry;
+    std::atomic<unsigned int> mRx_byte;
+    std::atomic<unsigned int> mRx_frame;
+    std::atomic<unsigned int> mRx_CmdId;
+    std::atomic<uint8_t>      mRx_CmdId_Last;
+    std::atomic<unsigned int> mRx_CmdSet;
+    std::atomic<uint8_t>      mRx_CmdSet_Last;
+    std::atomic<unsigned int> mRx_CmdType;
+    std::atomic<uint8_t>      mRx_CmdType_Last;
+    std::atomic<unsigned int> mRx_CRC16;
+    std::atomic<unsigned int> mRx_CRC32;
+    std::atomic<unsigned int> mRx_Encoded;
+    std::atomic<uint8_t>      mRx_Encoded_Last;
+    std::atomic<unsigned int> mRx_Id;
+    std::atomic<uint32_t>     mRx_Id_Last;
+    std::atomic<unsigned int> mRx_Overflow;
+    std::atomic<unsigned int> mRx_Result;
+    std::atomic<uint8_t>      mRx_Result_Last;
+    std::atomic<unsigned int> mRx_SOF;
+    std::atomic<unsigned int> mRx_SOF_Last;
+    std::atomic<unsigned int> mRx_TooLong;
+    std::atomic<unsigned int> mRx_TooShort;
+    std::atomic<unsigned int> mRx_Unexpected;
+    std::atomic<unsigned int> mRx_Unordered;
+    std::atomic<unsigned int> mRx_Unsolicited;
+    std::atomic<unsigned int> mRx_Version;
+    std::atomic<uint8_t>      mRx_Version_Last;
+    std::atomic<unsigned int> mSetpoint_Received;
+    std::atomic<unsigned int> mSetpoint_Sent;
+    std::atomic<unsigned int> mTx_byte;
+    std::atomic<unsigned int> mTx_frame;
+    std::atomic<unsigned int> mTx_Error;
+    std::atomic<unsigned int> mTx_Stage_Full;
+    std::atomic<unsigned int> mTr_Aborted;
+    std::atomic<unsigned int> mTr_InFlight_Max;
+    std::atomic<unsigned int> mTr_Overflow_Config;
+    std::atomic<unsigned int> mTr_Overflow_Focus;
+    std::atomic<unsigned int> mTr_Overflow_Stop;
+    std::atomic<unsigned int> mTr_Pool_Empty;
+    std::atomic<unsigned int> mTr_Queued;
+    std::atomic<unsigned int> mTr_Timeout;
+    std::atomic<unsigned int> mWait_Timeout;
+
+    // ===== Latency ========================================================
+    ZT_Lib::Histogram mCommand_us;   // From the command to the send of its frame
+    ZT_Lib::Histogram mGroup_Skew_us; // From the start of the first gimbal of a group move
+    ZT_Lib::Histogram mRoundTrip_us; // From the send of a request to its reply
+    ZT_Lib::Histogram mTick_us;      // Between two deadline ticks
+
+private:
+
+    Stats(const Stats &);
+
+    const Stats & operator = (const Stats &);
 
 };
@@ -9,7 +9,6 @@
 #include "Component.h"
 
 // ===== ZT_Lib =============================================================
-#include "DJI_Detector.h"
 #include "OSX_Detector.h"
 
 #include "System.h"
@@ -17,14 +16,21 @@
 // Public
 /////////////////////////////////////////////////////////////////////////////
 
-System::System() : mRefCount(1)
+System::System() : mDJI(new DJI_Detector()), mRefCount(1), mSimulator(NULL)
 {
-    mDetectors.push_back(new DJI_Detector());
+    mDetectors.push_back(mDJI);
     mDetectors.push_back(new OSX_Detector());
 }
 
 // ===== ZT::ISystem ========================================================
 
+ZT::Result System::Cache_Set(const char * aFolder)
+{
+    assert(NULL != mDJI);
+
+    return mDJI->Cache_Set(aFolder);
+}
+
 ZT::Result System::Gamepads_Detect()
 {
     Gamepads_Release();
@@ -147,6 +153,59 @@ ZT::IGimbal * System::Gimbal_Get(unsigned int aIndex)
     return NULL;
 }
 
+// The gimbals of a system are Gimbal instances.
+ZT::Result System::Gimbals_Position_Set(ZT::IGimbal ** aGimbals, const ZT::IGimbal::Position * aPositions, unsigned int aCount, unsigned int aFlags, unsigned int aDuration_ms)
+{
+    if ((NULL == aGimbals) || (NULL == aPositions))
+    {
+        return ZT::ZT_ERROR_FUNCTION;
+    }
+
+    if (ZT_GROUP_MAX < aCount)
+    {
+        return ZT::ZT_ERROR_MAX;
+    }
+
+    Gimbal * lGimbals[ZT_GROUP_MAX];
+
+    for (unsigned int i = 0; i < aCount; i ++)
+    {
+        if (NULL == aGimbals[i])
+        {
+            return ZT::ZT_ERROR_GIMBAL;
+        }
+
+        lGimbals[i] = static_cast<Gimbal *>(aGimbals[i]);
+    }
+
+    return Gimbal::Group_Position_Set(lGimbals, aPositions, aCount, aFlags, aDuration_ms);
+}
+
+ZT::Result System::Simulator_Set(unsigned int aGimbal_Count)
+{
+    if (SIM_DETECTOR_GIMBAL_MAX < aGimbal_Count)
+    {
+        return ZT::ZT_ERROR_MAX;
+    }
+
+    if (NULL != mSimulator)
+    {
+        mDetectors.remove(mSimulator);
+
+        delete mSimulator;
+        mSimulator = NULL;
+    }
+
+    if (0 < aGimbal_Count)
+    {
+        mSimulator = new Sim_Detector(aGimbal_Count);
+
+        mDetectors.push_back(mSimulator);
+    }
+
+    return ZT::ZT_OK;
+}
+
 // ===== ZT::IObject ========================================================
 
 void System::Release()
@@ -13,7 +13,9 @@
 #include <ZT/ISystem.h>
 
 // ===== ZT_Lib =============================================================
+#include "DJI_Detector.h"
 #include "IDetector.h"
+#include "Sim_Detector.h"
 
 // Class
 /////////////////////////////////////////////////////////////////////////////
@@ -27,6 +29,8 @@ public:
 
     // ===== ZT::ISystem ====================================================
 
+    virtual ZT::Result Cache_Set(const char * aFolder);
+
     virtual ZT::Result Gamepads_Detect();
 
     virtual ZT::IGamepad * Gamepad_Get(unsigned int aIndex);
@@ -37,6 +41,10 @@ public:
     virtual ZT::IGimbal * Gimbal_Find_IPv4(uint32_t aIPv4);
     virtual ZT::IGimbal * Gimbal_Get(unsigned int aIndex);
 
+    virtual ZT::Result Gimbals_Position_Set(ZT::IGimbal ** aGimbals, const ZT::IGimbal::Position * aPositions, unsigned int aCount, unsigned int aFlags, unsigned int aDuration_ms);
+
+    virtual ZT::Result Simulator_Set(unsigned int aGimbal_Count);
+
     // ===== ZT::IObject ====================================================
     virtual void Release();
 
@@ -58,6 +66,10 @@ private:
     
     IDetector::GimbalList mGimbals;
 
+    DJI_Detector * mDJI;
+
     unsigned int mRefCount;
 
+    Sim_Detector * mSimulator;
+
 };
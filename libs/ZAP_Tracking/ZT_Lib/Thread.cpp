@@ -6,12 +6,34 @@
 
 #include "Component.h"
 
+// ===== C ==================================================================
+#include <errno.h>
+
 // ===== ZT_Lib =============================================================
 #include "ZT_Lib/Thread.h"
 
+// Constants
+// //////////////////////////////////////////////////////////////////////////
+
+// pthread_condattr_setclock does not exist on OS X, the condition used for
+// the deadlines uses the default clock there.
+#ifdef __APPLE__
+    #define TICK_CLOCK CLOCK_REALTIME
+#else
+    #define TICK_CLOCK CLOCK_MONOTONIC
+#endif
+
+#define WHEEL_MASK (THREAD_WHEEL_SIZE - 1)
+
 // Static function declarations
 // //////////////////////////////////////////////////////////////////////////
 
+static void Timespec_Add_us(timespec * aInOut, unsigned int aIn_us);
+
+static int64_t Timespec_Diff_us(const timespec & aA, const timespec & aB);
+
+// ===== Entry point ========================================================
+
 static void * Run_Link(void * aContext);
 
 namespace ZT_Lib
@@ -20,12 +42,91 @@ namespace ZT_Lib
     // Public
     // //////////////////////////////////////////////////////////////////////
 
-    Thread::Thread() : mState(STATE_INIT)
+    Timer::Timer() : mRounds(0), mCode(0), mContext(NULL), mReceiver(NULL)
+    {
+        mNext = this;
+        mPrev = this;
+    }
+
+    Timer::~Timer()
     {
+        assert(!IsStarted());
+    }
+
+    void Timer::Init(ZT::IMessageReceiver * aReceiver, unsigned int aCode, void * aContext)
+    {
+        assert(NULL != aReceiver);
+
+        assert(!IsStarted());
+
+        mCode     = aCode;
+        mContext  = aContext;
+        mReceiver = aReceiver;
+    }
+
+    void * Timer::Context_Get() const
+    {
+        return mContext;
+    }
+
+    bool Timer::IsStarted() const
+    {
+        return this != mNext;
+    }
+
+    void Timer::Stop_Z0()
+    {
+        mNext->mPrev = mPrev;
+        mPrev->mNext = mNext;
+
+        mNext = this;
+        mPrev = this;
+    }
+
+    // Private
+    // //////////////////////////////////////////////////////////////////////
+
+    void Timer::Insert(Timer * aHead)
+    {
+        assert(NULL != aHead);
+
+        assert(!IsStarted());
+
+        mNext = aHead;
+        mPrev = aHead->mPrev;
+
+        mPrev->mNext = this;
+        aHead->mPrev = this;
+    }
+
+    // Public
+    // //////////////////////////////////////////////////////////////////////
+
+    Thread::Thread() : mPeriod_ms(0), mState(STATE_INIT), mTick_Wake(false), mWake_Pending(false), mWheel_Tick(0)
+    {
+        memset(&mTick_Deadline, 0, sizeof(mTick_Deadline));
+        memset(&mZone0_Begin  , 0, sizeof(mZone0_Begin  ));
+        memset(&mTiming       , 0, sizeof(mTiming       ));
 
         int lRet = pthread_cond_init(&mCond, NULL);
         assert(0 == lRet);
 
+        pthread_condattr_t lAttr;
+
+        lRet = pthread_condattr_init(&lAttr);
+        assert(0 == lRet);
+
+        #ifndef __APPLE__
+            lRet = pthread_condattr_setclock(&lAttr, TICK_CLOCK);
+            assert(0 == lRet);
+        #endif
+
+        lRet = pthread_cond_init(&mTick_Cond, &lAttr);
+        assert(0 == lRet);
+
+        lRet = pthread_condattr_destroy(&lAttr);
+        assert(0 == lRet);
+
         lRet = pthread_mutex_init(&mZone0, NULL);
         assert(0 == lRet);
     }
@@ -44,6 +145,7 @@ namespace ZT_Lib
             case STATE_STARTING:
                 mState = STATE_STOPPING;
                 lJoin = true;
+                Wake_Z0();
                 break;
 
             default: assert(false);
@@ -62,10 +164,19 @@ namespace ZT_Lib
         lRet = pthread_cond_destroy(&mCond);
         assert(0 == lRet);
 
+        lRet = pthread_cond_destroy(&mTick_Cond);
+        assert(0 == lRet);
+
         lRet = pthread_mutex_destroy(&mZone0);
         assert(0 == lRet);
     }
 
+    void Thread::Condition_Broadcast()
+    {
+        int lRet = pthread_cond_broadcast(&mCond);
+        assert(0 == lRet);
+    }
+
     void Thread::Condition_Signal()
     {
         int lRet = pthread_cond_signal(&mCond);
@@ -74,7 +185,12 @@ namespace ZT_Lib
 
     ZT::Result Thread::Condition_Wait()
     {
+        Zone0_Hold_End();
+
         int lRet = pthread_cond_wait(&mCond, &mZone0);
+
+        Zone0_Hold_Begin();
+
         if (0 != lRet)
         {
             return ZT::ZT_ERROR_THREAD;
@@ -85,7 +201,12 @@ namespace ZT_Lib
 
     ZT::Result Thread::Condition_Wait(const timespec & aAbsTime)
     {
+        Zone0_Hold_End();
+
         int lRet = pthread_cond_timedwait(&mCond, &mZone0, &aAbsTime);
+
+        Zone0_Hold_Begin();
+
         if (0 != lRet)
         {
             return ZT::ZT_ERROR_TIMEOUT;
@@ -94,7 +215,12 @@ namespace ZT_Lib
         return ZT::ZT_OK;
     }
 
-    ZT::Result Thread::Start(ZT::IMessageReceiver * aReceiver, unsigned int aStart, unsigned int aIteration, unsigned int aStop)
+    bool Thread::Iteration_IsWake() const
+    {
+        return mTick_Wake;
+    }
+
+    ZT::Result Thread::Start(ZT::IMessageReceiver * aReceiver, unsigned int aStart, unsigned int aIteration, unsigned int aStop, unsigned int aPeriod_ms)
     {
         assert(NULL != aReceiver);
 
@@ -109,6 +235,14 @@ namespace ZT_Lib
                 mReceiver_Iteration = aIteration;
                 mReceiver_Start     = aStart;
                 mReceiver_Stop      = aStop;
+
+                mPeriod_ms    = aPeriod_ms;
+                mWake_Pending = false;
+
+                memset(&mTiming, 0, sizeof(mTiming));
+
+                clock_gettime(TICK_CLOCK, &mTick_Deadline);
+                Timespec_Add_us(&mTick_Deadline, mPeriod_ms * 1000);
                 
                 mState = STATE_STARTING;
 
@@ -148,6 +282,8 @@ namespace ZT_Lib
             case STATE_STARTING:
                 mState = STATE_STOPPING;
 
+                Wake_Z0();
+
                 int lRet;
                 
                 Zone0_Leave();
@@ -168,18 +304,93 @@ namespace ZT_Lib
         return lResult;
     }
 
+    void Thread::Timer_Start_Z0(Timer * aTimer, unsigned int aDelay_tick)
+    {
+        assert(NULL != aTimer);
+
+        assert(NULL != aTimer->mReceiver);
+
+        aTimer->Stop_Z0();
+
+        switch (mState)
+        {
+        case STATE_RUNNING :
+        case STATE_STARTING:
+            unsigned int lDelay_tick;
+
+            lDelay_tick = (0 < aDelay_tick) ? aDelay_tick : 1;
+
+            aTimer->mRounds = (lDelay_tick - 1) / THREAD_WHEEL_SIZE;
+            aTimer->Insert(mWheel + ((mWheel_Tick + lDelay_tick) & WHEEL_MASK));
+            break;
+
+        case STATE_INIT    :
+        case STATE_STOPPING: break;
+
+        default: assert(false);
+        }
+    }
+
+    void Thread::Timing_Get(Timing * aOut)
+    {
+        assert(NULL != aOut);
+
+        Zone0_Enter();
+        {
+            *aOut = mTiming;
+        }
+        Zone0_Leave();
+    }
+
+    void Thread::Wake()
+    {
+        Zone0_Enter();
+        {
+            Wake_Z0();
+        }
+        Zone0_Leave();
+    }
+
+    void Thread::Wake_Z0()
+    {
+        mWake_Pending = true;
+
+        int lRet = pthread_cond_signal(&mTick_Cond);
+        assert(0 == lRet);
+    }
+
     void Thread::Zone0_Enter()
     {
+        timespec lNow;
+
+        clock_gettime(TICK_CLOCK, &lNow);
+
         int lRet = pthread_mutex_lock(&mZone0);
         assert(0 == lRet);
+
+        Zone0_Hold_Begin();
+
+        mZone0_Wait_us.Add(static_cast<unsigned int>(Timespec_Diff_us(mZone0_Begin, lNow)));
     }
 
     void Thread::Zone0_Leave()
     {
+        Zone0_Hold_End();
+
         int lRet = pthread_mutex_unlock(&mZone0);
         assert(0 == lRet);
     }
 
+    // Taking Zone0 here would add the reader to the histograms it reads.
+    void Thread::Zone0_Histograms_Get(Histogram * aHold_us, Histogram * aWait_us, bool aReset)
+    {
+        assert(NULL != aHold_us);
+        assert(NULL != aWait_us);
+
+        mZone0_Hold_us.Snapshot_Get(aHold_us, aReset);
+        mZone0_Wait_us.Snapshot_Get(aWait_us, aReset);
+    }
+
     // Internal
     // //////////////////////////////////////////////////////////////////////
 
@@ -206,6 +417,20 @@ namespace ZT_Lib
                         // no break
 
                     case STATE_RUNNING:
+                        if (0 < mPeriod_ms)
+                        {
+                            Tick_Wait_Z0();
+                            if (STATE_RUNNING != mState)
+                            {
+                                break;
+                            }
+
+                            if (!mTick_Wake)
+                            {
+                                Timer_Tick_Z0();
+                            }
+                        }
+
                         lRun = Call_Z0(mReceiver_Iteration);
                         break;
 
@@ -235,6 +460,7 @@ namespace ZT_Lib
             case STATE_RUNNING:
             case STATE_STOPPING:
                 mState = STATE_INIT;
+                Timer_Clear_Z0();
                 Call_Z0(mReceiver_Stop);
                 break;
 
@@ -264,11 +490,174 @@ namespace ZT_Lib
         return lResult;
     }
 
+    // The deadlines stay on the grid set by Start. When an iteration takes
+    // longer than the period, the next one starts at once and the other
+    // missed deadlines are dropped. A wake-up does not move the grid.
+    void Thread::Tick_Wait_Z0()
+    {
+        assert(0 < mPeriod_ms);
+
+        timespec lNow;
+
+        clock_gettime(TICK_CLOCK, &lNow);
+
+        mTick_Wake = false;
+
+        if (0 <= Timespec_Diff_us(lNow, mTick_Deadline))
+        {
+            mTiming.mOverrun ++;
+
+            while (mPeriod_ms * 1000 <= Timespec_Diff_us(lNow, mTick_Deadline))
+            {
+                Timespec_Add_us(&mTick_Deadline, mPeriod_ms * 1000);
+            }
+        }
+
+        while ((!mWake_Pending) && (STATE_RUNNING == mState))
+        {
+            Zone0_Hold_End();
+
+            int lRet = pthread_cond_timedwait(&mTick_Cond, &mZone0, &mTick_Deadline);
+
+            Zone0_Hold_Begin();
+
+            if (ETIMEDOUT == lRet)
+            {
+                clock_gettime(TICK_CLOCK, &lNow);
+
+                int64_t lJitter_us = Timespec_Diff_us(lNow, mTick_Deadline);
+                if (0 < lJitter_us)
+                {
+                    mTiming.mJitter_Sum_us += lJitter_us;
+
+                    if (mTiming.mJitter_Max_us < lJitter_us)
+                    {
+                        mTiming.mJitter_Max_us = static_cast<unsigned int>(lJitter_us);
+                    }
+                }
+
+                mTiming.mTick ++;
+
+                Timespec_Add_us(&mTick_Deadline, mPeriod_ms * 1000);
+                return;
+            }
+        }
+
+        if (mWake_Pending)
+        {
+            mWake_Pending = false;
+
+            if (STATE_RUNNING == mState)
+            {
+                mTick_Wake = true;
+                mTiming.mWake ++;
+            }
+        }
+    }
+
+    // The lock is held from Zone0_Hold_Begin to Zone0_Hold_End, the
+    // histograms are protected by Zone0 itself.
+    void Thread::Zone0_Hold_Begin()
+    {
+        clock_gettime(TICK_CLOCK, &mZone0_Begin);
+    }
+
+    void Thread::Zone0_Hold_End()
+    {
+        timespec lNow;
+
+        clock_gettime(TICK_CLOCK, &lNow);
+
+        mZone0_Hold_us.Add(static_cast<unsigned int>(Timespec_Diff_us(lNow, mZone0_Begin)));
+    }
+
+    // The timers do not expire once the thread stopped, they leave the wheel
+    // so their owners can destroy them.
+    void Thread::Timer_Clear_Z0()
+    {
+        for (unsigned int i = 0; i < THREAD_WHEEL_SIZE; i++)
+        {
+            while (mWheel[i].IsStarted())
+            {
+                mWheel[i].mNext->Stop_Z0();
+            }
+        }
+    }
+
+    // Only the timers of the current slot are visited. The slot moves to a
+    // local list first, so a receiver can start or stop any timer, the one
+    // expiring included.
+    void Thread::Timer_Tick_Z0()
+    {
+        mWheel_Tick ++;
+
+        Timer & lSlot = mWheel[mWheel_Tick & WHEEL_MASK];
+
+        if (!lSlot.IsStarted())
+        {
+            return;
+        }
+
+        Timer lList;
+
+        lList.mNext = lSlot.mNext;
+        lList.mPrev = lSlot.mPrev;
+
+        lList.mNext->mPrev = &lList;
+        lList.mPrev->mNext = &lList;
+
+        lSlot.mNext = &lSlot;
+        lSlot.mPrev = &lSlot;
+
+        while (lList.IsStarted())
+        {
+            Timer * lTimer = lList.mNext;
+
+            lTimer->Stop_Z0();
+
+            if (0 < lTimer->mRounds)
+            {
+                lTimer->mRounds --;
+                lTimer->Insert(&lSlot);
+            }
+            else
+            {
+                mTiming.mTimer ++;
+
+                assert(NULL != lTimer->mReceiver);
+
+                lTimer->mReceiver->ProcessMessage(this, lTimer->mCode, lTimer);
+            }
+        }
+    }
+
 }
 
 // Static functions
 // //////////////////////////////////////////////////////////////////////////
 
+void Timespec_Add_us(timespec * aInOut, unsigned int aIn_us)
+{
+    assert(NULL != aInOut);
+
+    aInOut->tv_nsec += static_cast<long>(aIn_us % 1000000) * 1000;
+    aInOut->tv_sec  += aIn_us / 1000000;
+
+    if (1000000000 <= aInOut->tv_nsec)
+    {
+        aInOut->tv_nsec -= 1000000000;
+        aInOut->tv_sec  ++;
+    }
+}
+
+// Return aA - aB
+int64_t Timespec_Diff_us(const timespec & aA, const timespec & aB)
+{
+    return (static_cast<int64_t>(aA.tv_sec) - aB.tv_sec) * 1000000 + (static_cast<int64_t>(aA.tv_nsec) - aB.tv_nsec) / 1000;
+}
+
+// ===== Entry point ========================================================
+
 void * Run_Link(void * aContext)
 {
     assert(NULL != aContext);
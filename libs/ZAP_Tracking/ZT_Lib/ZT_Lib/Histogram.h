@@ -0,0 +1,82 @@
+
+// Author  KMS - Martin Dubois, P.Eng.
+// Client  ZAP
+// Product Tacking
+// File    ZT_Lib/Histogram.h
+
+#pragma once
+
+// ===== C++ ================================================================
+#include <atomic>
+
+// ===== C ==================================================================
+#include <stdint.h>
+#include <stdio.h>
+
+// Constants
+/////////////////////////////////////////////////////////////////////////////
+
+// Each power of 2 is split in 2 ^ HISTOGRAM_SUB_BITS linear buckets, so a
+// bucket limit is never more than 12.5 % over the values it counts.
+#define HISTOGRAM_SUB_BITS (3)
+
+#define HISTOGRAM_SUB_COUNT (1 << HISTOGRAM_SUB_BITS)
+
+#define HISTOGRAM_BUCKETS (HISTOGRAM_SUB_COUNT * (33 - HISTOGRAM_SUB_BITS))
+
+namespace ZT_Lib
+{
+
+    // Log-linear histogram. The values under HISTOGRAM_SUB_COUNT have their
+    // own bucket, the larger ones share it with their neighbours.
+    //
+    // Add does not lock and any thread can call it, the readers work on a
+    // snapshot.
+    class Histogram
+    {
+
+    public:
+
+        Histogram();
+
+        void Add(unsigned int aValue);
+
+        unsigned int Avg_Get  () const;
+        uint64_t     Count_Get() const;
+        unsigned int Max_Get  () const;
+
+        // aPercent  0 to 100
+        //
+        // Return the upper limit of the bucket holding the percentile
+        unsigned int Percentile_Get(unsigned int aPercent) const;
+
+        void Reset();
+
+        // aOut   [---;-W-] The copy
+        // aReset           Reset the histogram while reading it, a value
+        //                  is part of one snapshot only
+        //
+        // The snapshot is consistent with itself, its count is the sum of
+        // its buckets. A value added during the copy may miss the sum or
+        // the maximum.
+        void Snapshot_Get(Histogram * aOut, bool aReset = false);
+
+        // aName  The name, 16 characters to align with the other statistics
+        // aUnit  The unit of the values
+        void Display(FILE * aOut, const char * aName, const char * aUnit) const;
+
+    private:
+
+        Histogram(const Histogram &);
+
+        const Histogram & operator = (const Histogram &);
+
+        std::atomic<uint64_t> mBuckets[HISTOGRAM_BUCKETS];
+        std::atomic<uint64_t> mCount;
+        std::atomic<uint64_t> mSum;
+
+        std::atomic<unsigned int> mMax;
+
+    };
+
+}
@@ -8,34 +8,140 @@
 
 // ===== C ==================================================================
 #include <pthread.h>
+#include <stdint.h>
+#include <time.h>
 
 // ===== Includes ===========================================================
 #include <ZT/IMessageReceiver.h>
 #include <ZT/Result.h>
 
+// ===== ZT_Lib =============================================================
+#include "Histogram.h"
+
+// Constants
+/////////////////////////////////////////////////////////////////////////////
+
+// Number of slots of the timer wheel, a power of 2. A timer expiring later
+// than one turn of the wheel stays in its slot for the complete turns.
+#define THREAD_WHEEL_SIZE (256)
+
 namespace ZT_Lib
 {
+    class Thread;
+
+    // The owner embeds the timer and the thread links it in its wheel, so
+    // starting and stopping a timer never allocate.
+    //
+    // Thread  Any, with the Zone0 of the thread
+    class Timer
+    {
+
+    public:
+
+        Timer();
+
+        ~Timer();
+
+        // aReceiver  Called by the thread when the timer expires
+        // aCode      The message code
+        // aContext   See Context_Get
+        void Init(ZT::IMessageReceiver * aReceiver, unsigned int aCode, void * aContext = NULL);
+
+        void * Context_Get() const;
+
+        bool IsStarted() const;
+
+        // Stopping a timer not started does nothing.
+        void Stop_Z0();
+
+    private:
+
+        friend class Thread;
+
+        Timer(const Timer &);
+
+        const Timer & operator = (const Timer &);
+
+        void Insert(Timer * aHead);
+
+        // The list is circular, a timer not started links to itself.
+        Timer * mNext;
+        Timer * mPrev;
+
+        unsigned int mRounds;
+
+        unsigned int           mCode;
+        void                 * mContext;
+        ZT::IMessageReceiver * mReceiver;
+
+    };
+
     class Thread
     {
 
     public:
 
+        // Statistics of the periodic iterations, in us
+        typedef struct
+        {
+            uint64_t     mJitter_Sum_us;
+            unsigned int mJitter_Max_us;
+            unsigned int mOverrun;
+            unsigned int mTick;
+            unsigned int mTimer;
+            unsigned int mWake;
+        }
+        Timing;
+
         Thread();
 
         ~Thread();
 
+        void Condition_Broadcast();
         void Condition_Signal();
 
         ZT::Result Condition_Wait();
         ZT::Result Condition_Wait(const timespec & aAbsTime);
 
-        ZT::Result Start(ZT::IMessageReceiver * aReceiver, unsigned int aStart, unsigned int aIteration, unsigned int aStop);
+        // Thread  Worker
+        //
+        // Return true when Wake started the current iteration before its
+        // deadline.
+        bool Iteration_IsWake() const;
+
+        // aPeriod_ms  When not 0, the iterations start at fixed absolute
+        //             deadlines. The period does not include the time the
+        //             iteration takes.
+        ZT::Result Start(ZT::IMessageReceiver * aReceiver, unsigned int aStart, unsigned int aIteration, unsigned int aStop, unsigned int aPeriod_ms = 0);
 
         ZT::Result Stop();
 
+        // aTimer      The timer, a started timer restarts
+        // aDelay_tick The number of periodic iterations before the timer
+        //             expires, 0 is the same as 1
+        //
+        // The expired timers call their receiver with Zone0 held, before
+        // the iteration of the deadline. A wake-up does not count. A timer
+        // started while the thread does not run never expires.
+        void Timer_Start_Z0(Timer * aTimer, unsigned int aDelay_tick);
+
+        void Timing_Get(Timing * aOut);
+
+        // Start the next iteration without waiting for its deadline.
+        void Wake();
+        void Wake_Z0();
+
         void Zone0_Enter();
         void Zone0_Leave();
 
+        // aHold_us [---;-W-] The time Zone0 stays locked, the condition
+        //                    waits excluded
+        // aWait_us [---;-W-] The time Zone0_Enter waits for the lock
+        // aReset             See Histogram::Snapshot_Get
+        //
+        // Zone0 is not needed
+        void Zone0_Histograms_Get(Histogram * aHold_us, Histogram * aWait_us, bool aReset = false);
+
     // Internal
 
         void * Run();
@@ -58,6 +164,14 @@ namespace ZT_Lib
 
         bool Call_Z0(unsigned int aCode);
 
+        void Tick_Wait_Z0();
+
+        void Timer_Clear_Z0();
+        void Timer_Tick_Z0 ();
+
+        void Zone0_Hold_Begin();
+        void Zone0_Hold_End  ();
+
         pthread_t mThread;
 
         ZT::IMessageReceiver *mReceiver;
@@ -65,6 +179,8 @@ namespace ZT_Lib
         unsigned int          mReceiver_Start;
         unsigned int          mReceiver_Stop;
 
+        unsigned int mPeriod_ms;
+
         // ===== Zone 0 =========================================================
         pthread_mutex_t mZone0;
 
@@ -72,6 +188,21 @@ namespace ZT_Lib
 
         State mState;
 
+        pthread_cond_t mTick_Cond;
+        timespec       mTick_Deadline;
+        bool           mTick_Wake;
+        Timing         mTiming;
+        bool           mWake_Pending;
+
+        // The timer in slot N expires at the iteration where mWheel_Tick
+        // reaches N, modulo the size, once its rounds reach 0.
+        Timer        mWheel[THREAD_WHEEL_SIZE];
+        unsigned int mWheel_Tick;
+
+        timespec  mZone0_Begin;
+        Histogram mZone0_Hold_us;
+        Histogram mZone0_Wait_us;
+
     };
 
 }
@@ -0,0 +1,193 @@
+
+// Author  KMS - Martin Dubois, P. Eng.
+// Client  ZAP
+// Product Tacking
+// File    ZT_Lib_Bench/Bench.cpp
+
+#include "Component.h"
+
+// ===== C++ ================================================================
+#include <new>
+
+// ===== C ==================================================================
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+// ===== ZT_Lib_Bench =======================================================
+#include "Bench.h"
+
+// Constants
+/////////////////////////////////////////////////////////////////////////////
+
+#define BENCH_RUN_ms (20)
+#define BENCH_RUNS   (5)
+
+// Variables
+/////////////////////////////////////////////////////////////////////////////
+
+// Only the benchmark thread counts its allocations
+static thread_local uint64_t sAllocations = 0;
+
+volatile uint64_t Bench::sSink = 0;
+
+// Static function declarations
+/////////////////////////////////////////////////////////////////////////////
+
+static void * Allocate(size_t aSize_byte);
+
+static uint64_t Time_Get_ns();
+
+// Public
+/////////////////////////////////////////////////////////////////////////////
+
+Bench::Bench(FILE * aOut, const char * aFilter) : mCount(0), mFilter(aFilter), mOut(aOut)
+{
+    assert(NULL != aOut);
+}
+
+unsigned int Bench::Count_Get() const
+{
+    return mCount;
+}
+
+bool Bench::IsSelected(const char * aName) const
+{
+    assert(NULL != aName);
+
+    return (NULL == mFilter) || (0 == strncmp(mFilter, aName, strlen(mFilter)));
+}
+
+void Bench::Run(const char * aName, Function aFunction, void * aContext)
+{
+    assert(NULL != aName);
+    assert(NULL != aFunction);
+
+    if (!IsSelected(aName))
+    {
+        return;
+    }
+
+    // Double the iterations until a run is long enough to be measured,
+    // then size the runs to last about BENCH_RUN_ms.
+    unsigned int lIterations = 1;
+    uint64_t     lDuration_ns;
+
+    for (;;)
+    {
+        uint64_t lBegin_ns = Time_Get_ns();
+
+        aFunction(aContext, lIterations);
+
+        lDuration_ns = Time_Get_ns() - lBegin_ns;
+
+        if ((1000000 <= lDuration_ns) || (0x40000000 <= lIterations))
+        {
+            break;
+        }
+
+        lIterations *= 2;
+    }
+
+    double lIterations_d = static_cast<double>(lIterations) * BENCH_RUN_ms * 1000000.0 / (lDuration_ns + 1);
+
+    lIterations = (0x40000000 < lIterations_d) ? 0x40000000 : ((1 > lIterations_d) ? 1 : static_cast<unsigned int>(lIterations_d));
+
+    uint64_t lAllocations = sAllocations;
+    double   lBest_ns     = 0.0;
+
+    for (unsigned int i = 0; i < BENCH_RUNS; i ++)
+    {
+        uint64_t lBegin_ns = Time_Get_ns();
+
+        aFunction(aContext, lIterations);
+
+        double lOp_ns = static_cast<double>(Time_Get_ns() - lBegin_ns) / lIterations;
+
+        if ((0 == i) || (lBest_ns > lOp_ns))
+        {
+            lBest_ns = lOp_ns;
+        }
+    }
+
+    lAllocations = sAllocations - lAllocations;
+
+    Result(aName, lIterations, lBest_ns, static_cast<double>(lAllocations) / (static_cast<double>(lIterations) * BENCH_RUNS));
+}
+
+void Bench::Run_Once(const char * aName, Function aFunction, void * aContext, unsigned int aIterations)
+{
+    assert(NULL != aName);
+    assert(NULL != aFunction);
+    assert(0 < aIterations);
+
+    if (!IsSelected(aName))
+    {
+        return;
+    }
+
+    uint64_t lAllocations = sAllocations;
+    uint64_t lBegin_ns    = Time_Get_ns();
+
+    aFunction(aContext, aIterations);
+
+    double lOp_ns = static_cast<double>(Time_Get_ns() - lBegin_ns) / aIterations;
+
+    lAllocations = sAllocations - lAllocations;
+
+    Result(aName, aIterations, lOp_ns, static_cast<double>(lAllocations) / aIterations);
+}
+
+// Private
+/////////////////////////////////////////////////////////////////////////////
+
+void Bench::Result(const char * aName, unsigned int aIterations, double aOp_ns, double aAllocs_op)
+{
+    assert(NULL != aName);
+
+    fprintf(mOut, "{\"bench\":\"%s\",\"iterations\":%u,\"ns_per_op\":%.2f,\"allocs_per_op\":%.3f}\n",
+        aName, aIterations, aOp_ns, aAllocs_op);
+    fflush(mOut);
+
+    mCount ++;
+}
+
+// Static functions
+/////////////////////////////////////////////////////////////////////////////
+
+void * Allocate(size_t aSize_byte)
+{
+    sAllocations ++;
+
+    void * lResult = malloc((0 < aSize_byte) ? aSize_byte : 1);
+    if (NULL == lResult)
+    {
+        throw std::bad_alloc();
+    }
+
+    return lResult;
+}
+
+uint64_t Time_Get_ns()
+{
+    timespec lNow;
+
+    clock_gettime(CLOCK_MONOTONIC, &lNow);
+
+    return static_cast<uint64_t>(lNow.tv_sec) * 1000000000 + lNow.tv_nsec;
+}
+
+// Operators
+/////////////////////////////////////////////////////////////////////////////
+
+void * operator new  (size_t aSize_byte) { return Allocate(aSize_byte); }
+void * operator new[](size_t aSize_byte) { return Allocate(aSize_byte); }
+
+void * operator new  (size_t aSize_byte, const std::nothrow_t &) noexcept { sAllocations ++; return malloc((0 < aSize_byte) ? aSize_byte : 1); }
+void * operator new[](size_t aSize_byte, const std::nothrow_t &) noexcept { sAllocations ++; return malloc((0 < aSize_byte) ? aSize_byte : 1); }
+
+void operator delete  (void * aPtr) noexcept { free(aPtr); }
+void operator delete[](void * aPtr) noexcept { free(aPtr); }
+
+void operator delete  (void * aPtr, size_t) noexcept { free(aPtr); }
+void operator delete[](void * aPtr, size_t) noexcept { free(aPtr); }
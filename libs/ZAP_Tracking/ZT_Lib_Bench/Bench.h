@@ -0,0 +1,65 @@
+
+// Author  KMS - Martin Dubois, P. Eng.
+// Client  ZAP
+// Product Tacking
+// File    ZT_Lib_Bench/Bench.h
+
+#pragma once
+
+// Class
+/////////////////////////////////////////////////////////////////////////////
+
+// Run the benchmarks and write one JSON object per line
+//
+// {"bench":"DJI_CRC_16","iterations":4194304,"ns_per_op":9.87,"allocs_per_op":0.000}
+//
+// ns_per_op is the best of BENCH_RUNS runs, each lasting about
+// BENCH_RUN_ms. allocs_per_op counts the operator new calls of the
+// benchmark thread, the threads of the library are not counted.
+//
+// The library traces can go to the same stream, the results are the lines
+// starting with {.
+class Bench
+{
+
+public:
+
+    // aContext    The context passed to Run
+    // aIterations Number of operations to execute
+    typedef void (*Function)(void * aContext, unsigned int aIterations);
+
+    // aOut     The JSON lines go there
+    // aFilter  Only run the benchmarks with a name starting with it, NULL
+    //          runs them all
+    Bench(FILE * aOut, const char * aFilter);
+
+    unsigned int Count_Get() const;
+
+    // Return false when the filter skips the benchmark, the caller then
+    // avoids its setup.
+    bool IsSelected(const char * aName) const;
+
+    void Run(const char * aName, Function aFunction, void * aContext = NULL);
+
+    // Call the function once with aIterations, for the benchmarks which
+    // can not repeat, the replay of a trace for example.
+    void Run_Once(const char * aName, Function aFunction, void * aContext, unsigned int aIterations);
+
+    // Keep the compiler from removing the computation of aValue
+    static void Consume(uint64_t aValue) { sSink = sSink + aValue; }
+
+private:
+
+    Bench(const Bench &);
+
+    const Bench & operator = (const Bench &);
+
+    void Result(const char * aName, unsigned int aIterations, double aOp_ns, double aAllocs_op);
+
+    static volatile uint64_t sSink;
+
+    unsigned int mCount;
+    const char * mFilter;
+    FILE       * mOut;
+
+};
@@ -0,0 +1,20 @@
+#!/bin/sh
+
+# Author  KMS - Martin Dubois, P. Eng.
+# Client  ZAP
+# Product Tracking
+# File    ZT_Lib_Bench/Clean.sh
+# Usage   ./Clean.sh
+
+echo Executing  ZT_Lib_Bench/Clean.sh  ...
+
+# ===== Execution ===========================================================
+
+rm -f ../Binaries/ZT_Lib_Bench
+
+rm -f *.o
+
+# ===== End =================================================================
+
+echo OK
+exit 0
@@ -0,0 +1,13 @@
+
+// Author  KMS - Martin Dubois, P. Eng.
+// Client  ZAP
+// Product Tacking
+// File    ZT_Lib_Bench/Component.h
+
+#pragma once
+
+// ===== C ==================================================================
+#include <assert.h>
+#include <memory.h>
+#include <stdint.h>
+#include <stdio.h>
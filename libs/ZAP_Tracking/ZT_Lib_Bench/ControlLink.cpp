@@ -0,0 +1,255 @@
+
+// Author  KMS - Martin Dubois, P. Eng.
+// Client  ZAP
+// Product Tacking
+// File    ZT_Lib_Bench/ControlLink.cpp
+
+#include "Component.h"
+
+// ===== C ==================================================================
+#include <stdlib.h>
+#include <unistd.h>
+
+// ===== Includes ===========================================================
+#include <ZT/ISystem.h>
+
+// ===== ZT_Lib =============================================================
+#include "ControlLink.h"
+#include "DJI_Gimbal.h"
+#include "Sim_Device.h"
+
+// ===== ZT_Lib_Bench =======================================================
+#include "Bench.h"
+
+// Constants
+/////////////////////////////////////////////////////////////////////////////
+
+#define MSG_GAMEPAD (1) // See ZT_Lib/ControlLink.cpp
+
+// Class
+/////////////////////////////////////////////////////////////////////////////
+
+// System giving the simulated gimbal the benchmark activated to the
+// ControlLink
+class System_Tester : public ZT::ISystem
+{
+
+public:
+
+    System_Tester(ZT::IGimbal * aGimbal) : mGimbal(aGimbal) {}
+
+    // ===== ZT::ISystem ====================================================
+    virtual ZT::Result Cache_Set(const char * aFolder) { return ZT::ZT_ERROR_NOT_READY; }
+
+    virtual ZT::Result Gamepads_Detect() { return ZT::ZT_OK; }
+    virtual ZT::Result Gimbals_Detect () { return ZT::ZT_OK; }
+
+    virtual ZT::IGamepad * Gamepad_Get(unsigned int aIndex) { return NULL; }
+
+    virtual ZT::IGimbal * Gimbal_Find_IPv4(const char * aIPv4) { return NULL; }
+    virtual ZT::IGimbal * Gimbal_Find_IPv4(uint32_t aIPv4) { return NULL; }
+
+    virtual ZT::IGimbal * Gimbal_Get(unsigned int aIndex)
+    {
+        ZT::IGimbal * lResult = (0 == aIndex) ? mGimbal : NULL;
+
+        mGimbal = NULL;
+
+        return lResult;
+    }
+
+    virtual ZT::Result Gimbals_Position_Set(ZT::IGimbal ** aGimbals, const ZT::IGimbal::Position * aPositions, unsigned int aCount, unsigned int aFlags, unsigned int aDuration_ms) { return ZT::ZT_ERROR_NOT_READY; }
+
+    virtual ZT::Result Simulator_Set(unsigned int aGimbal_Count) { return ZT::ZT_ERROR_NOT_READY; }
+
+    // ===== ZT::IObject ====================================================
+    virtual void Release() {}
+
+private:
+
+    ZT::IGimbal * mGimbal;
+
+};
+
+// Static function declarations
+/////////////////////////////////////////////////////////////////////////////
+
+// ===== Benchmarks =========================================================
+
+static void Full_Table(void * aContext, unsigned int aIterations);
+static void Last_Entry(void * aContext, unsigned int aIterations);
+static void Pitch     (void * aContext, unsigned int aIterations);
+static void Unmapped  (void * aContext, unsigned int aIterations);
+
+// Return a ControlLink mapping each action and control, NULL on error
+static ControlLink * Full_Table_Create();
+
+// Functions
+/////////////////////////////////////////////////////////////////////////////
+
+// The gamepad thread calls ProcessMessage for each event. The default table
+// maps ANALOG_1_Y to the pitch speed and PAD_TOP, its last entry, to
+// GIMBAL_LAST. The full table maps the 84 actions and controls, the cost of
+// its last entry compares to the one of the default table.
+void ControlLink_Bench(Bench * aBench)
+{
+    assert(NULL != aBench);
+
+    if (!aBench->IsSelected("ControlLink_"))
+    {
+        return;
+    }
+
+    DJI_Gimbal * lG0 = new DJI_Gimbal(new Sim_Device(Sim_Device::CONFIG_DEFAULT));
+
+    if ((ZT::ZT_OK != lG0->Connect()) || (ZT::ZT_OK != lG0->Activate()))
+    {
+        fprintf(stderr, "ERROR  ControlLink_Bench - The simulated gimbal does not activate\n");
+        lG0->Release();
+        return;
+    }
+
+    ControlLink * lC0 = new ControlLink();
+
+    System_Tester lS0(lG0);
+
+    ZT::Result lRet = lC0->Gimbals_Set(&lS0);
+    assert(ZT::ZT_OK == lRet);
+
+    aBench->Run("ControlLink_OnGamepadEvent_Last_Entry", Last_Entry, lC0);
+    aBench->Run("ControlLink_OnGamepadEvent_Pitch"     , Pitch     , lC0);
+    aBench->Run("ControlLink_OnGamepadEvent_Unmapped"  , Unmapped  , lC0);
+
+    lC0->Release();
+    lG0->Release();
+
+    ControlLink * lC1 = Full_Table_Create();
+    if (NULL == lC1)
+    {
+        fprintf(stderr, "ERROR  ControlLink_Bench - The full table does not load\n");
+        return;
+    }
+
+    aBench->Run("ControlLink_OnGamepadEvent_Full_Table", Full_Table, lC1);
+
+    lC1->Release();
+}
+
+// Static functions
+/////////////////////////////////////////////////////////////////////////////
+
+ControlLink * Full_Table_Create()
+{
+    char lFileName[] = "/tmp/ZT_Bench_XXXXXX";
+
+    int lFile = mkstemp(lFileName);
+    if (0 > lFile)
+    {
+        return NULL;
+    }
+
+    FILE * lOut = fdopen(lFile, "w");
+    assert(NULL != lOut);
+
+    fprintf(lOut, "CLEAR\n");
+
+    for (unsigned int a = 0; a < ZT::IGamepad::ACTION_QTY; a ++)
+    {
+        for (unsigned int c = 0; c < ZT::IGamepad::CONTROL_QTY; c ++)
+        {
+            fprintf(lOut, "%s %s GIMBAL_FIRST\n", ZT::IGamepad::ACTION_NAMES[a], ZT::IGamepad::CONTROL_NAMES[c]);
+        }
+    }
+
+    int lRet = fclose(lOut);
+    assert(0 == lRet);
+
+    ControlLink * lResult = new ControlLink();
+
+    if (ZT::ZT_OK != lResult->ReadConfigFile(lFileName))
+    {
+        lResult->Release();
+        lResult = NULL;
+    }
+
+    lRet = unlink(lFileName);
+    assert(0 == lRet);
+
+    return lResult;
+}
+
+// ===== Benchmarks =========================================================
+
+// RELEASED TRIGGER_RIGHT is the last line of the configuration
+void Full_Table(void * aContext, unsigned int aIterations)
+{
+    assert(NULL != aContext);
+
+    ControlLink * lC1 = reinterpret_cast<ControlLink *>(aContext);
+
+    ZT::IGamepad::Event lEvent;
+
+    lEvent.mAction   = ZT::IGamepad::ACTION_RELEASED;
+    lEvent.mControl  = ZT::IGamepad::TRIGGER_RIGHT;
+    lEvent.mValue_pc = 0.0;
+
+    for (unsigned int i = 0; i < aIterations; i ++)
+    {
+        Bench::Consume(lC1->ProcessMessage(NULL, MSG_GAMEPAD, &lEvent));
+    }
+}
+
+void Last_Entry(void * aContext, unsigned int aIterations)
+{
+    assert(NULL != aContext);
+
+    ControlLink * lC0 = reinterpret_cast<ControlLink *>(aContext);
+
+    ZT::IGamepad::Event lEvent;
+
+    lEvent.mAction   = ZT::IGamepad::ACTION_PRESSED;
+    lEvent.mControl  = ZT::IGamepad::PAD_TOP;
+    lEvent.mValue_pc = 100.0;
+
+    for (unsigned int i = 0; i < aIterations; i ++)
+    {
+        Bench::Consume(lC0->ProcessMessage(NULL, MSG_GAMEPAD, &lEvent));
+    }
+}
+
+void Pitch(void * aContext, unsigned int aIterations)
+{
+    assert(NULL != aContext);
+
+    ControlLink * lC0 = reinterpret_cast<ControlLink *>(aContext);
+
+    ZT::IGamepad::Event lEvent;
+
+    lEvent.mAction  = ZT::IGamepad::ACTION_CHANGED;
+    lEvent.mControl = ZT::IGamepad::ANALOG_1_Y;
+
+    for (unsigned int i = 0; i < aIterations; i ++)
+    {
+        lEvent.mValue_pc = (i % 200) - 100.0;
+
+        Bench::Consume(lC0->ProcessMessage(NULL, MSG_GAMEPAD, &lEvent));
+    }
+}
+
+void Unmapped(void * aContext, unsigned int aIterations)
+{
+    assert(NULL != aContext);
+
+    ControlLink * lC0 = reinterpret_cast<ControlLink *>(aContext);
+
+    ZT::IGamepad::Event lEvent;
+
+    lEvent.mAction   = ZT::IGamepad::ACTION_RELEASED;
+    lEvent.mControl  = ZT::IGamepad::BUTTON_A;
+    lEvent.mValue_pc = 0.0;
+
+    for (unsigned int i = 0; i < aIterations; i ++)
+    {
+        Bench::Consume(lC0->ProcessMessage(NULL, MSG_GAMEPAD, &lEvent));
+    }
+}
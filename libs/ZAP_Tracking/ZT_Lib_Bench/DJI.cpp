@@ -0,0 +1,189 @@
+
+// Author  KMS - Martin Dubois, P. Eng.
+// Client  ZAP
+// Product Tacking
+// File    ZT_Lib_Bench/DJI.cpp
+
+#include "Component.h"
+
+// ===== ZT_Lib =============================================================
+#include "CAN_Batch.h"
+#include "DJI.h"
+#include "DJI_CRC.h"
+#include "DJI_Reassembler.h"
+#include "Stats.h"
+
+// ===== ZT_Lib_Bench =======================================================
+#include "Bench.h"
+
+// Static function declarations
+/////////////////////////////////////////////////////////////////////////////
+
+static void Frame_Position(DJI_Frame * aOut, uint16_t aSerial);
+
+// ===== Benchmarks =========================================================
+
+static void CRC_16          (void * aContext, unsigned int aIterations);
+static void CRC_32          (void * aContext, unsigned int aIterations);
+static void Frame_Angle_Get (void * aContext, unsigned int aIterations);
+static void Frame_Angle_Set (void * aContext, unsigned int aIterations);
+static void Frame_Init      (void * aContext, unsigned int aIterations);
+static void Frame_Seal      (void * aContext, unsigned int aIterations);
+static void Reassembler     (void * aContext, unsigned int aIterations);
+
+// Functions
+/////////////////////////////////////////////////////////////////////////////
+
+void DJI_Bench(Bench * aBench)
+{
+    assert(NULL != aBench);
+
+    aBench->Run("DJI_CRC_16"         , CRC_16         );
+    aBench->Run("DJI_CRC_32"         , CRC_32         );
+    aBench->Run("DJI_Frame_Angle_Get", Frame_Angle_Get);
+    aBench->Run("DJI_Frame_Angle_Set", Frame_Angle_Set);
+    aBench->Run("DJI_Frame_Init"     , Frame_Init     );
+    aBench->Run("DJI_Frame_Seal"     , Frame_Seal     );
+
+    // The reassembly of a 10 data byte POSITION_SET, 4 CAN fragments
+    CAN_Batch lBatch;
+    DJI_Frame lFrame;
+
+    Frame_Position(&lFrame, 1);
+
+    bool lRet = lBatch.Frame_Add(lFrame, DJI_CAN_ID_RX);
+    assert(lRet);
+
+    aBench->Run("DJI_Reassembler_Frame", Reassembler, &lBatch);
+}
+
+// Static functions
+/////////////////////////////////////////////////////////////////////////////
+
+void Frame_Position(DJI_Frame * aOut, uint16_t aSerial)
+{
+    assert(NULL != aOut);
+
+    aOut->Init(10, DJI_CMD_TYPE_NO_REPLY, DJI_CMD_SET_DEFAULT, DJI_CMD_POSITION_SET, aSerial);
+
+    aOut->Angle_Set(2,  45.0);
+    aOut->Angle_Set(4,   0.0);
+    aOut->Angle_Set(6, -10.0);
+
+    aOut->mData[8] = 0x01;
+    aOut->mData[9] = 10;
+
+    aOut->Seal();
+}
+
+// ===== Benchmarks =========================================================
+
+void CRC_16(void *, unsigned int aIterations)
+{
+    DJI_Frame lFrame;
+
+    Frame_Position(&lFrame, 1);
+
+    for (unsigned int i = 0; i < aIterations; i ++)
+    {
+        lFrame.mSerial = i;
+
+        Bench::Consume(DJI_CRC_16(reinterpret_cast<const uint8_t *>(&lFrame)));
+    }
+}
+
+// The CRC 32 covers the whole frame of a POSITION_SET, 22 bytes
+void CRC_32(void *, unsigned int aIterations)
+{
+    DJI_Frame lFrame;
+
+    Frame_Position(&lFrame, 1);
+
+    for (unsigned int i = 0; i < aIterations; i ++)
+    {
+        lFrame.mSerial = i;
+
+        Bench::Consume(DJI_CRC_32(reinterpret_cast<const uint8_t *>(&lFrame), DJI_HEADER_SIZE_byte + 10));
+    }
+}
+
+void Frame_Angle_Get(void *, unsigned int aIterations)
+{
+    DJI_Frame lFrame;
+
+    Frame_Position(&lFrame, 1);
+
+    for (unsigned int i = 0; i < aIterations; i ++)
+    {
+        lFrame.mData[2] = i;
+
+        Bench::Consume(static_cast<uint64_t>(lFrame.Angle_Get(2)));
+    }
+}
+
+void Frame_Angle_Set(void *, unsigned int aIterations)
+{
+    DJI_Frame lFrame;
+
+    Frame_Position(&lFrame, 1);
+
+    for (unsigned int i = 0; i < aIterations; i ++)
+    {
+        lFrame.Angle_Set(2, (i % 3600) / 10.0 - 180.0);
+
+        Bench::Consume(lFrame.mData[2]);
+    }
+}
+
+void Frame_Init(void *, unsigned int aIterations)
+{
+    DJI_Frame lFrame;
+
+    for (unsigned int i = 0; i < aIterations; i ++)
+    {
+        lFrame.Init(10, DJI_CMD_TYPE_NO_REPLY, DJI_CMD_SET_DEFAULT, DJI_CMD_POSITION_SET, i);
+
+        Bench::Consume(lFrame.mSize_byte);
+    }
+}
+
+void Frame_Seal(void *, unsigned int aIterations)
+{
+    DJI_Frame lFrame;
+
+    Frame_Position(&lFrame, 1);
+
+    for (unsigned int i = 0; i < aIterations; i ++)
+    {
+        lFrame.mSerial = i;
+
+        lFrame.Seal();
+
+        Bench::Consume(lFrame.mCRC16);
+    }
+}
+
+void Reassembler(void * aContext, unsigned int aIterations)
+{
+    assert(NULL != aContext);
+
+    const CAN_Batch * lBatch = reinterpret_cast<const CAN_Batch *>(aContext);
+
+    Stats           lStats;
+    DJI_Reassembler lReassembler(&lStats);
+
+    for (unsigned int i = 0; i < aIterations; i ++)
+    {
+        for (unsigned int f = 0; f < lBatch->Count_Get(); f ++)
+        {
+            const EthCAN_Frame & lF = lBatch->Frames_Get()[f];
+
+            lReassembler.Push(lF.mData, lF.mDataSize_byte);
+        }
+
+        const DJI_Frame * lFrame = lReassembler.Next();
+        assert(NULL != lFrame);
+
+        Bench::Consume(lFrame->mSerial);
+    }
+}
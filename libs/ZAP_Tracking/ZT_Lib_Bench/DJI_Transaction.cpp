@@ -0,0 +1,87 @@
+
+// Author  KMS - Martin Dubois, P. Eng.
+// Client  ZAP
+// Product Tacking
+// File    ZT_Lib_Bench/DJI_Transaction.cpp
+
+#include "Component.h"
+
+// ===== ZT_Lib =============================================================
+#include "DJI_Transaction.h"
+
+// ===== ZT_Lib_Bench =======================================================
+#include "Bench.h"
+
+// Static function declarations
+/////////////////////////////////////////////////////////////////////////////
+
+// ===== Benchmarks =========================================================
+
+static void ANGLE_GET   (void * aContext, unsigned int aIterations);
+static void POSITION_SET(void * aContext, unsigned int aIterations);
+static void SPEED_SET   (void * aContext, unsigned int aIterations);
+
+// Functions
+/////////////////////////////////////////////////////////////////////////////
+
+void DJI_Transaction_Bench(Bench * aBench)
+{
+    assert(NULL != aBench);
+
+    aBench->Run("DJI_Transaction_Frame_Init_ANGLE_GET"   , ANGLE_GET   );
+    aBench->Run("DJI_Transaction_Frame_Init_POSITION_SET", POSITION_SET);
+    aBench->Run("DJI_Transaction_Frame_Init_SPEED_SET"   , SPEED_SET   );
+}
+
+// Static functions
+/////////////////////////////////////////////////////////////////////////////
+
+// ===== Benchmarks =========================================================
+
+void ANGLE_GET(void *, unsigned int aIterations)
+{
+    DJI_Transaction lTr;
+
+    for (unsigned int i = 0; i < aIterations; i ++)
+    {
+        lTr.Frame_Init_ANGLE_GET();
+
+        Bench::Consume(lTr.Serial_Get());
+    }
+}
+
+void POSITION_SET(void *, unsigned int aIterations)
+{
+    ZT::IGimbal::Position lPos;
+    DJI_Transaction       lTr;
+
+    lPos.mAxis_deg[ZT::IGimbal::AXIS_PITCH] = -10.0;
+    lPos.mAxis_deg[ZT::IGimbal::AXIS_ROLL ] =   0.0;
+
+    for (unsigned int i = 0; i < aIterations; i ++)
+    {
+        lPos.mAxis_deg[ZT::IGimbal::AXIS_YAW] = (i % 3600) / 10.0 - 180.0;
+
+        lTr.Frame_Init_POSITION_SET(lPos, ZT_FLAG_IGNORE_ROLL, 1000);
+
+        Bench::Consume(lTr.Frame_Data_Get(2));
+    }
+}
+
+void SPEED_SET(void *, unsigned int aIterations)
+{
+    ZT::IGimbal::Speed lSpeed;
+    DJI_Transaction    lTr;
+
+    lSpeed.mAxis_deg_s[ZT::IGimbal::AXIS_PITCH] = 5.0;
+    lSpeed.mAxis_deg_s[ZT::IGimbal::AXIS_ROLL ] = 0.0;
+
+    for (unsigned int i = 0; i < aIterations; i ++)
+    {
+        lSpeed.mAxis_deg_s[ZT::IGimbal::AXIS_YAW] = (i % 720) / 2.0 - 180.0;
+
+        lTr.Frame_Init_SPEED_SET(lSpeed);
+
+        Bench::Consume(lTr.Frame_Data_Get(2));
+    }
+}
@@ -0,0 +1,80 @@
+
+// Author  KMS - Martin Dubois, P. Eng.
+// Client  ZAP
+// Product Tacking
+// File    ZT_Lib_Bench/Gimbal.cpp
+
+#include "Component.h"
+
+// ===== ZT_Lib =============================================================
+#include "Gimbal.h"
+
+// ===== ZT_Lib_Bench =======================================================
+#include "Bench.h"
+
+// Class
+/////////////////////////////////////////////////////////////////////////////
+
+// Gimbal without device, it gives access to the validation
+class Gimbal_Tester : public Gimbal
+{
+
+public:
+
+    ZT::Result Validate(const Position & aIn, unsigned int aFlags) const { return Position_Validate(aIn, aFlags); }
+
+    // ===== ZT::IGimbal ====================================================
+    virtual ZT::Result Focus_Cal(Operation aOperation) { return ZT::ZT_ERROR_NOT_READY; }
+    virtual ZT::Result Metrics_Get(Metrics * aOut, bool aReset) { return ZT::ZT_ERROR_NOT_READY; }
+    virtual ZT::Result Recorder_Dump(const char * aFileName) { return ZT::ZT_ERROR_NOT_READY; }
+    virtual ZT::Result Track_Speed_Set(double aSpeed_pc) { return ZT::ZT_ERROR_NOT_READY; }
+    virtual ZT::Result Track_Switch() { return ZT::ZT_ERROR_NOT_READY; }
+
+    virtual void Debug(void * aOut) {}
+
+};
+
+// Static function declarations
+/////////////////////////////////////////////////////////////////////////////
+
+// ===== Benchmarks =========================================================
+
+static void Position_Validate(void * aContext, unsigned int aIterations);
+
+// Functions
+/////////////////////////////////////////////////////////////////////////////
+
+void Gimbal_Bench(Bench * aBench)
+{
+    assert(NULL != aBench);
+
+    Gimbal_Tester * lG0 = new Gimbal_Tester();
+
+    aBench->Run("Gimbal_Position_Validate", Position_Validate, lG0);
+
+    lG0->Release();
+}
+
+// Static functions
+/////////////////////////////////////////////////////////////////////////////
+
+// ===== Benchmarks =========================================================
+
+void Position_Validate(void * aContext, unsigned int aIterations)
+{
+    assert(NULL != aContext);
+
+    const Gimbal_Tester * lG0 = reinterpret_cast<const Gimbal_Tester *>(aContext);
+
+    ZT::IGimbal::Position lPos;
+
+    lPos.mAxis_deg[ZT::IGimbal::AXIS_PITCH] = -10.0;
+    lPos.mAxis_deg[ZT::IGimbal::AXIS_ROLL ] =   0.0;
+
+    for (unsigned int i = 0; i < aIterations; i ++)
+    {
+        lPos.mAxis_deg[ZT::IGimbal::AXIS_YAW] = (i % 3600) / 10.0 - 180.0;
+
+        Bench::Consume(lG0->Validate(lPos, 0));
+    }
+}
@@ -0,0 +1,257 @@
+// Author  KMS - Martin Dubois, P. Eng.
+// Client  ZAP
+// Product Tacking
+// File    ZT_Lib_Bench/Replay.cpp
+
+#include "Component.h"
+
+// ===== C ==================================================================
+#include <limits.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+
+// ===== ZT_Lib =============================================================
+#include "CAN_Batch.h"
+#include "DJI.h"
+#include "DJI_Gimbal.h"
+#include "FlightRecorder.h"
+#include "Replay_Device.h"
+#include "Sim_Device.h"
+
+// ===== ZT_Lib_Bench =======================================================
+#include "Bench.h"
+
+// Constants
+/////////////////////////////////////////////////////////////////////////////
+
+#define REPLY_QTY (16384)
+
+// The serial of the recorded SPEED_SET, the replay replaces it in the
+// replies
+#define TRIGGER_SERIAL (0xfff0)
+
+#define WAIT_us (10000000)
+
+// Data types
+/////////////////////////////////////////////////////////////////////////////
+
+typedef struct
+{
+    Replay_Device * mDevice;
+    DJI_Gimbal    * mGimbal;
+
+    uint64_t     mDuration_ns;
+    unsigned int mRx_Frame;
+}
+Context;
+
+// Static function declarations
+/////////////////////////////////////////////////////////////////////////////
+
+// aRD [---;RW-] The records of the frame go there
+static void Record_Frame(Replay_Device * aRD, FlightRecorder_Type aType, const DJI_Frame & aFrame);
+
+static uint64_t Time_Get_ns();
+
+// ===== Benchmarks =========================================================
+
+static void Reply(void * aContext, unsigned int aIterations);
+
+// Functions
+/////////////////////////////////////////////////////////////////////////////
+
+// The capture is the activation of a simulated gimbal, followed by a
+// SPEED_SET and REPLY_QTY ANGLE_GET replies recorded after it. A new
+// DJI_Gimbal activates on the replay, then the Speed_Stop sends the
+// SPEED_SET and the replies go through the receive path of the gimbal, as
+// the late replies of position requests.
+void Replay_Bench(Bench * aBench)
+{
+    assert(NULL != aBench);
+
+    if (!aBench->IsSelected("Replay_"))
+    {
+        return;
+    }
+
+    char lFolder[] = "/tmp/ZT_Lib_Bench_XXXXXX";
+    char lFileName[PATH_MAX];
+
+    if (NULL == mkdtemp(lFolder))
+    {
+        fprintf(stderr, "ERROR  mkdtemp failed\n");
+        return;
+    }
+
+    sprintf(lFileName, "%s/Capture.bin", lFolder);
+
+    // ===== Capture ========================================================
+    DJI_Gimbal * lG0 = new DJI_Gimbal(new Sim_Device(Sim_Device::CONFIG_DEFAULT));
+
+    ZT::Result lRet = lG0->Connect();
+    if (ZT::ZT_OK == lRet)
+    {
+        lRet = lG0->Activate();
+        if (ZT::ZT_OK == lRet)
+        {
+            lRet = lG0->Recorder_Dump(lFileName);
+        }
+    }
+
+    delete lG0;
+
+    Replay_Device * lRD = new Replay_Device(Replay_Device::MODE_FAST);
+
+    if (ZT::ZT_OK == lRet)
+    {
+        lRet = lRD->Load(lFileName);
+    }
+
+    unlink(lFileName);
+    rmdir (lFolder);
+
+    if (ZT::ZT_OK != lRet)
+    {
+        fprintf(stderr, "ERROR  The capture failed\n");
+        lRD->Release();
+        return;
+    }
+
+    DJI_Frame lFrame;
+
+    lFrame.Init(9, DJI_CMD_TYPE_NO_REPLY, DJI_CMD_SET_DEFAULT, DJI_CMD_SPEED_SET, TRIGGER_SERIAL);
+    lFrame.Seal();
+
+    Record_Frame(lRD, FLIGHT_RECORDER_CAN_TX, lFrame);
+
+    for (unsigned int i = 0; i < REPLY_QTY; i ++)
+    {
+        lFrame.Init(10, DJI_CMD_TYPE_REPLY, DJI_CMD_SET_DEFAULT, DJI_CMD_ANGLE_GET, TRIGGER_SERIAL);
+
+        lFrame.mData[DJI_REPLY_RESULT] = DJI_OK;
+        lFrame.mData[3] = 0x01;
+
+        lFrame.Angle_Set(4, (i % 100) / 10.0);
+        lFrame.Angle_Set(6, 0.0);
+        lFrame.Angle_Set(8, 0.0);
+
+        lFrame.Seal();
+
+        Record_Frame(lRD, FLIGHT_RECORDER_CAN_RX, lFrame);
+    }
+
+    // ===== Replay =========================================================
+    Context lContext;
+
+    lContext.mDevice = lRD;
+    lContext.mGimbal = new DJI_Gimbal(lRD);
+
+    lRet = lContext.mGimbal->Connect();
+    if (ZT::ZT_OK == lRet)
+    {
+        lRet = lContext.mGimbal->Activate();
+    }
+
+    if (ZT::ZT_OK != lRet)
+    {
+        fprintf(stderr, "ERROR  The activation on the replay failed\n");
+    }
+    else
+    {
+        Replay_Device::Counters lCounters;
+
+        lRD->Counters_Get(&lCounters);
+
+        lContext.mDuration_ns = 0;
+        lContext.mRx_Frame    = lCounters.mRx_Frame;
+
+        aBench->Run_Once("Replay_DJI_Gimbal_Reply", Reply, &lContext, REPLY_QTY);
+
+        if (0 < lContext.mDuration_ns)
+        {
+            printf("    Replay  %.0f replies/s\n", REPLY_QTY * 1000000000.0 / lContext.mDuration_ns);
+        }
+    }
+
+    delete lContext.mGimbal;
+}
+
+// Static functions
+/////////////////////////////////////////////////////////////////////////////
+
+void Record_Frame(Replay_Device * aRD, FlightRecorder_Type aType, const DJI_Frame & aFrame)
+{
+    assert(NULL != aRD);
+
+    CAN_Batch lBatch;
+
+    bool lRet = lBatch.Frame_Add(aFrame, (FLIGHT_RECORDER_CAN_RX == aType) ? DJI_CAN_ID_RX : DJI_CAN_ID_TX);
+    assert(lRet);
+
+    uint64_t lNow_ns = Time_Get_ns();
+
+    for (unsigned int i = 0; i < lBatch.Count_Get(); i ++)
+    {
+        const EthCAN_Frame & lF = lBatch.Frames_Get()[i];
+
+        FlightRecorder_Record lRecord;
+
+        memset(&lRecord, 0, sizeof(lRecord));
+
+        lRecord.mTime_ns       = lNow_ns;
+        lRecord.mId            = lF.mId;
+        lRecord.mValue         = EthCAN_OK;
+        lRecord.mType          = aType;
+        lRecord.mDataSize_byte = lF.mDataSize_byte;
+
+        memcpy(lRecord.mData, lF.mData, lF.mDataSize_byte);
+
+        aRD->Record_Add(lRecord);
+    }
+}
+
+uint64_t Time_Get_ns()
+{
+    timespec lNow;
+
+    clock_gettime(CLOCK_MONOTONIC, &lNow);
+
+    return static_cast<uint64_t>(lNow.tv_sec) * 1000000000 + lNow.tv_nsec;
+}
+
+// ===== Benchmarks =========================================================
+
+// The stop wakes the worker of the gimbal, it sends the SPEED_SET at once.
+void Reply(void * aContext, unsigned int aIterations)
+{
+    assert(NULL != aContext);
+
+    Context * lContext = reinterpret_cast<Context *>(aContext);
+
+    uint64_t lBegin_ns = Time_Get_ns();
+
+    ZT::Result lRet = lContext->mGimbal->Speed_Stop();
+    if (ZT::ZT_OK != lRet)
+    {
+        fprintf(stderr, "ERROR  Speed_Stop failed\n");
+        return;
+    }
+
+    for (unsigned int i = 0; i < WAIT_us / 100; i ++)
+    {
+        Replay_Device::Counters lCounters;
+
+        lContext->mDevice->Counters_Get(&lCounters);
+
+        if (lContext->mRx_Frame + aIterations <= lCounters.mRx_Frame)
+        {
+            lContext->mDuration_ns = Time_Get_ns() - lBegin_ns;
+            return;
+        }
+
+        usleep(100);
+    }
+
+    fprintf(stderr, "ERROR  The replay did not deliver the replies\n");
+}
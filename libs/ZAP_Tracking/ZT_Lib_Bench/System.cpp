@@ -0,0 +1,191 @@
+// Author  KMS - Martin Dubois, P. Eng.
+// Client  ZAP
+// Product Tacking
+// File    ZT_Lib_Bench/System.cpp
+
+#include "Component.h"
+
+// ===== C ==================================================================
+#include <time.h>
+
+// ===== Includes ===========================================================
+#include <ZT/IGimbal.h>
+#include <ZT/ISystem.h>
+
+// ===== ZT_Lib_Bench =======================================================
+#include "Bench.h"
+
+// Constants
+/////////////////////////////////////////////////////////////////////////////
+
+#define GIMBAL_MAX (64)
+
+// Data types
+/////////////////////////////////////////////////////////////////////////////
+
+typedef struct
+{
+    unsigned int  mCount;
+    ZT::IGimbal * mGimbals[GIMBAL_MAX];
+}
+Context;
+
+// Static function declarations
+/////////////////////////////////////////////////////////////////////////////
+
+// aSystem  The system, its simulator creates the gimbals
+// aCount   1 to GIMBAL_MAX
+static void Scaling(Bench * aBench, ZT::ISystem * aSystem, unsigned int aCount);
+
+static uint64_t Time_Get_ns();
+
+// ===== Benchmarks =========================================================
+
+static void Position_Set(void * aContext, unsigned int aIterations);
+
+// Functions
+/////////////////////////////////////////////////////////////////////////////
+
+// The simulated gimbals of ISystem::Simulator_Set run their worker and
+// their Sim_Device thread, as real gimbals do. The commands go to the
+// gimbals in turn, the workers send the frames and the simulators reply.
+void System_Bench(Bench * aBench)
+{
+    assert(NULL != aBench);
+
+    if (!aBench->IsSelected("System_"))
+    {
+        return;
+    }
+
+    ZT::ISystem * lS0 = ZT::ISystem::Create();
+    assert(NULL != lS0);
+
+    for (unsigned int lCount = 1; lCount <= GIMBAL_MAX; lCount *= 4)
+    {
+        Scaling(aBench, lS0, lCount);
+    }
+
+    lS0->Release();
+}
+
+// Static functions
+/////////////////////////////////////////////////////////////////////////////
+
+void Scaling(Bench * aBench, ZT::ISystem * aSystem, unsigned int aCount)
+{
+    assert(NULL != aBench);
+    assert(NULL != aSystem);
+    assert(0 < aCount);
+    assert(GIMBAL_MAX >= aCount);
+
+    char lName[64];
+
+    sprintf(lName, "System_Simulator_%02u_Position_Set", aCount);
+
+    if (!aBench->IsSelected(lName))
+    {
+        return;
+    }
+
+    ZT::Result lRet = aSystem->Simulator_Set(aCount);
+    assert(ZT::ZT_OK == lRet);
+
+    lRet = aSystem->Gimbals_Detect();
+    assert(ZT::ZT_OK == lRet);
+
+    Context      lContext;
+    unsigned int i;
+
+    lContext.mCount = 0;
+
+    for (i = 0; i < aCount; i ++)
+    {
+        ZT::IGimbal * lG = aSystem->Gimbal_Get(0);
+        if (NULL == lG)
+        {
+            break;
+        }
+
+        lContext.mGimbals[lContext.mCount] = lG;
+        lContext.mCount ++;
+
+        lRet = lG->Activate();
+        if (ZT::ZT_OK != lRet)
+        {
+            fprintf(stderr, "ERROR  The activation of a simulated gimbal failed\n");
+            break;
+        }
+    }
+
+    if (aCount == i)
+    {
+        ZT::IGimbal::Metrics lMetrics;
+
+        for (i = 0; i < aCount; i ++)
+        {
+            lRet = lContext.mGimbals[i]->Metrics_Get(&lMetrics, true);
+            assert(ZT::ZT_OK == lRet);
+        }
+
+        uint64_t lBegin_ns = Time_Get_ns();
+
+        aBench->Run(lName, Position_Set, &lContext);
+
+        double lDuration_s = static_cast<double>(Time_Get_ns() - lBegin_ns) / 1000000000.0;
+
+        uint64_t lRx_frame = 0;
+        uint64_t lTx_frame = 0;
+
+        for (i = 0; i < aCount; i ++)
+        {
+            lRet = lContext.mGimbals[i]->Metrics_Get(&lMetrics, false);
+            assert(ZT::ZT_OK == lRet);
+
+            lRx_frame += lMetrics.mRx_frame;
+            lTx_frame += lMetrics.mTx_frame;
+        }
+
+        printf("    %2u gimbals  Tx %.0f frames/s  Rx %.0f frames/s\n", aCount, lTx_frame / lDuration_s, lRx_frame / lDuration_s);
+    }
+
+    for (i = 0; i < lContext.mCount; i ++)
+    {
+        lContext.mGimbals[i]->Release();
+    }
+
+    lRet = aSystem->Simulator_Set(0);
+    assert(ZT::ZT_OK == lRet);
+}
+
+uint64_t Time_Get_ns()
+{
+    timespec lNow;
+
+    clock_gettime(CLOCK_MONOTONIC, &lNow);
+
+    return static_cast<uint64_t>(lNow.tv_sec) * 1000000000 + lNow.tv_nsec;
+}
+
+// ===== Benchmarks =========================================================
+
+// Each gimbal alternates between two positions, the worker sends the last
+// one at its next tick.
+void Position_Set(void * aContext, unsigned int aIterations)
+{
+    assert(NULL != aContext);
+
+    const Context * lContext = reinterpret_cast<const Context *>(aContext);
+
+    ZT::IGimbal::Position lPos;
+
+    lPos.mAxis_deg[ZT::IGimbal::AXIS_PITCH] = 0.0;
+    lPos.mAxis_deg[ZT::IGimbal::AXIS_ROLL ] = 0.0;
+
+    for (unsigned int i = 0; i < aIterations; i ++)
+    {
+        lPos.mAxis_deg[ZT::IGimbal::AXIS_YAW] = (0 == ((i / lContext->mCount) & 1)) ? 10.0 : -10.0;
+
+        Bench::Consume(lContext->mGimbals[i % lContext->mCount]->Position_Set(lPos, 0, 100));
+    }
+}
@@ -0,0 +1,54 @@
+
+// Author  KMS - Martin Dubois, P. Eng.
+// Client  ZAP
+// Product Tacking
+// File    ZT_Lib_Bench/ZT_Lib_Bench.cpp
+
+// Usage  ZT_Lib_Bench [Filter]
+//
+// Filter  Only run the benchmarks with a name starting with it
+
+#include "Component.h"
+
+// ===== ZT_Lib_Bench =======================================================
+#include "Bench.h"
+
+// Benchmarks
+/////////////////////////////////////////////////////////////////////////////
+
+extern void ControlLink_Bench    (Bench * aBench);
+extern void DJI_Bench            (Bench * aBench);
+extern void DJI_Transaction_Bench(Bench * aBench);
+extern void Gimbal_Bench         (Bench * aBench);
+extern void Replay_Bench         (Bench * aBench);
+extern void System_Bench         (Bench * aBench);
+
+// Entry point
+/////////////////////////////////////////////////////////////////////////////
+
+int main(int aCount, const char ** aVector)
+{
+    if (2 < aCount)
+    {
+        fprintf(stderr, "USER ERROR  Invalid command line\n");
+        fprintf(stderr, "Usage  ZT_Lib_Bench [Filter]\n");
+        return 1;
+    }
+
+    Bench lBench(stdout, (2 == aCount) ? aVector[1] : NULL);
+
+    ControlLink_Bench    (&lBench);
+    DJI_Bench            (&lBench);
+    DJI_Transaction_Bench(&lBench);
+    Gimbal_Bench         (&lBench);
+    Replay_Bench         (&lBench);
+    System_Bench         (&lBench);
+
+    if (0 >= lBench.Count_Get())
+    {
+        fprintf(stderr, "ERROR  No benchmark matches the filter\n");
+        return 2;
+    }
+
+    return 0;
+}
@@ -0,0 +1,237 @@
+
+// Author  KMS - Martin Dubois, P.Eng.
+// Client  ZAP
+// Product Tacking
+// File    ZT_Lib_Test/CAN_Batch.cpp
+
+#include "Component.h"
+
+// ===== C ==================================================================
+#include <fcntl.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <time.h>
+#include <unistd.h>
+
+// ===== ZT_Lib =============================================================
+#include "CAN_Batch.h"
+#include "DJI_Reassembler.h"
+#include "Fake_Transport.h"
+
+// Constants
+// //////////////////////////////////////////////////////////////////////////
+
+#define FRAME_QTY (20000)
+
+// Data types
+// //////////////////////////////////////////////////////////////////////////
+
+// The fake transport writes to /dev/null. One write per call is what a
+// vectored transport costs, one write per fragment is what the EthCAN
+// library costs.
+typedef struct
+{
+    int  mFile;
+    bool mPerFragment;
+}
+Context;
+
+// Static function declarations
+// //////////////////////////////////////////////////////////////////////////
+
+static EthCAN_Result Handler(void * aContext, const CAN_Batch & aBatch);
+
+static uint64_t Measure(Fake_Transport * aT, unsigned int aFramesPerBatch);
+
+// Tests
+// //////////////////////////////////////////////////////////////////////////
+
+KMS_TEST_BEGIN(CAN_Batch_Base)
+{
+    CAN_Batch lB0;
+    DJI_Frame lF0;
+
+    // ===== Fragments ======================================================
+
+    lF0.Init(2, DJI_CMD_TYPE_DO_REPLY, DJI_CMD_SET_DEFAULT, DJI_CMD_ANGLE_GET, 1);
+    lF0.Seal();
+
+    KMS_TEST_ASSERT(lB0.Frame_Add(lF0, DJI_CAN_ID_TX));
+    KMS_TEST_COMPARE(3, lB0.Count_Get());
+    KMS_TEST_COMPARE(8, lB0.Frames_Get()[0].mDataSize_byte);
+    KMS_TEST_COMPARE(6, lB0.Frames_Get()[1].mDataSize_byte);
+    KMS_TEST_COMPARE(4, lB0.Frames_Get()[2].mDataSize_byte);
+    KMS_TEST_COMPARE(DJI_CAN_ID_TX, lB0.Frames_Get()[2].mId);
+
+    lF0.Init(12, DJI_CMD_TYPE_DO_REPLY, DJI_CMD_SET_DEFAULT, DJI_CMD_POSITION_SET, 2);
+    lF0.Seal();
+
+    KMS_TEST_ASSERT(lB0.Frame_Add(lF0, DJI_CAN_ID_TX));
+    KMS_TEST_COMPARE(7, lB0.Count_Get());
+
+    // ===== The reassembler gets the frames back ===========================
+
+    // The gimbal delivers the footer before the short end of the data
+    CAN_Batch lB1;
+
+    lF0.Init(2, DJI_CMD_TYPE_DO_REPLY, DJI_CMD_SET_DEFAULT, DJI_CMD_ANGLE_GET, 1);
+    lF0.Seal();
+
+    KMS_TEST_ASSERT(lB1.Frame_Add(lF0, DJI_CAN_ID_RX));
+    KMS_TEST_COMPARE(3, lB1.Count_Get());
+    KMS_TEST_COMPARE(8, lB1.Frames_Get()[0].mDataSize_byte);
+    KMS_TEST_COMPARE(4, lB1.Frames_Get()[1].mDataSize_byte);
+    KMS_TEST_COMPARE(6, lB1.Frames_Get()[2].mDataSize_byte);
+
+    lF0.Init(12, DJI_CMD_TYPE_DO_REPLY, DJI_CMD_SET_DEFAULT, DJI_CMD_POSITION_SET, 2);
+    lF0.Seal();
+
+    KMS_TEST_ASSERT(lB1.Frame_Add(lF0, DJI_CAN_ID_RX));
+    KMS_TEST_COMPARE(7, lB1.Count_Get());
+
+    // As the receiver, the test calls Next after each fragment
+    Stats           lStats;
+    DJI_Reassembler lR0(&lStats);
+    unsigned int    lRx_frame = 0;
+
+    for (unsigned int i = 0; i < lB1.Count_Get(); i++)
+    {
+        lR0.Push(lB1.Frames_Get()[i].mData, lB1.Frames_Get()[i].mDataSize_byte);
+
+        const DJI_Frame * lRx = lR0.Next();
+        if (NULL != lRx)
+        {
+            switch (lRx_frame)
+            {
+            case 0: KMS_TEST_COMPARE(1, lRx->mSerial); break;
+            case 1: KMS_TEST_COMPARE(0, memcmp(lRx, &lF0, lF0.mSize_byte)); break;
+            default: KMS_TEST_ASSERT(false);
+            }
+
+            lRx_frame ++;
+        }
+    }
+
+    KMS_TEST_COMPARE(2, lRx_frame);
+
+    // ===== Full ===========================================================
+
+    while (lB0.Frame_Add(lF0, DJI_CAN_ID_TX))
+    {
+    }
+
+    KMS_TEST_COMPARE(31, lB0.Count_Get());
+
+    lB0.Clear();
+    KMS_TEST_COMPARE(0, lB0.Count_Get());
+
+    // ===== Benchmark ======================================================
+
+    Context lContext;
+
+    lContext.mFile = open("/dev/null", O_WRONLY);
+    KMS_TEST_ASSERT_RETURN(0 <= lContext.mFile);
+
+    Fake_Transport           lT0(Handler, &lContext);
+    Fake_Transport::Counters lCounters;
+
+    static const struct
+    {
+        const char * mName;
+        unsigned int mFramesPerBatch;
+        bool         mPerFragment;
+    }
+    MODES[] =
+    {
+        { "One write per fragment", 1, true  },
+        { "One write per frame   ", 1, false },
+        { "One write per 8 frames", 8, false },
+    };
+
+    for (unsigned int m = 0; m < sizeof(MODES) / sizeof(MODES[0]); m++)
+    {
+        lContext.mPerFragment = MODES[m].mPerFragment;
+
+        lT0.Counters_Reset();
+
+        uint64_t lDuration_ns = Measure(&lT0, MODES[m].mFramesPerBatch);
+
+        lT0.Counters_Get(&lCounters);
+
+        KMS_TEST_COMPARE(FRAME_QTY * 4, lCounters.mFrame);
+
+        unsigned int lWrite = lContext.mPerFragment ? lCounters.mFrame : lCounters.mBatch;
+
+        printf("    %s : %u writes, %.1f ns/frame\n", MODES[m].mName, lWrite, static_cast<double>(lDuration_ns) / FRAME_QTY);
+    }
+
+    close(lContext.mFile);
+}
+KMS_TEST_END
+
+// Static functions
+// //////////////////////////////////////////////////////////////////////////
+
+EthCAN_Result Handler(void * aContext, const CAN_Batch & aBatch)
+{
+    assert(NULL != aContext);
+
+    Context * lContext = reinterpret_cast<Context *>(aContext);
+
+    const EthCAN_Frame * lFrames = aBatch.Frames_Get();
+    unsigned int         lCount  = aBatch.Count_Get();
+
+    if (lContext->mPerFragment)
+    {
+        for (unsigned int i = 0; i < lCount; i++)
+        {
+            if (sizeof(EthCAN_Frame) != write(lContext->mFile, lFrames + i, sizeof(EthCAN_Frame)))
+            {
+                return EthCAN_ERROR;
+            }
+        }
+    }
+    else
+    {
+        if (sizeof(EthCAN_Frame) * lCount != write(lContext->mFile, lFrames, sizeof(EthCAN_Frame) * lCount))
+        {
+            return EthCAN_ERROR;
+        }
+    }
+
+    return EthCAN_OK;
+}
+
+uint64_t Measure(Fake_Transport * aT, unsigned int aFramesPerBatch)
+{
+    assert(NULL != aT);
+    assert(0 < aFramesPerBatch);
+
+    CAN_Batch lBatch;
+    DJI_Frame lFrame;
+
+    // A POSITION_SET frame is 4 fragments
+    lFrame.Init(12, DJI_CMD_TYPE_DO_REPLY, DJI_CMD_SET_DEFAULT, DJI_CMD_POSITION_SET, 0);
+    lFrame.Seal();
+
+    timespec lT0;
+    timespec lT1;
+
+    clock_gettime(CLOCK_MONOTONIC, &lT0);
+
+    for (unsigned int i = 0; i < FRAME_QTY; i += aFramesPerBatch)
+    {
+        lBatch.Clear();
+
+        for (unsigned int j = 0; j < aFramesPerBatch; j++)
+        {
+            lBatch.Frame_Add(lFrame, DJI_CAN_ID_TX);
+        }
+
+        aT->Send(lBatch);
+    }
+
+    clock_gettime(CLOCK_MONOTONIC, &lT1);
+
+    return (lT1.tv_sec - lT0.tv_sec) * 1000000000LL + (lT1.tv_nsec - lT0.tv_nsec);
+}
@@ -6,11 +6,156 @@
 
 #include "Component.h"
 
+// ===== C++ ================================================================
+#include <atomic>
+
+// ===== C ==================================================================
+#include <time.h>
+#include <unistd.h>
+
 // ===== Includes ===========================================================
 #include <ZT/IControlLink.h>
 #include <ZT/IGamepad.h>
+#include <ZT/IMessageReceiver.h>
 #include <ZT/ISystem.h>
 
+// ===== ZT_Lib =============================================================
+#include "ControlLink.h"
+#include "Gimbal.h"
+
+// Constants
+// //////////////////////////////////////////////////////////////////////////
+
+#define ACTIVATE_us (200000)
+
+#define GIMBAL_QTY (4)
+
+#define MSG_GAMEPAD (1) // See ZT_Lib/ControlLink.cpp
+#define MSG_UNKNOWN (2)
+
+// Class
+// //////////////////////////////////////////////////////////////////////////
+
+class Gamepad_Tester : public ZT::IGamepad
+{
+
+public:
+
+    // ===== ZT::IGamepad ===================================================
+    virtual void Debug(void * aOut) {}
+
+    virtual ZT::Result Receiver_Start(ZT::IMessageReceiver * aReceiver, unsigned int aCode) { return ZT::ZT_OK; }
+    virtual ZT::Result Receiver_Stop() { return ZT::ZT_OK; }
+
+    // ===== ZT::IObject ====================================================
+    virtual void Release() {}
+
+};
+
+// Gimbal without device, Activate takes ACTIVATE_us and returns the result
+// the test gives
+class Gimbal_Activate_Tester : public Gimbal
+{
+
+public:
+
+    Gimbal_Activate_Tester(ZT::Result aResult) : mActivate_Count(0), mResult(aResult) {}
+
+    std::atomic<unsigned int> mActivate_Count;
+
+    // ===== ZT::IGimbal ====================================================
+    virtual ZT::Result Activate() { mActivate_Count ++; usleep(ACTIVATE_us); return mResult; }
+
+    virtual ZT::Result Focus_Cal(Operation aOperation) { return ZT::ZT_ERROR_NOT_READY; }
+    virtual ZT::Result Metrics_Get(Metrics * aOut, bool aReset) { return ZT::ZT_ERROR_NOT_READY; }
+    virtual ZT::Result Recorder_Dump(const char * aFileName) { return ZT::ZT_ERROR_NOT_READY; }
+    virtual ZT::Result Track_Speed_Set(double aSpeed_pc) { return ZT::ZT_ERROR_NOT_READY; }
+    virtual ZT::Result Track_Switch() { return ZT::ZT_ERROR_NOT_READY; }
+
+    virtual void Debug(void * aOut) {}
+
+private:
+
+    ZT::Result mResult;
+
+};
+
+// Count the events the ControlLink does not map
+class Receiver_Tester : public ZT::IMessageReceiver
+{
+
+public:
+
+    Receiver_Tester() : mUnknown(0) {}
+
+    // ===== ZT::IMessageReceiver ===========================================
+    virtual bool ProcessMessage(void * aSender, unsigned int aCode, const void * aData)
+    {
+        assert(MSG_UNKNOWN == aCode);
+
+        mUnknown ++;
+
+        return true;
+    }
+
+    unsigned int mUnknown;
+
+};
+
+// System giving the gimbals of the test to the ControlLink
+class System_Tester : public ZT::ISystem
+{
+
+public:
+
+    System_Tester(ZT::IGimbal ** aGimbals) : mPosition_Count(0), mGimbals(aGimbals) {}
+
+    // The gimbals of the last Gimbals_Position_Set
+    ZT::IGimbal * mPosition_Gimbals[GIMBAL_QTY];
+    unsigned int  mPosition_Count;
+
+    // ===== ZT::ISystem ====================================================
+    virtual ZT::Result Cache_Set(const char * aFolder) { return ZT::ZT_ERROR_NOT_READY; }
+
+    virtual ZT::Result Gamepads_Detect() { return ZT::ZT_OK; }
+    virtual ZT::Result Gimbals_Detect () { return ZT::ZT_OK; }
+
+    virtual ZT::IGamepad * Gamepad_Get(unsigned int aIndex) { return NULL; }
+
+    virtual ZT::IGimbal * Gimbal_Find_IPv4(const char * aIPv4) { return NULL; }
+    virtual ZT::IGimbal * Gimbal_Find_IPv4(uint32_t aIPv4) { return NULL; }
+
+    virtual ZT::IGimbal * Gimbal_Get(unsigned int aIndex) { return (GIMBAL_QTY > aIndex) ? mGimbals[aIndex] : NULL; }
+
+    virtual ZT::Result Gimbals_Position_Set(ZT::IGimbal ** aGimbals, const ZT::IGimbal::Position * aPositions, unsigned int aCount, unsigned int aFlags, unsigned int aDuration_ms)
+    {
+        assert(GIMBAL_QTY >= aCount);
+
+        memcpy(mPosition_Gimbals, aGimbals, sizeof(ZT::IGimbal *) * aCount);
+        mPosition_Count = aCount;
+
+        return ZT::ZT_OK;
+    }
+
+    virtual ZT::Result Simulator_Set(unsigned int aGimbal_Count) { return ZT::ZT_ERROR_NOT_READY; }
+
+    // ===== ZT::IObject ====================================================
+    virtual void Release() {}
+
+private:
+
+    ZT::IGimbal ** mGimbals;
+
+};
+
+// Static function declarations
+// //////////////////////////////////////////////////////////////////////////
+
+// Return true when the ControlLink maps the event
+static bool IsMapped(ControlLink * aC, Receiver_Tester * aR, ZT::IGamepad::Action aAction, ZT::IGamepad::Control aControl);
+
+static uint64_t Time_Get_us();
+
 // Tests
 // //////////////////////////////////////////////////////////////////////////
 
@@ -29,6 +174,35 @@ KMS_TEST_BEGIN(ControlLink_Base)
 }
 KMS_TEST_END
 
+KMS_TEST_BEGIN(ControlLink_Table)
+{
+    Receiver_Tester lR0;
+
+    ControlLink * lC0 = new ControlLink();
+
+    KMS_TEST_COMPARE(ZT::ZT_OK, lC0->Receiver_Set(&lR0, 0, MSG_UNKNOWN));
+
+    // ===== Default table ==================================================
+
+    KMS_TEST_ASSERT( IsMapped(lC0, &lR0, ZT::IGamepad::ACTION_PRESSED , ZT::IGamepad::PAD_BOTTOM));
+    KMS_TEST_ASSERT(!IsMapped(lC0, &lR0, ZT::IGamepad::ACTION_PRESSED , ZT::IGamepad::BUTTON_RIGHT));
+    KMS_TEST_ASSERT(!IsMapped(lC0, &lR0, ZT::IGamepad::ACTION_RELEASED, ZT::IGamepad::PAD_BOTTOM));
+
+    // ===== CLEAR, add, remove and add again ===============================
+
+    KMS_TEST_COMPARE(ZT::ZT_OK, lC0->ReadConfigFile("ZT_Lib/Tests/Config_5.txt"));
+
+    KMS_TEST_ASSERT(!IsMapped(lC0, &lR0, ZT::IGamepad::ACTION_PRESSED , ZT::IGamepad::PAD_BOTTOM));
+    KMS_TEST_ASSERT( IsMapped(lC0, &lR0, ZT::IGamepad::ACTION_PRESSED , ZT::IGamepad::BUTTON_A));
+    KMS_TEST_ASSERT(!IsMapped(lC0, &lR0, ZT::IGamepad::ACTION_PRESSED , ZT::IGamepad::BUTTON_B));
+    KMS_TEST_ASSERT( IsMapped(lC0, &lR0, ZT::IGamepad::ACTION_RELEASED, ZT::IGamepad::TRIGGER_RIGHT));
+
+    KMS_TEST_COMPARE(4, lR0.mUnknown);
+
+    lC0->Release();
+}
+KMS_TEST_END
+
 KMS_TEST_BEGIN(ControlLink_SetupC)
 {
     ZT::IControlLink * lC0 = ZT::IControlLink::Create();
@@ -56,3 +230,151 @@ KMS_TEST_BEGIN(ControlLink_SetupC)
     lS0->Release();
 }
 KMS_TEST_END
+
+KMS_TEST_BEGIN(ControlLink_Start)
+{
+    ControlLink  * lC0;
+    uint64_t       lDuration_us;
+    Gamepad_Tester lGamepad;
+    ZT::IGimbal  * lGimbals[GIMBAL_QTY];
+    unsigned int   i;
+
+    // ===== Partial success, the gimbals activate in parallel ==============
+
+    lGimbals[0] = new Gimbal_Activate_Tester(ZT::ZT_OK);
+    lGimbals[1] = new Gimbal_Activate_Tester(ZT::ZT_ERROR_TIMEOUT);
+    lGimbals[2] = new Gimbal_Activate_Tester(ZT::ZT_OK);
+    lGimbals[3] = new Gimbal_Activate_Tester(ZT::ZT_ERROR_GIMBAL);
+
+    System_Tester lSystem(lGimbals);
+
+    lC0 = new ControlLink();
+
+    KMS_TEST_COMPARE(ZT::ZT_OK, lC0->ReadConfigFile("ZT_Lib/Tests/Config_4.txt"));
+    KMS_TEST_COMPARE(ZT::ZT_OK, lC0->Gamepad_Set(&lGamepad));
+    KMS_TEST_COMPARE(ZT::ZT_OK, lC0->Gimbals_Set(&lSystem));
+
+    lDuration_us = Time_Get_us();
+
+    KMS_TEST_COMPARE(ZT::ZT_OK, lC0->Start());
+
+    lDuration_us = Time_Get_us() - lDuration_us;
+
+    printf("    %u gimbals, Start took %u ms, %u ms each\n", GIMBAL_QTY, static_cast<unsigned int>(lDuration_us / 1000), ACTIVATE_us / 1000);
+
+    KMS_TEST_ASSERT(2 * ACTIVATE_us > lDuration_us);
+
+    KMS_TEST_COMPARE(GIMBAL_QTY, lC0->Gimbal_Count_Get());
+
+    KMS_TEST_COMPARE(ZT::ZT_OK           , lC0->Gimbal_Result_Get(0));
+    KMS_TEST_COMPARE(ZT::ZT_ERROR_TIMEOUT, lC0->Gimbal_Result_Get(1));
+    KMS_TEST_COMPARE(ZT::ZT_OK           , lC0->Gimbal_Result_Get(2));
+    KMS_TEST_COMPARE(ZT::ZT_ERROR_GIMBAL , lC0->Gimbal_Result_Get(3));
+    KMS_TEST_COMPARE(ZT::ZT_ERROR_GIMBAL , lC0->Gimbal_Result_Get(GIMBAL_QTY));
+
+    // ===== HOME_ALL moves the activated gimbals through the system ========
+
+    ZT::IGamepad::Event lEvent;
+
+    lEvent.mAction   = ZT::IGamepad::ACTION_PRESSED;
+    lEvent.mControl  = ZT::IGamepad::BUTTON_RIGHT;
+    lEvent.mValue_pc = 100.0;
+
+    KMS_TEST_ASSERT(lC0->ProcessMessage(NULL, MSG_GAMEPAD, &lEvent));
+
+    KMS_TEST_COMPARE(2, lSystem.mPosition_Count);
+    KMS_TEST_ASSERT(lGimbals[0] == lSystem.mPosition_Gimbals[0]);
+    KMS_TEST_ASSERT(lGimbals[2] == lSystem.mPosition_Gimbals[1]);
+
+    KMS_TEST_COMPARE(ZT::ZT_OK, lC0->Stop());
+
+    lC0->Release();
+
+    for (i = 0; i < GIMBAL_QTY; i ++)
+    {
+        lGimbals[i]->Release();
+    }
+
+    // ===== Shared gimbal, it activates once ===============================
+
+    lGimbals[0] = new Gimbal_Activate_Tester(ZT::ZT_ERROR_TIMEOUT);
+    lGimbals[1] = new Gimbal_Activate_Tester(ZT::ZT_OK);
+    lGimbals[2] = NULL;
+    lGimbals[3] = NULL;
+
+    ZT::IControlLink * lC1 = new ControlLink();
+
+    KMS_TEST_COMPARE(ZT::ZT_OK, lC1->ReadConfigFile("ZT_Lib/Tests/Config_6.txt"));
+    KMS_TEST_COMPARE(ZT::ZT_OK, lC1->Gamepad_Set(&lGamepad));
+    KMS_TEST_COMPARE(ZT::ZT_OK, lC1->Gimbals_Set(&lSystem));
+    KMS_TEST_COMPARE(ZT::ZT_OK, lC1->Start());
+
+    KMS_TEST_COMPARE(1, static_cast<Gimbal_Activate_Tester *>(lGimbals[0])->mActivate_Count);
+    KMS_TEST_COMPARE(1, static_cast<Gimbal_Activate_Tester *>(lGimbals[1])->mActivate_Count);
+
+    KMS_TEST_COMPARE(3                   , lC1->Gimbal_Count_Get());
+    KMS_TEST_COMPARE(ZT::ZT_ERROR_TIMEOUT, lC1->Gimbal_Result_Get(0));
+    KMS_TEST_COMPARE(ZT::ZT_ERROR_TIMEOUT, lC1->Gimbal_Result_Get(1));
+    KMS_TEST_COMPARE(ZT::ZT_OK           , lC1->Gimbal_Result_Get(2));
+
+    KMS_TEST_COMPARE(ZT::ZT_OK, lC1->Stop());
+
+    lC1->Release();
+
+    lGimbals[0]->Release();
+    lGimbals[1]->Release();
+
+    // ===== No gimbal activates ============================================
+
+    for (i = 0; i < GIMBAL_QTY; i ++)
+    {
+        lGimbals[i] = new Gimbal_Activate_Tester(ZT::ZT_ERROR_TIMEOUT);
+    }
+
+    lC0 = new ControlLink();
+
+    KMS_TEST_COMPARE(ZT::ZT_OK, lC0->ReadConfigFile("ZT_Lib/Tests/Config_4.txt"));
+    KMS_TEST_COMPARE(ZT::ZT_OK, lC0->Gamepad_Set(&lGamepad));
+    KMS_TEST_COMPARE(ZT::ZT_OK, lC0->Gimbals_Set(&lSystem));
+
+    KMS_TEST_COMPARE(ZT::ZT_ERROR_TIMEOUT, lC0->Start());
+
+    lC0->Release();
+
+    for (i = 0; i < GIMBAL_QTY; i ++)
+    {
+        lGimbals[i]->Release();
+    }
+}
+KMS_TEST_END
+
+// Static functions
+// //////////////////////////////////////////////////////////////////////////
+
+bool IsMapped(ControlLink * aC, Receiver_Tester * aR, ZT::IGamepad::Action aAction, ZT::IGamepad::Control aControl)
+{
+    assert(NULL != aC);
+    assert(NULL != aR);
+
+    ZT::IGamepad::Event lEvent;
+
+    lEvent.mAction   = aAction;
+    lEvent.mControl  = aControl;
+    lEvent.mValue_pc = 100.0;
+
+    unsigned int lUnknown = aR->mUnknown;
+
+    bool lRet = aC->ProcessMessage(NULL, MSG_GAMEPAD, &lEvent);
+    assert(lRet);
+
+    return lUnknown == aR->mUnknown;
+}
+
+uint64_t Time_Get_us()
+{
+    timespec lNow;
+
+    clock_gettime(CLOCK_MONOTONIC, &lNow);
+
+    return static_cast<uint64_t>(lNow.tv_sec) * 1000000 + lNow.tv_nsec / 1000;
+}
@@ -0,0 +1,98 @@
+
+// Author  KMS - Martin Dubois, P. Eng.
+// Client  ZAP
+// Product Tacking
+// File    ZT_Lib_Test/DJI_CRC.cpp
+
+#include "Component.h"
+
+// ===== C ==================================================================
+#include <stdint.h>
+#include <stdlib.h>
+
+// ===== ZT_Lib =============================================================
+#include "DJI_CRC.h"
+
+// Static function declarations
+// //////////////////////////////////////////////////////////////////////////
+
+// One bit at a time, the definition of the CRC
+static uint16_t CRC_16_Bitwise(const uint8_t * aIn, unsigned int aSize_byte);
+static uint32_t CRC_32_Bitwise(const uint8_t * aIn, unsigned int aSize_byte);
+
+// Tests
+// //////////////////////////////////////////////////////////////////////////
+
+KMS_TEST_BEGIN(DJI_CRC_Base)
+{
+    uint8_t lBuffer[256];
+
+    for (unsigned int i = 0; i < sizeof(lBuffer); i ++)
+    {
+        lBuffer[i] = i * 37 + 11;
+    }
+
+    // Values of the byte at a time implementation
+    KMS_TEST_COMPARE(0xe74b, DJI_CRC_16(lBuffer));
+
+    KMS_TEST_COMPARE(0x024ce3ea, DJI_CRC_32(lBuffer, 14));
+    KMS_TEST_COMPARE(0xabbe34d0, DJI_CRC_32(lBuffer, 22));
+    KMS_TEST_COMPARE(0xcf2981b0, DJI_CRC_32(lBuffer, 28));
+    KMS_TEST_COMPARE(0x2a9a70c6, DJI_CRC_32(lBuffer, 32));
+    KMS_TEST_COMPARE(0x5b22e546, DJI_CRC_32(lBuffer, 64));
+
+    // Random content, each size and each alignment
+    srand(1);
+
+    for (unsigned int i = 0; i < 2000; i ++)
+    {
+        for (unsigned int j = 0; j < sizeof(lBuffer); j ++)
+        {
+            lBuffer[j] = rand();
+        }
+
+        unsigned int lOffset    = i % 8;
+        unsigned int lSize_byte = 14 + i % 200;
+
+        KMS_TEST_COMPARE(CRC_16_Bitwise(lBuffer + lOffset, 10        ), DJI_CRC_16(lBuffer + lOffset));
+        KMS_TEST_COMPARE(CRC_32_Bitwise(lBuffer + lOffset, lSize_byte), DJI_CRC_32(lBuffer + lOffset, lSize_byte));
+    }
+}
+KMS_TEST_END
+
+// Static functions
+// //////////////////////////////////////////////////////////////////////////
+
+uint16_t CRC_16_Bitwise(const uint8_t * aIn, unsigned int aSize_byte)
+{
+    uint16_t lResult = 0x3aa3;
+
+    for (unsigned int i = 0; i < aSize_byte; i ++)
+    {
+        lResult ^= aIn[i];
+
+        for (unsigned int b = 0; b < 8; b ++)
+        {
+            lResult = (lResult & 1) ? ((lResult >> 1) ^ 0xa001) : (lResult >> 1);
+        }
+    }
+
+    return lResult;
+}
+
+uint32_t CRC_32_Bitwise(const uint8_t * aIn, unsigned int aSize_byte)
+{
+    uint32_t lResult = 0x3aa3;
+
+    for (unsigned int i = 0; i < aSize_byte; i ++)
+    {
+        lResult ^= aIn[i];
+
+        for (unsigned int b = 0; b < 8; b ++)
+        {
+            lResult = (lResult & 1) ? ((lResult >> 1) ^ 0xedb88320) : (lResult >> 1);
+        }
+    }
+
+    return lResult;
+}
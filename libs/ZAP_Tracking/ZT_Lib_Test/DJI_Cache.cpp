@@ -0,0 +1,184 @@
+
+// Author  KMS - Martin Dubois, P. Eng.
+// Client  ZAP
+// Product Tacking
+// File    ZT_Lib_Test/DJI_Cache.cpp
+
+#include "Component.h"
+
+// ===== C ==================================================================
+#include <fcntl.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+// ===== ZT_Lib =============================================================
+#include "DJI_Cache.h"
+#include "DJI_Gimbal.h"
+#include "Sim_Device.h"
+
+// Static function declarations
+// //////////////////////////////////////////////////////////////////////////
+
+// aDuration_us [---;-W-] The duration of Activate
+static DJI_Gimbal * Gimbal_Activate(const char * aFolder, uint64_t * aDuration_us);
+
+static uint64_t Time_Get_us();
+
+// Tests
+// //////////////////////////////////////////////////////////////////////////
+
+KMS_TEST_BEGIN(DJI_Cache_Base)
+{
+    DJI_Cache           lCache;
+    ZT::IGimbal::Config lConfig;
+    ZT::IGimbal::Config lConfig_Cold;
+    char                lFileName[PATH_MAX];
+    char                lFolder[] = "/tmp/ZT_Cache_Test_XXXXXX";
+    DJI_Gimbal        * lG;
+    ZT::IGimbal::Info   lInfo;
+    ZT::IGimbal::Info   lInfo_Cold;
+    uint64_t            lCold_us;
+    uint64_t            lWarm_us;
+
+    KMS_TEST_ASSERT(NULL != mkdtemp(lFolder));
+
+    lCache.Folder_Set(lFolder);
+    KMS_TEST_ASSERT(lCache.IsEnabled());
+
+    // ===== Cold, Activate asks the gimbal and saves the cache =============
+
+    lG = Gimbal_Activate(lFolder, &lCold_us);
+
+    lG->Config_Get(&lConfig_Cold);
+    lG->Info_Get  (&lInfo_Cold);
+
+    delete lG;
+
+    memset(&lConfig, 0, sizeof(lConfig));
+    memset(&lInfo  , 0, sizeof(lInfo));
+
+    lInfo.mIPv4_Address = lInfo_Cold.mIPv4_Address;
+    memcpy(lInfo.mName, lInfo_Cold.mName, sizeof(lInfo.mName));
+
+    KMS_TEST_COMPARE(ZT::ZT_OK, lCache.Load(&lInfo, &lConfig));
+    KMS_TEST_ASSERT(0 == memcmp(lInfo_Cold.mVersion, lInfo.mVersion, sizeof(lInfo.mVersion)));
+
+    FOR_EACH_AXIS(a)
+    {
+        KMS_TEST_ASSERT(lConfig_Cold.mAxis[a].mMax_deg      == lConfig.mAxis[a].mMax_deg);
+        KMS_TEST_ASSERT(lConfig_Cold.mAxis[a].mMin_deg      == lConfig.mAxis[a].mMin_deg);
+        KMS_TEST_ASSERT(lConfig_Cold.mAxis[a].mStiffness_pc == lConfig.mAxis[a].mStiffness_pc);
+    }
+
+    // ===== Warm, Activate uses the cache ==================================
+
+    lG = Gimbal_Activate(lFolder, &lWarm_us);
+
+    printf("    Activate - Cold %u us, warm %u us\n", static_cast<unsigned int>(lCold_us), static_cast<unsigned int>(lWarm_us));
+
+    KMS_TEST_ASSERT(lCold_us > lWarm_us);
+
+    lG->Info_Get(&lInfo);
+    KMS_TEST_ASSERT(0 == memcmp(lInfo_Cold.mVersion, lInfo.mVersion, sizeof(lInfo.mVersion)));
+
+    // The validation gives the same values
+    usleep(200000);
+
+    lG->Config_Get(&lConfig);
+    KMS_TEST_ASSERT(lConfig_Cold.mAxis[ZT::IGimbal::AXIS_YAW].mMax_deg == lConfig.mAxis[ZT::IGimbal::AXIS_YAW].mMax_deg);
+
+    delete lG;
+
+    // ===== Mismatch, the validation corrects the cache ====================
+
+    lConfig = lConfig_Cold;
+    lConfig.mAxis[ZT::IGimbal::AXIS_YAW].mMax_deg = lConfig_Cold.mAxis[ZT::IGimbal::AXIS_YAW].mMax_deg - 10.0;
+
+    KMS_TEST_COMPARE(ZT::ZT_OK, lCache.Save(lInfo_Cold, lConfig));
+
+    lG = Gimbal_Activate(lFolder, &lWarm_us);
+
+    usleep(200000);
+
+    // The gimbal uses the value it reported, not the cached one.
+    lG->Config_Get(&lConfig);
+    KMS_TEST_ASSERT(lConfig_Cold.mAxis[ZT::IGimbal::AXIS_YAW].mMax_deg == lConfig.mAxis[ZT::IGimbal::AXIS_YAW].mMax_deg);
+
+    delete lG;
+
+    lInfo = lInfo_Cold;
+
+    KMS_TEST_COMPARE(ZT::ZT_OK, lCache.Load(&lInfo, &lConfig));
+    KMS_TEST_ASSERT(lConfig_Cold.mAxis[ZT::IGimbal::AXIS_YAW].mMax_deg == lConfig.mAxis[ZT::IGimbal::AXIS_YAW].mMax_deg);
+
+    // ===== An other device at the same address ============================
+
+    lInfo = lInfo_Cold;
+    lInfo.mName[0] ++;
+
+    KMS_TEST_COMPARE(ZT::ZT_ERROR_GIMBAL, lCache.Load(&lInfo, &lConfig));
+
+    // ===== Corrupted file =================================================
+
+    const uint8_t * lA = reinterpret_cast<const uint8_t *>(&lInfo_Cold.mIPv4_Address);
+
+    sprintf(lFileName, "%s/ZT_Cache_%u.%u.%u.%u.bin", lFolder, lA[0], lA[1], lA[2], lA[3]);
+
+    int lFile = open(lFileName, O_WRONLY);
+    KMS_TEST_ASSERT(0 <= lFile);
+
+    KMS_TEST_COMPARE(4, pwrite(lFile, "ZTZT", 4, offsetof(DJI_Cache_File, mAxis)));
+    KMS_TEST_COMPARE(0, close(lFile));
+
+    lInfo = lInfo_Cold;
+
+    KMS_TEST_COMPARE(ZT::ZT_ERROR_CONFIG, lCache.Load(&lInfo, &lConfig));
+
+    // ===== Without file ===================================================
+
+    KMS_TEST_COMPARE(0, unlink(lFileName));
+
+    KMS_TEST_COMPARE(ZT::ZT_ERROR_FILE_OPEN, lCache.Load(&lInfo, &lConfig));
+
+    KMS_TEST_COMPARE(0, rmdir(lFolder));
+}
+KMS_TEST_END
+
+// Static functions
+// //////////////////////////////////////////////////////////////////////////
+
+DJI_Gimbal * Gimbal_Activate(const char * aFolder, uint64_t * aDuration_us)
+{
+    assert(NULL != aFolder);
+    assert(NULL != aDuration_us);
+
+    DJI_Gimbal * lResult = new DJI_Gimbal(new Sim_Device(Sim_Device::CONFIG_DEFAULT));
+
+    lResult->Cache_Set(aFolder);
+
+    ZT::Result lRet = lResult->Connect();
+    assert(ZT::ZT_OK == lRet);
+
+    *aDuration_us = Time_Get_us();
+
+    lRet = lResult->Activate();
+    assert(ZT::ZT_OK == lRet);
+
+    *aDuration_us = Time_Get_us() - *aDuration_us;
+
+    return lResult;
+}
+
+uint64_t Time_Get_us()
+{
+    timespec lNow;
+
+    clock_gettime(CLOCK_MONOTONIC, &lNow);
+
+    return static_cast<uint64_t>(lNow.tv_sec) * 1000000 + lNow.tv_nsec / 1000;
+}
@@ -0,0 +1,175 @@
+
+// Author  KMS - Martin Dubois, P. Eng.
+// Client  ZAP
+// Product Tacking
+// File    ZT_Lib_Test/DJI_Command.cpp
+
+#include "Component.h"
+
+// ===== C ==================================================================
+#include <stdint.h>
+#include <string.h>
+
+// ===== ZT_Lib =============================================================
+#include "DJI_Command.h"
+#include "DJI_Transaction.h"
+
+// Static function declarations
+// //////////////////////////////////////////////////////////////////////////
+
+// Return true when the frame of the transaction is the one the generic
+// DJI_Frame::Seal gives. aExpected comes from DJI_Frame::Init.
+static bool Compare(DJI_Frame * aExpected, DJI_Transaction * aTr);
+
+// The reference, with the generic DJI_Frame::Init
+static void Expected_Init(DJI_Frame * aOut, uint8_t aDataSize_byte, uint8_t aCmdType, uint8_t aCmdId, const DJI_Transaction & aTr);
+
+// Tests
+// //////////////////////////////////////////////////////////////////////////
+
+KMS_TEST_BEGIN(DJI_Command_Base)
+{
+    ZT::IGimbal::Config lConfig;
+    DJI_Frame           lExpected;
+    DJI_Transaction     lTr;
+
+    memset(&lConfig, 0, sizeof(lConfig));
+
+    // ===== Constants ======================================================
+
+    const uint8_t lHeader[DJI_COMMAND_CONSTANT_byte] = { DJI_SOF, DJI_FRAME_TOTAL_SIZE(10), 0, DJI_CMD_TYPE_NO_REPLY, 0, 0, 0, 0 };
+
+    KMS_TEST_COMPARE(DJI_CRC_16_Continue(DJI_CRC_16_INIT, lHeader, sizeof(lHeader)), DJI_Command_POSITION_SET::CRC_16);
+    KMS_TEST_COMPARE(DJI_CRC_32_Continue(DJI_CRC_32_INIT, lHeader, sizeof(lHeader)), DJI_Command_POSITION_SET::CRC_32);
+
+    // ===== ANGLE_GET ======================================================
+
+    lTr.Frame_Init_ANGLE_GET();
+
+    Expected_Init(&lExpected, 3, DJI_CMD_TYPE_DO_REPLY, DJI_CMD_ANGLE_GET, lTr);
+    lExpected.mData[2] = 0x01;
+    KMS_TEST_ASSERT(Compare(&lExpected, &lTr));
+
+    // ===== ANGLE_LIMIT_SET ================================================
+
+    lConfig.mAxis[ZT::IGimbal::AXIS_PITCH].mMax_deg =  30.0;
+    lConfig.mAxis[ZT::IGimbal::AXIS_PITCH].mMin_deg = -40.0;
+    lConfig.mAxis[ZT::IGimbal::AXIS_ROLL ].mMax_deg =  10.0;
+    lConfig.mAxis[ZT::IGimbal::AXIS_ROLL ].mMin_deg =   5.0;
+    lConfig.mAxis[ZT::IGimbal::AXIS_YAW  ].mMax_deg = 170.0;
+    lConfig.mAxis[ZT::IGimbal::AXIS_YAW  ].mMin_deg = -90.0;
+
+    lTr.Frame_Init_ANGLE_LIMIT_SET(lConfig);
+
+    // The layout of the ANGLE_LIMIT_GET reply
+    Expected_Init(&lExpected, 9, DJI_CMD_TYPE_DO_REPLY, DJI_CMD_ANGLE_LIMIT_SET, lTr);
+    lExpected.mData[2] = 0x01;
+    lExpected.mData[3] =  30;
+    lExpected.mData[4] =  40;
+    lExpected.mData[5] = 170;
+    lExpected.mData[6] =  90;
+    lExpected.mData[7] =  10;
+    lExpected.mData[8] =   0;
+    KMS_TEST_ASSERT(Compare(&lExpected, &lTr));
+
+    // ===== FOCUS_SET ======================================================
+
+    lTr.Frame_Init_FOCUS_SET(50.0);
+
+    Expected_Init(&lExpected, 7, DJI_CMD_TYPE_NO_REPLY, DJI_CMD_FOCUS, lTr);
+    lExpected.mData[2] = DJI_CMD_FOCUS_SET;
+    lExpected.mData[4] = 0x02;
+    lExpected.mData[5] = 0xff; // 2047
+    lExpected.mData[6] = 0x07;
+    KMS_TEST_ASSERT(Compare(&lExpected, &lTr));
+
+    // ===== MOTOR_STIFFNESS_SET ============================================
+
+    lConfig.mAxis[ZT::IGimbal::AXIS_PITCH].mStiffness_pc = 10.0;
+    lConfig.mAxis[ZT::IGimbal::AXIS_ROLL ].mStiffness_pc = 20.0;
+    lConfig.mAxis[ZT::IGimbal::AXIS_YAW  ].mStiffness_pc = 30.0;
+
+    lTr.Frame_Init_MOTOR_STIFFNESS_SET(lConfig);
+
+    Expected_Init(&lExpected, 6, DJI_CMD_TYPE_DO_REPLY, DJI_CMD_MOTOR_STIFFNESS_SET, lTr);
+    lExpected.mData[2] = 0x01;
+    lExpected.mData[3] = 10;
+    lExpected.mData[4] = 20;
+    lExpected.mData[5] = 30;
+    KMS_TEST_ASSERT(Compare(&lExpected, &lTr));
+
+    // ===== POSITION_SET ===================================================
+
+    ZT::IGimbal::Position lPosition;
+
+    lPosition.mAxis_deg[ZT::IGimbal::AXIS_PITCH] = -12.3;
+    lPosition.mAxis_deg[ZT::IGimbal::AXIS_ROLL ] =   4.5;
+    lPosition.mAxis_deg[ZT::IGimbal::AXIS_YAW  ] = 170.0;
+
+    lTr.Frame_Init_POSITION_SET(lPosition, ZT_FLAG_IGNORE_ROLL, 2000);
+
+    Expected_Init(&lExpected, 10, DJI_CMD_TYPE_NO_REPLY, DJI_CMD_POSITION_SET, lTr);
+    lExpected.Angle_Set(6, -12.3);
+    lExpected.Angle_Set(2, 170.0);
+    lExpected.mData[8] = 0x05;
+    lExpected.mData[9] = 20;
+    KMS_TEST_ASSERT(Compare(&lExpected, &lTr));
+
+    // ===== SPEED_SET ======================================================
+
+    ZT::IGimbal::Speed lSpeed;
+
+    lSpeed.mAxis_deg_s[ZT::IGimbal::AXIS_PITCH] =   -5.5;
+    lSpeed.mAxis_deg_s[ZT::IGimbal::AXIS_ROLL ] =    0.0;
+    lSpeed.mAxis_deg_s[ZT::IGimbal::AXIS_YAW  ] = -180.0;
+
+    lTr.Frame_Init_SPEED_SET(lSpeed);
+
+    Expected_Init(&lExpected, 9, DJI_CMD_TYPE_NO_REPLY, DJI_CMD_SPEED_SET, lTr);
+    lExpected.Speed_Set(6,   -5.5);
+    lExpected.Speed_Set(2, -180.0);
+    lExpected.mData[8] = 0x88;
+    KMS_TEST_ASSERT(Compare(&lExpected, &lTr));
+
+    // ===== TRACK_SWITCH and VERSION =======================================
+
+    lTr.Frame_Init_TRACK_SWITCH();
+
+    Expected_Init(&lExpected, 3, DJI_CMD_TYPE_NO_REPLY, DJI_CMD_TRACK_SWITCH, lTr);
+    lExpected.mData[2] = 0x03;
+    KMS_TEST_ASSERT(Compare(&lExpected, &lTr));
+
+    lTr.Frame_Init_VERSION();
+
+    Expected_Init(&lExpected, 6, DJI_CMD_TYPE_DO_REPLY, DJI_CMD_VERSION, lTr);
+    lExpected.mData[2] = 0x01;
+    KMS_TEST_ASSERT(Compare(&lExpected, &lTr));
+}
+KMS_TEST_END
+
+// Static functions
+// //////////////////////////////////////////////////////////////////////////
+
+bool Compare(DJI_Frame * aExpected, DJI_Transaction * aTr)
+{
+    assert(NULL != aExpected);
+    assert(NULL != aTr);
+
+    const DJI_Frame * lFrame = aTr->Frame_Get();
+
+    aExpected->Seal();
+
+    if (aExpected->mSize_byte != lFrame->mSize_byte)
+    {
+        return false;
+    }
+
+    return 0 == memcmp(&aExpected->mSOF, &lFrame->mSOF, lFrame->mSize_byte);
+}
+
+void Expected_Init(DJI_Frame * aOut, uint8_t aDataSize_byte, uint8_t aCmdType, uint8_t aCmdId, const DJI_Transaction & aTr)
+{
+    assert(NULL != aOut);
+
+    aOut->Init(aDataSize_byte, aCmdType, DJI_CMD_SET_DEFAULT, aCmdId, aTr.Serial_Get());
+}
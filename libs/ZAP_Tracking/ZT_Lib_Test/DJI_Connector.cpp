@@ -0,0 +1,179 @@
+
+// Author  KMS - Martin Dubois, P. Eng.
+// Client  ZAP
+// Product Tacking
+// File    ZT_Lib_Test/DJI_Connector.cpp
+
+#include "Component.h"
+
+// ===== C ==================================================================
+#include <stdint.h>
+#include <stdio.h>
+#include <time.h>
+#include <unistd.h>
+
+// ===== ZT_Lib =============================================================
+#include "DJI_Connector.h"
+#include "DJI_Gimbal.h"
+#include "Sim_Device.h"
+
+// Constants
+// //////////////////////////////////////////////////////////////////////////
+
+// Connect does 3 synchronous calls, 300 ms per gimbal
+#define CALL_us (100000)
+
+#define GIMBAL_QTY (8)
+
+// Static function declarations
+// //////////////////////////////////////////////////////////////////////////
+
+// aConnector [---;RW-]
+// aCall_us   The gimbal i waits aCall_us * (i + 1) when aStep is true
+static void Gimbals_Add(DJI_Connector * aConnector, unsigned int aCall_us, bool aStep);
+
+static uint32_t IPv4_Get(unsigned int aIndex);
+
+static void List_Release(IDetector::GimbalList * aList);
+
+static uint64_t Time_Get_ms();
+
+// Tests
+// //////////////////////////////////////////////////////////////////////////
+
+KMS_TEST_BEGIN(DJI_Connector_Base)
+{
+    DJI_Connector         * lC;
+    uint64_t                lDuration_ms;
+    IDetector::GimbalList   lList;
+    unsigned int            i;
+
+    // ===== 8 gimbals, the duration of one Connect =========================
+
+    lC = new DJI_Connector();
+
+    Gimbals_Add(lC, CALL_us, false);
+
+    lDuration_ms = Time_Get_ms();
+
+    KMS_TEST_COMPARE(GIMBAL_QTY, lC->Run(&lList));
+
+    lDuration_ms = Time_Get_ms() - lDuration_ms;
+
+    lC->Release();
+
+    printf("    %u gimbals connected in %u ms, %u ms each\n", GIMBAL_QTY, static_cast<unsigned int>(lDuration_ms), 3 * CALL_us / 1000);
+
+    KMS_TEST_ASSERT(GIMBAL_QTY * 3 * CALL_us / 1000 / 2 > lDuration_ms);
+
+    // ===== The order of Add ===============================================
+
+    KMS_TEST_COMPARE(GIMBAL_QTY, lList.size());
+
+    i = 0;
+
+    for (IDetector::GimbalList::iterator lIt = lList.begin(); lIt != lList.end(); lIt ++)
+    {
+        ZT::IGimbal::Info lInfo;
+
+        (*lIt)->Info_Get(&lInfo);
+
+        KMS_TEST_COMPARE(IPv4_Get(i), lInfo.mIPv4_Address);
+
+        i ++;
+    }
+
+    List_Release(&lList);
+
+    // ===== Timeout ========================================================
+    // The gimbal i needs 50 ms * (i + 1) * 3, the gimbals 0 to 2 connect
+    // before the timeout.
+
+    lC = new DJI_Connector(500);
+
+    Gimbals_Add(lC, 50000, true);
+
+    lDuration_ms = Time_Get_ms();
+
+    KMS_TEST_COMPARE(3, lC->Run(&lList));
+
+    lDuration_ms = Time_Get_ms() - lDuration_ms;
+
+    // The threads still connecting keep a reference
+    lC->Release();
+
+    KMS_TEST_ASSERT(500 <= lDuration_ms);
+    KMS_TEST_ASSERT(700 >  lDuration_ms);
+
+    i = 0;
+
+    for (IDetector::GimbalList::iterator lIt = lList.begin(); lIt != lList.end(); lIt ++)
+    {
+        ZT::IGimbal::Info lInfo;
+
+        (*lIt)->Info_Get(&lInfo);
+
+        KMS_TEST_COMPARE(IPv4_Get(i), lInfo.mIPv4_Address);
+
+        i ++;
+    }
+
+    List_Release(&lList);
+
+    // The abandoned threads delete their gimbal and the connector, the
+    // last one after 1.2 s.
+    usleep(1500000);
+
+    // ===== Release without Run ============================================
+
+    lC = new DJI_Connector();
+
+    Gimbals_Add(lC, 0, false);
+
+    lC->Release();
+}
+KMS_TEST_END
+
+// Static functions
+// //////////////////////////////////////////////////////////////////////////
+
+void Gimbals_Add(DJI_Connector * aConnector, unsigned int aCall_us, bool aStep)
+{
+    assert(NULL != aConnector);
+
+    for (unsigned int i = 0; i < GIMBAL_QTY; i ++)
+    {
+        Sim_Device::Config lConfig = Sim_Device::CONFIG_DEFAULT;
+
+        lConfig.mCall_us      = aStep ? (aCall_us * (i + 1)) : aCall_us;
+        lConfig.mIPv4_Address = IPv4_Get(i);
+
+        aConnector->Add(new DJI_Gimbal(new Sim_Device(lConfig)));
+    }
+}
+
+uint32_t IPv4_Get(unsigned int aIndex)
+{
+    return 127 | (2 << 8) | ((aIndex + 1) << 24);
+}
+
+void List_Release(IDetector::GimbalList * aList)
+{
+    assert(NULL != aList);
+
+    for (IDetector::GimbalList::iterator lIt = aList->begin(); lIt != aList->end(); lIt ++)
+    {
+        delete *lIt;
+    }
+
+    aList->clear();
+}
+
+uint64_t Time_Get_ms()
+{
+    timespec lNow;
+
+    clock_gettime(CLOCK_MONOTONIC, &lNow);
+
+    return static_cast<uint64_t>(lNow.tv_sec) * 1000 + lNow.tv_nsec / 1000000;
+}
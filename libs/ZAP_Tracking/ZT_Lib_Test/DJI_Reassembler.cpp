@@ -0,0 +1,248 @@
+
+// Author  KMS - Martin Dubois, P.Eng.
+// Client  ZAP
+// Product Tacking
+// File    ZT_Lib_Test/DJI_Reassembler.cpp
+
+#include "Component.h"
+
+// ===== C ==================================================================
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+// ===== ZT_Lib =============================================================
+#include "DJI_Reassembler.h"
+
+// Constants
+// //////////////////////////////////////////////////////////////////////////
+
+#define FRAME_QTY (50000)
+
+#define GARBAGE_MAX_byte (8)
+
+// Static function declarations
+// //////////////////////////////////////////////////////////////////////////
+
+static void Frame_Random(DJI_Frame * aOut, uint16_t aSerial);
+
+// aCorrupt     Corrupt one byte of one frame every aCorrupt frames, 0 to
+//              never corrupt
+// aRx_frame    [---;-W-] The number of valid frames received
+// aDuration_ns [---;-W-] The time spent in Push and Next
+//
+// Return false when the frames do not come out in order
+static bool Stream(DJI_Reassembler * aR, unsigned int aCorrupt, unsigned int * aRx_frame, uint64_t * aDuration_ns);
+
+// Tests
+// //////////////////////////////////////////////////////////////////////////
+
+KMS_TEST_BEGIN(DJI_Reassembler_Base)
+{
+    uint64_t     lDuration_ns;
+    unsigned int lRx_frame;
+
+    srand(1);
+
+    // ===== CAN fragments and garbage between frames =======================
+    {
+        Stats           lStats;
+        DJI_Reassembler lR0(&lStats);
+
+        KMS_TEST_ASSERT(Stream(&lR0, 0, &lRx_frame, &lDuration_ns));
+        KMS_TEST_COMPARE(FRAME_QTY, lRx_frame);
+        KMS_TEST_COMPARE(FRAME_QTY, lStats.mRx_frame);
+        KMS_TEST_COMPARE(0, lStats.mRx_Overflow);
+
+        printf("    %u frames, %u bytes, %u SOF skipped, %u CRC-16 errors\n", lStats.mRx_frame.load(), lStats.mRx_byte.load(), lStats.mRx_SOF.load(), lStats.mRx_CRC16.load());
+        printf("    %.1f ns/byte, %.1f MB/s\n", static_cast<double>(lDuration_ns) / lStats.mRx_byte, static_cast<double>(lStats.mRx_byte) * 1000.0 / lDuration_ns);
+    }
+
+    // ===== Corrupted frames ===============================================
+    {
+        Stats           lStats;
+        DJI_Reassembler lR1(&lStats);
+
+        KMS_TEST_ASSERT(Stream(&lR1, 7, &lRx_frame, &lDuration_ns));
+
+        // Only the corrupted frames are lost. When the corrupted byte is in
+        // the short fragment at the end of a frame, the fragment following
+        // it can complete the frame and pass the CRC-32 by chance, 1 in 256.
+        KMS_TEST_ASSERT(FRAME_QTY - (FRAME_QTY + 6) / 7      <= lRx_frame);
+        KMS_TEST_ASSERT(FRAME_QTY - (FRAME_QTY + 6) / 7 + 10 >= lRx_frame);
+        KMS_TEST_ASSERT(0 < lStats.mRx_CRC16 + lStats.mRx_CRC32);
+    }
+
+    // ===== Short fragment received before the preceding one ===============
+    {
+        DJI_Frame       lFrame;
+        Stats           lStats;
+        DJI_Reassembler lR2(&lStats);
+
+        // 19 bytes, sent as [8][4][7]
+        lFrame.Init(3, DJI_CMD_TYPE_REPLY, DJI_CMD_SET_DEFAULT, DJI_CMD_ANGLE_GET, 7);
+        lFrame.mData[DJI_REPLY_RESULT] = DJI_OK;
+        lFrame.Seal();
+
+        const uint8_t * lBytes = reinterpret_cast<const uint8_t *>(&lFrame);
+
+        KMS_TEST_COMPARE(19, lFrame.mSize_byte);
+
+        lR2.Push(lBytes, 8);
+        KMS_TEST_ASSERT(NULL == lR2.Next());
+
+        lR2.Push(lBytes + 12, 7);
+        KMS_TEST_ASSERT(NULL == lR2.Next());
+
+        lR2.Push(lBytes + 8, 4);
+
+        const DJI_Frame * lRx = lR2.Next();
+        KMS_TEST_ASSERT_RETURN(NULL != lRx);
+        KMS_TEST_COMPARE(7, lRx->mSerial);
+        KMS_TEST_COMPARE(0, lR2.Size_Get());
+        KMS_TEST_COMPARE(1, lStats.mRx_Unordered);
+
+        // The short fragment of a lost frame does not stay in the buffer,
+        // the next frame is sent as [8][8][3].
+        lR2.Push(lBytes + 12, 7);
+
+        lR2.Push(lBytes     , 8);
+        lR2.Push(lBytes +  8, 8);
+        lR2.Push(lBytes + 16, 3);
+
+        lRx = lR2.Next();
+        KMS_TEST_ASSERT_RETURN(NULL != lRx);
+        KMS_TEST_COMPARE(0, lR2.Size_Get());
+    }
+}
+KMS_TEST_END
+
+// Static functions
+// //////////////////////////////////////////////////////////////////////////
+
+void Frame_Random(DJI_Frame * aOut, uint16_t aSerial)
+{
+    assert(NULL != aOut);
+
+    unsigned int lData_byte = 2 + rand() % 11;
+
+    aOut->Init(lData_byte, DJI_CMD_TYPE_REPLY, DJI_CMD_SET_DEFAULT, rand() & 0xff, aSerial);
+
+    for (unsigned int i = DJI_REPLY_RESULT; i < lData_byte; i++)
+    {
+        aOut->mData[i] = rand() & 0xff;
+    }
+
+    aOut->Seal();
+}
+
+bool Stream(DJI_Reassembler * aR, unsigned int aCorrupt, unsigned int * aRx_frame, uint64_t * aDuration_ns)
+{
+    assert(NULL != aR);
+    assert(NULL != aRx_frame);
+    assert(NULL != aDuration_ns);
+
+    // ===== Build the stream ===============================================
+
+    uint8_t * lStream = new uint8_t[FRAME_QTY * (GARBAGE_MAX_byte + sizeof(DJI_Frame))];
+    unsigned int * lEnds = new unsigned int[FRAME_QTY];
+    unsigned int lSize_byte = 0;
+
+    for (unsigned int i = 0; i < FRAME_QTY; i++)
+    {
+        // Garbage before the frame, SOF included
+        unsigned int lGarbage_byte = rand() % (GARBAGE_MAX_byte + 1);
+
+        for (unsigned int j = 0; j < lGarbage_byte; j++)
+        {
+            lStream[lSize_byte] = rand() & 0xff;
+            lSize_byte ++;
+        }
+
+        DJI_Frame lFrame;
+
+        Frame_Random(&lFrame, i);
+
+        memcpy(lStream + lSize_byte, &lFrame, lFrame.mSize_byte);
+
+        if ((0 != aCorrupt) && (0 == (i % aCorrupt)))
+        {
+            lStream[lSize_byte + 1 + rand() % (lFrame.mSize_byte - 1)] ^= 1 << (rand() % 8);
+        }
+
+        lSize_byte += lFrame.mSize_byte;
+
+        lEnds[i] = lSize_byte;
+    }
+
+    // ===== Feed it in CAN fragments =======================================
+
+    // The garbage and the frame following it go in 8 bytes fragments, the
+    // last one is shorter.
+
+    uint16_t   * lSerials  = new uint16_t[FRAME_QTY];
+    unsigned int lRx_frame = 0;
+
+    timespec lT0;
+    timespec lT1;
+
+    clock_gettime(CLOCK_MONOTONIC, &lT0);
+
+    unsigned int lEnd = 0;
+
+    for (unsigned int lOffset_byte = 0; lOffset_byte < lSize_byte;)
+    {
+        if (lEnds[lEnd] <= lOffset_byte)
+        {
+            lEnd ++;
+        }
+
+        unsigned int lFragment_byte = DJI_REASSEMBLER_FRAGMENT_byte;
+        if (lEnds[lEnd] - lOffset_byte < lFragment_byte)
+        {
+            lFragment_byte = lEnds[lEnd] - lOffset_byte;
+        }
+
+        aR->Push(lStream + lOffset_byte, lFragment_byte);
+
+        for (;;)
+        {
+            const DJI_Frame * lRx = aR->Next();
+            if (NULL == lRx)
+            {
+                break;
+            }
+
+            assert(FRAME_QTY > lRx_frame);
+
+            lSerials[lRx_frame] = lRx->mSerial;
+            lRx_frame ++;
+        }
+
+        lOffset_byte += lFragment_byte;
+    }
+
+    clock_gettime(CLOCK_MONOTONIC, &lT1);
+
+    delete [] lEnds;
+    delete [] lStream;
+
+    *aDuration_ns = (lT1.tv_sec - lT0.tv_sec) * 1000000000LL + (lT1.tv_nsec - lT0.tv_nsec);
+    *aRx_frame    = lRx_frame;
+
+    // The frames come out in order and none is received twice
+    bool lResult = true;
+
+    for (unsigned int i = 1; i < lRx_frame; i++)
+    {
+        if (lSerials[i - 1] >= lSerials[i])
+        {
+            lResult = false;
+        }
+    }
+
+    delete [] lSerials;
+
+    return lResult;
+}
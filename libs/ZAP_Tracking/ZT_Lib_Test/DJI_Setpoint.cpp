@@ -0,0 +1,142 @@
+
+// Author  KMS - Martin Dubois, P.Eng.
+// Client  ZAP
+// Product Tacking
+// File    ZT_Lib_Test/DJI_Setpoint.cpp
+
+#include "Component.h"
+
+// ===== C ==================================================================
+#include <assert.h>
+#include <pthread.h>
+#include <stdint.h>
+#include <stdio.h>
+
+// ===== ZT_Lib =============================================================
+#include "DJI_Setpoint.h"
+
+// Constants
+// //////////////////////////////////////////////////////////////////////////
+
+#define PUBLISH_QTY (100000)
+
+// Static function declarations
+// //////////////////////////////////////////////////////////////////////////
+
+static void * Writer(void * aSetpoint);
+
+// Tests
+// //////////////////////////////////////////////////////////////////////////
+
+KMS_TEST_BEGIN(DJI_Setpoint_Base)
+{
+    DJI_Setpoint        lS0;
+    DJI_Setpoint::Value lV0;
+    DJI_Setpoint::Value lV1;
+
+    KMS_TEST_ASSERT(!lS0.Read(&lV1));
+
+    // ===== Latest wins ====================================================
+
+    memset(&lV0, 0, sizeof(lV0));
+
+    lV0.mKind = DJI_Setpoint::KIND_SPEED;
+
+    for (unsigned int i = 1; i <= 3; i++)
+    {
+        lV0.mSpeed.mAxis_deg_s[0] = i;
+
+        lS0.Publish(lV0);
+    }
+
+    KMS_TEST_ASSERT(lS0.Read(&lV1));
+    KMS_TEST_ASSERT(DJI_Setpoint::KIND_SPEED == lV1.mKind);
+    KMS_TEST_ASSERT(3.0 == lV1.mSpeed.mAxis_deg_s[0]);
+
+    KMS_TEST_ASSERT(!lS0.Read(&lV1));
+
+    // ===== Position then speed ============================================
+
+    lV0.mKind = DJI_Setpoint::KIND_POSITION;
+    lV0.mPosition.mAxis_deg[0] = 10.0;
+    lS0.Publish(lV0);
+
+    lV0.mKind = DJI_Setpoint::KIND_SPEED;
+    lV0.mSpeed.mAxis_deg_s[0] = 4.0;
+    lS0.Publish(lV0);
+
+    KMS_TEST_ASSERT(lS0.Read(&lV1));
+    KMS_TEST_ASSERT(DJI_Setpoint::KIND_POSITION == lV1.mKind);
+    KMS_TEST_ASSERT(10.0 == lV1.mPosition.mAxis_deg[0]);
+
+    KMS_TEST_ASSERT(lS0.Read(&lV1));
+    KMS_TEST_ASSERT(DJI_Setpoint::KIND_SPEED == lV1.mKind);
+    KMS_TEST_ASSERT(4.0 == lV1.mSpeed.mAxis_deg_s[0]);
+
+    KMS_TEST_ASSERT(!lS0.Read(&lV1));
+
+    // ===== Stop ===========================================================
+
+    lS0.Publish(lV0);
+
+    lV0.mKind = DJI_Setpoint::KIND_NONE;
+    lS0.Publish(lV0);
+
+    KMS_TEST_ASSERT(lS0.Read(&lV1));
+    KMS_TEST_ASSERT(DJI_Setpoint::KIND_NONE == lV1.mKind);
+
+    KMS_TEST_ASSERT(!lS0.Read(&lV1));
+
+    // ===== Concurrent writer ==============================================
+
+    pthread_t lThread;
+
+    KMS_TEST_COMPARE_RETURN(0, pthread_create(&lThread, NULL, Writer, &lS0));
+
+    unsigned int lTorn = 0;
+
+    do
+    {
+        if (lS0.Read(&lV1))
+        {
+            // The writer sets all the axes to the same value. A torn read
+            // would mix two values.
+            if ((lV1.mSpeed.mAxis_deg_s[0] != lV1.mSpeed.mAxis_deg_s[1]) || (lV1.mSpeed.mAxis_deg_s[0] != lV1.mSpeed.mAxis_deg_s[2]))
+            {
+                lTorn ++;
+            }
+        }
+    }
+    while (PUBLISH_QTY > lV1.mSpeed.mAxis_deg_s[0]);
+
+    KMS_TEST_COMPARE(0, pthread_join(lThread, NULL));
+    KMS_TEST_COMPARE(0, lTorn);
+}
+KMS_TEST_END
+
+// Static functions
+// //////////////////////////////////////////////////////////////////////////
+
+void * Writer(void * aSetpoint)
+{
+    assert(NULL != aSetpoint);
+
+    DJI_Setpoint * lSetpoint = reinterpret_cast<DJI_Setpoint *>(aSetpoint);
+
+    DJI_Setpoint::Value lValue;
+
+    memset(&lValue, 0, sizeof(lValue));
+
+    lValue.mKind = DJI_Setpoint::KIND_SPEED;
+
+    for (unsigned int i = 1; i <= PUBLISH_QTY; i++)
+    {
+        lValue.mSpeed.mAxis_deg_s[0] = i;
+        lValue.mSpeed.mAxis_deg_s[1] = i;
+        lValue.mSpeed.mAxis_deg_s[2] = i;
+
+        lSetpoint->Publish(lValue);
+    }
+
+    return NULL;
+}
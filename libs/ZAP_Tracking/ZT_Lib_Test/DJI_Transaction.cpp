@@ -0,0 +1,159 @@
+
+// Author  KMS - Martin Dubois, P.Eng.
+// Client  ZAP
+// Product Tacking
+// File    ZT_Lib_Test/DJI_Transaction.cpp
+
+#include "Component.h"
+
+// ===== C ==================================================================
+#include <assert.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+// ===== C++ ================================================================
+#include <atomic>
+#include <new>
+
+// ===== ZT_Lib =============================================================
+#include "DJI_Gimbal.h"
+#include "DJI_TransactionPool.h"
+#include "DJI_TransactionQueue.h"
+#include "Sim_Device.h"
+
+// Constants
+// //////////////////////////////////////////////////////////////////////////
+
+#define COMMAND_QTY (100)
+
+// Static variables
+// //////////////////////////////////////////////////////////////////////////
+
+// All the threads count their allocations, the worker and the receiver of
+// the gimbal included.
+static std::atomic<unsigned int> sAllocCount(0);
+
+// Static function declarations
+// //////////////////////////////////////////////////////////////////////////
+
+static void * Allocate(size_t aSize_byte);
+
+// Tests
+// //////////////////////////////////////////////////////////////////////////
+
+KMS_TEST_BEGIN(DJI_Transaction_Base)
+{
+    DJI_TransactionPool  lPool;
+    DJI_TransactionQueue lQueue;
+
+    DJI_Transaction * lTrs[DJI_TRANSACTION_POOL_SIZE];
+    unsigned int      i;
+
+    // ===== Exhaust the pool ===============================================
+
+    for (i = 0; i < DJI_TRANSACTION_POOL_SIZE; i++)
+    {
+        lTrs[i] = lPool.Alloc();
+        KMS_TEST_ASSERT_RETURN(NULL != lTrs[i]);
+        KMS_TEST_ASSERT(lPool.IsOwner(lTrs[i]));
+    }
+
+    KMS_TEST_ASSERT(NULL == lPool.Alloc());
+
+    for (i = 0; i < DJI_TRANSACTION_POOL_SIZE; i++)
+    {
+        lPool.Free(lTrs[i]);
+    }
+
+    // ===== Steady state ===================================================
+
+    ZT::IGimbal::Speed lSpeed;
+
+    memset(&lSpeed, 0, sizeof(lSpeed));
+
+    unsigned int lBefore = sAllocCount;
+
+    for (i = 0; i < 10000; i++)
+    {
+        DJI_Transaction * lTr = lPool.Alloc();
+        KMS_TEST_ASSERT_RETURN(NULL != lTr);
+
+        lTr->Frame_Init_SPEED_SET(lSpeed);
+
+        KMS_TEST_ASSERT(lQueue.Push(lTr, DJI_TransactionQueue::PRIORITY_STOP));
+        KMS_TEST_ASSERT(lTr == lQueue.Pop());
+
+        lPool.Free(lTr);
+    }
+
+    KMS_TEST_COMPARE(lBefore, sAllocCount);
+    KMS_TEST_ASSERT(lQueue.IsEmpty());
+
+    // ===== Commands of an activated gimbal ================================
+    {
+        Sim_Device * lSD = new Sim_Device(Sim_Device::CONFIG_DEFAULT);
+        DJI_Gimbal * lG  = new DJI_Gimbal(lSD);
+
+        KMS_TEST_COMPARE(ZT::ZT_OK, lG->Connect());
+        KMS_TEST_COMPARE(ZT::ZT_OK, lG->Activate());
+
+        ZT::IGimbal::Position lPos;
+
+        lPos.mAxis_deg[ZT::IGimbal::AXIS_PITCH] = 0.0;
+        lPos.mAxis_deg[ZT::IGimbal::AXIS_ROLL ] = 0.0;
+
+        lSpeed.mAxis_deg_s[ZT::IGimbal::AXIS_YAW] = 10.0;
+
+        lBefore = sAllocCount;
+
+        for (i = 0; i < COMMAND_QTY; i++)
+        {
+            lPos.mAxis_deg[ZT::IGimbal::AXIS_YAW] = (0 == (i & 1)) ? 10.0 : -10.0;
+
+            KMS_TEST_COMPARE(ZT::ZT_OK, lG->Speed_Set(lSpeed, 0));
+            KMS_TEST_COMPARE(ZT::ZT_OK, lG->Position_Set(lPos, 0, 100));
+            KMS_TEST_COMPARE(ZT::ZT_OK, lG->Speed_Stop());
+
+            // The worker sends the stop before the next one
+            usleep(1000);
+        }
+
+        KMS_TEST_COMPARE(lBefore, sAllocCount);
+
+        delete lG;
+    }
+}
+KMS_TEST_END
+
+// Static functions
+// //////////////////////////////////////////////////////////////////////////
+
+void * Allocate(size_t aSize_byte)
+{
+    sAllocCount ++;
+
+    void * lResult = malloc((0 < aSize_byte) ? aSize_byte : 1);
+    if (NULL == lResult)
+    {
+        throw std::bad_alloc();
+    }
+
+    return lResult;
+}
+
+// Operators
+// //////////////////////////////////////////////////////////////////////////
+
+void * operator new  (size_t aSize_byte) { return Allocate(aSize_byte); }
+void * operator new[](size_t aSize_byte) { return Allocate(aSize_byte); }
+
+void * operator new  (size_t aSize_byte, const std::nothrow_t &) noexcept { sAllocCount ++; return malloc((0 < aSize_byte) ? aSize_byte : 1); }
+void * operator new[](size_t aSize_byte, const std::nothrow_t &) noexcept { sAllocCount ++; return malloc((0 < aSize_byte) ? aSize_byte : 1); }
+
+void operator delete  (void * aPtr) noexcept { free(aPtr); }
+void operator delete[](void * aPtr) noexcept { free(aPtr); }
+
+void operator delete  (void * aPtr, size_t) noexcept { free(aPtr); }
+void operator delete[](void * aPtr, size_t) noexcept { free(aPtr); }
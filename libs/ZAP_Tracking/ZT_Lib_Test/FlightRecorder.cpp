@@ -0,0 +1,235 @@
+
+// Author  KMS - Martin Dubois, P.Eng.
+// Client  ZAP
+// Product Tacking
+// File    ZT_Lib_Test/FlightRecorder.cpp
+
+#include "Component.h"
+
+// ===== C ==================================================================
+#include <pthread.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+// ===== ZT_Lib =============================================================
+#include "FlightRecorder.h"
+
+// Constants
+// //////////////////////////////////////////////////////////////////////////
+
+#define FILE_NAME   "/tmp/ZT_Lib_Test_FlightRecorder.bin"
+#define LINK_TARGET "/tmp/ZT_Lib_Test_FlightRecorder.target"
+
+#define RECORD_QTY (100000)
+
+#define THREAD_QTY (4)
+
+// Static function declarations
+// //////////////////////////////////////////////////////////////////////////
+
+// aHeader  [---;-W-]
+// aRecords [---;-W-] The caller deletes the array
+//
+// Return false when the file cannot be read
+static bool File_Read(FlightRecorder_Header * aHeader, FlightRecorder_Record ** aRecords);
+
+static uint64_t Time_Get_ns();
+
+// ===== Entry point ========================================================
+
+static void * Writer(void * aRecorder);
+
+// Tests
+// //////////////////////////////////////////////////////////////////////////
+
+KMS_TEST_BEGIN(FlightRecorder_Base)
+{
+    FlightRecorder_Header   lHeader;
+    FlightRecorder_Record * lRecords;
+
+    // ===== Empty ==========================================================
+    {
+        FlightRecorder lFR0;
+
+        unlink(FILE_NAME);
+
+        KMS_TEST_COMPARE(ZT::ZT_OK, lFR0.Dump(FILE_NAME));
+        KMS_TEST_ASSERT(File_Read(&lHeader, &lRecords));
+        KMS_TEST_COMPARE(FLIGHT_RECORDER_MAGIC  , lHeader.mMagic);
+        KMS_TEST_COMPARE(FLIGHT_RECORDER_VERSION, lHeader.mVersion);
+        KMS_TEST_COMPARE(0                      , lHeader.mRecord_Count);
+        KMS_TEST_COMPARE(32                     , lHeader.mRecord_Size_byte);
+
+        delete [] lRecords;
+    }
+
+    // ===== Only the last records stay, in order ===========================
+    {
+        FlightRecorder * lFR1 = new FlightRecorder();
+
+        uint64_t lBegin_ns = Time_Get_ns();
+
+        for (unsigned int i = 0; i < RECORD_QTY; i++)
+        {
+            uint8_t lData[8] = { 0, 1, 2, 3, 4, 5, 6, static_cast<uint8_t>(i) };
+
+            lFR1->Record(FLIGHT_RECORDER_CAN_TX, 0x223, 0, i, lData, sizeof(lData));
+        }
+
+        printf("    %.1f ns/record\n", static_cast<double>(Time_Get_ns() - lBegin_ns) / RECORD_QTY);
+
+        lFR1->Record(FLIGHT_RECORDER_STATE, __LINE__);
+
+        unlink(FILE_NAME);
+
+        KMS_TEST_COMPARE(ZT::ZT_OK, lFR1->Dump(FILE_NAME));
+        KMS_TEST_ASSERT(File_Read(&lHeader, &lRecords));
+        KMS_TEST_COMPARE(FLIGHT_RECORDER_SIZE, lHeader.mRecord_Count);
+
+        for (unsigned int i = 0; i < FLIGHT_RECORDER_SIZE - 1; i++)
+        {
+            uint32_t lValue = RECORD_QTY - FLIGHT_RECORDER_SIZE + 1 + i;
+
+            KMS_TEST_COMPARE(FLIGHT_RECORDER_CAN_TX, lRecords[i].mType);
+            KMS_TEST_COMPARE(lValue                , lRecords[i].mIndex);
+            KMS_TEST_COMPARE(lValue                , lRecords[i].mValue);
+            KMS_TEST_COMPARE(8                     , lRecords[i].mDataSize_byte);
+            KMS_TEST_COMPARE(lValue & 0xff         , lRecords[i].mData[7]);
+            KMS_TEST_ASSERT(lRecords[i].mTime_ns <= lRecords[i + 1].mTime_ns);
+        }
+
+        KMS_TEST_COMPARE(FLIGHT_RECORDER_STATE, lRecords[FLIGHT_RECORDER_SIZE - 1].mType);
+        KMS_TEST_COMPARE(0                    , lRecords[FLIGHT_RECORDER_SIZE - 1].mDataSize_byte);
+
+        delete [] lRecords;
+        delete lFR1;
+    }
+
+    // ===== Writers and dump at the same time ==============================
+    {
+        FlightRecorder * lFR2 = new FlightRecorder();
+
+        pthread_t lThreads[THREAD_QTY];
+
+        for (unsigned int i = 0; i < THREAD_QTY; i++)
+        {
+            int lRet = pthread_create(lThreads + i, NULL, Writer, lFR2);
+            assert(0 == lRet);
+        }
+
+        unlink(FILE_NAME);
+
+        KMS_TEST_COMPARE(ZT::ZT_OK, lFR2->Dump(FILE_NAME));
+
+        for (unsigned int i = 0; i < THREAD_QTY; i++)
+        {
+            int lRet = pthread_join(lThreads[i], NULL);
+            assert(0 == lRet);
+        }
+
+        // The dump contains only complete records, in order
+        KMS_TEST_ASSERT(File_Read(&lHeader, &lRecords));
+        KMS_TEST_ASSERT(FLIGHT_RECORDER_SIZE >= lHeader.mRecord_Count);
+
+        for (unsigned int i = 0; i < lHeader.mRecord_Count; i++)
+        {
+            KMS_TEST_COMPARE(FLIGHT_RECORDER_CAN_RX, lRecords[i].mType);
+            KMS_TEST_COMPARE(lRecords[i].mValue    , lRecords[i].mData[0]);
+
+            if (0 < i)
+            {
+                KMS_TEST_ASSERT(lRecords[i - 1].mIndex < lRecords[i].mIndex);
+            }
+        }
+
+        delete [] lRecords;
+        delete lFR2;
+    }
+
+    KMS_TEST_COMPARE(ZT::ZT_ERROR_FILE_OPEN, FlightRecorder().Dump("/NotADirectory/FlightRecorder.bin"));
+
+    // ===== Never replace a file nor follow a link =========================
+    {
+        KMS_TEST_COMPARE(ZT::ZT_ERROR_FILE_OPEN, FlightRecorder().Dump(FILE_NAME));
+
+        KMS_TEST_COMPARE(0, unlink(FILE_NAME));
+        KMS_TEST_COMPARE(0, symlink(LINK_TARGET, FILE_NAME));
+
+        KMS_TEST_COMPARE(ZT::ZT_ERROR_FILE_OPEN, FlightRecorder().Dump(FILE_NAME));
+        KMS_TEST_COMPARE(-1, access(LINK_TARGET, F_OK));
+
+        KMS_TEST_COMPARE(0, unlink(FILE_NAME));
+    }
+
+    // ===== Unique name ====================================================
+    {
+        char lName0[] = "/tmp/ZT_Lib_Test_FlightRecorder_XXXXXX";
+        char lName1[] = "/tmp/ZT_Lib_Test_FlightRecorder_XXXXXX";
+
+        KMS_TEST_COMPARE(ZT::ZT_OK, FlightRecorder().Dump_Temp(lName0));
+        KMS_TEST_COMPARE(ZT::ZT_OK, FlightRecorder().Dump_Temp(lName1));
+        KMS_TEST_ASSERT(0 != strcmp(lName0, lName1));
+
+        KMS_TEST_COMPARE(0, unlink(lName0));
+        KMS_TEST_COMPARE(0, unlink(lName1));
+    }
+}
+KMS_TEST_END
+
+// Static functions
+// //////////////////////////////////////////////////////////////////////////
+
+bool File_Read(FlightRecorder_Header * aHeader, FlightRecorder_Record ** aRecords)
+{
+    assert(NULL != aHeader);
+    assert(NULL != aRecords);
+
+    bool lResult = false;
+
+    FILE * lFile = fopen(FILE_NAME, "rb");
+    if (NULL != lFile)
+    {
+        if (1 == fread(aHeader, sizeof(FlightRecorder_Header), 1, lFile))
+        {
+            *aRecords = new FlightRecorder_Record[aHeader->mRecord_Count + 1];
+
+            lResult = (aHeader->mRecord_Count == fread(*aRecords, sizeof(FlightRecorder_Record), aHeader->mRecord_Count, lFile));
+        }
+
+        int lRet = fclose(lFile);
+        assert(0 == lRet);
+    }
+
+    return lResult;
+}
+
+uint64_t Time_Get_ns()
+{
+    timespec lNow;
+
+    clock_gettime(CLOCK_MONOTONIC, &lNow);
+
+    return static_cast<uint64_t>(lNow.tv_sec) * 1000000000 + lNow.tv_nsec;
+}
+
+// ===== Entry point ========================================================
+
+void * Writer(void * aRecorder)
+{
+    assert(NULL != aRecorder);
+
+    FlightRecorder * lFR = reinterpret_cast<FlightRecorder *>(aRecorder);
+
+    for (unsigned int i = 0; i < RECORD_QTY; i++)
+    {
+        uint8_t lData = i;
+
+        lFR->Record(FLIGHT_RECORDER_CAN_RX, 0x530, 0, lData, &lData, sizeof(lData));
+    }
+
+    return NULL;
+}
@@ -8,12 +8,139 @@
 
 // ===== Includes ===========================================================
 #include <ZT/IGimbal.h>
+#include <ZT/IMessageReceiver.h>
 #include <ZT/ISystem.h>
 #include <ZT/Result.h>
 
+// ===== ZT_Lib =============================================================
+#include "Gimbal.h"
+
+// Constants
+// //////////////////////////////////////////////////////////////////////////
+
+#define MSG_TELEMETRY (1)
+
+// Class
+// //////////////////////////////////////////////////////////////////////////
+
+// Gimbal without device, the test feeds the positions
+class Gimbal_Tester : public Gimbal
+{
+
+public:
+
+    void Receive(const Position & aIn) { Position_Update(aIn); Telemetry_Send(); }
+
+    // ===== ZT::IGimbal ====================================================
+    virtual ZT::Result Focus_Cal(Operation aOperation) { return ZT::ZT_ERROR_NOT_READY; }
+    virtual ZT::Result Metrics_Get(Metrics * aOut, bool aReset) { return ZT::ZT_ERROR_NOT_READY; }
+    virtual ZT::Result Recorder_Dump(const char * aFileName) { return ZT::ZT_ERROR_NOT_READY; }
+    virtual ZT::Result Track_Speed_Set(double aSpeed_pc) { return ZT::ZT_ERROR_NOT_READY; }
+    virtual ZT::Result Track_Switch() { return ZT::ZT_ERROR_NOT_READY; }
+
+    virtual void Debug(void * aOut) {}
+
+};
+
+class Telemetry_Tester : public ZT::IMessageReceiver
+{
+
+public:
+
+    Telemetry_Tester() : mCount(0) {}
+
+    unsigned int           mCount;
+    ZT::IGimbal::Telemetry mLast;
+
+    // ===== ZT::IMessageReceiver ==========================================
+
+    virtual bool ProcessMessage(void * aSender, unsigned int aCode, const void * aData)
+    {
+        assert(NULL          != aSender);
+        assert(MSG_TELEMETRY == aCode);
+        assert(NULL          != aData);
+
+        mLast = *reinterpret_cast<const ZT::IGimbal::Telemetry *>(aData);
+        mCount ++;
+
+        return true;
+    }
+
+};
+
 // Tests
 // //////////////////////////////////////////////////////////////////////////
 
+KMS_TEST_BEGIN(Gimbal_Base)
+{
+    Gimbal_Tester * lG0 = new Gimbal_Tester();
+
+    ZT::IGimbal::Position       lPos;
+    ZT::IGimbal::PositionSample lSample;
+
+    // Position_Get_Cached
+    KMS_TEST_COMPARE(ZT::ZT_ERROR_NOT_READY, lG0->Position_Get_Cached(&lSample));
+
+    lPos.mAxis_deg[ZT::IGimbal::AXIS_PITCH] = 10.0;
+    lPos.mAxis_deg[ZT::IGimbal::AXIS_ROLL ] =  0.0;
+    lPos.mAxis_deg[ZT::IGimbal::AXIS_YAW  ] = 20.0;
+
+    lG0->Receive(lPos);
+
+    KMS_TEST_COMPARE(ZT::ZT_OK, lG0->Position_Get_Cached(&lSample));
+    KMS_TEST_ASSERT(10.0 == lSample.mPosition.mAxis_deg[ZT::IGimbal::AXIS_PITCH]);
+    KMS_TEST_ASSERT(20.0 == lSample.mPosition.mAxis_deg[ZT::IGimbal::AXIS_YAW  ]);
+    KMS_TEST_ASSERT(0 != lSample.mTimestamp_us);
+    KMS_TEST_ASSERT(10 > lSample.mAge_ms);
+
+    // Position_Get with a maximum age, the base class never waits
+    usleep(50000);
+
+    KMS_TEST_COMPARE(ZT::ZT_OK, lG0->Position_Get(&lSample, 1000));
+    KMS_TEST_ASSERT(40 <= lSample.mAge_ms);
+
+    KMS_TEST_COMPARE(ZT::ZT_ERROR_NOT_READY, lG0->Position_Get(&lSample, 10));
+    KMS_TEST_ASSERT(20.0 == lSample.mPosition.mAxis_deg[ZT::IGimbal::AXIS_YAW]);
+
+    // Telemetry_Start
+    Telemetry_Tester lTT;
+
+    KMS_TEST_COMPARE(ZT::ZT_ERROR_RECEIVER       , lG0->Telemetry_Start(NULL, MSG_TELEMETRY, 1));
+    KMS_TEST_COMPARE(ZT::ZT_ERROR_MIN            , lG0->Telemetry_Start(&lTT, MSG_TELEMETRY, 0));
+    KMS_TEST_COMPARE(ZT::ZT_ERROR_ALREADY_STOPPED, lG0->Telemetry_Stop());
+
+    KMS_TEST_COMPARE(ZT::ZT_OK                   , lG0->Telemetry_Start(&lTT, MSG_TELEMETRY, 2));
+    KMS_TEST_COMPARE(ZT::ZT_ERROR_ALREADY_STARTED, lG0->Telemetry_Start(&lTT, MSG_TELEMETRY, 1));
+
+    // One position of two is sent, the index counts them all
+    for (unsigned int i = 0; i < 5; i++)
+    {
+        lPos.mAxis_deg[ZT::IGimbal::AXIS_YAW] = 30.0 + i;
+
+        lG0->Receive(lPos);
+    }
+
+    KMS_TEST_COMPARE(3, lTT.mCount);
+    KMS_TEST_COMPARE(6, lTT.mLast.mIndex);
+    KMS_TEST_COMPARE(ZT::IGimbal::MOTION_STOPPED, lTT.mLast.mMotion);
+    KMS_TEST_ASSERT(34.0 == lTT.mLast.mPosition.mAxis_deg[ZT::IGimbal::AXIS_YAW]);
+    KMS_TEST_ASSERT(0.0  == lTT.mLast.mSpeed.mAxis_deg_s[ZT::IGimbal::AXIS_YAW]);
+
+    KMS_TEST_COMPARE(ZT::ZT_OK, lG0->Position_Get_Cached(&lSample));
+    KMS_TEST_ASSERT(lSample.mTimestamp_us == lTT.mLast.mTimestamp_us);
+
+    // Telemetry_Stop
+    KMS_TEST_COMPARE(ZT::ZT_OK, lG0->Telemetry_Stop());
+
+    lG0->Receive(lPos);
+    lG0->Receive(lPos);
+
+    KMS_TEST_COMPARE(3, lTT.mCount);
+
+    lG0->Release();
+}
+KMS_TEST_END
+
 KMS_TEST_BEGIN(Gimbal_SetupA)
 
     FILE * lNull = fopen("/dev/null", "wb");
@@ -60,6 +187,14 @@ KMS_TEST_BEGIN(Gimbal_SetupA)
     KMS_TEST_COMPARE(ZT::ZT_OK, lG0->Position_Get(&lPos));
     ZT::IGimbal::Display(stdout, lPos);
 
+    // Position_Get_Cached - The worker polls the position, a sample is
+    // always available once activated.
+    ZT::IGimbal::PositionSample lSample;
+
+    KMS_TEST_COMPARE(ZT::ZT_OK, lG0->Position_Get_Cached(&lSample));
+    KMS_TEST_COMPARE(ZT::ZT_OK, lG0->Position_Get(&lSample, 0));
+    KMS_TEST_ASSERT(100 > lSample.mAge_ms);
+
     // Position_Set
     lPos.mAxis_deg[0] -= 10.0;
     KMS_TEST_COMPARE(ZT::ZT_OK, lG0->Position_Set(lPos));
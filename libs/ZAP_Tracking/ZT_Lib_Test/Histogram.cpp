@@ -0,0 +1,80 @@
+
+// Author  KMS - Martin Dubois, P.Eng.
+// Client  ZAP
+// Product Tacking
+// File    ZT_Lib_Test/Histogram.cpp
+
+#include "Component.h"
+
+// ===== ZT_Lib =============================================================
+#include "ZT_Lib/Histogram.h"
+
+// Tests
+// //////////////////////////////////////////////////////////////////////////
+
+KMS_TEST_BEGIN(Histogram_Base)
+{
+    ZT_Lib::Histogram lH0;
+
+    KMS_TEST_COMPARE(0, lH0.Count_Get());
+    KMS_TEST_COMPARE(0, lH0.Percentile_Get(50));
+
+    // 90 values in the bucket 1 to 1, 9 in the bucket 10 to 10 and 1 very
+    // large value in the last bucket
+    for (unsigned int i = 0; i < 90; i++)
+    {
+        lH0.Add(1);
+    }
+
+    for (unsigned int i = 0; i < 9; i++)
+    {
+        lH0.Add(10);
+    }
+
+    lH0.Add(0xffffffff);
+
+    KMS_TEST_COMPARE(100, lH0.Count_Get());
+    KMS_TEST_COMPARE(0xffffffff, lH0.Max_Get());
+
+    KMS_TEST_COMPARE(         1, lH0.Percentile_Get( 50));
+    KMS_TEST_COMPARE(         1, lH0.Percentile_Get( 90));
+    KMS_TEST_COMPARE(        10, lH0.Percentile_Get( 99));
+    KMS_TEST_COMPARE(0xffffffff, lH0.Percentile_Get(100));
+
+    lH0.Display(stdout, "Histogram       ", "us");
+
+    // The linear buckets keep the error under 12.5 %, 1000 goes in the
+    // bucket 960 to 1023
+    ZT_Lib::Histogram lH1;
+
+    lH1.Add(1000);
+    lH1.Add(2000);
+
+    KMS_TEST_COMPARE(1023, lH1.Percentile_Get( 50));
+    KMS_TEST_COMPARE(2000, lH1.Percentile_Get(100));
+
+    // The snapshot with reset moves the values
+    lH0.Snapshot_Get(&lH1, true);
+
+    KMS_TEST_COMPARE(100, lH1.Count_Get());
+    KMS_TEST_COMPARE( 10, lH1.Percentile_Get(99));
+    KMS_TEST_COMPARE(  0, lH0.Count_Get());
+
+    lH0.Add(5);
+
+    lH0.Snapshot_Get(&lH1);
+
+    KMS_TEST_COMPARE(1, lH1.Count_Get());
+    KMS_TEST_COMPARE(1, lH0.Count_Get());
+
+    lH0.Reset();
+
+    KMS_TEST_COMPARE(0, lH0.Count_Get());
+    KMS_TEST_COMPARE(0, lH0.Max_Get());
+
+    // The percentile never goes over the maximum
+    lH0.Add(9);
+
+    KMS_TEST_COMPARE(9, lH0.Percentile_Get(50));
+}
+KMS_TEST_END
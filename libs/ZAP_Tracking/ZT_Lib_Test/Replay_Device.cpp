@@ -0,0 +1,310 @@
+
+// Author  KMS - Martin Dubois, P.Eng.
+// Client  ZAP
+// Product Tacking
+// File    ZT_Lib_Test/Replay_Device.cpp
+
+#include "Component.h"
+
+// ===== C++ ================================================================
+#include <atomic>
+
+// ===== C ==================================================================
+#include <stdint.h>
+#include <stdio.h>
+#include <time.h>
+#include <unistd.h>
+
+// ===== ZT_Lib =============================================================
+#include "CAN_Batch.h"
+#include "DJI_Gimbal.h"
+#include "DJI_Reassembler.h"
+#include "FlightRecorder.h"
+#include "Replay_Device.h"
+
+// Constants
+// //////////////////////////////////////////////////////////////////////////
+
+#define FILE_NAME "/tmp/ZT_Lib_Test_Replay_Device.bin"
+
+#define REPLY_DELAY_ns (20000000)
+
+#define T0_ns (1000000000)
+
+// Class
+// //////////////////////////////////////////////////////////////////////////
+
+// The replay thread writes the members, the test reads them once mFrames
+// says the frame is there.
+class Receiver
+{
+
+public:
+
+    Receiver() : mReassembler(&mStats), mFrames(0), mSerial(0), mTime_ns(0)
+    {
+    }
+
+    Stats           mStats;
+    DJI_Reassembler mReassembler;
+
+    std::atomic<unsigned int> mFrames;
+
+    uint16_t mSerial;
+    uint64_t mTime_ns;
+
+};
+
+// Static function declarations
+// //////////////////////////////////////////////////////////////////////////
+
+static void Frame_Init(DJI_Frame * aOut, uint8_t aCmdType, uint8_t aCmdId, uint16_t aSerial);
+
+static EthCAN_Result Send(Replay_Device * aRD, uint8_t aCmdType, uint8_t aCmdId, uint16_t aSerial);
+
+static uint64_t Time_Get_ns();
+
+// aType     CAN_RX or CAN_TX
+// aRecorder [---;RW-] The records go there
+// aRD       [---;RW-] The records go there
+static void Trace_Frame(FlightRecorder_Type aType, uint64_t aTime_ns, uint8_t aCmdType, uint8_t aCmdId, uint16_t aSerial, EthCAN_Result aResult, FlightRecorder * aRecorder, Replay_Device * aRD);
+
+// Return false when the replay is not done after 1 s
+static bool Wait(const Replay_Device * aRD);
+
+// ===== Entry point ========================================================
+
+static bool Receiver_Link(EthCAN::Device * aDevice, void * aContext, const EthCAN_Frame & aFrame);
+
+// Tests
+// //////////////////////////////////////////////////////////////////////////
+
+KMS_TEST_BEGIN(Replay_Device_Base)
+{
+    Replay_Device::Counters lCounters;
+
+    // ===== Reply serial, unmatched frame and recorded error ===============
+    {
+        Receiver        lR;
+        Replay_Device * lRD0 = new Replay_Device(Replay_Device::MODE_FAST);
+
+        Trace_Frame(FLIGHT_RECORDER_CAN_RX, T0_ns     , DJI_CMD_TYPE_NO_REPLY, DJI_CMD_ANGLE_GET, 50 , EthCAN_OK   , NULL, lRD0);
+        Trace_Frame(FLIGHT_RECORDER_CAN_TX, T0_ns +  1, DJI_CMD_TYPE_DO_REPLY, DJI_CMD_ANGLE_GET, 100, EthCAN_OK   , NULL, lRD0);
+        Trace_Frame(FLIGHT_RECORDER_CAN_RX, T0_ns +  2, DJI_CMD_TYPE_REPLY   , DJI_CMD_ANGLE_GET, 100, EthCAN_OK   , NULL, lRD0);
+        Trace_Frame(FLIGHT_RECORDER_CAN_TX, T0_ns +  3, DJI_CMD_TYPE_NO_REPLY, DJI_CMD_SPEED_SET, 101, EthCAN_ERROR, NULL, lRD0);
+
+        KMS_TEST_COMPARE(EthCAN_OK, lRD0->Receiver_Start(Receiver_Link, &lR));
+
+        // The unsolicited frame comes before the first Tx frame
+        while (0 == lR.mFrames)
+        {
+            usleep(1000);
+        }
+
+        KMS_TEST_COMPARE(50, lR.mSerial);
+
+        KMS_TEST_COMPARE(EthCAN_OK, Send(lRD0, DJI_CMD_TYPE_DO_REPLY, DJI_CMD_ANGLE_GET, 7));
+
+        while (2 > lR.mFrames)
+        {
+            usleep(1000);
+        }
+
+        KMS_TEST_COMPARE(7, lR.mSerial);
+
+        // No reply left in the trace
+        KMS_TEST_COMPARE(EthCAN_OK   , Send(lRD0, DJI_CMD_TYPE_DO_REPLY, DJI_CMD_ANGLE_GET, 8));
+        KMS_TEST_COMPARE(EthCAN_ERROR, Send(lRD0, DJI_CMD_TYPE_NO_REPLY, DJI_CMD_SPEED_SET, 9));
+
+        KMS_TEST_ASSERT(Wait(lRD0));
+
+        lRD0->Counters_Get(&lCounters);
+        KMS_TEST_COMPARE(6, lCounters.mRx_Fragment);
+        KMS_TEST_COMPARE(2, lCounters.mRx_Frame);
+        KMS_TEST_COMPARE(1, lCounters.mRx_Serial);
+        KMS_TEST_COMPARE(1, lCounters.mTx_Error);
+        KMS_TEST_COMPARE(3, lCounters.mTx_Frame);
+        KMS_TEST_COMPARE(1, lCounters.mTx_Unmatched);
+
+        KMS_TEST_COMPARE(2, lR.mFrames);
+        KMS_TEST_COMPARE(0, lR.mStats.mRx_CRC16);
+        KMS_TEST_COMPARE(0, lR.mStats.mRx_CRC32);
+
+        KMS_TEST_COMPARE(EthCAN_OK   , lRD0->Receiver_Stop());
+        KMS_TEST_COMPARE(EthCAN_ERROR, lRD0->Receiver_Stop());
+
+        lRD0->Release();
+    }
+
+    // ===== Recorded timing, from a FlightRecorder dump ====================
+    {
+        FlightRecorder * lFR = new FlightRecorder();
+        Receiver         lR;
+        Replay_Device  * lRD1 = new Replay_Device(Replay_Device::MODE_TIMED);
+
+        Trace_Frame(FLIGHT_RECORDER_CAN_TX, T0_ns                 , DJI_CMD_TYPE_DO_REPLY, DJI_CMD_VERSION, 200, EthCAN_OK, lFR, NULL);
+        Trace_Frame(FLIGHT_RECORDER_CAN_RX, T0_ns + REPLY_DELAY_ns, DJI_CMD_TYPE_REPLY   , DJI_CMD_VERSION, 200, EthCAN_OK, lFR, NULL);
+
+        unlink(FILE_NAME);
+
+        KMS_TEST_COMPARE(ZT::ZT_OK, lFR->Dump(FILE_NAME));
+
+        delete lFR;
+
+        KMS_TEST_COMPARE(ZT::ZT_OK             , lRD1->Load(FILE_NAME));
+        KMS_TEST_COMPARE(ZT::ZT_ERROR_FILE_OPEN, lRD1->Load("DoesNotExist"));
+
+        KMS_TEST_COMPARE(EthCAN_OK, lRD1->Receiver_Start(Receiver_Link, &lR));
+
+        uint64_t lBegin_ns = Time_Get_ns();
+
+        KMS_TEST_COMPARE(EthCAN_OK, Send(lRD1, DJI_CMD_TYPE_DO_REPLY, DJI_CMD_VERSION, 3));
+
+        KMS_TEST_ASSERT(Wait(lRD1));
+        KMS_TEST_COMPARE(1, lR.mFrames);
+        KMS_TEST_COMPARE(3, lR.mSerial);
+        KMS_TEST_ASSERT(REPLY_DELAY_ns <= lR.mTime_ns - lBegin_ns);
+
+        printf("    Reply after %.1f ms, recorded after %.1f ms\n", static_cast<double>(lR.mTime_ns - lBegin_ns) / 1000000.0, REPLY_DELAY_ns / 1000000.0);
+
+        lRD1->Release();
+    }
+
+    // ===== DJI_Gimbal =====================================================
+    {
+        DJI_Gimbal * lG0 = new DJI_Gimbal(new Replay_Device(Replay_Device::MODE_FAST));
+
+        KMS_TEST_COMPARE(ZT::ZT_OK, lG0->Connect());
+
+        delete lG0;
+    }
+}
+KMS_TEST_END
+
+// Static functions
+// //////////////////////////////////////////////////////////////////////////
+
+void Frame_Init(DJI_Frame * aOut, uint8_t aCmdType, uint8_t aCmdId, uint16_t aSerial)
+{
+    assert(NULL != aOut);
+
+    aOut->Init(3, aCmdType, DJI_CMD_SET_DEFAULT, aCmdId, aSerial);
+
+    aOut->mData[DJI_REPLY_RESULT] = DJI_OK;
+
+    aOut->Seal();
+}
+
+EthCAN_Result Send(Replay_Device * aRD, uint8_t aCmdType, uint8_t aCmdId, uint16_t aSerial)
+{
+    assert(NULL != aRD);
+
+    CAN_Batch lBatch;
+    DJI_Frame lFrame;
+
+    Frame_Init(&lFrame, aCmdType, aCmdId, aSerial);
+
+    bool lRet = lBatch.Frame_Add(lFrame, DJI_CAN_ID_TX);
+    assert(lRet);
+
+    EthCAN_Result lResult = EthCAN_OK;
+
+    for (unsigned int i = 0; i < lBatch.Count_Get(); i++)
+    {
+        lResult = aRD->Send(lBatch.Frames_Get()[i]);
+    }
+
+    return lResult;
+}
+
+uint64_t Time_Get_ns()
+{
+    timespec lNow;
+
+    clock_gettime(CLOCK_MONOTONIC, &lNow);
+
+    return static_cast<uint64_t>(lNow.tv_sec) * 1000000000 + lNow.tv_nsec;
+}
+
+void Trace_Frame(FlightRecorder_Type aType, uint64_t aTime_ns, uint8_t aCmdType, uint8_t aCmdId, uint16_t aSerial, EthCAN_Result aResult, FlightRecorder * aRecorder, Replay_Device * aRD)
+{
+    CAN_Batch lBatch;
+    DJI_Frame lFrame;
+
+    Frame_Init(&lFrame, aCmdType, aCmdId, aSerial);
+
+    bool lRet = lBatch.Frame_Add(lFrame, (FLIGHT_RECORDER_CAN_RX == aType) ? DJI_CAN_ID_RX : DJI_CAN_ID_TX);
+    assert(lRet);
+
+    if (NULL != aRecorder)
+    {
+        // The recorder takes its own time, the test waits to get the delay.
+        usleep((aTime_ns - T0_ns) / 1000);
+    }
+
+    for (unsigned int i = 0; i < lBatch.Count_Get(); i++)
+    {
+        const EthCAN_Frame & lF = lBatch.Frames_Get()[i];
+
+        if (NULL != aRecorder)
+        {
+            aRecorder->Record(aType, lF.mId, 0, aResult, lF.mData, lF.mDataSize_byte);
+        }
+
+        if (NULL != aRD)
+        {
+            FlightRecorder_Record lRecord;
+
+            memset(&lRecord, 0, sizeof(lRecord));
+
+            lRecord.mTime_ns       = aTime_ns;
+            lRecord.mId            = lF.mId;
+            lRecord.mValue         = aResult;
+            lRecord.mType          = aType;
+            lRecord.mDataSize_byte = lF.mDataSize_byte;
+
+            memcpy(lRecord.mData, lF.mData, lF.mDataSize_byte);
+
+            aRD->Record_Add(lRecord);
+        }
+    }
+}
+
+bool Wait(const Replay_Device * aRD)
+{
+    assert(NULL != aRD);
+
+    for (unsigned int i = 0; i < 1000; i++)
+    {
+        if (aRD->IsDone())
+        {
+            return true;
+        }
+
+        usleep(1000);
+    }
+
+    return false;
+}
+
+// ===== Entry point ========================================================
+
+bool Receiver_Link(EthCAN::Device * aDevice, void * aContext, const EthCAN_Frame & aFrame)
+{
+    assert(NULL != aContext);
+
+    Receiver * lR = reinterpret_cast<Receiver *>(aContext);
+
+    lR->mReassembler.Push(aFrame.mData, aFrame.mDataSize_byte);
+
+    const DJI_Frame * lFrame = lR->mReassembler.Next();
+    if (NULL != lFrame)
+    {
+        lR->mSerial  = lFrame->mSerial;
+        lR->mTime_ns = Time_Get_ns();
+
+        lR->mFrames ++;
+    }
+
+    return true;
+}
@@ -0,0 +1,109 @@
+
+// Author  KMS - Martin Dubois, P.Eng.
+// Client  ZAP
+// Product Tacking
+// File    ZT_Lib_Test/Scheduler.cpp
+
+#include "Component.h"
+
+// ===== C ==================================================================
+#include <stdio.h>
+
+// ===== ZT_Lib =============================================================
+#include "Scheduler.h"
+
+// Constants
+// //////////////////////////////////////////////////////////////////////////
+
+#define CLASS_A (0)
+#define CLASS_B (1)
+#define CLASS_C (2)
+
+#define READY_ALL (0x7)
+
+#define TICK_QTY (400)
+
+// Static function declarations
+// //////////////////////////////////////////////////////////////////////////
+
+// aSlots [---;-W-] The number of slots of each class
+static void Run(Scheduler * aS, unsigned int aReady, unsigned int * aSlots);
+
+// Tests
+// //////////////////////////////////////////////////////////////////////////
+
+KMS_TEST_BEGIN(Scheduler_Base)
+{
+    Scheduler    lS0;
+    unsigned int lSlots[3];
+
+    lS0.Class_Init(CLASS_A, "A", SCHEDULER_SLOT / 4, 2 * SCHEDULER_SLOT);
+    lS0.Class_Init(CLASS_B, "B", SCHEDULER_SLOT / 2, 2 * SCHEDULER_SLOT);
+    lS0.Class_Init(CLASS_C, "C", SCHEDULER_SLOT / 4, 2 * SCHEDULER_SLOT);
+
+    // ===== Only ready classes get slots ===================================
+    Run(&lS0, 1 << CLASS_A, lSlots);
+    KMS_TEST_COMPARE(TICK_QTY / 4, lSlots[CLASS_A]);
+    KMS_TEST_COMPARE(0           , lSlots[CLASS_B]);
+    KMS_TEST_COMPARE(0           , lSlots[CLASS_C]);
+    KMS_TEST_COMPARE(4           , lS0.Elapsed_Get(CLASS_A));
+
+    // ===== The weights share the slots ====================================
+    Run(&lS0, READY_ALL, lSlots);
+    KMS_TEST_ASSERT(TICK_QTY / 4 - 1 <= lSlots[CLASS_A]);
+    KMS_TEST_ASSERT(TICK_QTY / 2 - 1 <= lSlots[CLASS_B]);
+    KMS_TEST_ASSERT(TICK_QTY / 4 - 1 <= lSlots[CLASS_C]);
+
+    // ===== Too much work, the first classes have priority =================
+    lS0.Class_Weight_Set(CLASS_A, SCHEDULER_SLOT / 2);
+
+    Run(&lS0, READY_ALL, lSlots);
+    KMS_TEST_COMPARE(TICK_QTY, lSlots[CLASS_A] + lSlots[CLASS_B] + lSlots[CLASS_C]);
+    KMS_TEST_ASSERT(TICK_QTY / 2 - 1 <= lSlots[CLASS_A]);
+    KMS_TEST_ASSERT(TICK_QTY / 2 - 1 <= lSlots[CLASS_B]);
+    KMS_TEST_ASSERT(2 >= lSlots[CLASS_C]);
+
+    // ===== Credit_Reset ===================================================
+    unsigned int lClass;
+
+    lS0.Class_Weight_Set(CLASS_A, SCHEDULER_SLOT / 4);
+
+    Run(&lS0, 0, lSlots);
+
+    for (unsigned int i = 0; i < 3; i++)
+    {
+        KMS_TEST_ASSERT(!lS0.Tick(&lClass, 1 << CLASS_A));
+    }
+
+    lS0.Credit_Reset(CLASS_A);
+
+    KMS_TEST_ASSERT(!lS0.Tick(&lClass, 1 << CLASS_A));
+
+    lS0.Account(CLASS_A, 10);
+
+    lS0.Display(stdout);
+}
+KMS_TEST_END
+
+// Static functions
+// //////////////////////////////////////////////////////////////////////////
+
+void Run(Scheduler * aS, unsigned int aReady, unsigned int * aSlots)
+{
+    assert(NULL != aS);
+    assert(NULL != aSlots);
+
+    memset(aSlots, 0, sizeof(unsigned int) * 3);
+
+    for (unsigned int i = 0; i < TICK_QTY; i++)
+    {
+        unsigned int lClass;
+
+        if (aS->Tick(&lClass, aReady))
+        {
+            assert(3 > lClass);
+
+            aSlots[lClass] ++;
+        }
+    }
+}
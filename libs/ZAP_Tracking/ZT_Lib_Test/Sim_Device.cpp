@@ -0,0 +1,325 @@
+
+// Author  KMS - Martin Dubois, P. Eng.
+// Client  ZAP
+// Product Tacking
+// File    ZT_Lib_Test/Sim_Device.cpp
+
+#include "Component.h"
+
+// ===== C ==================================================================
+#include <math.h>
+#include <time.h>
+#include <unistd.h>
+
+// ===== ZT_Lib =============================================================
+#include "DJI_Gimbal.h"
+#include "Sim_Detector.h"
+#include "Sim_Device.h"
+
+// Static function declarations
+// //////////////////////////////////////////////////////////////////////////
+
+// Return false when the health is not aHealth after aTimeout_ms
+static bool Health_Wait(ZT::IGimbal * aG, ZT::IGimbal::Health aHealth, unsigned int aTimeout_ms, ZT::IGimbal::HealthStatus * aOut);
+
+static uint64_t Time_Get_us();
+
+// Return false when the simulated angles are not at aTarget after 5 s
+static bool Wait(Sim_Device * aSD, const ZT::IGimbal::Position & aTarget);
+
+// Tests
+// //////////////////////////////////////////////////////////////////////////
+
+KMS_TEST_BEGIN(Sim_Device_Base)
+{
+    Sim_Device::Counters  lCounters;
+    ZT::IGimbal::Position lPos;
+    ZT::IGimbal::Position lSim;
+    ZT::IGimbal::Speed    lSpeed;
+
+    // ===== Position and speed =============================================
+    {
+        Sim_Device * lSD0 = new Sim_Device(Sim_Device::CONFIG_DEFAULT);
+        DJI_Gimbal * lG0  = new DJI_Gimbal(lSD0);
+
+        KMS_TEST_COMPARE(ZT::ZT_OK, lG0->Connect());
+        KMS_TEST_COMPARE(ZT::ZT_OK, lG0->Activate());
+
+        lPos.mAxis_deg[ZT::IGimbal::AXIS_PITCH] = 10.0;
+        lPos.mAxis_deg[ZT::IGimbal::AXIS_ROLL ] =  0.0;
+        lPos.mAxis_deg[ZT::IGimbal::AXIS_YAW  ] = 20.0;
+
+        KMS_TEST_COMPARE(ZT::ZT_OK, lG0->Position_Set(lPos, 0, 200));
+
+        KMS_TEST_ASSERT(Wait(lSD0, lPos));
+
+        KMS_TEST_COMPARE(ZT::ZT_OK, lG0->Position_Get(&lPos));
+        KMS_TEST_ASSERT(0.2 > fabs(10.0 - lPos.mAxis_deg[ZT::IGimbal::AXIS_PITCH]));
+        KMS_TEST_ASSERT(0.2 > fabs(20.0 - lPos.mAxis_deg[ZT::IGimbal::AXIS_YAW  ]));
+
+        lSpeed.mAxis_deg_s[ZT::IGimbal::AXIS_PITCH] =  0.0;
+        lSpeed.mAxis_deg_s[ZT::IGimbal::AXIS_ROLL ] =  0.0;
+        lSpeed.mAxis_deg_s[ZT::IGimbal::AXIS_YAW  ] = 40.0;
+
+        KMS_TEST_COMPARE(ZT::ZT_OK, lG0->Speed_Set(lSpeed, 0));
+        usleep(250000);
+        KMS_TEST_COMPARE(ZT::ZT_OK, lG0->Speed_Stop());
+        usleep(300000);
+
+        lSD0->Position_Get(&lSim);
+        KMS_TEST_ASSERT(25.0 < lSim.mAxis_deg[ZT::IGimbal::AXIS_YAW]);
+        KMS_TEST_ASSERT(35.0 > lSim.mAxis_deg[ZT::IGimbal::AXIS_YAW]);
+
+        // The yaw limit stops the motor
+        lSpeed.mAxis_deg_s[ZT::IGimbal::AXIS_YAW] = 360.0;
+
+        KMS_TEST_COMPARE(ZT::ZT_OK, lG0->Speed_Set(lSpeed, 0));
+        usleep(1000000);
+
+        lSD0->Position_Get(&lSim);
+        KMS_TEST_ASSERT(180.0 >= lSim.mAxis_deg[ZT::IGimbal::AXIS_YAW]);
+
+        KMS_TEST_COMPARE(ZT::ZT_OK, lG0->Speed_Stop());
+
+        lSD0->Counters_Get(&lCounters);
+        KMS_TEST_ASSERT(0 < lCounters.mRx_Frame);
+        KMS_TEST_ASSERT(0 < lCounters.mTx_Frame);
+        KMS_TEST_COMPARE(0, lCounters.mRx_Lost);
+        KMS_TEST_COMPARE(0, lCounters.mTx_Lost);
+
+        delete lG0;
+    }
+
+    // ===== Loss ===========================================================
+    {
+        Sim_Device::Config lConfig = Sim_Device::CONFIG_DEFAULT;
+
+        lConfig.mLoss_pc = 10.0;
+
+        Sim_Device * lSD1 = new Sim_Device(lConfig);
+        DJI_Gimbal * lG1  = new DJI_Gimbal(lSD1);
+
+        KMS_TEST_COMPARE(ZT::ZT_OK, lG1->Connect());
+        KMS_TEST_COMPARE(ZT::ZT_OK, lG1->Activate());
+
+        ZT::IGimbal::PositionSample lSample;
+
+        unsigned int lOK = 0;
+
+        // The sample gets older than 0 ms, each call sends an ANGLE_GET.
+        for (unsigned int i = 0; i < 50; i ++)
+        {
+            usleep(5000);
+
+            if (ZT::ZT_OK == lG1->Position_Get(&lSample, 0))
+            {
+                lOK ++;
+            }
+        }
+
+        lSD1->Counters_Get(&lCounters);
+
+        printf("    %u / 50 Position_Get, %u / %u requests lost, %u / %u replies lost\n", lOK, lCounters.mRx_Lost, lCounters.mRx_Frame, lCounters.mTx_Lost, lCounters.mTx_Frame);
+
+        // ANGLE_GET goes without retry, the request and the reply both get
+        // through 81 % of the time.
+        KMS_TEST_ASSERT(30 <= lOK);
+        KMS_TEST_ASSERT(0 < lCounters.mRx_Lost + lCounters.mTx_Lost);
+
+        delete lG1;
+    }
+
+    // ===== Sim_Detector ===================================================
+    {
+        IDetector::GimbalList lGimbals;
+        ZT::IGimbal::Info     lInfo;
+        Sim_Detector          lSD2(3);
+
+        lSD2.Gimbals_Detect(&lGimbals);
+        KMS_TEST_COMPARE(3, lGimbals.size());
+
+        lGimbals.back()->Info_Get(&lInfo);
+        KMS_TEST_COMPARE(0x0300017f, lInfo.mIPv4_Address);
+
+        for (IDetector::GimbalList::iterator lIt = lGimbals.begin(); lIt != lGimbals.end(); lIt ++)
+        {
+            (*lIt)->Release();
+        }
+    }
+}
+KMS_TEST_END
+
+KMS_TEST_BEGIN(Sim_Device_Recovery)
+{
+    Sim_Device::Counters      lCounters;
+    ZT::IGimbal::HealthStatus lHealth;
+    ZT::IGimbal::Position     lPos;
+
+    Sim_Device * lSD = new Sim_Device(Sim_Device::CONFIG_DEFAULT);
+    DJI_Gimbal * lG  = new DJI_Gimbal(lSD);
+
+    KMS_TEST_COMPARE(ZT::ZT_OK, lG->Health_Get(&lHealth));
+    KMS_TEST_COMPARE(ZT::IGimbal::HEALTH_INACTIVE, lHealth.mHealth);
+
+    KMS_TEST_COMPARE(ZT::ZT_OK, lG->Connect());
+    KMS_TEST_COMPARE(ZT::ZT_OK, lG->Activate());
+
+    KMS_TEST_COMPARE(ZT::ZT_OK, lG->Health_Get(&lHealth));
+    KMS_TEST_COMPARE(ZT::IGimbal::HEALTH_OK, lHealth.mHealth);
+
+    memset(&lPos, 0, sizeof(lPos));
+
+    // ===== The gimbal stops replying, then replies again ==================
+
+    lSD->Loss_Set(100.0);
+
+    KMS_TEST_ASSERT(Health_Wait(lG, ZT::IGimbal::HEALTH_RECOVERING, 1000, &lHealth));
+
+    // The reset delay lasts 1 s, the calls do not wait for its end.
+    unsigned int lMax_us   = 0;
+    unsigned int lNotReady = 0;
+
+    for (unsigned int i = 0; i < 50; i ++)
+    {
+        uint64_t lStart_us = Time_Get_us();
+
+        ZT::Result lRet = lG->Position_Set(lPos, 0, 100);
+
+        unsigned int lDuration_us = static_cast<unsigned int>(Time_Get_us() - lStart_us);
+
+        if (ZT::ZT_ERROR_NOT_READY == lRet)
+        {
+            lNotReady ++;
+
+            if (lMax_us < lDuration_us)
+            {
+                lMax_us = lDuration_us;
+            }
+        }
+
+        usleep(10000);
+    }
+
+    printf("    %u / 50 ZT_ERROR_NOT_READY, max %u us\n", lNotReady, lMax_us);
+
+    KMS_TEST_ASSERT(0 < lNotReady);
+    KMS_TEST_ASSERT(20000 > lMax_us);
+
+    lSD->Loss_Set(0.0);
+
+    KMS_TEST_ASSERT(Health_Wait(lG, ZT::IGimbal::HEALTH_OK, 3000, &lHealth));
+    KMS_TEST_COMPARE(0, lHealth.mFailure);
+    KMS_TEST_COMPARE(1, lHealth.mRecovery);
+
+    KMS_TEST_COMPARE(ZT::ZT_OK, lG->Position_Set(lPos, 0, 100));
+
+    lSD->Counters_Get(&lCounters);
+    KMS_TEST_COMPARE(1, lCounters.mCAN_Reset);
+
+    // ===== The gimbal goes off, the circuit opens =========================
+
+    lSD->Loss_Set(100.0);
+
+    // The transaction times out after 1 s and the recovery starts. The retry
+    // completes at once, the caller does not wait for the end of the
+    // recovery.
+    uint64_t lStart_us = Time_Get_us();
+
+    KMS_TEST_COMPARE(ZT::ZT_ERROR_NOT_READY, lG->Track_Speed_Set(50.0));
+
+    unsigned int lDuration_ms = static_cast<unsigned int>((Time_Get_us() - lStart_us) / 1000);
+
+    printf("    Track_Speed_Set took %u ms\n", lDuration_ms);
+
+    KMS_TEST_ASSERT(1500 > lDuration_ms);
+
+    // 4 resets and 3 waits of 100, 200 and 400 ms
+    KMS_TEST_ASSERT(Health_Wait(lG, ZT::IGimbal::HEALTH_FAILED, 10000, &lHealth));
+
+    ZT::IGimbal::Display(stdout, lHealth);
+
+    KMS_TEST_COMPARE(4, lHealth.mFailure);
+    KMS_TEST_COMPARE(1, lHealth.mRecovery);
+    KMS_TEST_ASSERT(9000 <  lHealth.mRetry_ms);
+    KMS_TEST_ASSERT(10000 >= lHealth.mRetry_ms);
+
+    KMS_TEST_COMPARE(ZT::ZT_ERROR_NOT_READY, lG->Position_Set(lPos, 0, 100));
+
+    // While the circuit is open, a synchronous call does not wait for the
+    // next reset.
+    ZT::IGimbal::PositionSample lSample;
+
+    lStart_us = Time_Get_us();
+
+    KMS_TEST_COMPARE(ZT::ZT_ERROR_NOT_READY, lG->Position_Get(&lSample, 0));
+    KMS_TEST_COMPARE(ZT::ZT_ERROR_NOT_READY, lG->Track_Speed_Set(50.0));
+
+    KMS_TEST_ASSERT(20000 > Time_Get_us() - lStart_us);
+
+    lSD->Counters_Get(&lCounters);
+    KMS_TEST_COMPARE(5, lCounters.mCAN_Reset);
+
+    delete lG;
+}
+KMS_TEST_END
+
+// Static functions
+// //////////////////////////////////////////////////////////////////////////
+
+bool Health_Wait(ZT::IGimbal * aG, ZT::IGimbal::Health aHealth, unsigned int aTimeout_ms, ZT::IGimbal::HealthStatus * aOut)
+{
+    assert(NULL != aG);
+    assert(NULL != aOut);
+
+    for (unsigned int i = 0; i < aTimeout_ms; i += 10)
+    {
+        ZT::Result lRet = aG->Health_Get(aOut);
+        assert(ZT::ZT_OK == lRet);
+
+        if (aHealth == aOut->mHealth)
+        {
+            return true;
+        }
+
+        usleep(10000);
+    }
+
+    return false;
+}
+
+uint64_t Time_Get_us()
+{
+    timespec lNow;
+
+    clock_gettime(CLOCK_MONOTONIC, &lNow);
+
+    return static_cast<uint64_t>(lNow.tv_sec) * 1000000 + lNow.tv_nsec / 1000;
+}
+
+bool Wait(Sim_Device * aSD, const ZT::IGimbal::Position & aTarget)
+{
+    assert(NULL != aSD);
+
+    for (unsigned int i = 0; i < 500; i ++)
+    {
+        ZT::IGimbal::Position lSim;
+
+        aSD->Position_Get(&lSim);
+
+        bool lDone = true;
+
+        for (unsigned int a = 0; a < ZT::IGimbal::AXIS_QTY; a ++)
+        {
+            lDone &= (0.1 > fabs(aTarget.mAxis_deg[a] - lSim.mAxis_deg[a]));
+        }
+
+        if (lDone)
+        {
+            return true;
+        }
+
+        usleep(10000);
+    }
+
+    return false;
+}
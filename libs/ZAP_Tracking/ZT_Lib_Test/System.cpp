@@ -6,10 +6,69 @@
 
 #include "Component.h"
 
+// ===== C ==================================================================
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+// ===== C++ ================================================================
+#include <atomic>
+
 // ===== Includes ===========================================================
+#include <ZT/IGimbal.h>
+#include <ZT/IMessageReceiver.h>
 #include <ZT/ISystem.h>
 #include <ZT/Result.h>
 
+// ===== ZT_Lib =============================================================
+#include "Gimbal.h"
+
+// Constants
+// //////////////////////////////////////////////////////////////////////////
+
+#define GROUP_QTY (3)
+
+#define MOVE_QTY (10)
+
+#define MSG_TELEMETRY (1)
+
+// Class
+// //////////////////////////////////////////////////////////////////////////
+
+// The gimbal threads send the telemetry, the test reads it.
+class Motion_Tester : public ZT::IMessageReceiver
+{
+
+public:
+
+    Motion_Tester() : mCount(0), mMotion(ZT::IGimbal::MOTION_UNKNOWN) {}
+
+    std::atomic<unsigned int>        mCount;
+    std::atomic<ZT::IGimbal::Motion> mMotion;
+
+    // ===== ZT::IMessageReceiver ==========================================
+
+    virtual bool ProcessMessage(void * aSender, unsigned int aCode, const void * aData)
+    {
+        assert(NULL          != aSender);
+        assert(MSG_TELEMETRY == aCode);
+        assert(NULL          != aData);
+
+        mMotion = reinterpret_cast<const ZT::IGimbal::Telemetry *>(aData)->mMotion;
+        mCount ++;
+
+        return true;
+    }
+
+};
+
+// Static function declarations
+// //////////////////////////////////////////////////////////////////////////
+
+// Return false when the gimbal is not at aTarget after 5 s
+static bool Wait(ZT::IGimbal * aGimbal, const ZT::IGimbal::Position & aTarget);
+
 // Tests
 // //////////////////////////////////////////////////////////////////////////
 
@@ -19,6 +78,17 @@ KMS_TEST_BEGIN(System_Base)
     ZT::ISystem * lS0 = ZT::ISystem::Create();
     KMS_TEST_ASSERT(NULL != lS0);
 
+    // Cache_Set
+    char lFolder[] = "/tmp/ZT_Lib_Test_XXXXXX";
+    KMS_TEST_ASSERT(NULL != mkdtemp(lFolder));
+
+    KMS_TEST_COMPARE(ZT::ZT_ERROR_CONFIG   , lS0->Cache_Set("/tmp"));
+    KMS_TEST_COMPARE(ZT::ZT_ERROR_FILE_OPEN, lS0->Cache_Set("/ZT_Lib_Test_Unknown"));
+    KMS_TEST_COMPARE(ZT::ZT_OK             , lS0->Cache_Set(lFolder));
+    KMS_TEST_COMPARE(ZT::ZT_OK             , lS0->Cache_Set(NULL));
+
+    KMS_TEST_COMPARE(0, rmdir(lFolder));
+
     // Gamepads_Detect
     KMS_TEST_COMPARE(ZT::ZT_OK, lS0->Gamepads_Detect());
     
@@ -38,3 +108,186 @@ KMS_TEST_BEGIN(System_Base)
     lS0->Release();
 
 KMS_TEST_END
+
+KMS_TEST_BEGIN(System_Simulator)
+{
+    ZT::ISystem * lS0 = ZT::ISystem::Create();
+    KMS_TEST_ASSERT_RETURN(NULL != lS0);
+
+    KMS_TEST_COMPARE(ZT::ZT_ERROR_MAX, lS0->Simulator_Set(65));
+    KMS_TEST_COMPARE(ZT::ZT_OK       , lS0->Simulator_Set(4));
+    KMS_TEST_COMPARE(ZT::ZT_OK       , lS0->Gimbals_Detect());
+
+    ZT::IGimbal * lG0 = lS0->Gimbal_Find_IPv4("127.1.0.4");
+    KMS_TEST_ASSERT(NULL != lG0);
+    lG0->Release();
+
+    for (unsigned int i = 0; i < 3; i ++)
+    {
+        lG0 = lS0->Gimbal_Get(0);
+        KMS_TEST_ASSERT_RETURN(NULL != lG0);
+        lG0->Release();
+    }
+
+    KMS_TEST_COMPARE(ZT::ZT_OK, lS0->Simulator_Set(0));
+    KMS_TEST_COMPARE(ZT::ZT_OK, lS0->Gimbals_Detect());
+    KMS_TEST_ASSERT(NULL == lS0->Gimbal_Get(0));
+
+    lS0->Release();
+}
+KMS_TEST_END
+
+// The workers of the gimbals tick every 10 ms without being aligned, a
+// Position_Set per gimbal starts the moves up to one period apart.
+KMS_TEST_BEGIN(System_Group)
+{
+    ZT::IGimbal         * lG[GROUP_QTY];
+    ZT::IGimbal::Metrics  lMetrics;
+    ZT::IGimbal::Position lPos[GROUP_QTY];
+    unsigned int          i;
+
+    ZT::ISystem * lS0 = ZT::ISystem::Create();
+    KMS_TEST_ASSERT_RETURN(NULL != lS0);
+
+    KMS_TEST_COMPARE(ZT::ZT_OK, lS0->Simulator_Set(GROUP_QTY));
+    KMS_TEST_COMPARE(ZT::ZT_OK, lS0->Gimbals_Detect());
+
+    for (i = 0; i < GROUP_QTY; i ++)
+    {
+        lG[i] = lS0->Gimbal_Get(0);
+        KMS_TEST_ASSERT_RETURN(NULL != lG[i]);
+
+        KMS_TEST_COMPARE(ZT::ZT_OK, lG[i]->Activate());
+        KMS_TEST_COMPARE(ZT::ZT_OK, lG[i]->Metrics_Get(&lMetrics, true));
+
+        lPos[i].mAxis_deg[ZT::IGimbal::AXIS_PITCH] = 5.0 * i;
+        lPos[i].mAxis_deg[ZT::IGimbal::AXIS_ROLL ] = 0.0;
+        lPos[i].mAxis_deg[ZT::IGimbal::AXIS_YAW  ] = 10.0 * (i + 1);
+    }
+
+    // ===== Invalid =======================================================
+
+    KMS_TEST_COMPARE(ZT::ZT_ERROR_MIN, lS0->Gimbals_Position_Set(lG, lPos, 0));
+    KMS_TEST_COMPARE(ZT::ZT_ERROR_MAX, lS0->Gimbals_Position_Set(lG, lPos, ZT_GROUP_MAX + 1));
+
+    // The last gimbal refuses the position, the others do not move.
+    lPos[GROUP_QTY - 1].mAxis_deg[ZT::IGimbal::AXIS_PITCH] = 1000.0;
+
+    KMS_TEST_ASSERT(ZT::ZT_OK != lS0->Gimbals_Position_Set(lG, lPos, GROUP_QTY));
+
+    lPos[GROUP_QTY - 1].mAxis_deg[ZT::IGimbal::AXIS_PITCH] = 0.0;
+
+    KMS_TEST_COMPARE(ZT::ZT_OK, lG[0]->Metrics_Get(&lMetrics));
+    KMS_TEST_COMPARE(0, lMetrics.mGroup_Skew.mCount);
+
+    // ===== Moves =========================================================
+
+    for (unsigned int m = 0; m < MOVE_QTY; m ++)
+    {
+        for (i = 0; i < GROUP_QTY; i ++)
+        {
+            lPos[i].mAxis_deg[ZT::IGimbal::AXIS_YAW] = - lPos[i].mAxis_deg[ZT::IGimbal::AXIS_YAW];
+        }
+
+        KMS_TEST_COMPARE(ZT::ZT_OK, lS0->Gimbals_Position_Set(lG, lPos, GROUP_QTY, 0, 200));
+
+        usleep(25000);
+    }
+
+    for (i = 0; i < GROUP_QTY; i ++)
+    {
+        KMS_TEST_ASSERT(Wait(lG[i], lPos[i]));
+
+        KMS_TEST_COMPARE(ZT::ZT_OK, lG[i]->Metrics_Get(&lMetrics));
+        KMS_TEST_COMPARE(MOVE_QTY, lMetrics.mGroup_Skew.mCount);
+
+        printf("    Gimbal %u - Skew ", i);
+        ZT::IGimbal::Display(stdout, lMetrics.mGroup_Skew);
+
+        // Less than a tenth of the period of the workers
+        KMS_TEST_ASSERT(1000 > lMetrics.mGroup_Skew.mP50_us);
+    }
+
+    // ===== Member already in a group move ================================
+
+    // The second gimbal refuses the move, the first one keeps its target.
+    Gimbal * lBusy = static_cast<Gimbal *>(lG[1]);
+
+    KMS_TEST_COMPARE(ZT::ZT_OK, lBusy->Group_Stage(lPos[1], 0, 200));
+
+    ZT::IGimbal::Position lOther_Pos[2] = { lPos[0], lPos[1] };
+
+    lOther_Pos[0].mAxis_deg[ZT::IGimbal::AXIS_YAW] = - lPos[0].mAxis_deg[ZT::IGimbal::AXIS_YAW];
+
+    KMS_TEST_COMPARE(ZT::ZT_ERROR_STATE, lS0->Gimbals_Position_Set(lG, lOther_Pos, 2));
+
+    lBusy->Group_Cancel();
+
+    Motion_Tester      lMT;
+    ZT::IGimbal::Speed lSpeed;
+
+    KMS_TEST_COMPARE(ZT::ZT_OK, lG[0]->Speed_Get(&lSpeed));
+    KMS_TEST_ASSERT(0.0 == lSpeed.mAxis_deg_s[ZT::IGimbal::AXIS_YAW]);
+
+    KMS_TEST_COMPARE(ZT::ZT_OK, lG[0]->Telemetry_Start(&lMT, MSG_TELEMETRY, 1));
+
+    usleep(100000);
+
+    KMS_TEST_COMPARE(ZT::ZT_OK, lG[0]->Telemetry_Stop());
+    KMS_TEST_ASSERT(0 < lMT.mCount);
+    KMS_TEST_COMPARE(ZT::IGimbal::MOTION_STOPPED, lMT.mMotion);
+
+    KMS_TEST_COMPARE(ZT::ZT_OK, lG[0]->Metrics_Get(&lMetrics));
+    KMS_TEST_COMPARE(MOVE_QTY, lMetrics.mGroup_Skew.mCount);
+
+    // ===== Duplicate, the gimbal moves once ==============================
+
+    ZT::IGimbal         * lDup    [3] = { lG[0], lG[0], lG[1] };
+    ZT::IGimbal::Position lDup_Pos[3] = { lPos[0], lPos[1], lPos[1] };
+
+    KMS_TEST_COMPARE(ZT::ZT_OK, lS0->Gimbals_Position_Set(lDup, lDup_Pos, 3));
+    KMS_TEST_ASSERT(Wait(lG[0], lPos[0]));
+
+    KMS_TEST_COMPARE(ZT::ZT_OK, lG[0]->Metrics_Get(&lMetrics));
+    KMS_TEST_COMPARE(MOVE_QTY + 1, lMetrics.mGroup_Skew.mCount);
+
+    for (i = 0; i < GROUP_QTY; i ++)
+    {
+        lG[i]->Release();
+    }
+
+    lS0->Release();
+}
+KMS_TEST_END
+
+// Static functions
+// //////////////////////////////////////////////////////////////////////////
+
+bool Wait(ZT::IGimbal * aGimbal, const ZT::IGimbal::Position & aTarget)
+{
+    assert(NULL != aGimbal);
+
+    for (unsigned int i = 0; i < 100; i ++)
+    {
+        ZT::IGimbal::Position lPosition;
+
+        ZT::Result lRet = aGimbal->Position_Get(&lPosition);
+        assert(ZT::ZT_OK == lRet);
+
+        bool lDone = true;
+
+        for (unsigned int a = 0; a < ZT::IGimbal::AXIS_QTY; a ++)
+        {
+            lDone &= (0.2 > fabs(aTarget.mAxis_deg[a] - lPosition.mAxis_deg[a]));
+        }
+
+        if (lDone)
+        {
+            return true;
+        }
+
+        usleep(50000);
+    }
+
+    return false;
+}
@@ -0,0 +1,184 @@
+
+// Author  KMS - Martin Dubois, P.Eng.
+// Client  ZAP
+// Product Tacking
+// File    ZT_Lib_Test/Thread.cpp
+
+#include "Component.h"
+
+// ===== C ==================================================================
+#include <assert.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <unistd.h>
+
+// ===== Includes ===========================================================
+#include <ZT/IMessageReceiver.h>
+
+// ===== ZT_Lib =============================================================
+#include "ZT_Lib/Thread.h"
+
+// Constants
+// //////////////////////////////////////////////////////////////////////////
+
+#define MSG_DUMMY     (1)
+#define MSG_ITERATION (2)
+#define MSG_TIMER     (3)
+
+#define PERIOD_ms (10)
+
+#define TIMER_PERIOD_ms (2)
+
+// Test class
+// //////////////////////////////////////////////////////////////////////////
+
+class Thread_Tester : public ZT::IMessageReceiver
+{
+
+public:
+
+    Thread_Tester();
+
+    unsigned int mIteration;
+
+    // The contexts of the expired timers, in order
+    unsigned int mTimer[4];
+    unsigned int mTimer_Count;
+
+    // ===== ZT::IMessageReceiver ==========================================
+
+    virtual bool ProcessMessage(void * aSender, unsigned int aCode, const void * aData);
+
+};
+
+// Tests
+// //////////////////////////////////////////////////////////////////////////
+
+KMS_TEST_BEGIN(Thread_Base)
+{
+    ZT_Lib::Thread         lT0;
+    ZT_Lib::Thread::Timing lTiming;
+    Thread_Tester          lTester;
+
+    KMS_TEST_COMPARE_RETURN(ZT::ZT_OK, lT0.Start(&lTester, MSG_DUMMY, MSG_ITERATION, MSG_DUMMY, PERIOD_ms));
+
+    usleep(20 * PERIOD_ms * 1000);
+
+    for (unsigned int i = 0; i < 5; i++)
+    {
+        lT0.Wake();
+
+        usleep(PERIOD_ms * 1000 / 4);
+    }
+
+    KMS_TEST_COMPARE(ZT::ZT_OK, lT0.Stop());
+
+    lT0.Timing_Get(&lTiming);
+
+    // The limits are large because the test may run on a loaded computer.
+    KMS_TEST_ASSERT(15 <= lTiming.mTick);
+    KMS_TEST_ASSERT(25 >= lTiming.mTick);
+    KMS_TEST_ASSERT( 1 <= lTiming.mWake);
+    KMS_TEST_ASSERT( 5 >= lTiming.mWake);
+
+    KMS_TEST_ASSERT(lTiming.mTick + lTiming.mWake == lTester.mIteration);
+}
+KMS_TEST_END
+
+KMS_TEST_BEGIN(Thread_Timer)
+{
+    static const unsigned int DELAYS_tick[4] = { 3, 1, THREAD_WHEEL_SIZE + 2, 5 };
+
+    ZT_Lib::Thread         lT0;
+    ZT_Lib::Thread::Timing lTiming;
+    Thread_Tester          lTester;
+    ZT_Lib::Timer          lTimers[4];
+
+    // Not started, the timer never expires
+    lTimers[0].Init(&lTester, MSG_TIMER, reinterpret_cast<void *>(0));
+    lT0.Zone0_Enter();
+    {
+        lT0.Timer_Start_Z0(lTimers + 0, 1);
+    }
+    lT0.Zone0_Leave();
+    KMS_TEST_ASSERT(!lTimers[0].IsStarted());
+
+    KMS_TEST_COMPARE_RETURN(ZT::ZT_OK, lT0.Start(&lTester, MSG_DUMMY, MSG_ITERATION, MSG_DUMMY, TIMER_PERIOD_ms));
+
+    lT0.Zone0_Enter();
+    {
+        for (unsigned int i = 0; i < 4; i++)
+        {
+            lTimers[i].Init(&lTester, MSG_TIMER, reinterpret_cast<void *>(i));
+
+            lT0.Timer_Start_Z0(lTimers + i, DELAYS_tick[i]);
+            KMS_TEST_ASSERT(lTimers[i].IsStarted());
+        }
+
+        // A started timer restarts, a stopped one never expires
+        lT0.Timer_Start_Z0(lTimers + 0, 2);
+
+        lTimers[3].Stop_Z0();
+        KMS_TEST_ASSERT(!lTimers[3].IsStarted());
+    }
+    lT0.Zone0_Leave();
+
+    usleep((THREAD_WHEEL_SIZE + 20) * TIMER_PERIOD_ms * 1000);
+
+    lT0.Zone0_Enter();
+    {
+        // The rounds keep the long timer in the wheel for one more turn
+        lT0.Timer_Start_Z0(lTimers + 3, 2 * THREAD_WHEEL_SIZE);
+    }
+    lT0.Zone0_Leave();
+
+    KMS_TEST_COMPARE(ZT::ZT_OK, lT0.Stop());
+
+    // The thread stopped, the timer left the wheel
+    KMS_TEST_ASSERT(!lTimers[3].IsStarted());
+
+    KMS_TEST_COMPARE(3, lTester.mTimer_Count);
+    KMS_TEST_COMPARE(1, lTester.mTimer[0]);
+    KMS_TEST_COMPARE(0, lTester.mTimer[1]);
+    KMS_TEST_COMPARE(2, lTester.mTimer[2]);
+
+    lT0.Timing_Get(&lTiming);
+
+    KMS_TEST_COMPARE(3, lTiming.mTimer);
+}
+KMS_TEST_END
+
+// Test class
+// //////////////////////////////////////////////////////////////////////////
+
+Thread_Tester::Thread_Tester() : mIteration(0), mTimer_Count(0)
+{
+    memset(&mTimer, 0, sizeof(mTimer));
+}
+
+// ===== ZT::IMessageReceiver ==============================================
+
+bool Thread_Tester::ProcessMessage(void * aSender, unsigned int aCode, const void * aData)
+{
+    switch (aCode)
+    {
+    case MSG_DUMMY: break;
+
+    case MSG_ITERATION: mIteration ++; break;
+
+    case MSG_TIMER:
+        assert(NULL != aData);
+
+        if (sizeof(mTimer) / sizeof(mTimer[0]) > mTimer_Count)
+        {
+            mTimer[mTimer_Count] = static_cast<unsigned int>(reinterpret_cast<uintptr_t>(reinterpret_cast<const ZT_Lib::Timer *>(aData)->Context_Get()));
+        }
+
+        mTimer_Count ++;
+        break;
+
+    default: assert(false);
+    }
+
+    return true;
+}
@@ -21,20 +21,62 @@ KMS_TEST_GROUP_LIST_BEGIN
     KMS_TEST_GROUP_LIST_ENTRY("Setup-C")
 KMS_TEST_GROUP_LIST_END
 
+extern int CAN_Batch_Base();
 extern int ControlLink_Base();
 extern int ControlLink_SetupC();
+extern int ControlLink_Start();
+extern int ControlLink_Table();
+extern int DJI_Cache_Base();
+extern int DJI_Command_Base();
+extern int DJI_Connector_Base();
+extern int DJI_CRC_Base();
+extern int DJI_Reassembler_Base();
+extern int DJI_Setpoint_Base();
+extern int DJI_Transaction_Base();
+extern int FlightRecorder_Base();
 extern int Gamepad_SetupB();
+extern int Gimbal_Base();
 extern int Gimbal_SetupA();
 extern int Gimbal_Focus_SetupA();
+extern int Histogram_Base();
+extern int Replay_Device_Base();
+extern int Scheduler_Base();
+extern int Sim_Device_Base();
+extern int Sim_Device_Recovery();
 extern int System_Base();
+extern int System_Group();
+extern int System_Simulator();
+extern int Thread_Base();
+extern int Thread_Timer();
 
 KMS_TEST_LIST_BEGIN
-    KMS_TEST_LIST_ENTRY(ControlLink_Base   , "ControlLink - Base"      , 0, 0)
-    KMS_TEST_LIST_ENTRY(ControlLink_SetupC , "ControlLink - Setup-C"   , 3, KMS_TEST_FLAG_INTERACTION_NEEDED)
-    KMS_TEST_LIST_ENTRY(Gamepad_SetupB     , "Gamepad - Setup-B"       , 2, KMS_TEST_FLAG_INTERACTION_NEEDED)
-    KMS_TEST_LIST_ENTRY(Gimbal_SetupA      , "Gimbal - Setup-A"        , 1, KMS_TEST_FLAG_INTERACTION_NEEDED)
-    KMS_TEST_LIST_ENTRY(Gimbal_Focus_SetupA, "Gimbal - Focus - Setup-A", 1, KMS_TEST_FLAG_INTERACTION_NEEDED)
-    KMS_TEST_LIST_ENTRY(System_Base        , "System - Base"           , 0, 0)
+    KMS_TEST_LIST_ENTRY(CAN_Batch_Base      , "CAN_Batch - Base"        , 0, 0)
+    KMS_TEST_LIST_ENTRY(ControlLink_Base    , "ControlLink - Base"      , 0, 0)
+    KMS_TEST_LIST_ENTRY(ControlLink_SetupC  , "ControlLink - Setup-C"   , 3, KMS_TEST_FLAG_INTERACTION_NEEDED)
+    KMS_TEST_LIST_ENTRY(ControlLink_Start   , "ControlLink - Start"     , 0, 0)
+    KMS_TEST_LIST_ENTRY(ControlLink_Table   , "ControlLink - Table"     , 0, 0)
+    KMS_TEST_LIST_ENTRY(DJI_Cache_Base      , "DJI_Cache - Base"        , 0, 0)
+    KMS_TEST_LIST_ENTRY(DJI_Command_Base    , "DJI_Command - Base"      , 0, 0)
+    KMS_TEST_LIST_ENTRY(DJI_Connector_Base  , "DJI_Connector - Base"    , 0, 0)
+    KMS_TEST_LIST_ENTRY(DJI_CRC_Base        , "DJI_CRC - Base"          , 0, 0)
+    KMS_TEST_LIST_ENTRY(DJI_Reassembler_Base, "DJI_Reassembler - Base"  , 0, 0)
+    KMS_TEST_LIST_ENTRY(DJI_Setpoint_Base   , "DJI_Setpoint - Base"     , 0, 0)
+    KMS_TEST_LIST_ENTRY(DJI_Transaction_Base, "DJI_Transaction - Base"  , 0, 0)
+    KMS_TEST_LIST_ENTRY(FlightRecorder_Base , "FlightRecorder - Base"   , 0, 0)
+    KMS_TEST_LIST_ENTRY(Gamepad_SetupB      , "Gamepad - Setup-B"       , 2, KMS_TEST_FLAG_INTERACTION_NEEDED)
+    KMS_TEST_LIST_ENTRY(Gimbal_Base         , "Gimbal - Base"           , 0, 0)
+    KMS_TEST_LIST_ENTRY(Gimbal_SetupA       , "Gimbal - Setup-A"        , 1, KMS_TEST_FLAG_INTERACTION_NEEDED)
+    KMS_TEST_LIST_ENTRY(Gimbal_Focus_SetupA , "Gimbal - Focus - Setup-A", 1, KMS_TEST_FLAG_INTERACTION_NEEDED)
+    KMS_TEST_LIST_ENTRY(Histogram_Base      , "Histogram - Base"        , 0, 0)
+    KMS_TEST_LIST_ENTRY(Replay_Device_Base  , "Replay_Device - Base"    , 0, 0)
+    KMS_TEST_LIST_ENTRY(Scheduler_Base      , "Scheduler - Base"        , 0, 0)
+    KMS_TEST_LIST_ENTRY(Sim_Device_Base     , "Sim_Device - Base"       , 0, 0)
+    KMS_TEST_LIST_ENTRY(Sim_Device_Recovery , "Sim_Device - Recovery"   , 0, 0)
+    KMS_TEST_LIST_ENTRY(System_Base         , "System - Base"           , 0, 0)
+    KMS_TEST_LIST_ENTRY(System_Group        , "System - Group"          , 0, 0)
+    KMS_TEST_LIST_ENTRY(System_Simulator    , "System - Simulator"      , 0, 0)
+    KMS_TEST_LIST_ENTRY(Thread_Base         , "Thread - Base"           , 0, 0)
+    KMS_TEST_LIST_ENTRY(Thread_Timer        , "Thread - Timer"          , 0, 0)
 KMS_TEST_LIST_END
 
 KMS_TEST_MAIN
@@ -12,9 +12,55 @@
 #include <cstdint>
 
 #include <ZT/IGimbal.h>
+#include <ZT/IMessageReceiver.h>
 #include <ZT/ISystem.h>
 #include "../ZT_Lib/Atem.h"
 
+// ============== Telemetry ==============
+
+typedef struct {
+    double pitch_deg;
+    double roll_deg;
+    double yaw_deg;
+    double pitch_deg_s;
+    double roll_deg_s;
+    double yaw_deg_s;
+    uint64_t timestamp_us;
+    unsigned int index;
+    int motion;
+} ZTP_Telemetry;
+
+typedef void (*ZTP_Telemetry_Callback)(void* context, const ZTP_Telemetry* telemetry);
+
+// Converts the telemetry messages for the C callback
+class ZTP_TelemetryReceiver final : public ZT::IMessageReceiver {
+public:
+    ZTP_TelemetryReceiver(ZTP_Telemetry_Callback callback, void* context)
+        : m_callback(callback), m_context(context) {}
+
+    virtual bool ProcessMessage(void* sender, unsigned int code, const void* data) {
+        const ZT::IGimbal::Telemetry* zt_tel = static_cast<const ZT::IGimbal::Telemetry*>(data);
+
+        ZTP_Telemetry tel;
+        tel.pitch_deg    = zt_tel->mPosition.mAxis_deg[ZT::IGimbal::AXIS_PITCH];
+        tel.roll_deg     = zt_tel->mPosition.mAxis_deg[ZT::IGimbal::AXIS_ROLL];
+        tel.yaw_deg      = zt_tel->mPosition.mAxis_deg[ZT::IGimbal::AXIS_YAW];
+        tel.pitch_deg_s  = zt_tel->mSpeed.mAxis_deg_s[ZT::IGimbal::AXIS_PITCH];
+        tel.roll_deg_s   = zt_tel->mSpeed.mAxis_deg_s[ZT::IGimbal::AXIS_ROLL];
+        tel.yaw_deg_s    = zt_tel->mSpeed.mAxis_deg_s[ZT::IGimbal::AXIS_YAW];
+        tel.timestamp_us = zt_tel->mTimestamp_us;
+        tel.index        = zt_tel->mIndex;
+        tel.motion       = static_cast<int>(zt_tel->mMotion);
+
+        m_callback(m_context, &tel);
+        return true;
+    }
+
+private:
+    ZTP_Telemetry_Callback m_callback;
+    void* m_context;
+};
+
 // ============== C API ==============
 
 extern "C" {
@@ -40,6 +86,16 @@ void* ZTP_System_Gimbal_Get(void* system, int index) {
     return static_cast<ZT::ISystem*>(system)->Gimbal_Get(index);
 }
 
+int ZTP_System_Cache_Set(void* system, const char* folder) {
+    if (!system) return -1;
+    return static_cast<int>(static_cast<ZT::ISystem*>(system)->Cache_Set(folder));
+}
+
+int ZTP_System_Simulator_Set(void* system, int count) {
+    if (!system || count < 0) return -1;
+    return static_cast<int>(static_cast<ZT::ISystem*>(system)->Simulator_Set(count));
+}
+
 // Gimbal functions
 int ZTP_Gimbal_Activate(void* gimbal) {
     if (!gimbal) return -1;
@@ -80,6 +136,42 @@ int ZTP_Gimbal_Position_Get(void* gimbal, ZTP_Position* pos) {
     return static_cast<int>(result);
 }
 
+// Never blocks, returns the last polled position and its age
+int ZTP_Gimbal_Position_Get_Cached(void* gimbal, ZTP_Position* pos, unsigned int* age_ms) {
+    if (!gimbal || !pos) return -1;
+
+    ZT::IGimbal::PositionSample zt_sample;
+    ZT::Result result = static_cast<ZT::IGimbal*>(gimbal)->Position_Get_Cached(&zt_sample);
+
+    if (result == ZT::ZT_OK) {
+        pos->pitch_deg = zt_sample.mPosition.mAxis_deg[ZT::IGimbal::AXIS_PITCH];
+        pos->roll_deg  = zt_sample.mPosition.mAxis_deg[ZT::IGimbal::AXIS_ROLL];
+        pos->yaw_deg   = zt_sample.mPosition.mAxis_deg[ZT::IGimbal::AXIS_YAW];
+
+        if (age_ms) *age_ms = zt_sample.mAge_ms;
+    }
+
+    return static_cast<int>(result);
+}
+
+// Waits for a new position only when the last one is older than max_age_ms
+int ZTP_Gimbal_Position_Get_MaxAge(void* gimbal, ZTP_Position* pos, unsigned int max_age_ms, unsigned int* age_ms) {
+    if (!gimbal || !pos) return -1;
+
+    ZT::IGimbal::PositionSample zt_sample;
+    ZT::Result result = static_cast<ZT::IGimbal*>(gimbal)->Position_Get(&zt_sample, max_age_ms);
+
+    if (result == ZT::ZT_OK) {
+        pos->pitch_deg = zt_sample.mPosition.mAxis_deg[ZT::IGimbal::AXIS_PITCH];
+        pos->roll_deg  = zt_sample.mPosition.mAxis_deg[ZT::IGimbal::AXIS_ROLL];
+        pos->yaw_deg   = zt_sample.mPosition.mAxis_deg[ZT::IGimbal::AXIS_YAW];
+
+        if (age_ms) *age_ms = zt_sample.mAge_ms;
+    }
+
+    return static_cast<int>(result);
+}
+
 int ZTP_Gimbal_Position_Set(void* gimbal, double pitch_deg, double roll_deg, double yaw_deg) {
     if (!gimbal) return -1;
 
@@ -114,6 +206,36 @@ int ZTP_Gimbal_Speed_Stop(void* gimbal) {
     return static_cast<int>(static_cast<ZT::IGimbal*>(gimbal)->Speed_Stop());
 }
 
+// Telemetry functions
+
+// The callback is called by the library thread receiving the positions,
+// one position of every decimation. Returns a handle for
+// ZTP_Gimbal_Telemetry_Stop, NULL on error.
+void* ZTP_Gimbal_Telemetry_Start(void* gimbal, ZTP_Telemetry_Callback callback, void* context, unsigned int decimation) {
+    if (!gimbal || !callback) return nullptr;
+
+    ZTP_TelemetryReceiver* receiver = new ZTP_TelemetryReceiver(callback, context);
+
+    ZT::Result result = static_cast<ZT::IGimbal*>(gimbal)->Telemetry_Start(receiver, 1, decimation);
+    if (result != ZT::ZT_OK) {
+        delete receiver;
+        return nullptr;
+    }
+
+    return receiver;
+}
+
+// The callback is not called anymore when this function returns
+int ZTP_Gimbal_Telemetry_Stop(void* gimbal, void* handle) {
+    if (!gimbal || !handle) return -1;
+
+    ZT::Result result = static_cast<ZT::IGimbal*>(gimbal)->Telemetry_Stop();
+
+    delete static_cast<ZTP_TelemetryReceiver*>(handle);
+
+    return static_cast<int>(result);
+}
+
 // Config functions
 typedef struct {
     double pitch_min_deg;
@@ -155,6 +277,68 @@ int ZTP_Gimbal_Config_Set(void* gimbal, const ZTP_Config* config) {
     return static_cast<int>(static_cast<ZT::IGimbal*>(gimbal)->Config_Set(zt_config));
 }
 
+// Metrics functions
+typedef struct {
+    uint64_t count;
+    unsigned int avg_us;
+    unsigned int max_us;
+    unsigned int p50_us;
+    unsigned int p90_us;
+    unsigned int p99_us;
+} ZTP_Latency;
+
+typedef struct {
+    ZTP_Latency command;
+    ZTP_Latency round_trip;
+    ZTP_Latency tick;
+    ZTP_Latency zone0_hold;
+    ZTP_Latency zone0_wait;
+    unsigned int retry;
+    unsigned int rx_byte;
+    unsigned int rx_error;
+    unsigned int rx_frame;
+    unsigned int timeout;
+    unsigned int tx_byte;
+    unsigned int tx_error;
+    unsigned int tx_frame;
+} ZTP_Metrics;
+
+static void ZTP_Latency_Copy(ZTP_Latency* out, const ZT::IGimbal::Latency& in) {
+    out->count  = in.mCount;
+    out->avg_us = in.mAvg_us;
+    out->max_us = in.mMax_us;
+    out->p50_us = in.mP50_us;
+    out->p90_us = in.mP90_us;
+    out->p99_us = in.mP99_us;
+}
+
+// Does not stop the gimbal thread, reset != 0 starts a new period
+int ZTP_Gimbal_Metrics_Get(void* gimbal, ZTP_Metrics* metrics, int reset) {
+    if (!gimbal || !metrics) return -1;
+
+    ZT::IGimbal::Metrics zt_metrics;
+    ZT::Result result = static_cast<ZT::IGimbal*>(gimbal)->Metrics_Get(&zt_metrics, reset != 0);
+
+    if (result == ZT::ZT_OK) {
+        ZTP_Latency_Copy(&metrics->command   , zt_metrics.mCommand);
+        ZTP_Latency_Copy(&metrics->round_trip, zt_metrics.mRoundTrip);
+        ZTP_Latency_Copy(&metrics->tick      , zt_metrics.mTick);
+        ZTP_Latency_Copy(&metrics->zone0_hold, zt_metrics.mZone0_Hold);
+        ZTP_Latency_Copy(&metrics->zone0_wait, zt_metrics.mZone0_Wait);
+
+        metrics->retry    = zt_metrics.mRetry;
+        metrics->rx_byte  = zt_metrics.mRx_byte;
+        metrics->rx_error = zt_metrics.mRx_Error;
+        metrics->rx_frame = zt_metrics.mRx_frame;
+        metrics->timeout  = zt_metrics.mTimeout;
+        metrics->tx_byte  = zt_metrics.mTx_byte;
+        metrics->tx_error = zt_metrics.mTx_Error;
+        metrics->tx_frame = zt_metrics.mTx_frame;
+    }
+
+    return static_cast<int>(result);
+}
+
 // Info functions
 typedef struct {
     char name[16];
@@ -16,7 +16,7 @@ import os
 import sys
 import time
 import ctypes
-from ctypes import c_void_p, c_int, c_double, c_char, c_uint, c_ubyte, POINTER, Structure
+from ctypes import c_void_p, c_int, c_double, c_char, c_uint, c_uint64, c_ubyte, POINTER, Structure
 from typing import Optional, Dict, Any, List
 
 # Config file paths
@@ -50,6 +50,22 @@ class ZTP_Speed(Structure):
         ("yaw_deg_s", c_double),
     ]
 
+class ZTP_Telemetry(Structure):
+    _fields_ = [
+        ("pitch_deg", c_double),
+        ("roll_deg", c_double),
+        ("yaw_deg", c_double),
+        ("pitch_deg_s", c_double),
+        ("roll_deg_s", c_double),
+        ("yaw_deg_s", c_double),
+        ("timestamp_us", c_uint64),
+        ("index", c_uint),
+        ("motion", c_int),
+    ]
+
+# Called by the library thread receiving the positions
+ZTP_Telemetry_Callback = ctypes.CFUNCTYPE(None, c_void_p, POINTER(ZTP_Telemetry))
+
 class ZTP_Config(Structure):
     _fields_ = [
         ("pitch_min_deg", c_double),
@@ -69,6 +85,33 @@ class ZTP_Info(Structure):
         ("version", c_ubyte * 4),
     ]
 
+class ZTP_Latency(Structure):
+    _fields_ = [
+        ("count", c_uint64),
+        ("avg_us", c_uint),
+        ("max_us", c_uint),
+        ("p50_us", c_uint),
+        ("p90_us", c_uint),
+        ("p99_us", c_uint),
+    ]
+
+class ZTP_Metrics(Structure):
+    _fields_ = [
+        ("command", ZTP_Latency),
+        ("round_trip", ZTP_Latency),
+        ("tick", ZTP_Latency),
+        ("zone0_hold", ZTP_Latency),
+        ("zone0_wait", ZTP_Latency),
+        ("retry", c_uint),
+        ("rx_byte", c_uint),
+        ("rx_error", c_uint),
+        ("rx_frame", c_uint),
+        ("timeout", c_uint),
+        ("tx_byte", c_uint),
+        ("tx_error", c_uint),
+        ("tx_frame", c_uint),
+    ]
+
 
 # ============== ATEM Camera Type Constants ==============
 CAMERA_EF = 0   # Canon EF mount - uses offset-based focus
@@ -325,6 +368,12 @@ class ZTLibWrapper:
         self.system = None
         self.gimbal = None
 
+        # Telemetry subscription, see start_telemetry
+        self.telemetry_callback = None
+        self.telemetry_handle = None
+        self.telemetry_listener = None
+        self.telemetry_position = None
+
         # Find the library
         lib_file = os.path.join(zt_path, 'Binaries', 'libzt_python.dylib')
         if not os.path.exists(lib_file):
@@ -354,6 +403,18 @@ class ZTLibWrapper:
         self.lib.ZTP_System_Gimbal_Get.restype = c_void_p
         self.lib.ZTP_System_Gimbal_Get.argtypes = [c_void_p, c_int]
 
+        # Gimbal cache, missing from older builds of the library
+        self.has_cache = hasattr(self.lib, 'ZTP_System_Cache_Set')
+        if self.has_cache:
+            self.lib.ZTP_System_Cache_Set.restype = c_int
+            self.lib.ZTP_System_Cache_Set.argtypes = [c_void_p, ctypes.c_char_p]
+
+        # Simulated gimbals, missing from older builds of the library
+        self.has_simulator = hasattr(self.lib, 'ZTP_System_Simulator_Set')
+        if self.has_simulator:
+            self.lib.ZTP_System_Simulator_Set.restype = c_int
+            self.lib.ZTP_System_Simulator_Set.argtypes = [c_void_p, c_int]
+
         # Gimbal functions
         self.lib.ZTP_Gimbal_Activate.restype = c_int
         self.lib.ZTP_Gimbal_Activate.argtypes = [c_void_p]
@@ -368,9 +429,29 @@ class ZTLibWrapper:
         self.lib.ZTP_Gimbal_Position_Get.restype = c_int
         self.lib.ZTP_Gimbal_Position_Get.argtypes = [c_void_p, POINTER(ZTP_Position)]
 
+        # Non-blocking variant, missing from older builds of the library
+        self.has_position_cached = hasattr(self.lib, 'ZTP_Gimbal_Position_Get_Cached')
+        if self.has_position_cached:
+            self.lib.ZTP_Gimbal_Position_Get_Cached.restype = c_int
+            self.lib.ZTP_Gimbal_Position_Get_Cached.argtypes = [c_void_p, POINTER(ZTP_Position), POINTER(c_uint)]
+
         self.lib.ZTP_Gimbal_Position_Set.restype = c_int
         self.lib.ZTP_Gimbal_Position_Set.argtypes = [c_void_p, c_double, c_double, c_double]
 
+        # Telemetry functions, missing from older builds of the library
+        self.has_telemetry = hasattr(self.lib, 'ZTP_Gimbal_Telemetry_Start')
+        if self.has_telemetry:
+            self.lib.ZTP_Gimbal_Telemetry_Start.restype = c_void_p
+            self.lib.ZTP_Gimbal_Telemetry_Start.argtypes = [c_void_p, ZTP_Telemetry_Callback, c_void_p, c_uint]
+            self.lib.ZTP_Gimbal_Telemetry_Stop.restype = c_int
+            self.lib.ZTP_Gimbal_Telemetry_Stop.argtypes = [c_void_p, c_void_p]
+
+        # Metrics functions, missing from older builds of the library
+        self.has_metrics = hasattr(self.lib, 'ZTP_Gimbal_Metrics_Get')
+        if self.has_metrics:
+            self.lib.ZTP_Gimbal_Metrics_Get.restype = c_int
+            self.lib.ZTP_Gimbal_Metrics_Get.argtypes = [c_void_p, POINTER(ZTP_Metrics), c_int]
+
         # Speed functions
         self.lib.ZTP_Gimbal_Speed_Set.restype = c_int
         self.lib.ZTP_Gimbal_Speed_Set.argtypes = [c_void_p, c_double, c_double, c_double]
@@ -430,6 +511,18 @@ class ZTLibWrapper:
             return self.lib.ZTP_System_Gimbals_Detect(self.system)
         return -1
 
+    def set_cache(self, folder) -> int:
+        """Cache the gimbal configuration in folder at the next detection, None disables the cache."""
+        if self.system and self.has_cache:
+            return self.lib.ZTP_System_Cache_Set(self.system, None if folder is None else folder.encode())
+        return -1
+
+    def set_simulator(self, count: int) -> int:
+        """Add count simulated gimbals to the next detection, 0 removes them."""
+        if self.system and self.has_simulator:
+            return self.lib.ZTP_System_Simulator_Set(self.system, count)
+        return -1
+
     def get_gimbal(self, index: int = 0):
         """Get gimbal by index."""
         if self.system:
@@ -446,14 +539,59 @@ class ZTLibWrapper:
     def release_gimbal(self):
         """Release the gimbal."""
         if self.gimbal:
+            self.stop_telemetry()
             self.lib.ZTP_Gimbal_Release(self.gimbal)
             self.gimbal = None
 
+    def start_telemetry(self, listener=None, decimation: int = 1) -> bool:
+        """Receive the positions as the library gets them.
+
+        listener(position) is called by the library thread, it must not block.
+        """
+        if not self.gimbal or not self.has_telemetry or self.telemetry_handle:
+            return False
+
+        def on_telemetry(context, telemetry):
+            t = telemetry.contents
+            position = {
+                "pitch": t.pitch_deg,
+                "roll": t.roll_deg,
+                "yaw": t.yaw_deg,
+            }
+            self.telemetry_position = position
+            if self.telemetry_listener:
+                self.telemetry_listener(position)
+
+        # The library keeps a pointer to the callback, keep a reference
+        self.telemetry_callback = ZTP_Telemetry_Callback(on_telemetry)
+        self.telemetry_listener = listener
+        self.telemetry_handle = self.lib.ZTP_Gimbal_Telemetry_Start(self.gimbal, self.telemetry_callback, None, decimation)
+        if not self.telemetry_handle:
+            self.telemetry_callback = None
+            self.telemetry_listener = None
+            return False
+        return True
+
+    def stop_telemetry(self):
+        """Stop the telemetry, the listener is not called after this returns."""
+        if self.telemetry_handle:
+            self.lib.ZTP_Gimbal_Telemetry_Stop(self.gimbal, self.telemetry_handle)
+            self.telemetry_handle = None
+            self.telemetry_callback = None
+            self.telemetry_listener = None
+            self.telemetry_position = None
+
     def get_position(self) -> Optional[Dict[str, float]]:
-        """Get current gimbal position."""
+        """Get the last polled gimbal position, without waiting for the gimbal."""
+        if self.telemetry_position:
+            return self.telemetry_position.copy()
         if self.gimbal:
             pos = ZTP_Position()
-            result = self.lib.ZTP_Gimbal_Position_Get(self.gimbal, ctypes.byref(pos))
+            age_ms = c_uint(0)
+            if self.has_position_cached:
+                result = self.lib.ZTP_Gimbal_Position_Get_Cached(self.gimbal, ctypes.byref(pos), ctypes.byref(age_ms))
+            else:
+                result = self.lib.ZTP_Gimbal_Position_Get(self.gimbal, ctypes.byref(pos))
             if result == 0:  # ZT_OK
                 return {
                     "pitch": pos.pitch_deg,
@@ -505,6 +643,20 @@ class ZTLibWrapper:
             return self.lib.ZTP_Gimbal_Track_Switch(self.gimbal)
         return -1
 
+    def get_metrics(self, reset: bool = False) -> Optional[Dict[str, Any]]:
+        """Get the latency histograms and counters, reset starts a new period."""
+        if self.gimbal and self.has_metrics:
+            metrics = ZTP_Metrics()
+            if self.lib.ZTP_Gimbal_Metrics_Get(self.gimbal, ctypes.byref(metrics), 1 if reset else 0) == 0:
+                result: Dict[str, Any] = {}
+                for name, _ in ZTP_Metrics._fields_:
+                    value = getattr(metrics, name)
+                    if isinstance(value, ZTP_Latency):
+                        value = {field: getattr(value, field) for field, _ in ZTP_Latency._fields_}
+                    result[name] = value
+                return result
+        return None
+
     def debug(self):
         """Print debug info."""
         if self.gimbal:
@@ -1319,7 +1471,8 @@ async def handle_remove_gimbal(sid, gimbal_id):
     # Disconnect if connected
     if gimbal_id in real_gimbals:
         try:
-            # Clean up wrapper
+            # Clean up wrapper, the library must not call it anymore
+            real_gimbals[gimbal_id].stop_telemetry()
             del real_gimbals[gimbal_id]
         except:
             pass
@@ -1419,6 +1572,11 @@ async def try_connect_gimbal(gimbal_id: str, ip: str):
                 wrapper.activate_gimbal()
                 real_gimbals[gimbal_id] = wrapper
 
+                # Push the positions as they arrive instead of polling
+                loop = asyncio.get_running_loop()
+                wrapper.start_telemetry(
+                    lambda position, gid=gimbal_id: loop.call_soon_threadsafe(on_real_gimbal_position, gid, position))
+
                 # Update gimbal info
                 for g in available_gimbals:
                     if g['id'] == gimbal_id:
@@ -1496,14 +1654,35 @@ async def handle_select_gimbal(sid, gimbal_id):
 
 # ============== Background Tasks ==============
 
+def is_real_telemetry_active() -> bool:
+    """Check if the active real gimbal pushes its positions."""
+    return (is_real_gimbal_active() and active_gimbal_id in real_gimbals
+            and real_gimbals[active_gimbal_id].telemetry_handle is not None)
+
+
+def on_real_gimbal_position(gimbal_id: str, position: Dict[str, float]):
+    """Broadcast a position pushed by a real gimbal, runs in the event loop."""
+    if gimbal_id != active_gimbal_id:
+        return
+
+    gimbal_state["position"] = position
+    # Mirror to virtual gimbal
+    if VIRTUAL_GIMBAL_ID in gimbal_states:
+        gimbal_states[VIRTUAL_GIMBAL_ID]["position"] = position.copy()
+
+    asyncio.ensure_future(sio.emit('gimbal:position', position))
+
+
 async def position_broadcast_loop():
     """Periodically broadcast gimbal position to all clients."""
     global home_animation
 
     while True:
         try:
-            position = get_gimbal_position()
-            await sio.emit('gimbal:position', position)
+            # The active real gimbal pushes its positions itself
+            if not is_real_telemetry_active():
+                position = get_gimbal_position()
+                await sio.emit('gimbal:position', position)
 
             # Simulate position changes based on speed (for virtual mode or when controlling virtual gimbal)
             if not is_real_gimbal_active():